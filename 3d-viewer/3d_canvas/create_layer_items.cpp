@@ -946,10 +946,21 @@ void CINFO3D_VISU::AddSolidAreasShapesToContainer( const ZONE_CONTAINER* aZoneCo
     if( polyList.IsEmpty() )
         return;
 
-    Convert_shape_line_polygon_to_triangles( polyList,
-                                             *aDstContainer,
-                                             m_biuTo3Dunits,
-                                             *aZoneContainer );
+    // The triangles cached by the zone are reused, instead of a new triangulation
+    const SHAPE_POLY_SET& filledPolys = aZoneContainer->GetFilledPolysList();
+
+    aZoneContainer->CacheTriangulation();
+
+    if( filledPolys.IsTriangulationUpToDate() )
+        Convert_triangulated_polygons_to_triangles( filledPolys,
+                                                    *aDstContainer,
+                                                    m_biuTo3Dunits,
+                                                    *aZoneContainer );
+    else
+        Convert_shape_line_polygon_to_triangles( polyList,
+                                                 *aDstContainer,
+                                                 m_biuTo3Dunits,
+                                                 *aZoneContainer );
 
 
     // add filled areas outlines, which are drawn with thick lines segments
@@ -1942,13 +1953,13 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         {
             // found
             SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST, true );
 
             wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
                       m_layers_inner_holes_poly.end() );
 
             polyLayer = m_layers_inner_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST, true );
         }
     }
 
@@ -1959,10 +1970,11 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
 
     // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    // (thousands of small disjoint holes: use the parallel union)
+    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST, true );
+    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST, true );
+    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST, true );
+    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST, true );
     //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
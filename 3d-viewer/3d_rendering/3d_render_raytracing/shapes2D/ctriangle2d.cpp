@@ -314,3 +314,34 @@ void Convert_shape_line_polygon_to_triangles( const SHAPE_POLY_SET &aPolyList,
         }
     }
 }
+
+
+void Convert_triangulated_polygons_to_triangles( const SHAPE_POLY_SET &aPolyList,
+                                                 CGENERICCONTAINER2D &aDstContainer,
+                                                 float aBiuTo3DunitsScale,
+                                                 const BOARD_ITEM &aBoardItem )
+{
+    for( unsigned int idx = 0; idx < aPolyList.TriangulatedPolyCount(); ++idx )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON *triPoly = aPolyList.TriangulatedPolygon( idx );
+
+        for( int i = 0; i < triPoly->GetTriangleCount(); ++i )
+        {
+            VECTOR2I a, b, c;
+
+            triPoly->GetTriangle( i, a, b, c );
+
+            // Flat triangles have no area, and would give a null denominator
+            if( (double)( b.x - a.x ) * ( c.y - a.y ) == (double)( b.y - a.y ) * ( c.x - a.x ) )
+                continue;
+
+            aDstContainer.Add( new CTRIANGLE2D( SFVEC2F( a.x * aBiuTo3DunitsScale,
+                                                        -a.y * aBiuTo3DunitsScale ),
+                                                SFVEC2F( b.x * aBiuTo3DunitsScale,
+                                                        -b.y * aBiuTo3DunitsScale ),
+                                                SFVEC2F( c.x * aBiuTo3DunitsScale,
+                                                        -c.y * aBiuTo3DunitsScale ),
+                                                aBoardItem ) );
+        }
+    }
+}
@@ -72,4 +72,13 @@ void Convert_shape_line_polygon_to_triangles(  const SHAPE_POLY_SET &aPolyList,
                                                CGENERICCONTAINER2D &aDstContainer,
                                                float aBiuTo3DunitsScale,
                                                const BOARD_ITEM &aBoardItem );
+
+/**
+ * Adds the cached triangles of a polygon set to a container.
+ * The triangulation of aPolyList must be up to date.
+ */
+void Convert_triangulated_polygons_to_triangles( const SHAPE_POLY_SET &aPolyList,
+                                                 CGENERICCONTAINER2D &aDstContainer,
+                                                 float aBiuTo3DunitsScale,
+                                                 const BOARD_ITEM &aBoardItem );
 #endif // _CTRIANGLE2D_H_
@@ -37,12 +37,15 @@
 #include <id.h>
 #include <base_units.h>
 
+#include <unordered_set>
+
 wxString BASE_SCREEN::m_PageLayoutDescrFileName;   // the name of the page layout descr file.
 
 BASE_SCREEN::BASE_SCREEN( KICAD_T aType ) :
     EDA_ITEM( aType )
 {
     m_UndoRedoCountMax = DEFAULT_MAX_UNDO_ITEMS;
+    m_UndoRedoMemoryMax = DEFAULT_MAX_UNDO_MEMORY;
     m_FirstRedraw      = true;
     m_ScreenNumber     = 1;
     m_NumberOfScreens  = 1;      // Hierarchy: Root: ScreenNumber = 1
@@ -413,6 +416,7 @@ void BASE_SCREEN::ClearUndoRedoList()
 
 void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
 {
+    aNewitem->m_MemorySize = commandMemorySize( *aNewitem );
     m_UndoList.PushCommand( aNewitem );
 
     // Delete the extra items, if count max reached
@@ -420,13 +424,16 @@ void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
     {
         int extraitems = GetUndoCommandCount() - m_UndoRedoCountMax;
         if( extraitems > 0 )
-            ClearUndoORRedoList( m_UndoList, extraitems );
+            clearOldCommands( m_UndoList, extraitems );
     }
+
+    trimToMemoryBudget( m_UndoList );
 }
 
 
 void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
 {
+    aNewitem->m_MemorySize = commandMemorySize( *aNewitem );
     m_RedoList.PushCommand( aNewitem );
 
     // Delete the extra items, if count max reached
@@ -434,8 +441,51 @@ void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
     {
         int extraitems = GetRedoCommandCount() - m_UndoRedoCountMax;
         if( extraitems > 0 )
-            ClearUndoORRedoList( m_RedoList, extraitems );
+            clearOldCommands( m_RedoList, extraitems );
     }
+
+    trimToMemoryBudget( m_RedoList );
+}
+
+
+size_t BASE_SCREEN::commandMemorySize( const PICKED_ITEMS_LIST& aCommand ) const
+{
+    // Each command is estimated once, when it is pushed.  The data shared between the
+    // copies of a command is counted once, but the data shared with the copies of other
+    // commands (like zone fills) is counted again, so the total is an upper bound.
+    std::unordered_set<const void*> counted;
+
+    return GetCommandMemorySize( aCommand, counted );
+}
+
+
+void BASE_SCREEN::clearOldCommands( UNDO_REDO_CONTAINER& aList, int aItemCount )
+{
+    int count = std::min( aItemCount, (int) aList.m_CommandsList.size() );
+
+    for( int ii = 0; ii < count; ii++ )
+        aList.m_MemorySize -= std::min( aList.m_MemorySize,
+                                        aList.m_CommandsList[ii]->m_MemorySize );
+
+    ClearUndoORRedoList( aList, count );
+}
+
+
+void BASE_SCREEN::trimToMemoryBudget( UNDO_REDO_CONTAINER& aList )
+{
+    if( m_UndoRedoMemoryMax <= 0 )
+        return;
+
+    size_t budget = size_t( m_UndoRedoMemoryMax ) * 1024 * 1024;
+    size_t total = aList.m_MemorySize;
+    int    count = 0;
+
+    // The newest command is always kept
+    while( total > budget && count < (int) aList.m_CommandsList.size() - 1 )
+        total -= std::min( total, aList.m_CommandsList[count++]->m_MemorySize );
+
+    if( count > 0 )
+        clearOldCommands( aList, count );
 }
 
 
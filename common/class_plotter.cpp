@@ -39,6 +39,8 @@
 
 #include <fctsys.h>
 
+#include <cmath>
+
 #include <trigo.h>
 #include <wxstruct.h>
 #include <base_struct.h>
@@ -89,10 +91,148 @@ bool PLOTTER::OpenFile( const wxString& aFullFilename )
     if( outputFile == NULL )
         return false ;
 
+    setFileBuffer( outputFile, m_outputBuffer );
+
     return true;
 }
 
 
+void PLOTTER::setFileBuffer( FILE* aFile, std::unique_ptr<char[]>& aBuffer )
+{
+    if( !aBuffer )
+        aBuffer.reset( new char[FILE_BUFFER_SIZE] );
+
+    setvbuf( aFile, aBuffer.get(), _IOFBF, FILE_BUFFER_SIZE );
+}
+
+
+char* PLOTTER::formatInt( char* aBuffer, int aValue )
+{
+    // The digits are found from the last one
+    char  digits[12];
+    char* end = digits + sizeof( digits );
+    char* first = end;
+    unsigned int mag = aValue < 0 ? 0u - (unsigned int) aValue : (unsigned int) aValue;
+
+    do
+    {
+        *--first = char( '0' + mag % 10 );
+        mag /= 10;
+    } while( mag );
+
+    if( aValue < 0 )
+        *aBuffer++ = '-';
+
+    memcpy( aBuffer, first, end - first );
+
+    return aBuffer + ( end - first );
+}
+
+
+char* PLOTTER::formatDouble( char* aBuffer, double aValue )
+{
+    // Powers of ten from 1e-4 to 1e6
+    static const double decades[] = { 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+    static const int    scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000,
+                                     100000000, 1000000000 };
+
+    if( aValue == 0.0 )
+    {
+        if( std::signbit( aValue ) )
+            *aBuffer++ = '-';
+
+        *aBuffer++ = '0';
+        return aBuffer;
+    }
+
+    double mag = std::fabs( aValue );
+
+    // %g uses the exponent notation out of this range (and for infinities and NaNs)
+    if( !( mag >= 1e-4 && mag < 1e6 ) )
+        return aBuffer + snprintf( aBuffer, NUMBER_MAX_LEN, "%g", aValue );
+
+    // %g gives 6 significant digits
+    int exponent = -4;
+
+    while( mag >= decades[exponent + 5] )
+        exponent++;
+
+    int       decimals = 5 - exponent;
+    double    scaled = mag * scales[decimals];
+    long long digits = (long long) scaled;
+    double    rest = scaled - digits;
+
+    // Round like printf: half to even, from the exact product
+    if( rest > 0.5 )
+    {
+        digits++;
+    }
+    else if( rest == 0.5 )
+    {
+        double error = std::fma( mag, scales[decimals], -scaled );
+
+        if( error > 0.0 || ( error == 0.0 && ( digits & 1 ) ) )
+            digits++;
+    }
+
+    // The rounding can give one more digit
+    if( digits >= 1000000 )
+    {
+        if( exponent == 5 )
+            return aBuffer + snprintf( aBuffer, NUMBER_MAX_LEN, "%g", aValue );
+
+        decimals--;
+        digits = ( digits + 5 ) / 10;
+    }
+
+    if( aValue < 0 )
+        *aBuffer++ = '-';
+
+    aBuffer = formatInt( aBuffer, int( digits / scales[decimals] ) );
+
+    int fraction = int( digits % scales[decimals] );
+
+    if( fraction )
+    {
+        // %g drops the trailing zeros
+        while( fraction % 10 == 0 )
+        {
+            fraction /= 10;
+            decimals--;
+        }
+
+        *aBuffer++ = '.';
+
+        for( int ii = decimals - 1; ii >= 0; ii-- )
+        {
+            aBuffer[ii] = char( '0' + fraction % 10 );
+            fraction /= 10;
+        }
+
+        aBuffer += decimals;
+    }
+
+    return aBuffer;
+}
+
+
+void PLOTTER::writeCoords( FILE* aFile, double aX, double aY, const char* aSuffix )
+{
+    char   line[2 * NUMBER_MAX_LEN + 32];
+    size_t suffixLen = strlen( aSuffix );
+
+    wxASSERT( suffixLen < 32 );
+
+    char* end = formatDouble( line, aX );
+    *end++ = ' ';
+    end = formatDouble( end, aY );
+    memcpy( end, aSuffix, suffixLen );
+    end += suffixLen;
+
+    fwrite( line, 1, end - line, aFile );
+}
+
+
 DPOINT PLOTTER::userToDeviceCoordinates( const wxPoint& aCoordinate )
 {
     wxPoint pos = aCoordinate - plotOffset;
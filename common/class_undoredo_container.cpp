@@ -43,6 +43,7 @@ ITEM_PICKER::ITEM_PICKER( EDA_ITEM* aItem, UNDO_REDO_T aUndoRedoStatus )
 PICKED_ITEMS_LIST::PICKED_ITEMS_LIST()
 {
     m_Status = UR_UNSPECIFIED;
+    m_MemorySize = 0;
 }
 
 PICKED_ITEMS_LIST::~PICKED_ITEMS_LIST()
@@ -307,6 +308,7 @@ void PICKED_ITEMS_LIST::ReversePickersListOrder()
 
 UNDO_REDO_CONTAINER::UNDO_REDO_CONTAINER()
 {
+    m_MemorySize = 0;
 }
 
 
@@ -322,12 +324,19 @@ void UNDO_REDO_CONTAINER::ClearCommandList()
         delete m_CommandsList[ii];
 
     m_CommandsList.clear();
+    m_MemorySize = 0;
 }
 
 
 void UNDO_REDO_CONTAINER::PushCommand( PICKED_ITEMS_LIST* aItem )
 {
+    // The screens empty the list without ClearCommandList(), when the redo list is
+    // cleared by a new change
+    if( m_CommandsList.empty() )
+        m_MemorySize = 0;
+
     m_CommandsList.push_back( aItem );
+    m_MemorySize += aItem->m_MemorySize;
 }
 
 
@@ -337,6 +346,7 @@ PICKED_ITEMS_LIST* UNDO_REDO_CONTAINER::PopCommand()
     {
         PICKED_ITEMS_LIST* item = m_CommandsList.back();
         m_CommandsList.pop_back();
+        m_MemorySize -= std::min( m_MemorySize, item->m_MemorySize );
         return item;
     }
 
@@ -64,6 +64,15 @@ GERBER_PLOTTER::GERBER_PLOTTER()
 }
 
 
+GERBER_PLOTTER::~GERBER_PLOTTER()
+{
+    // Emergency cleanup, when EndPlot() is not called: the base destructor closes
+    // the work file, which is then the output file, but not the final file
+    if( finalFile && finalFile != outputFile )
+        fclose( finalFile );
+}
+
+
 void GERBER_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
 				  double aScale, bool aMirror )
 {
@@ -100,9 +109,25 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
+    // Same as fprintf( outputFile, "X%dY%dD%02d*\n", ... ), but the coordinates are the bulk
+    // of a gerber file: they are formatted without printf
+    char  line[3 * NUMBER_MAX_LEN + 8];
+    char* end = line;
+
+    *end++ = 'X';
+    end = formatInt( end, KiROUND( pt.x ) );
+    *end++ = 'Y';
+    end = formatInt( end, KiROUND( pt.y ) );
+    *end++ = 'D';
+
+    if( dcode >= 0 && dcode < 10 )
+        *end++ = '0';
 
-    fprintf( outputFile, "X%dY%dD%02d*\n",
-	    KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+    end = formatInt( end, dcode );
+    *end++ = '*';
+    *end++ = '\n';
+
+    fwrite( line, 1, end - line, outputFile );
 }
 
 
@@ -172,6 +197,8 @@ bool GERBER_PLOTTER::StartPlot()
     if( outputFile == NULL )
         return false;
 
+    setFileBuffer( workFile, m_workBuffer );
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
@@ -230,6 +257,7 @@ bool GERBER_PLOTTER::EndPlot()
     fclose( workFile );
     workFile   = wxFopen( m_workFilename, wxT( "rt" ));
     wxASSERT( workFile );
+    setFileBuffer( workFile, m_workBuffer );
     outputFile = finalFile;
 
     // Placement of apertures in RS274X
@@ -241,13 +269,22 @@ bool GERBER_PLOTTER::EndPlot()
         {
             writeApertureList();
             fputs( "G04 APERTURE END LIST*\n", outputFile );
+            break;
         }
     }
 
+    // The rest of the file is copied as is
+    size_t count;
+
+    while( ( count = fread( line, 1, sizeof( line ), workFile ) ) > 0 )
+        fwrite( line, 1, count, outputFile );
+
     fclose( workFile );
     fclose( finalFile );
     ::wxRemoveFile( m_workFilename );
     outputFile = 0;
+    workFile = NULL;
+    finalFile = NULL;
 
     return true;
 }
@@ -37,7 +37,40 @@
 #include <macros.h>
 #include <kicad_string.h>
 #include <wx/zstream.h>
-#include <wx/mstream.h>
+
+
+/**
+ * Class PDF_FILE_OUTPUT_STREAM
+ * is a wxOutputStream writing to a plot file, which counts the written bytes.
+ * The file is not closed with the stream.
+ */
+class PDF_FILE_OUTPUT_STREAM : public wxOutputStream
+{
+public:
+    PDF_FILE_OUTPUT_STREAM( FILE* aFile ) :
+        m_file( aFile ),
+        m_count( 0 )
+    {
+    }
+
+    size_t GetCount() const { return m_count; }
+
+protected:
+    size_t OnSysWrite( const void* aBuffer, size_t aSize ) override
+    {
+        size_t written = fwrite( aBuffer, 1, aSize, m_file );
+
+        if( written != aSize )
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+
+        m_count += written;
+        return written;
+    }
+
+private:
+    FILE*   m_file;
+    size_t  m_count;
+};
 
 
 /*
@@ -58,9 +91,22 @@ bool PDF_PLOTTER::OpenFile( const wxString& aFullFilename )
     if( outputFile == NULL )
         return false ;
 
+    setFileBuffer( outputFile, m_outputBuffer );
+
     return true;
 }
 
+
+PDF_PLOTTER::~PDF_PLOTTER()
+{
+    // Emergency cleanup of an unfinished page stream
+    if( workFile )
+    {
+        fclose( workFile );
+        ::wxRemoveFile( workFilename );
+    }
+}
+
 void PDF_PLOTTER::SetPageSettings( const PAGE_INFO& aPageSettings )
 {
     pageInfo = aPageSettings;
@@ -229,19 +275,19 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    writeCoords( workFile, pos_dev.x, pos_dev.y, " m " );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        writeCoords( workFile, pos_dev.x, pos_dev.y, " l " );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    writeCoords( workFile, pos_dev.x, pos_dev.y, " l " );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
@@ -252,7 +298,7 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        writeCoords( workFile, pos_dev.x, pos_dev.y, " l b\n" );
     }
 }
 
@@ -270,12 +316,12 @@ void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    writeCoords( workFile, pos.x, pos.y, " m\n" );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        writeCoords( workFile, pos.x, pos.y, " l\n" );
     }
 
     // Close path and stroke(/fill)
@@ -301,9 +347,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
-                 pos_dev.x, pos_dev.y,
-                 ( plume=='D' ) ? 'l' : 'm' );
+        writeCoords( workFile, pos_dev.x, pos_dev.y, ( plume=='D' ) ? " l\n" : " m\n" );
     }
     penState   = plume;
     penLastpos = pos;
@@ -447,6 +491,10 @@ int PDF_PLOTTER::startPdfStream(int handle)
     workFilename = filename + wxT(".tmp");
     workFile = wxFopen( workFilename, wxT( "w+b" ));
     wxASSERT( workFile );
+
+    if( workFile )
+        setFileBuffer( workFile, m_workBuffer );
+
     return handle;
 }
 
@@ -458,29 +506,10 @@ void PDF_PLOTTER::closePdfStream()
 {
     wxASSERT( workFile );
 
-    long stream_len = ftell( workFile );
-
-    if( stream_len < 0 )
-    {
-        wxASSERT( false );
-        return;
-    }
-
-    // Rewind the file, read in the page stream and DEFLATE it
+    // Rewind the file, and DEFLATE the page stream to the output file, by chunks
     fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
-
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
-
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+    PDF_FILE_OUTPUT_STREAM fileStream( outputFile );
 
     {
         /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
@@ -490,19 +519,22 @@ void PDF_PLOTTER::closePdfStream()
          *                    8, Z_DEFAULT_STRATEGY );
          */
 
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+        wxZlibOutputStream zos( fileStream, m_compressionLevel, wxZLIB_ZLIB );
 
-        zos.Write( inbuf, stream_len );
+        char   inbuf[64 * 1024];
+        size_t count;
 
-        delete[] inbuf;
+        while( ( count = fread( inbuf, 1, sizeof( inbuf ), workFile ) ) > 0 )
+            zos.Write( inbuf, count );
 
     }   // flush the zip stream using zos destructor
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
-
-    unsigned out_count = sb->Tell();
+    // We are done with the temporary file, junk it
+    fclose( workFile );
+    workFile = 0;
+    ::wxRemoveFile( workFilename );
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+    unsigned out_count = fileStream.GetCount();
 
     fputs( "endstream\n", outputFile );
     closePdfObject();
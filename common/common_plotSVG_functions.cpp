@@ -459,13 +459,19 @@ void SVG_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
         break;
     }
 
-    DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( outputFile, "points=\"%d,%d\n", (int) pos.x, (int) pos.y );
+    fputs( "points=\"", outputFile );
 
-    for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
+    // The points are the bulk of large plots: they are formatted without printf
+    char line[2 * NUMBER_MAX_LEN + 2];
+
+    for( unsigned ii = 0; ii < aCornerList.size(); ii++ )
     {
-        pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( outputFile, "%d,%d\n", (int) pos.x, (int) pos.y );
+        DPOINT pos = userToDeviceCoordinates( aCornerList[ii] );
+        char*  end = formatInt( line, (int) pos.x );
+        *end++ = ',';
+        end = formatInt( end, (int) pos.y );
+        *end++ = '\n';
+        fwrite( line, 1, end - line, outputFile );
     }
 
     // Close/(fill) the path
@@ -522,8 +528,15 @@ void SVG_PLOTTER::PenTo( const wxPoint& pos, char plume )
     else if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( outputFile, "L%d %d\n",
-                 (int) pos_dev.x, (int) pos_dev.y );
+        char   line[2 * NUMBER_MAX_LEN + 3];
+        char*  end = line;
+
+        *end++ = 'L';
+        end = formatInt( end, (int) pos_dev.x );
+        *end++ = ' ';
+        end = formatInt( end, (int) pos_dev.y );
+        *end++ = '\n';
+        fwrite( line, 1, end - line, outputFile );
     }
 
     penState    = plume;
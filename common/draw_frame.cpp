@@ -93,6 +93,20 @@ static const wxString GalDisplayOptionsKeyword( wxT( "GalDisplayOptions" ) );
  */
 static const wxString MaxUndoItemsEntry(wxT( "DevelMaxUndoItems" ) );
 
+/**
+ * Integer to set the memory budget of the undo and redo stacks, in MB.  The oldest
+ * commands are deleted when a stack uses more memory.  If zero, the memory is unlimited.
+ * Only the pcbnew frames estimate the memory used by their commands.
+ *
+ * Present as:
+ *
+ * - PcbFrameDevelMaxUndoMemory (file: pcbnew)
+ * - ModEditFrameDevelMaxUndoMemory (file: pcbnew)
+ *
+ * \ingroup develconfig
+ */
+static const wxString MaxUndoMemoryEntry( wxT( "DevelMaxUndoMemory" ) );
+
 BEGIN_EVENT_TABLE( EDA_DRAW_FRAME, KIWAY_PLAYER )
     EVT_MOUSEWHEEL( EDA_DRAW_FRAME::OnMouseEvent )
     EVT_MENU_OPEN( EDA_DRAW_FRAME::OnMenuOpen )
@@ -161,6 +175,8 @@ EDA_DRAW_FRAME::EDA_DRAW_FRAME( KIWAY* aKiway, wxWindow* aParent,
     m_MsgFrameHeight      = EDA_MSG_PANEL::GetRequiredHeight();
     m_movingCursorWithKeyboard = false;
     m_zoomLevelCoeff      = 1.0;
+    m_UndoRedoCountMax    = DEFAULT_MAX_UNDO_ITEMS;
+    m_UndoRedoMemoryMax   = DEFAULT_MAX_UNDO_MEMORY;
 
     m_auimgr.SetFlags(wxAUI_MGR_DEFAULT|wxAUI_MGR_LIVE_RESIZE);
 
@@ -728,6 +744,9 @@ void EDA_DRAW_FRAME::LoadSettings( wxConfigBase* aCfg )
     m_UndoRedoCountMax = aCfg->Read( baseCfgName + MaxUndoItemsEntry,
             long( DEFAULT_MAX_UNDO_ITEMS ) );
 
+    m_UndoRedoMemoryMax = aCfg->Read( baseCfgName + MaxUndoMemoryEntry,
+            long( DEFAULT_MAX_UNDO_MEMORY ) );
+
     m_galDisplayOptions->ReadConfig( aCfg, baseCfgName + GalDisplayOptionsKeyword );
 }
 
@@ -744,7 +763,10 @@ void EDA_DRAW_FRAME::SaveSettings( wxConfigBase* aCfg )
     aCfg->Write( baseCfgName + LastGridSizeIdKeyword, ( long ) m_LastGridSizeId );
 
     if( GetScreen() )
+    {
         aCfg->Write( baseCfgName + MaxUndoItemsEntry, long( GetScreen()->GetMaxUndoItems() ) );
+        aCfg->Write( baseCfgName + MaxUndoMemoryEntry, long( GetScreen()->GetMaxUndoMemory() ) );
+    }
 
     m_galDisplayOptions->WriteConfig( aCfg, baseCfgName + GalDisplayOptionsKeyword );
 }
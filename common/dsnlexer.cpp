@@ -654,8 +654,10 @@ L_read:
                     case 't':   c = '\x09';     break;
                     case 'v':   c = '\x0b';     break;
 
+                    // The line is not nul terminated when read by a MAPPED_FILE_LINE_READER:
+                    // the escape sequences must not be read past limit.
                     case 'x':   // 1 or 2 byte hex escape sequence
-                        for( i=0; i<2; ++i )
+                        for( i=0; i<2 && head+i<limit; ++i )
                         {
                             if( !isxdigit( head[i] ) )
                                 break;
@@ -671,7 +673,7 @@ L_read:
 
                     default:    // 1-3 byte octal escape sequence
                         --head;
-                        for( i=0; i<3; ++i )
+                        for( i=0; i<3 && head+i<limit; ++i )
                         {
                             if( head[i] < '0' || head[i] > '7' )
                                 break;
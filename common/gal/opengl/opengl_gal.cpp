@@ -776,6 +776,12 @@ void OPENGL_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
 
 void OPENGL_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
 {
+    if( aPolySet.IsTriangulationUpToDate() )
+    {
+        drawTriangulatedPolyset( aPolySet );
+        return;
+    }
+
     for( int j = 0; j < aPolySet.OutlineCount(); ++j )
     {
         const SHAPE_LINE_CHAIN& outline = aPolySet.COutline( j );
@@ -1490,6 +1496,32 @@ void OPENGL_GAL::drawPolygon( GLdouble* aPoints, int aPointCount )
 }
 
 
+void OPENGL_GAL::drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet )
+{
+    currentManager->Shader( SHADER_NONE );
+    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+
+    for( unsigned int j = 0; j < aPolySet.TriangulatedPolyCount(); ++j )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* triPoly = aPolySet.TriangulatedPolygon( j );
+        const std::vector<VECTOR2I>& vertices = triPoly->Vertices();
+
+        if( triPoly->GetTriangleCount() == 0 )
+            continue;
+
+        if( !currentManager->Reserve( 3 * triPoly->GetTriangleCount() ) )
+            return;
+
+        for( const SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI& tri : triPoly->Triangles() )
+        {
+            currentManager->Vertex( vertices[tri.a].x, vertices[tri.a].y, layerDepth );
+            currentManager->Vertex( vertices[tri.b].x, vertices[tri.b].y, layerDepth );
+            currentManager->Vertex( vertices[tri.c].x, vertices[tri.c].y, layerDepth );
+        }
+    }
+}
+
+
 void OPENGL_GAL::drawPolyline( std::function<VECTOR2D (int)> aPointGetter, int aPointCount )
 {
     if( aPointCount < 2 )
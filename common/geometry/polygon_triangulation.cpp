@@ -0,0 +1,496 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * Ear clipping with Z-order hashing adapted from the earcut library,
+ * (C) Mapbox, subject to the ISC license.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <geometry/polygon_triangulation.h>
+
+
+// Twice the signed area of the triangle pqr: negative when the turn p, q, r is convex in
+// the vertex lists, which are counterclockwise in a Y up frame.
+static inline int64_t area( int64_t px, int64_t py, int64_t qx, int64_t qy,
+                            int64_t rx, int64_t ry )
+{
+    return ( qy - py ) * ( rx - qx ) - ( qx - px ) * ( ry - qy );
+}
+
+
+// Checks if p is in the triangle abc, or on its edges
+static inline bool pointInTriangle( int64_t ax, int64_t ay, int64_t bx, int64_t by,
+                                    int64_t cx, int64_t cy, int64_t px, int64_t py )
+{
+    return ( cx - px ) * ( ay - py ) - ( ax - px ) * ( cy - py ) >= 0
+           && ( ax - px ) * ( by - py ) - ( bx - px ) * ( ay - py ) >= 0
+           && ( bx - px ) * ( cy - py ) - ( cx - px ) * ( by - py ) >= 0;
+}
+
+
+POLYGON_TRIANGULATION::POLYGON_TRIANGULATION( SHAPE_POLY_SET::TRIANGULATED_POLYGON& aResult ) :
+    m_result( aResult ),
+    m_minX( 0 ),
+    m_minY( 0 ),
+    m_zScale( 0.0 )
+{
+}
+
+
+bool POLYGON_TRIANGULATION::TesselatePolygon( const SHAPE_LINE_CHAIN& aPoly )
+{
+    m_vertices.clear();
+
+    if( aPoly.PointCount() < 3 )
+        return true;
+
+    const BOX2I bbox = aPoly.BBox();
+    int64_t     size = std::max( bbox.GetWidth(), bbox.GetHeight() );
+
+    m_minX = bbox.GetX();
+    m_minY = bbox.GetY();
+    m_zScale = size > 0 ? 32767.0 / size : 0.0;
+
+    VERTEX* first = createList( aPoly );
+
+    if( !first )
+        return true;
+
+    return earcutList( first );
+}
+
+
+POLYGON_TRIANGULATION::VERTEX* POLYGON_TRIANGULATION::createList( const SHAPE_LINE_CHAIN& aPoly )
+{
+    int     base = m_result.GetVertexCount();
+    int     count = aPoly.PointCount();
+    double  sum = 0.0;
+
+    for( int ii = 0, jj = count - 1; ii < count; jj = ii++ )
+    {
+        const VECTOR2I& p1 = aPoly.CPoint( jj );
+        const VECTOR2I& p2 = aPoly.CPoint( ii );
+
+        m_result.AddVertex( p2 );
+        sum += double( p1.x ) * p2.y - double( p2.x ) * p1.y;
+    }
+
+    // The vertices are linked counterclockwise, whatever the outline orientation
+    VERTEX* tail = nullptr;
+
+    if( sum > 0.0 )
+    {
+        for( int ii = 0; ii < count; ii++ )
+            tail = insertVertex( base + ii, aPoly.CPoint( ii ), tail );
+    }
+    else
+    {
+        for( int ii = count - 1; ii >= 0; ii-- )
+            tail = insertVertex( base + ii, aPoly.CPoint( ii ), tail );
+    }
+
+    if( tail && tail->x == tail->next->x && tail->y == tail->next->y )
+    {
+        VERTEX* next = tail->next;
+        removeVertex( tail );
+        tail = next;
+    }
+
+    return tail;
+}
+
+
+POLYGON_TRIANGULATION::VERTEX* POLYGON_TRIANGULATION::insertVertex( int aIndex,
+        const VECTOR2I& aPoint, VERTEX* aLast )
+{
+    m_vertices.emplace_back( aIndex, aPoint.x, aPoint.y );
+    VERTEX* p = &m_vertices.back();
+
+    if( !aLast )
+    {
+        p->prev = p;
+        p->next = p;
+    }
+    else
+    {
+        p->next = aLast->next;
+        p->prev = aLast;
+        aLast->next->prev = p;
+        aLast->next = p;
+    }
+
+    return p;
+}
+
+
+void POLYGON_TRIANGULATION::removeVertex( VERTEX* aVertex )
+{
+    aVertex->next->prev = aVertex->prev;
+    aVertex->prev->next = aVertex->next;
+
+    if( aVertex->prevZ )
+        aVertex->prevZ->nextZ = aVertex->nextZ;
+
+    if( aVertex->nextZ )
+        aVertex->nextZ->prevZ = aVertex->prevZ;
+}
+
+
+POLYGON_TRIANGULATION::VERTEX* POLYGON_TRIANGULATION::filterPoints( VERTEX* aStart, VERTEX* aEnd )
+{
+    if( !aEnd )
+        aEnd = aStart;
+
+    VERTEX* p = aStart;
+    bool    again;
+
+    do
+    {
+        again = false;
+
+        if( ( p->x == p->next->x && p->y == p->next->y )
+            || area( p->prev->x, p->prev->y, p->x, p->y, p->next->x, p->next->y ) == 0 )
+        {
+            removeVertex( p );
+            p = aEnd = p->prev;
+
+            if( p == p->next )
+                break;
+
+            again = true;
+        }
+        else
+        {
+            p = p->next;
+        }
+    } while( again || p != aEnd );
+
+    return aEnd;
+}
+
+
+uint32_t POLYGON_TRIANGULATION::zOrder( int64_t aX, int64_t aY ) const
+{
+    // Interleaves the bits of the coordinates, scaled to 15 bits
+    uint32_t x = uint32_t( ( aX - m_minX ) * m_zScale );
+    uint32_t y = uint32_t( ( aY - m_minY ) * m_zScale );
+
+    x = ( x | ( x << 8 ) ) & 0x00FF00FF;
+    x = ( x | ( x << 4 ) ) & 0x0F0F0F0F;
+    x = ( x | ( x << 2 ) ) & 0x33333333;
+    x = ( x | ( x << 1 ) ) & 0x55555555;
+
+    y = ( y | ( y << 8 ) ) & 0x00FF00FF;
+    y = ( y | ( y << 4 ) ) & 0x0F0F0F0F;
+    y = ( y | ( y << 2 ) ) & 0x33333333;
+    y = ( y | ( y << 1 ) ) & 0x55555555;
+
+    return x | ( y << 1 );
+}
+
+
+void POLYGON_TRIANGULATION::zIndexList( VERTEX* aStart )
+{
+    std::vector<VERTEX*> sorted;
+    VERTEX*              p = aStart;
+
+    do
+    {
+        p->z = zOrder( p->x, p->y );
+        sorted.push_back( p );
+        p = p->next;
+    } while( p != aStart );
+
+    std::sort( sorted.begin(), sorted.end(),
+               []( const VERTEX* a, const VERTEX* b ) { return a->z < b->z; } );
+
+    for( size_t ii = 0; ii < sorted.size(); ii++ )
+    {
+        sorted[ii]->prevZ = ii > 0 ? sorted[ii - 1] : nullptr;
+        sorted[ii]->nextZ = ii + 1 < sorted.size() ? sorted[ii + 1] : nullptr;
+    }
+}
+
+
+bool POLYGON_TRIANGULATION::earcutList( VERTEX* aEar, int aPass )
+{
+    if( !aEar )
+        return true;
+
+    if( aPass == 0 )
+        zIndexList( aEar );
+
+    VERTEX* stop = aEar;
+
+    // Clips the ears, until the polygon is a single triangle
+    while( aEar->prev != aEar->next )
+    {
+        VERTEX* prev = aEar->prev;
+        VERTEX* next = aEar->next;
+
+        if( isEar( aEar ) )
+        {
+            addTriangle( prev, aEar, next );
+            removeVertex( aEar );
+
+            // Skipping the next vertex gives less sliver triangles
+            aEar = next->next;
+            stop = next->next;
+            continue;
+        }
+
+        aEar = next;
+
+        // No ear was found in a whole turn: try to clean up the polygon
+        if( aEar == stop )
+        {
+            if( aPass == 0 )
+                return earcutList( filterPoints( aEar ), 1 );
+            else if( aPass == 1 )
+                return earcutList( cureLocalIntersections( filterPoints( aEar ) ), 2 );
+            else
+                return splitPolygon( aEar );
+        }
+    }
+
+    return true;
+}
+
+
+bool POLYGON_TRIANGULATION::isEar( const VERTEX* aEar ) const
+{
+    const VERTEX* a = aEar->prev;
+    const VERTEX* b = aEar;
+    const VERTEX* c = aEar->next;
+
+    // A reflex vertex is not an ear
+    if( area( a->x, a->y, b->x, b->y, c->x, c->y ) >= 0 )
+        return false;
+
+    // Only the vertices in the Z-order range of the triangle box can be in the triangle
+    uint32_t minZ = zOrder( std::min( a->x, std::min( b->x, c->x ) ),
+                            std::min( a->y, std::min( b->y, c->y ) ) );
+    uint32_t maxZ = zOrder( std::max( a->x, std::max( b->x, c->x ) ),
+                            std::max( a->y, std::max( b->y, c->y ) ) );
+
+    auto blocksEar = [a, b, c]( const VERTEX* p )
+    {
+        return p != a && p != c
+               && pointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y )
+               && area( p->prev->x, p->prev->y, p->x, p->y, p->next->x, p->next->y ) >= 0;
+    };
+
+    for( const VERTEX* p = aEar->prevZ; p && p->z >= minZ; p = p->prevZ )
+    {
+        if( blocksEar( p ) )
+            return false;
+    }
+
+    for( const VERTEX* p = aEar->nextZ; p && p->z <= maxZ; p = p->nextZ )
+    {
+        if( blocksEar( p ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+// Checks if the segments p1q1 and p2q2 cross
+static bool intersects( int64_t p1x, int64_t p1y, int64_t q1x, int64_t q1y,
+                        int64_t p2x, int64_t p2y, int64_t q2x, int64_t q2y )
+{
+    if( ( p1x == q1x && p1y == q1y && p2x == q2x && p2y == q2y )
+        || ( p1x == q2x && p1y == q2y && p2x == q1x && p2y == q1y ) )
+        return true;
+
+    return ( area( p1x, p1y, q1x, q1y, p2x, p2y ) > 0 )
+                != ( area( p1x, p1y, q1x, q1y, q2x, q2y ) > 0 )
+           && ( area( p2x, p2y, q2x, q2y, p1x, p1y ) > 0 )
+                != ( area( p2x, p2y, q2x, q2y, q1x, q1y ) > 0 );
+}
+
+
+POLYGON_TRIANGULATION::VERTEX* POLYGON_TRIANGULATION::cureLocalIntersections( VERTEX* aStart )
+{
+    VERTEX* p = aStart;
+
+    do
+    {
+        VERTEX* a = p->prev;
+        VERTEX* b = p->next->next;
+
+        // a, p, p->next, b is a small loop: the triangle a p b is clipped
+        if( !( a->x == b->x && a->y == b->y )
+            && intersects( a->x, a->y, p->x, p->y, p->next->x, p->next->y, b->x, b->y )
+            && locallyInside( a, b ) && locallyInside( b, a ) )
+        {
+            addTriangle( a, p, b );
+            removeVertex( p );
+            removeVertex( p->next );
+            p = aStart = b;
+        }
+
+        p = p->next;
+    } while( p != aStart );
+
+    return filterPoints( p );
+}
+
+
+bool POLYGON_TRIANGULATION::splitPolygon( VERTEX* aStart )
+{
+    VERTEX* a = aStart;
+
+    do
+    {
+        for( VERTEX* b = a->next->next; b != a->prev; b = b->next )
+        {
+            if( a->i != b->i && isValidDiagonal( a, b ) )
+            {
+                VERTEX* c = split( a, b );
+
+                a = filterPoints( a, a->next );
+                c = filterPoints( c, c->next );
+
+                bool firstDone = earcutList( a );
+                bool secondDone = earcutList( c );
+
+                return firstDone && secondDone;
+            }
+        }
+
+        a = a->next;
+    } while( a != aStart );
+
+    // No diagonal: the rest is a loop turned inside out by a self intersection, which has
+    // no area to fill, or a polygon too degenerated to be triangulated
+    if( loopArea( aStart ) <= 0.0 )
+        return true;
+
+    return false;
+}
+
+
+double POLYGON_TRIANGULATION::loopArea( const VERTEX* aStart ) const
+{
+    const VERTEX* p = aStart;
+    double        sum = 0.0;
+
+    do
+    {
+        sum += double( p->x ) * p->next->y - double( p->next->x ) * p->y;
+        p = p->next;
+    } while( p != aStart );
+
+    return sum;
+}
+
+
+POLYGON_TRIANGULATION::VERTEX* POLYGON_TRIANGULATION::split( VERTEX* a, VERTEX* b )
+{
+    m_vertices.emplace_back( a->i, a->x, a->y );
+    VERTEX* a2 = &m_vertices.back();
+    m_vertices.emplace_back( b->i, b->x, b->y );
+    VERTEX* b2 = &m_vertices.back();
+
+    VERTEX* an = a->next;
+    VERTEX* bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+
+    a2->next = an;
+    an->prev = a2;
+
+    b2->next = a2;
+    a2->prev = b2;
+
+    bp->next = b2;
+    b2->prev = bp;
+
+    return b2;
+}
+
+
+bool POLYGON_TRIANGULATION::isValidDiagonal( const VERTEX* a, const VERTEX* b ) const
+{
+    return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon( a, b )
+           && locallyInside( a, b ) && locallyInside( b, a ) && middleInside( a, b );
+}
+
+
+bool POLYGON_TRIANGULATION::intersectsPolygon( const VERTEX* a, const VERTEX* b ) const
+{
+    const VERTEX* p = a;
+
+    do
+    {
+        if( p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i
+            && intersects( p->x, p->y, p->next->x, p->next->y, a->x, a->y, b->x, b->y ) )
+            return true;
+
+        p = p->next;
+    } while( p != a );
+
+    return false;
+}
+
+
+bool POLYGON_TRIANGULATION::locallyInside( const VERTEX* a, const VERTEX* b ) const
+{
+    if( area( a->prev->x, a->prev->y, a->x, a->y, a->next->x, a->next->y ) < 0 )
+        return area( a->x, a->y, b->x, b->y, a->next->x, a->next->y ) >= 0
+               && area( a->x, a->y, a->prev->x, a->prev->y, b->x, b->y ) >= 0;
+    else
+        return area( a->x, a->y, b->x, b->y, a->prev->x, a->prev->y ) < 0
+               || area( a->x, a->y, a->next->x, a->next->y, b->x, b->y ) < 0;
+}
+
+
+bool POLYGON_TRIANGULATION::middleInside( const VERTEX* a, const VERTEX* b ) const
+{
+    const VERTEX* p = a;
+    bool          inside = false;
+    double        px = ( a->x + b->x ) / 2.0;
+    double        py = ( a->y + b->y ) / 2.0;
+
+    do
+    {
+        if( ( ( p->y > py ) != ( p->next->y > py ) ) && p->next->y != p->y
+            && ( px < double( p->next->x - p->x ) * ( py - p->y ) / double( p->next->y - p->y )
+                      + p->x ) )
+            inside = !inside;
+
+        p = p->next;
+    } while( p != a );
+
+    return inside;
+}
+
+
+void POLYGON_TRIANGULATION::addTriangle( const VERTEX* a, const VERTEX* b, const VERTEX* c )
+{
+    m_result.AddTriangle( a->i, b->i, c->i );
+}
@@ -28,27 +28,38 @@
 
 
 #include <vector>
+#include <array>
 #include <cstdio>
 #include <set>
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdint>
 
 #include <common.h>
 
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
+#include <geometry/polygon_triangulation.h>
+#include <geometry/rtree.h>
 
 using namespace ClipperLib;
 
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
-    SHAPE( SH_POLY_SET )
+    SHAPE( SH_POLY_SET ),
+    m_triangulationDirty( true ),
+    m_triangulationValid( false )
 {
 }
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ),
+    m_triangulatedPolys( aOther.m_triangulatedPolys ),
+    m_triangulationDirty( aOther.m_triangulationDirty ),
+    m_triangulationValid( aOther.m_triangulationValid )
 {
 }
 
@@ -121,7 +132,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -129,7 +140,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx ++ )
         {
@@ -149,6 +160,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    invalidateTriangulation();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
     empty_path.SetClosed( true );
@@ -160,6 +173,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    invalidateTriangulation();
+
     SHAPE_LINE_CHAIN empty_path;
     empty_path.SetClosed( true );
 
@@ -176,6 +191,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    invalidateTriangulation();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -197,6 +214,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    invalidateTriangulation();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -245,7 +264,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -254,6 +273,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aIndex, int aOutline, int aHole )
 {
+    invalidateTriangulation();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -292,6 +313,8 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) c
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aGlobalIndex )
 {
+    invalidateTriangulation();
+
     SHAPE_POLY_SET::VERTEX_INDEX index;
 
     // Assure the passed index references a legal position; abort otherwise
@@ -416,6 +439,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting()
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    invalidateTriangulation();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -430,6 +455,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    invalidateTriangulation();
+
     assert ( m_polys.size() );
 
     if( aOutline < 0 )
@@ -533,81 +560,323 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
 }
 
 
-void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+// Below this vertex count, the parallel transforms are done in the calling thread:
+// starting threads would cost more than it saves.
+static const int PARALLEL_MIN_VERTEX_COUNT = 4096;
+
+// The polygons are split in (at most) this bucket count.  It does not depend on the
+// thread count, so the order of the result polygons is always the same.
+static const int PARALLEL_BUCKET_COUNT = 64;
+
+
+// Runs aTask( 0 ) ... aTask( aCount - 1 ) on all the processors
+static void runConcurrently( int aCount, const std::function<void( int )>& aTask )
+{
+    std::atomic<int> next( 0 );
+
+    auto worker = [&]()
+    {
+        for( int ii = next++; ii < aCount; ii = next++ )
+            aTask( ii );
+    };
+
+    int threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount = std::min( threadCount, aCount );
+
+    std::vector<std::thread> threads;
+
+    for( int ii = 1; ii < threadCount; ++ii )
+        threads.push_back( std::thread( worker ) );
+
+    worker();
+
+    for( auto& thread : threads )
+        thread.join();
+}
+
+
+void SHAPE_POLY_SET::transformParallel( const BUCKET_TRANSFORM& aTransform,
+                                        const SHAPE_POLY_SET& aShape,
+                                        const SHAPE_POLY_SET& aOtherShape, int aMargin )
+{
+    invalidateTriangulation();
+
+    const int shapeCount = aShape.m_polys.size();
+    const int count = shapeCount + aOtherShape.m_polys.size();
+
+    auto polygon = [&]( int aIndex ) -> const POLYGON&
+    {
+        return aIndex < shapeCount ? aShape.m_polys[aIndex]
+                                   : aOtherShape.m_polys[aIndex - shapeCount];
+    };
+
+    std::vector<int> parent( count );
+    std::vector<BOX2I> bboxes( count );
+
+    // The R-tree stores its data in a pointer: the polygon index is a pointer sized integer
+    RTree<intptr_t, int, 2, double> tree;
+    int vertexCount = 0;
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        const POLYGON& poly = polygon( ii );
+
+        parent[ii] = ii;
+
+        for( const SHAPE_LINE_CHAIN& path : poly )
+            vertexCount += path.PointCount();
+
+        if( poly.empty() || !poly[0].PointCount() )
+            continue;
+
+        // Holes are inside the outline
+        bboxes[ii] = poly[0].BBox( aMargin );
+
+        const int mmin[2] = { bboxes[ii].GetX(), bboxes[ii].GetY() };
+        const int mmax[2] = { bboxes[ii].GetRight(), bboxes[ii].GetBottom() };
+        tree.Insert( mmin, mmax, ii );
+    }
+
+    if( vertexCount < PARALLEL_MIN_VERTEX_COUNT )
+    {
+        SHAPE_POLY_SET result;
+
+        aTransform( aShape, aOtherShape, result );
+        m_polys.swap( result.m_polys );
+        return;
+    }
+
+    auto find = [&parent]( int aItem )
+    {
+        while( parent[aItem] != aItem )
+        {
+            parent[aItem] = parent[parent[aItem]];
+            aItem = parent[aItem];
+        }
+
+        return aItem;
+    };
+
+    // Build the clusters.  The root of a cluster is its first polygon.
+    for( int ii = 0; ii < count; ++ii )
+    {
+        const int mmin[2] = { bboxes[ii].GetX(), bboxes[ii].GetY() };
+        const int mmax[2] = { bboxes[ii].GetRight(), bboxes[ii].GetBottom() };
+
+        auto visitor = [&]( intptr_t aOther ) -> bool
+        {
+            int root = find( ii );
+            int otherRoot = find( int( aOther ) );
+
+            if( root < otherRoot )
+                parent[otherRoot] = root;
+            else
+                parent[root] = otherRoot;
+
+            return true;
+        };
+
+        tree.Search( mmin, mmax, visitor );
+    }
+
+    // Gather the clusters in buckets, in the order of their first polygon
+    std::vector<int> bucketOf( count );
+    int bucketVertexCount = 0;
+    int bucketCount = 1;
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int root = find( ii );
+
+        if( root == ii )
+        {
+            if( bucketVertexCount * PARALLEL_BUCKET_COUNT >= vertexCount )
+            {
+                bucketCount++;
+                bucketVertexCount = 0;
+            }
+
+            bucketOf[ii] = bucketCount - 1;
+        }
+        else
+        {
+            bucketOf[ii] = bucketOf[root];
+        }
+
+        for( const SHAPE_LINE_CHAIN& path : polygon( ii ) )
+            bucketVertexCount += path.PointCount();
+    }
+
+    std::vector<SHAPE_POLY_SET> shapes( bucketCount );
+    std::vector<SHAPE_POLY_SET> otherShapes( bucketCount );
+    std::vector<SHAPE_POLY_SET> results( bucketCount );
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        if( ii < shapeCount )
+            shapes[bucketOf[ii]].m_polys.push_back( polygon( ii ) );
+        else
+            otherShapes[bucketOf[ii]].m_polys.push_back( polygon( ii ) );
+    }
+
+    if( bucketCount == 1 )
+    {
+        aTransform( shapes[0], otherShapes[0], results[0] );
+    }
+    else
+    {
+        runConcurrently( bucketCount, [&]( int aBucket ) {
+            aTransform( shapes[aBucket], otherShapes[aBucket], results[aBucket] );
+        } );
+    }
+
+    // aShape or aOtherShape can be this set: it is modified only now
+    m_polys.clear();
+
+    for( const SHAPE_POLY_SET& result : results )
+        m_polys.insert( m_polys.end(), result.m_polys.begin(), result.m_polys.end() );
+}
+
+
+void SHAPE_POLY_SET::booleanOpParallel( ClipperLib::ClipType aType,
+                                        const SHAPE_POLY_SET& aShape,
+                                        const SHAPE_POLY_SET& aOtherShape,
+                                        POLYGON_MODE aFastMode )
+{
+    transformParallel( [aType, aFastMode]( const SHAPE_POLY_SET& aBucketShape,
+                                           const SHAPE_POLY_SET& aBucketOtherShape,
+                                           SHAPE_POLY_SET& aResult )
+                       {
+                           aResult.booleanOp( aType, aBucketShape, aBucketOtherShape, aFastMode );
+                       },
+                       aShape, aOtherShape, 0 );
+}
+
+
+void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                                bool aParallel )
 {
-    booleanOp( ctUnion, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctUnion, *this, b, aFastMode );
+    else
+        booleanOp( ctUnion, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::BooleanSubtract( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::BooleanSubtract( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                                     bool aParallel )
 {
-    booleanOp( ctDifference, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctDifference, *this, b, aFastMode );
+    else
+        booleanOp( ctDifference, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                                         bool aParallel )
 {
-    booleanOp( ctIntersection, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctIntersection, *this, b, aFastMode );
+    else
+        booleanOp( ctIntersection, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
+                                POLYGON_MODE aFastMode, bool aParallel )
 {
-    booleanOp( ctUnion, a, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctUnion, a, b, aFastMode );
+    else
+        booleanOp( ctUnion, a, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::BooleanSubtract( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::BooleanSubtract( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
+                                     POLYGON_MODE aFastMode, bool aParallel )
 {
-    booleanOp( ctDifference, a, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctDifference, a, b, aFastMode );
+    else
+        booleanOp( ctDifference, a, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
+                                         POLYGON_MODE aFastMode, bool aParallel )
 {
-    booleanOp( ctIntersection, a, b, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctIntersection, a, b, aFastMode );
+    else
+        booleanOp( ctIntersection, a, b, aFastMode );
 }
 
 
-void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount )
+// Calculate the arc tolerance (arc error) coefficient from the seg count by circle.
+// the seg count is nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aFactor))
+// see:
+// www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
+static double arcToleranceFactor( int aCircleSegmentsCount )
 {
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI/aCircleSegmentsCount)
     // aCircleSegmentsCount is most of time <= 64 and usually 8, 12, 16, 32
+    // The table is filled once, by its thread safe initialization, so the polygons can be
+    // inflated from several threads.
     #define SEG_CNT_MAX 64
-    static double arc_tolerance_factor[SEG_CNT_MAX+1];
-
-    ClipperOffset c;
+    typedef std::array<double, SEG_CNT_MAX + 1> FACTOR_TABLE;
 
-    for( const POLYGON& poly : m_polys )
+    static const FACTOR_TABLE arc_tolerance_factor = []()
     {
-        for( unsigned int i = 0; i < poly.size(); i++ )
-            c.AddPath( convertToClipper( poly[i], i > 0 ? false : true ), jtRound, etClosedPolygon );
-    }
+        FACTOR_TABLE table;
 
-    PolyTree solution;
+        table.fill( 0.0 );
+
+        for( int ii = 6; ii <= SEG_CNT_MAX; ii++ )
+            table[ii] = 1.0 - cos( M_PI / ii );
 
-    // Calculate the arc tolerance (arc error) from the seg count by circle.
-    // the seg count is nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aFactor))
-    // see:
-    // www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Classes/ClipperOffset/Properties/ArcTolerance.htm
+        return table;
+    }();
 
     if( aCircleSegmentsCount < 6 )  // avoid incorrect aCircleSegmentsCount values
         aCircleSegmentsCount = 6;
 
-    double coeff;
+    if( aCircleSegmentsCount > SEG_CNT_MAX )
+        return 1.0 - cos( M_PI/aCircleSegmentsCount);
+
+    return arc_tolerance_factor[aCircleSegmentsCount];
+}
+
 
-    if( aCircleSegmentsCount > SEG_CNT_MAX || arc_tolerance_factor[aCircleSegmentsCount] == 0 )
+void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount, bool aParallel )
+{
+    if( aParallel )
     {
-        coeff = 1.0 - cos( M_PI/aCircleSegmentsCount);
+        SHAPE_POLY_SET empty;
+
+        transformParallel( [aFactor, aCircleSegmentsCount]( const SHAPE_POLY_SET& aShape,
+                                                            const SHAPE_POLY_SET& aOtherShape,
+                                                            SHAPE_POLY_SET& aResult )
+                           {
+                               aResult = aShape;
+                               aResult.Inflate( aFactor, aCircleSegmentsCount );
+                           },
+                           *this, empty, std::max( aFactor, 0 ) + 1 );
+        return;
+    }
+
+    ClipperOffset c;
 
-        if( aCircleSegmentsCount <= SEG_CNT_MAX )
-            arc_tolerance_factor[aCircleSegmentsCount] = coeff;
+    for( const POLYGON& poly : m_polys )
+    {
+        for( unsigned int i = 0; i < poly.size(); i++ )
+            c.AddPath( convertToClipper( poly[i], i > 0 ? false : true ), jtRound, etClosedPolygon );
     }
-    else
-        coeff = arc_tolerance_factor[aCircleSegmentsCount];
 
-    c.ArcTolerance = std::abs( aFactor ) * coeff;
+    PolyTree solution;
+
+    c.ArcTolerance = std::abs( aFactor ) * arcToleranceFactor( aCircleSegmentsCount );
 
     c.Execute( solution, aFactor );
 
@@ -617,6 +886,8 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount )
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    invalidateTriangulation();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -848,9 +1119,21 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 }
 
 
-void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode, bool aParallel )
 {
-    Simplify( aFastMode ); // remove overlapping holes/degeneracy
+    invalidateTriangulation();
+
+    Simplify( aFastMode, aParallel ); // remove overlapping holes/degeneracy
+
+    if( aParallel && TotalVertices() >= PARALLEL_MIN_VERTEX_COUNT )
+    {
+        // Each polygon is fractured alone
+        runConcurrently( (int) m_polys.size(), [this]( int aPolygon ) {
+            fractureSingle( m_polys[aPolygon] );
+        } );
+
+        return;
+    }
 
     for( POLYGON& paths : m_polys )
     {
@@ -874,11 +1157,52 @@ bool SHAPE_POLY_SET::HasHoles() const
 }
 
 
-void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::CacheTriangulation()
+{
+    if( !m_triangulationDirty )
+        return;
+
+    m_triangulatedPolys.clear();
+    m_triangulationDirty = false;
+    m_triangulationValid = false;
+
+    // The triangulation needs polygons without holes
+    SHAPE_POLY_SET fractured;
+    const SHAPE_POLY_SET* polys = this;
+
+    if( HasHoles() )
+    {
+        fractured.m_polys = m_polys;
+        fractured.Fracture( PM_FAST );
+        polys = &fractured;
+    }
+
+    for( const POLYGON& poly : polys->m_polys )
+    {
+        auto tri = std::make_shared<TRIANGULATED_POLYGON>();
+        POLYGON_TRIANGULATION triangulation( *tri );
+
+        if( !triangulation.TesselatePolygon( poly[0] ) )
+        {
+            m_triangulatedPolys.clear();
+            return;
+        }
+
+        m_triangulatedPolys.push_back( tri );
+    }
+
+    m_triangulationValid = true;
+}
+
+
+void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode, bool aParallel )
 {
     SHAPE_POLY_SET empty;
 
-    booleanOp( ctUnion, empty, aFastMode );
+    if( aParallel )
+        booleanOpParallel( ctUnion, *this, empty, aFastMode );
+    else
+        booleanOp( ctUnion, empty, aFastMode );
 }
 
 
@@ -939,6 +1263,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    invalidateTriangulation();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1046,12 +1372,16 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    invalidateTriangulation();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    invalidateTriangulation();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1115,12 +1445,16 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    invalidateTriangulation();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    invalidateTriangulation();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1234,6 +1568,8 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    invalidateTriangulation();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
@@ -1355,6 +1691,9 @@ bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN&
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    // The triangles are moved with the polygons, rather than built again
+    bool moveTriangles = IsTriangulationUpToDate();
+
     for( POLYGON &poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN &path : poly )
@@ -1362,6 +1701,17 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
             path.Move( aVector );
         }
     }
+
+    if( moveTriangles )
+    {
+        // The triangles can be shared with other sets: move copies of them
+        for( std::shared_ptr<const TRIANGULATED_POLYGON>& tri : m_triangulatedPolys )
+        {
+            auto moved = std::make_shared<TRIANGULATED_POLYGON>( *tri );
+            moved->Move( aVector );
+            tri = moved;
+        }
+    }
 }
 
 
@@ -27,6 +27,16 @@
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
+#include <wx/ffile.h>
+
+#if defined( __WINDOWS__ )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
@@ -226,14 +236,153 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
-STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber,
+            unsigned aMaxLineLength ) :
+    LINE_READER( 0 ),       // no line buffer, lines point into m_data
+    m_data( NULL ),
+    m_size( 0 ),
+    m_ndx( 0 ),
+    m_mapping( NULL )
+{
+    maxLineLength = aMaxLineLength;
+    source  = aFileName;
+    lineNum = aStartingLineNumber;
+
+    bool opened = false;
+
+#if defined( __WINDOWS__ )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        opened = true;
+
+        if( GetFileSizeEx( file, &size ) && size.QuadPart > 0 )
+        {
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+            if( mapping )
+            {
+                // The view keeps the mapping object alive
+                m_mapping = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+                CloseHandle( mapping );
+            }
+
+            m_size = size.QuadPart;
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd >= 0 )
+    {
+        struct stat st;
+
+        opened = true;
+
+        if( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0 )
+        {
+            m_size = st.st_size;
+            m_mapping = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+            if( m_mapping == MAP_FAILED )
+                m_mapping = NULL;
+            else
+                madvise( m_mapping, m_size, MADV_SEQUENTIAL );
+        }
+
+        close( fd );
+    }
+#endif
+
+    if( !opened )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename '%s' for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    if( m_mapping )
+    {
+        m_data = (const char*) m_mapping;
+        return;
+    }
+
+    // Not a regular file, or no address space left: read it
+    wxFFile file( aFileName, wxT( "rb" ) );
+    char    chunk[65536];
+    size_t  count;
+
+    m_size = 0;
+
+    while( file.IsOpened() && ( count = file.Read( chunk, sizeof( chunk ) ) ) > 0 )
+        m_buffer.insert( m_buffer.end(), chunk, chunk + count );
+
+    m_size = m_buffer.size();
+    m_data = m_size ? &m_buffer[0] : NULL;
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+    if( m_mapping )
+    {
+#if defined( __WINDOWS__ )
+        UnmapViewOfFile( m_mapping );
+#else
+        munmap( m_mapping, m_size );
+#endif
+    }
+
+    // line points into m_data, it must not be deleted by ~LINE_READER()
+    line = NULL;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine()
+{
+    length = 0;
+
+    if( m_ndx < m_size )
+    {
+        const char* begin = m_data + m_ndx;
+        const char* nl = (const char*) memchr( begin, '\n', m_size - m_ndx );
+
+        size_t len = nl ? nl - begin + 1 : m_size - m_ndx;     // include the newline
+
+        if( len >= maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        // No copy.  LINE_READER::line is not const, but is never written by DSNLEXER.
+        line   = const_cast<char*>( begin );
+        length = len;
+        m_ndx += len;
+    }
+
+    // lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++lineNum;
+
+    return length ? line : NULL;
+}
+
+
+STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                                        unsigned aStartingLineNumber ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     lines( aString ),
     ndx( 0 )
 {
     // Clipboard text should be nice and _use multiple lines_ so that
     // we can report _line number_ oriented error messages when parsing.
-    source = aSource;
+    source  = aSource;
+    lineNum = aStartingLineNumber;
 }
 
 
@@ -69,28 +69,24 @@ plot_plan = [
 ]
 
 
+# The layers are added to a batch, and plotted at the same time,
+# each one in its own file
 for layer_info in plot_plan:
-    pctl.SetLayer(layer_info[1])
-    pctl.OpenPlotfile(layer_info[0], PLOT_FORMAT_GERBER, layer_info[2])
-    print 'plot %s' % pctl.GetPlotFileName()
-    if pctl.PlotLayer() == False:
-        print "plot error"
+    pctl.AddLayerPlot(layer_info[1], layer_info[0], layer_info[2])
 
 #generate internal copper layers, if any
 lyrcnt = board.GetCopperLayerCount();
 
 for innerlyr in range ( 1, lyrcnt-1 ):
-    pctl.SetLayer(innerlyr)
     lyrname = 'inner%s' % innerlyr
-    pctl.OpenPlotfile(lyrname, PLOT_FORMAT_GERBER, "inner")
-    print 'plot %s' % pctl.GetPlotFileName()
-    if pctl.PlotLayer() == False:
-        print "plot error"
+    pctl.AddLayerPlot(innerlyr, lyrname, "inner")
 
+if pctl.PlotLayers(PLOT_FORMAT_GERBER) == False:
+    print "plot error"
 
-# At the end you have to close the last plot, otherwise you don't know when
-# the object will be recycled!
-pctl.ClosePlot()
+for ii in range(pctl.GetLayerPlotCount()):
+    job = pctl.GetLayerPlot(ii)
+    print 'plot %s: %.0f ms' % (job.m_fileName, job.m_time)
 
 # Fabricators need drill files.
 # sometimes a drill map file is asked (for verification purpose)
@@ -35,6 +35,11 @@
 #include <sch_sheet_path.h>
 #include <lib_pin.h>      // LIB_PIN::PinStringNum( m_PinNum )
 #include <sch_item_struct.h>
+#include <hashtables.h>
+
+#include <climits>
+#include <unordered_map>
+#include <vector>
 
 class NETLIST_OBJECT_LIST;
 class SCH_COMPONENT;
@@ -288,6 +293,52 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    /**
+     * Struct POINT_KEY
+     * is a position in a sheet, used to find the items connected at this position.
+     * For wires and buses, it is the line holding them: horizontal lines have no
+     * X coordinate, vertical lines no Y coordinate, other lines none.
+     */
+    struct POINT_KEY
+    {
+        int m_Sheet;
+        int m_X;
+        int m_Y;
+
+        POINT_KEY( int aSheet, int aX, int aY ) : m_Sheet( aSheet ), m_X( aX ), m_Y( aY ) {}
+
+        bool operator==( const POINT_KEY& aOther ) const
+        {
+            return m_Sheet == aOther.m_Sheet && m_X == aOther.m_X && m_Y == aOther.m_Y;
+        }
+    };
+
+    struct POINT_KEY_HASH
+    {
+        std::size_t operator()( const POINT_KEY& aKey ) const
+        {
+            std::size_t hash = std::hash<int>()( aKey.m_Sheet );
+
+            hash = hash * 31 + std::hash<int>()( aKey.m_X );
+            return hash * 31 + std::hash<int>()( aKey.m_Y );
+        }
+    };
+
+    typedef std::unordered_map<POINT_KEY, std::vector<unsigned>, POINT_KEY_HASH> POINT_INDEX;
+    typedef std::unordered_map<wxString, std::vector<unsigned>, WXSTRING_HASH> LABEL_INDEX;
+
+    // Used in intermediate calculation: the indexes of the list items, sorted by sheet,
+    // to find the connected items without scanning the list
+    std::vector<int>    m_sheetNumbers;     // the sheet number of each item
+    POINT_INDEX         m_itemsAtPoint;     // items by start and end points
+    POINT_INDEX         m_segmentsOnLine;   // wires and buses by line
+    LABEL_INDEX         m_labelsByName;     // labels of all the sheets by name
+
+    // Used in intermediate calculation: the net codes merged by propagateNetCode(),
+    // stored as union-find trees, the root being the net code of the merged items
+    std::vector<int>    m_netCodeParent;
+    std::vector<int>    m_busNetCodeParent;
+
 public:
     /**
      * Constructor.
@@ -423,10 +474,33 @@ private:
     /*
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
-     * when a new connection is found between aOldNetCode and aNewNetCode
+     * when a new connection is found between aOldNetCode and aNewNetCode.
+     * The items are not changed: the net codes are merged, and the items get the
+     * merged code at the end of BuildNetListInfo()
      */
     void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
 
+    /**
+     * Function findNetCode
+     * @return the net code (or bus net code) of the items having the internal
+     * code aNetCode, after the merges done by propagateNetCode()
+     */
+    int findNetCode( int aNetCode, bool aIsBus );
+
+    /**
+     * Function buildConnectionIndexes
+     * fills the item indexes used to search connections.
+     * The list is expected sorted by sheets.
+     */
+    void buildConnectionIndexes();
+
+    /**
+     * Function clearConnectionIndexes
+     * frees the item indexes and the merged net codes, once the items have their
+     * final net codes.
+     */
+    void clearConnectionIndexes();
+
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
@@ -454,16 +528,20 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search connections between the ends of aRef and the ends of the other objects
+     * of the sheet aSheet (the sheet number of aRef).
+     * Propagate the aRef net code to objects connected.
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int aSheet );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search is done in the sheet aSheet (the sheet number of the junction)
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aSheet );
 
 
     /**
@@ -43,9 +43,11 @@
 #include <sch_no_connect.h>
 #include <sch_text.h>
 #include <sch_sheet.h>
-#include <algorithm>
 #include <invoke_sch_dialog.h>
 
+#include <algorithm>
+#include <map>
+
 #define IS_WIRE false
 #define IS_BUS true
 
@@ -205,19 +207,14 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
 
     // Sort objects by Sheet
     SortListbySheet();
+    buildConnectionIndexes();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
-
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
-        {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
-        }
+        int             sheetNumber = m_sheetNumbers[ii];
 
         switch( net_item->m_Type )
         {
@@ -240,7 +237,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE, sheetNumber );
             break;
 
         case NET_JUNCTION:
@@ -251,16 +248,16 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE, sheetNumber );
 
             // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
+            if( findNetCode( net_item->m_BusNetCode, IS_BUS ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS, sheetNumber );
             break;
 
         case NET_LABEL:
@@ -273,22 +270,22 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE, sheetNumber );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
+            if( findNetCode( net_item->m_BusNetCode, IS_BUS ) != 0 )
                 break;
 
         case NET_BUS:
             // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
+            if( findNetCode( net_item->m_BusNetCode, IS_BUS ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS, sheetNumber );
             break;
 
         case NET_BUSLABELMEMBER:
@@ -301,7 +298,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS, sheetNumber );
             break;
         }
     }
@@ -358,6 +355,17 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    // Give to the items their merged net codes
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* item = GetItem( ii );
+
+        item->SetNet( findNetCode( item->GetNet(), IS_WIRE ) );
+        item->m_BusNetCode = findNetCode( item->m_BusNetCode, IS_BUS );
+    }
+
+    clearConnectionIndexes();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -605,12 +613,78 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
+void NETLIST_OBJECT_LIST::buildConnectionIndexes()
+{
+    int sheet = 0;
+
+    m_sheetNumbers.resize( size() );
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* item = GetItem( ii );
+
+        if( ii > 0 && item->m_SheetPath != GetItem( ii - 1 )->m_SheetPath )
+            sheet++;
+
+        m_sheetNumbers[ii] = sheet;
+
+        m_itemsAtPoint[POINT_KEY( sheet, item->m_Start.x, item->m_Start.y )].push_back( ii );
+
+        if( item->m_End != item->m_Start )
+            m_itemsAtPoint[POINT_KEY( sheet, item->m_End.x, item->m_End.y )].push_back( ii );
+
+        if( item->m_Type == NET_SEGMENT || item->m_Type == NET_BUS )
+        {
+            POINT_KEY line( sheet, INT_MIN, INT_MIN );
+
+            if( item->m_Start.y == item->m_End.y )
+                line.m_Y = item->m_Start.y;
+            else if( item->m_Start.x == item->m_End.x )
+                line.m_X = item->m_Start.x;
+
+            m_segmentsOnLine[line].push_back( ii );
+        }
+
+        if( item->IsLabelType() )
+            m_labelsByName[item->m_Label].push_back( ii );
+    }
+}
+
+
+void NETLIST_OBJECT_LIST::clearConnectionIndexes()
+{
+    m_sheetNumbers.clear();
+    m_itemsAtPoint.clear();
+    m_segmentsOnLine.clear();
+    m_labelsByName.clear();
+    m_netCodeParent.clear();
+    m_busNetCodeParent.clear();
+}
+
+
+// Appends to aList the items of aIndex at aKey
+template <typename INDEX, typename KEY>
+static void appendIndexedItems( const INDEX& aIndex, const KEY& aKey,
+                                std::vector<unsigned>& aList )
+{
+    auto it = aIndex.find( aKey );
+
+    if( it != aIndex.end() )
+        aList.insert( aList.end(), it->second.begin(), it->second.end() );
+}
+
+
 void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
 {
     if( SheetLabel->GetNet() == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    auto labels = m_labelsByName.find( SheetLabel->m_Label );
+
+    if( labels == m_labelsByName.end() )
+        return;     // no label of this name
+
+    for( unsigned ii : labels->second )
     {
         NETLIST_OBJECT* ObjetNet = GetItem( ii );
 
@@ -620,17 +694,16 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
-            continue;  //already connected.
+        int netCode = findNetCode( SheetLabel->GetNet(), IS_WIRE );
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
+        if( findNetCode( ObjetNet->GetNet(), IS_WIRE ) == netCode )
+            continue;  //already connected.
 
         // Propagate Netcode having all the objects of the same Netcode.
         if( ObjetNet->GetNet() )
-            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+            propagateNetCode( ObjetNet->GetNet(), netCode, IS_WIRE );
         else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+            ObjetNet->SetNet( netCode );
     }
 }
 
@@ -639,88 +712,126 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 {
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
-    // Search is done in the entire list
+    // Search is done in the entire list, grouping the labels by bus and member
+    std::map< std::pair<int, int>, std::vector<unsigned> > members;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
 
         if( Label->IsLabelBusMemberType() )
         {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+            std::pair<int, int> key( findNetCode( Label->m_BusNetCode, IS_BUS ),
+                                     Label->m_Member );
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+            members[key].push_back( ii );
+        }
+    }
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
+    // The groups are connected in the list order of their first label.  Once the first
+    // label of a group is connected to the others, they all have its net code.
+    std::vector<const std::vector<unsigned>*> groups;
+
+    for( const auto& entry : members )
+        groups.push_back( &entry.second );
+
+    std::sort( groups.begin(), groups.end(),
+               []( const std::vector<unsigned>* a, const std::vector<unsigned>* b )
+               {
+                   return a->front() < b->front();
+               } );
+
+    for( const std::vector<unsigned>* group : groups )
+    {
+        NETLIST_OBJECT* Label = GetItem( group->front() );
+
+        if( Label->GetNet() == 0 )
+        {
+            // Not yet existiing net code: create a new one.
+            Label->SetNet( m_lastNetCode );
+            m_lastNetCode++;
+        }
+
+        for( unsigned jj = 1; jj < group->size(); jj++ )
+        {
+            NETLIST_OBJECT* LabelInTst = GetItem( (*group)[jj] );
+
+            if( LabelInTst->GetNet() == 0 )
+                // Append this object to the current net
+                LabelInTst->SetNet( findNetCode( Label->GetNet(), IS_WIRE ) );
+            else
+                // Merge the 2 net codes, they are connected.
+                propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
         }
     }
 }
 
 
+int NETLIST_OBJECT_LIST::findNetCode( int aNetCode, bool aIsBus )
+{
+    std::vector<int>& parent = aIsBus ? m_busNetCodeParent : m_netCodeParent;
+    int               root = aNetCode;
+
+    while( root < (int) parent.size() && parent[root] != root )
+        root = parent[root];
+
+    // Compress the path, for the next searches
+    while( aNetCode != root )
+    {
+        int next = parent[aNetCode];
+        parent[aNetCode] = root;
+        aNetCode = next;
+    }
+
+    return root;
+}
+
+
 void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
 {
+    aOldNetCode = findNetCode( aOldNetCode, aIsBus );
+    aNewNetCode = findNetCode( aNewNetCode, aIsBus );
+
     if( aOldNetCode == aNewNetCode )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+    // The merged items keep the new net code, as if they were all changed
+    std::vector<int>& parent = aIsBus ? m_busNetCodeParent : m_netCodeParent;
+    int               count = std::max( aOldNetCode, aNewNetCode ) + 1;
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
-    }
-    else               // Propagate BusNetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+    while( (int) parent.size() < count )
+        parent.push_back( parent.size() );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
-    }
+    parent[aOldNetCode] = aNewNetCode;
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int aSheet )
 {
     int netCode;
 
+    // The objects having an end at an end of aRef, in the list order
+    std::vector<unsigned> items;
+
+    appendIndexedItems( m_itemsAtPoint, POINT_KEY( aSheet, aRef->m_Start.x, aRef->m_Start.y ),
+                        items );
+
+    if( aRef->m_End != aRef->m_Start )
+    {
+        appendIndexedItems( m_itemsAtPoint, POINT_KEY( aSheet, aRef->m_End.x, aRef->m_End.y ),
+                            items );
+        std::sort( items.begin(), items.end() );
+        items.erase( std::unique( items.begin(), items.end() ), items.end() );
+    }
+
     if( aIsBus == false )    // Objects other than BUS and BUSLABELS
     {
-        netCode = aRef->GetNet();
+        netCode = findNetCode( aRef->GetNet(), IS_WIRE );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : items )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
-
             switch( item->m_Type )
             {
             case NET_SEGMENT:
@@ -732,16 +843,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_PINLABEL:
             case NET_JUNCTION:
             case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
+                if( item->GetNet() == 0 )
+                    item->SetNet( netCode );
+                else
+                    propagateNetCode( item->GetNet(), netCode, IS_WIRE );
                 break;
 
             case NET_BUS:
@@ -756,15 +861,12 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
     }
     else    // Object type BUS, BUSLABELS, and junctions.
     {
-        netCode = aRef->m_BusNetCode;
+        netCode = findNetCode( aRef->m_BusNetCode, IS_BUS );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : items )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
-
             switch( item->m_Type )
             {
             case NET_ITEM_UNSPECIFIED:
@@ -784,16 +886,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_HIERBUSLABELMEMBER:
             case NET_GLOBBUSLABELMEMBER:
             case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
+                if( findNetCode( item->m_BusNetCode, IS_BUS ) == 0 )
+                    item->m_BusNetCode = netCode;
+                else
+                    propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
                 break;
             }
         }
@@ -802,16 +898,22 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
 
 
 void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+                                                 bool aIsBus, int aSheet )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    const wxPoint& pos = aJonction->m_Start;
+
+    // The segments on a line going through the junction, in the list order
+    std::vector<unsigned> segments;
+
+    appendIndexedItems( m_segmentsOnLine, POINT_KEY( aSheet, INT_MIN, pos.y ), segments );
+    appendIndexedItems( m_segmentsOnLine, POINT_KEY( aSheet, pos.x, INT_MIN ), segments );
+    appendIndexedItems( m_segmentsOnLine, POINT_KEY( aSheet, INT_MIN, INT_MIN ), segments );
+    std::sort( segments.begin(), segments.end() );
+
+    for( unsigned i : segments )
     {
         NETLIST_OBJECT* segment = GetItem( i );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
         if( aIsBus == IS_WIRE )
         {
             if( segment->m_Type != NET_SEGMENT )
@@ -823,7 +925,7 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                 continue;
         }
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
+        if( IsPointOnSegment( segment->m_Start, segment->m_End, pos ) )
         {
             // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
@@ -831,14 +933,14 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                 if( segment->GetNet() )
                     propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    segment->SetNet( findNetCode( aJonction->GetNet(), aIsBus ) );
             }
             else
             {
-                if( segment->m_BusNetCode )
+                if( findNetCode( segment->m_BusNetCode, aIsBus ) )
                     propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    segment->m_BusNetCode = findNetCode( aJonction->m_BusNetCode, aIsBus );
             }
         }
     }
@@ -850,11 +952,22 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
     if( aLabelRef->GetNet() == 0 )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    // NET_HIERLABEL are used to connect sheets.
+    // NET_LABEL are local to a sheet
+    // NET_GLOBLABEL are global.
+    // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
+    // All the labels of the same name are in the label index
+    auto labels = m_labelsByName.find( aLabelRef->m_Label );
+
+    if( labels == m_labelsByName.end() )
+        return;
+
+    for( unsigned i : labels->second )
     {
         NETLIST_OBJECT* item = GetItem( i );
+        int             netCode = findNetCode( aLabelRef->GetNet(), IS_WIRE );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( findNetCode( item->GetNet(), IS_WIRE ) == netCode )
             continue;
 
         if( item->m_SheetPath != aLabelRef->m_SheetPath )
@@ -870,20 +983,10 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
                 continue;
         }
 
-        // NET_HIERLABEL are used to connect sheets.
-        // NET_LABEL are local to a sheet
-        // NET_GLOBLABEL are global.
-        // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        if( item->GetNet() )
+            propagateNetCode( item->GetNet(), netCode, IS_WIRE );
+        else
+            item->SetNet( netCode );
     }
 }
 
@@ -1811,7 +1811,7 @@ void SCH_COMPONENT::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_COMPONENT::IsPinDanglingStateChanged( std::vector<DANGLING_END_ITEM> &aItemList,
+bool SCH_COMPONENT::IsPinDanglingStateChanged( const DANGLING_END_INDEX& aIndex,
         LIB_PINS& aLibPins, unsigned aPin )
 {
     bool previousState;
@@ -1828,9 +1828,15 @@ bool SCH_COMPONENT::IsPinDanglingStateChanged( std::vector<DANGLING_END_ITEM> &a
     }
 
     wxPoint pin_position = GetPinPhysicalPosition( aLibPins[aPin] );
+    const std::vector<unsigned>* items = aIndex.ItemsAt( pin_position );
 
-    for( DANGLING_END_ITEM& each_item : aItemList )
+    if( !items )
+        return previousState != m_isDangling[aPin];
+
+    for( unsigned ii : *items )
     {
+        const DANGLING_END_ITEM& each_item = aIndex.GetItems()[ii];
+
         // Some people like to stack pins on top of each other in a symbol to indicate
         // internal connection. While technically connected, it is not particularly useful
         // to display them that way, so skip any pins that are in the same symbol as this
@@ -1854,8 +1860,7 @@ bool SCH_COMPONENT::IsPinDanglingStateChanged( std::vector<DANGLING_END_ITEM> &a
         case WIRE_END_END:
         case NO_CONNECT_END:
         case JUNCTION_END:
-            if( pin_position == each_item.GetPosition() )
-                m_isDangling[aPin] = false;
+            m_isDangling[aPin] = false;
             break;
         default:
             break;
@@ -1868,7 +1873,7 @@ bool SCH_COMPONENT::IsPinDanglingStateChanged( std::vector<DANGLING_END_ITEM> &a
 }
 
 
-bool SCH_COMPONENT::IsDanglingStateChanged( std::vector<DANGLING_END_ITEM>& aItemList )
+bool SCH_COMPONENT::IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex )
 {
     bool changed = false;
     LIB_PINS libPins;
@@ -1876,7 +1881,7 @@ bool SCH_COMPONENT::IsDanglingStateChanged( std::vector<DANGLING_END_ITEM>& aIte
         part->GetPins( libPins, m_unit, m_convert );
     for( size_t i = 0; i < libPins.size(); ++i )
     {
-        if( IsPinDanglingStateChanged( aItemList, libPins, i ) )
+        if( IsPinDanglingStateChanged( aIndex, libPins, i ) )
             changed = true;
     }
     return changed;
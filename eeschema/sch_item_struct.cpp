@@ -30,6 +30,7 @@
 #include <common.h>
 #include <gr_basic.h>
 #include <base_struct.h>
+#include <trigo.h>
 #include <sch_item_struct.h>
 #include <class_sch_screen.h>
 #include <class_drawpanel.h>
@@ -37,10 +38,108 @@
 
 #include <general.h>
 
+#include <algorithm>
+
 
 const wxString traceFindItem( wxT( "KicadFindItem" ) );
 
 
+// Size of the cells of the segment grid, in internal units, and the largest number of cells
+// a segment bounding box can cover.  Longer segments are tested for every position.
+static const int      SEGMENT_GRID_SIZE = 500;
+static const unsigned SEGMENT_MAX_CELLS = 256;
+
+
+static int gridCell( int aCoord )
+{
+    // Rounds down, also for negative coordinates
+    return aCoord >= 0 ? aCoord / SEGMENT_GRID_SIZE : -( ( -aCoord - 1 ) / SEGMENT_GRID_SIZE ) - 1;
+}
+
+
+DANGLING_END_INDEX::DANGLING_END_INDEX( const std::vector< DANGLING_END_ITEM >& aItemList ) :
+    m_items( aItemList )
+{
+    m_itemsAtPoint.reserve( m_items.size() );
+
+    for( unsigned ii = 0; ii < m_items.size(); ii++ )
+    {
+        const DANGLING_END_ITEM& item = m_items[ii];
+
+        m_itemsAtPoint[item.GetPosition()].push_back( ii );
+
+        // Wires and buses are stored in the list as a pair, start and end.
+        if( ( item.GetType() != WIRE_START_END && item.GetType() != BUS_START_END )
+            || ii + 1 >= m_items.size() )
+            continue;
+
+        wxPoint  start = item.GetPosition();
+        wxPoint  end = m_items[ii + 1].GetPosition();
+        int      xmin = gridCell( std::min( start.x, end.x ) );
+        int      xmax = gridCell( std::max( start.x, end.x ) );
+        int      ymin = gridCell( std::min( start.y, end.y ) );
+        int      ymax = gridCell( std::max( start.y, end.y ) );
+
+        if( (unsigned long long) ( xmax - xmin + 1 ) * ( ymax - ymin + 1 ) > SEGMENT_MAX_CELLS )
+        {
+            m_longSegments.push_back( ii );
+            continue;
+        }
+
+        for( int x = xmin; x <= xmax; x++ )
+        {
+            for( int y = ymin; y <= ymax; y++ )
+                m_segmentsInCell[wxPoint( x, y )].push_back( ii );
+        }
+    }
+}
+
+
+const std::vector< unsigned >* DANGLING_END_INDEX::ItemsAt( const wxPoint& aPosition ) const
+{
+    POINT_INDEX::const_iterator it = m_itemsAtPoint.find( aPosition );
+
+    return it == m_itemsAtPoint.end() ? NULL : &it->second;
+}
+
+
+bool DANGLING_END_INDEX::isOnSegment( unsigned aStart, const wxPoint& aPosition,
+                                      bool aWiresOnly ) const
+{
+    if( aWiresOnly && m_items[aStart].GetType() != WIRE_START_END )
+        return false;
+
+    return IsPointOnSegment( m_items[aStart].GetPosition(), m_items[aStart + 1].GetPosition(),
+                             aPosition );
+}
+
+
+bool DANGLING_END_INDEX::IsOnSegment( const wxPoint& aPosition, bool aWiresOnly ) const
+{
+    // A point on a segment is inside its bounding box, so only the segments of the cell
+    // holding the point can pass through it.
+    POINT_INDEX::const_iterator it =
+            m_segmentsInCell.find( wxPoint( gridCell( aPosition.x ), gridCell( aPosition.y ) ) );
+
+    if( it != m_segmentsInCell.end() )
+    {
+        for( unsigned start : it->second )
+        {
+            if( isOnSegment( start, aPosition, aWiresOnly ) )
+                return true;
+        }
+    }
+
+    for( unsigned start : m_longSegments )
+    {
+        if( isOnSegment( start, aPosition, aWiresOnly ) )
+            return true;
+    }
+
+    return false;
+}
+
+
 bool sort_schematic_items( const SCH_ITEM* aItem1, const SCH_ITEM* aItem2 )
 {
     return *aItem1 < *aItem2;
@@ -33,6 +33,7 @@
 #include <vector>
 #include <class_base_screen.h>
 #include <general.h>
+#include <hashtables.h>
 
 #include <boost/ptr_container/ptr_vector.hpp>
 
@@ -106,6 +107,52 @@ public:
 };
 
 
+/**
+ * Class DANGLING_END_INDEX
+ * indexes a list of DANGLING_END_ITEMs by position, so an item can find the end points
+ * connected to it without scanning the whole list.
+ *
+ * The end points are hashed by position.  Wires and buses, which are stored in the list
+ * as a start and end pair, are also stored in a grid of cells by bounding box, to find the
+ * segments passing through a position.  The list must not change while it is indexed.
+ */
+class DANGLING_END_INDEX
+{
+public:
+    DANGLING_END_INDEX( const std::vector< DANGLING_END_ITEM >& aItemList );
+
+    const std::vector< DANGLING_END_ITEM >& GetItems() const { return m_items; }
+
+    /**
+     * Function ItemsAt
+     * @return the indexes in the list of the end points at \a aPosition, in list order,
+     *         or NULL if there is none.
+     */
+    const std::vector< unsigned >* ItemsAt( const wxPoint& aPosition ) const;
+
+    /**
+     * Function IsOnSegment
+     * tests if \a aPosition is on a wire or bus segment of the list.
+     *
+     * @param aPosition - The position to test.
+     * @param aWiresOnly - True to ignore the bus segments.
+     * @return True if a segment passes through \a aPosition.
+     */
+    bool IsOnSegment( const wxPoint& aPosition, bool aWiresOnly ) const;
+
+private:
+    typedef std::unordered_map< wxPoint, std::vector< unsigned >, WXPOINT_HASH > POINT_INDEX;
+
+    bool isOnSegment( unsigned aStart, const wxPoint& aPosition, bool aWiresOnly ) const;
+
+    const std::vector< DANGLING_END_ITEM >& m_items;
+
+    POINT_INDEX             m_itemsAtPoint;     ///< End points by position
+    POINT_INDEX             m_segmentsInCell;   ///< Segment start points by grid cell
+    std::vector< unsigned > m_longSegments;     ///< Segment start points too long for the grid
+};
+
+
 /**
  * Class SCH_ITEM
  * is a base class for any item which can be embedded within the SCHEMATIC
@@ -252,7 +299,7 @@ public:
 
     /**
      * Function IsDanglingStateChanged
-     * tests the schematic item to \a aItemList to check if it's dangling state has changed.
+     * tests the schematic item to \a aIndex to check if it's dangling state has changed.
      *
      * Note that the return value only true when the state of the test has changed.  Use
      * the IsDangling() method to get the current dangling state of the item.  Some of
@@ -260,10 +307,10 @@ public:
      * always returns false.  Only override the method if the item can be tested for a
      * dangling state.
      *
-     * @param aItemList - List of items to test item against.
+     * @param aIndex - The indexed list of items to test item against.
      * @return True if the dangling state has changed from it's current setting.
      */
-    virtual bool IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList ) { return false; }
+    virtual bool IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex ) { return false; }
 
     virtual bool IsDangling() const { return false; }
 
@@ -369,32 +369,42 @@ void SCH_LINE::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_LINE::IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList )
+/**
+ * Function isEndConnected
+ * @return true if an end point of \a aIndex other than the ends of \a aLine and the no
+ *         connects is at \a aPosition.
+ */
+static bool isEndConnected( const SCH_LINE* aLine, const wxPoint& aPosition,
+                            const DANGLING_END_INDEX& aIndex )
 {
-    bool previousStartState = m_startIsDangling;
-    bool previousEndState = m_endIsDangling;
+    const std::vector< unsigned >* items = aIndex.ItemsAt( aPosition );
 
-    m_startIsDangling = m_endIsDangling = true;
+    if( !items )
+        return false;
 
-    if( GetLayer() == LAYER_WIRE )
+    for( unsigned ii : *items )
     {
-        for( DANGLING_END_ITEM item : aItemList )
-        {
-            if( item.GetItem() == this )
-                continue;
+        const DANGLING_END_ITEM& item = aIndex.GetItems()[ii];
 
-            if( item.GetType() == NO_CONNECT_END )
-                continue;
+        if( item.GetItem() != aLine && item.GetType() != NO_CONNECT_END )
+            return true;
+    }
 
-            if( m_start == item.GetPosition() )
-                m_startIsDangling = false;
+    return false;
+}
 
-            if( m_end == item.GetPosition() )
-                m_endIsDangling = false;
 
-            if( (m_startIsDangling == false) && (m_endIsDangling == false) )
-                break;
-        }
+bool SCH_LINE::IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex )
+{
+    bool previousStartState = m_startIsDangling;
+    bool previousEndState = m_endIsDangling;
+
+    m_startIsDangling = m_endIsDangling = true;
+
+    if( GetLayer() == LAYER_WIRE )
+    {
+        m_startIsDangling = !isEndConnected( this, m_start, aIndex );
+        m_endIsDangling = !isEndConnected( this, m_end, aIndex );
     }
     else if( GetLayer() == LAYER_BUS || GetLayer() == LAYER_NOTES )
     {
@@ -115,7 +115,7 @@ public:
 
     void GetEndPoints( std::vector<DANGLING_END_ITEM>& aItemList ) override;
 
-    bool IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList ) override;
+    bool IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex ) override;
 
     bool IsDangling() const override { return m_startIsDangling || m_endIsDangling; }
 
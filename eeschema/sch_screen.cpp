@@ -54,6 +54,9 @@
 #include <sch_text.h>
 #include <lib_pin.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
 
@@ -423,46 +426,141 @@ bool SCH_SCREEN::IsTerminalPoint( const wxPoint& aPosition, int aLayer )
 }
 
 
+// Size of the grid cells used to find the overlapping junctions, in internal units
+static const int CLEANUP_GRID_SIZE = 500;
+
+
+static wxPoint cleanupCell( int aX, int aY )
+{
+    return wxPoint( (int) floor( (double) aX / CLEANUP_GRID_SIZE ),
+                    (int) floor( (double) aY / CLEANUP_GRID_SIZE ) );
+}
+
+
 bool SCH_SCREEN::SchematicCleanUp()
 {
-    bool      modified = false;
+    typedef std::unordered_map< wxPoint, std::vector< unsigned >, WXPOINT_HASH > POINT_INDEX;
 
-    for( SCH_ITEM* item = m_drawList.begin() ; item; item = item->Next() )
+    bool                        modified = false;
+    std::vector< SCH_ITEM* >    items;          // lines and junctions in draw list order
+    POINT_INDEX                 linesAtPoint;   // lines by end point
+    POINT_INDEX                 junctionsInCell;
+
+    // Lines are only merged with lines having a common end, and junctions only removed when
+    // they overlap, so the candidates of an item are found in the indexes instead of testing
+    // all the items.  The other tests do nothing, thus the candidates are tested in the draw
+    // list order to merge and delete the same items as a test of all the items would.
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( ( item->Type() != SCH_LINE_T ) && ( item->Type() != SCH_JUNCTION_T ) )
+        unsigned index = items.size();
+
+        if( item->Type() == SCH_LINE_T )
+        {
+            SCH_LINE* line = (SCH_LINE*) item;
+
+            linesAtPoint[line->GetStartPoint()].push_back( index );
+            linesAtPoint[line->GetEndPoint()].push_back( index );
+        }
+        else if( item->Type() == SCH_JUNCTION_T )
+        {
+            EDA_RECT bbox = item->GetBoundingBox();
+
+            bbox.Normalize();
+
+            wxPoint first = cleanupCell( bbox.GetX(), bbox.GetY() );
+            wxPoint last = cleanupCell( bbox.GetRight(), bbox.GetBottom() );
+
+            for( int x = first.x; x <= last.x; x++ )
+            {
+                for( int y = first.y; y <= last.y; y++ )
+                    junctionsInCell[wxPoint( x, y )].push_back( index );
+            }
+        }
+        else
+        {
             continue;
+        }
+
+        items.push_back( item );
+    }
+
+    std::vector< unsigned > candidates;
 
-        bool restart;
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+    {
+        SCH_ITEM* item = items[ii];
 
-        for( SCH_ITEM* testItem = item->Next(); testItem; testItem = restart ? m_drawList.begin() : testItem->Next() )
+        if( !item )     // already deleted
+            continue;
+
+        // The first pass tests the items after this one, the next passes, after a deletion,
+        // restart from the beginning of the list.
+        for( bool restart = false; ; restart = true )
         {
-            restart = false;
+            candidates.clear();
 
-            if( ( item->Type() == SCH_LINE_T ) && ( testItem->Type() == SCH_LINE_T ) )
+            if( item->Type() == SCH_LINE_T )
             {
                 SCH_LINE* line = (SCH_LINE*) item;
 
-                if( line->MergeOverlap( (SCH_LINE*) testItem ) )
+                for( const wxPoint& end : { line->GetStartPoint(), line->GetEndPoint() } )
                 {
-                    // Keep the current flags, because the deleted segment can be flagged.
-                    item->SetFlags( testItem->GetFlags() );
-                    DeleteItem( testItem );
-                    restart = true;
-                    modified = true;
+                    POINT_INDEX::const_iterator it = linesAtPoint.find( end );
+
+                    if( it != linesAtPoint.end() )
+                        candidates.insert( candidates.end(), it->second.begin(),
+                                           it->second.end() );
                 }
             }
-            else if ( ( ( item->Type() == SCH_JUNCTION_T )
-                      && ( testItem->Type() == SCH_JUNCTION_T ) ) && ( testItem != item ) )
+            else
+            {
+                wxPoint cell = cleanupCell( item->GetPosition().x, item->GetPosition().y );
+                POINT_INDEX::const_iterator it = junctionsInCell.find( cell );
+
+                if( it != junctionsInCell.end() )
+                    candidates = it->second;
+            }
+
+            std::sort( candidates.begin(), candidates.end() );
+            candidates.erase( std::unique( candidates.begin(), candidates.end() ),
+                              candidates.end() );
+
+            bool deleted = false;
+
+            for( unsigned jj : candidates )
             {
-                if ( testItem->HitTest( item->GetPosition() ) )
+                SCH_ITEM* testItem = items[jj];
+
+                if( !testItem || ( !restart && jj <= ii ) )
+                    continue;
+
+                if( item->Type() == SCH_LINE_T )
                 {
-                    // Keep the current flags, because the deleted segment can be flagged.
-                    item->SetFlags( testItem->GetFlags() );
-                    DeleteItem( testItem );
-                    restart = true;
-                    modified = true;
+                    SCH_LINE* line = (SCH_LINE*) item;
+
+                    if( !line->MergeOverlap( (SCH_LINE*) testItem ) )
+                        continue;
+
+                    // The merged line can have new ends.
+                    linesAtPoint[line->GetStartPoint()].push_back( ii );
+                    linesAtPoint[line->GetEndPoint()].push_back( ii );
                 }
+                else if( testItem == item || !testItem->HitTest( item->GetPosition() ) )
+                {
+                    continue;
+                }
+
+                // Keep the current flags, because the deleted segment can be flagged.
+                item->SetFlags( testItem->GetFlags() );
+                DeleteItem( testItem );
+                items[jj] = NULL;
+                deleted = true;
+                modified = true;
+                break;
             }
+
+            if( !deleted )
+                break;
         }
     }
 
@@ -917,9 +1015,11 @@ bool SCH_SCREEN::TestDanglingEnds()
     for( item = m_drawList.begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    DANGLING_END_INDEX index( endPoints );
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->IsDanglingStateChanged( endPoints ) )
+        if( item->IsDanglingStateChanged( index ) )
         {
             hasStateChanged = true;
         }
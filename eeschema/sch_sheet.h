@@ -40,6 +40,7 @@ class SCH_SHEET;
 class SCH_SHEET_PIN;
 class SCH_SHEET_PATH;
 class DANGLING_END_ITEM;
+class DANGLING_END_INDEX;
 class SCH_EDIT_FRAME;
 class NETLIST_OBJECT_LIST;
 
@@ -558,7 +559,7 @@ public:
 
     void GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList ) override;
 
-    bool IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList ) override;
+    bool IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex ) override;
 
     bool IsDangling() const override;
 
@@ -508,7 +508,7 @@ void SCH_TEXT::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 }
 
 
-bool SCH_TEXT::IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList )
+bool SCH_TEXT::IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex )
 {
     // Normal text labels cannot be tested for dangling ends.
     if( Type() == SCH_TEXT_T )
@@ -517,46 +517,36 @@ bool SCH_TEXT::IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemLi
     bool previousState = m_isDangling;
     m_isDangling = true;
 
-    for( unsigned ii = 0; ii < aItemList.size(); ii++ )
+    if( const std::vector< unsigned >* items = aIndex.ItemsAt( GetTextPos() ) )
     {
-        DANGLING_END_ITEM& item = aItemList[ii];
-
-        if( item.GetItem() == this )
-            continue;
-
-        switch( item.GetType() )
+        for( unsigned ii : *items )
         {
-        case PIN_END:
-        case LABEL_END:
-        case SHEET_LABEL_END:
-            if( GetTextPos() == item.GetPosition() )
-                m_isDangling = false;
+            const DANGLING_END_ITEM& item = aIndex.GetItems()[ii];
 
-            break;
-
-        case WIRE_START_END:
-        case BUS_START_END:
-        {
-            // These schematic items have created 2 DANGLING_END_ITEM one per end.  But being
-            // a paranoid programmer, I'll check just in case.
-            ii++;
+            if( item.GetItem() == this )
+                continue;
 
-            wxCHECK_MSG( ii < aItemList.size(), previousState != m_isDangling,
-                         wxT( "Dangling end type list overflow.  Bad programmer!" ) );
+            switch( item.GetType() )
+            {
+            case PIN_END:
+            case LABEL_END:
+            case SHEET_LABEL_END:
+                m_isDangling = false;
+                break;
 
-            DANGLING_END_ITEM & nextItem = aItemList[ii];
-            m_isDangling = !IsPointOnSegment( item.GetPosition(), nextItem.GetPosition(), GetTextPos() );
-        }
-            break;
+            default:
+                break;
+            }
 
-        default:
-            break;
+            if( !m_isDangling )
+                break;
         }
-
-        if( !m_isDangling )
-            break;
     }
 
+    // Wires and buses connect the label anywhere along their length.
+    if( m_isDangling )
+        m_isDangling = !aIndex.IsOnSegment( GetTextPos(), false );
+
     return previousState != m_isDangling;
 }
 
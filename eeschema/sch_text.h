@@ -180,7 +180,7 @@ public:
 
     virtual void GetEndPoints( std::vector< DANGLING_END_ITEM >& aItemList ) override;
 
-    virtual bool IsDanglingStateChanged( std::vector< DANGLING_END_ITEM >& aItemList ) override;
+    virtual bool IsDanglingStateChanged( const DANGLING_END_INDEX& aIndex ) override;
 
     virtual bool IsDangling() const override { return m_isDangling; }
 
@@ -162,6 +162,7 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+// One instance for each thread, so texts can be plotted by several threads at the same time
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
@@ -38,6 +38,8 @@
 #include <common.h>
 #include <id.h>
 
+#include <unordered_set>
+
 /**
  * Class GRID_TYPE
  * is for grid arrays.
@@ -84,6 +86,7 @@ private:
     wxPoint     m_scrollCenter;     ///< Current scroll center point in logical units.
     wxPoint     m_MousePosition;    ///< Mouse cursor coordinate in logical units.
     int         m_UndoRedoCountMax; ///< undo/Redo command Max depth
+    int         m_UndoRedoMemoryMax; ///< undo/Redo memory budget in MB, 0 for no limit
 
     /**
      * The cross hair position in logical (drawing) units.  The cross hair is not the cursor
@@ -94,6 +97,28 @@ private:
 
     double      m_Zoom;             ///< Current zoom coefficient.
 
+    /**
+     * Function trimToMemoryBudget
+     * deletes the oldest commands of \a aList when its commands use more memory than
+     * the budget.  The newest command is always kept.  It uses the sizes estimated when
+     * the commands were pushed, so it does not depend on the length of the list.
+     */
+    void trimToMemoryBudget( UNDO_REDO_CONTAINER& aList );
+
+    /**
+     * Function commandMemorySize
+     * estimates the memory used by the item copies of \a aCommand, using
+     * GetCommandMemorySize().
+     */
+    size_t commandMemorySize( const PICKED_ITEMS_LIST& aCommand ) const;
+
+    /**
+     * Function clearOldCommands
+     * deletes the \a aItemCount oldest commands of \a aList with ClearUndoORRedoList(),
+     * and removes their size from the memory used by the list.
+     */
+    void clearOldCommands( UNDO_REDO_CONTAINER& aList, int aItemCount );
+
     //----< Old public API now is private, and migratory>------------------------
     // called only from EDA_DRAW_FRAME
     friend class EDA_DRAW_FRAME;
@@ -260,6 +285,22 @@ public:
      */
     virtual void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) = 0;
 
+    /**
+     * Function GetCommandMemorySize (virtual).
+     * returns an estimate of the memory used by the item copies owned by a command, used
+     * to keep the undo and redo lists in the memory budget.  The default version returns 0,
+     * so the memory used by the commands is not limited.
+     * @param aCommand = the command to estimate
+     * @param aCounted = the data shared between item copies already counted, which is not
+     *                   counted again.  The data counted now is added to it.
+     * @return the size in bytes.
+     */
+    virtual size_t GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand,
+                                         std::unordered_set<const void*>& aCounted ) const
+    {
+        return 0;
+    }
+
     /**
      * Function ClearUndoRedoList
      * clear undo and redo list, using ClearUndoORRedoList()
@@ -271,8 +312,8 @@ public:
     /**
      * Function PushCommandToUndoList
      * add a command to undo in undo list
-     * delete the very old commands when the max count of undo commands is
-     * reached
+     * delete the very old commands when the max count of undo commands or the
+     * memory budget is reached
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem );
@@ -280,8 +321,8 @@ public:
     /**
      * Function PushCommandToRedoList
      * add a command to redo in redo list
-     * delete the very old commands when the max count of redo commands is
-     * reached
+     * delete the very old commands when the max count of redo commands or the
+     * memory budget is reached
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToRedoList( PICKED_ITEMS_LIST* aItem );
@@ -321,6 +362,13 @@ public:
         }
     }
 
+    int GetMaxUndoMemory() const { return m_UndoRedoMemoryMax; }
+
+    void SetMaxUndoMemory( int aMegabytes )
+    {
+        m_UndoRedoMemoryMax = std::max( aMegabytes, 0 );
+    }
+
     void SetModify()        { m_FlagModified = true; }
     void ClrModify()        { m_FlagModified = false; }
     void SetSave()          { m_FlagSave = true; }
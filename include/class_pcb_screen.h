@@ -100,6 +100,17 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) override;
+
+    /**
+     * Function GetCommandMemorySize
+     * estimates the memory used by the copies of board items owned by a command:
+     * the images of changed items and the deleted items.
+     * @param aCommand = the command to estimate
+     * @param aCounted = the zone fills already counted
+     * @return the size in bytes.
+     */
+    size_t GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand,
+                                 std::unordered_set<const void*>& aCounted ) const override;
 };
 
 #endif  // CLASS_PCB_SCREEN_H_
@@ -133,6 +133,8 @@ public:
                                    * UR_UNSPECIFIED */
     wxPoint m_TransformPoint;     /* used to undo redo command by the same command: usually
                                    * need to know the rotate point or the move vector */
+    size_t  m_MemorySize;         /* memory used by the item copies, estimated when the
+                                   * command is pushed to an undo or redo list */
 
 private:
     std::vector <ITEM_PICKER> m_ItemsList;
@@ -309,6 +311,7 @@ class UNDO_REDO_CONTAINER
 {
 public:
     std::vector <PICKED_ITEMS_LIST*> m_CommandsList;   // the list of possible undo/redo commands
+    size_t m_MemorySize;        // the sum of the m_MemorySize of the commands
 
 public:
 
@@ -44,6 +44,7 @@ namespace KIGFX
 
 #define DEFAULT_MAX_UNDO_ITEMS 0
 #define ABS_MAX_UNDO_ITEMS (INT_MAX / 2)
+#define DEFAULT_MAX_UNDO_MEMORY 1024      // MB, 0 for no limit
 
 /**
  * Class EDA_DRAW_FRAME
@@ -87,6 +88,8 @@ protected:
                                             // is at scale = 1
     int         m_UndoRedoCountMax;         ///< default Undo/Redo command Max depth, to be handed
                                             // to screens
+    int         m_UndoRedoMemoryMax;        ///< default Undo/Redo memory budget in MB, to be
+                                            // handed to screens
 
     /// The area to draw on.
     EDA_DRAW_PANEL* m_canvas;
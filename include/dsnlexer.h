@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of the current line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -516,7 +517,13 @@ public:
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        // Some readers (MAPPED_FILE_LINE_READER) do not nul terminate their lines.
+        if( reader && reader->Line() )
+            curLine.assign( reader->Line(), reader->Length() );
+        else
+            curLine.clear();
+
+        return curLine.c_str();
     }
 
     /**
@@ -384,6 +384,12 @@ private:
      */
     void drawPolygon( GLdouble* aPoints, int aPointCount );
 
+    /**
+     * @brief Draws the cached triangles of a polygon set, without tesselating it again.
+     * @param aPolySet is the polygon set, whose triangulation is up to date.
+     */
+    void drawTriangulatedPolyset( const SHAPE_POLY_SET& aPolySet );
+
     /**
      * @brief Draws a single character using bitmap font.
      * Its main purpose is to be used in BitmapText() function.
@@ -0,0 +1,113 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLYGON_TRIANGULATION_H
+#define __POLYGON_TRIANGULATION_H
+
+#include <deque>
+#include <cstdint>
+
+#include <geometry/shape_poly_set.h>
+
+/**
+ * Class POLYGON_TRIANGULATION
+ *
+ * Splits a polygon without holes in triangles, by ear clipping.  The polygon can be weakly
+ * simple, like the fractured polygons, whose slits are pairs of overlapping edges.
+ *
+ * The vertices are kept in a circular list, and an ear is clipped when no other vertex lies
+ * in it.  The vertices are also sorted along a Z-order curve, so only the vertices near an
+ * ear are tested.  When no ear is found, the collinear and duplicated vertices are removed,
+ * then the small self intersections are cut, and at last the polygon is split in two along
+ * a diagonal, and each part is triangulated on its own.
+ */
+class POLYGON_TRIANGULATION
+{
+public:
+    POLYGON_TRIANGULATION( SHAPE_POLY_SET::TRIANGULATED_POLYGON& aResult );
+
+    /**
+     * Function TesselatePolygon
+     * adds the vertices and the triangles of a polygon to the result.
+     * @param aPoly is the outline of the polygon.
+     * @return bool - false if a part of the polygon could not be triangulated.
+     */
+    bool TesselatePolygon( const SHAPE_LINE_CHAIN& aPoly );
+
+private:
+    struct VERTEX
+    {
+        VERTEX( int aIndex, int64_t aX, int64_t aY ) :
+            i( aIndex ), x( aX ), y( aY ), prev( nullptr ), next( nullptr ),
+            z( 0 ), prevZ( nullptr ), nextZ( nullptr )
+        {
+        }
+
+        int         i;          ///< index of the vertex in the result
+        int64_t     x;
+        int64_t     y;
+
+        VERTEX*     prev;       ///< polygon order
+        VERTEX*     next;
+
+        uint32_t    z;          ///< Z-order curve position
+        VERTEX*     prevZ;      ///< Z-order
+        VERTEX*     nextZ;
+    };
+
+    VERTEX* createList( const SHAPE_LINE_CHAIN& aPoly );
+    VERTEX* insertVertex( int aIndex, const VECTOR2I& aPoint, VERTEX* aLast );
+    void removeVertex( VERTEX* aVertex );
+
+    /// Removes the duplicated and collinear vertices from aStart to aEnd.
+    VERTEX* filterPoints( VERTEX* aStart, VERTEX* aEnd = nullptr );
+
+    /// Sorts the vertices of a polygon along the Z-order curve.
+    void zIndexList( VERTEX* aStart );
+    uint32_t zOrder( int64_t aX, int64_t aY ) const;
+
+    bool earcutList( VERTEX* aEar, int aPass = 0 );
+    bool isEar( const VERTEX* aEar ) const;
+    VERTEX* cureLocalIntersections( VERTEX* aStart );
+    bool splitPolygon( VERTEX* aStart );
+    VERTEX* split( VERTEX* a, VERTEX* b );
+
+    /// @return twice the signed area of a vertex list, positive if counterclockwise.
+    double loopArea( const VERTEX* aStart ) const;
+
+    bool isValidDiagonal( const VERTEX* a, const VERTEX* b ) const;
+    bool intersectsPolygon( const VERTEX* a, const VERTEX* b ) const;
+    bool locallyInside( const VERTEX* a, const VERTEX* b ) const;
+    bool middleInside( const VERTEX* a, const VERTEX* b ) const;
+
+    void addTriangle( const VERTEX* a, const VERTEX* b, const VERTEX* c );
+
+    SHAPE_POLY_SET::TRIANGULATED_POLYGON& m_result;
+
+    std::deque<VERTEX>  m_vertices;     ///< a deque, so the vertex addresses are stable
+    int64_t             m_minX;
+    int64_t             m_minY;
+    double              m_zScale;       ///< scales the coordinates to the Z-order range
+};
+
+#endif // __POLYGON_TRIANGULATION_H
@@ -28,6 +28,8 @@
 
 #include <vector>
 #include <cstdio>
+#include <functional>
+#include <memory>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
@@ -57,6 +59,80 @@ class SHAPE_POLY_SET : public SHAPE
         ///> the remaining (if any), are the holes
         typedef std::vector<SHAPE_LINE_CHAIN> POLYGON;
 
+        /**
+         * Class TRIANGULATED_POLYGON
+         *
+         * Holds the triangles of a polygon without holes: each triangle is given by the
+         * indices of its corners in the vertex list.
+         */
+        class TRIANGULATED_POLYGON
+        {
+        public:
+            struct TRI
+            {
+                TRI( int aA, int aB, int aC ) : a( aA ), b( aB ), c( aC )
+                {
+                }
+
+                int a, b, c;
+            };
+
+            void Clear()
+            {
+                m_vertices.clear();
+                m_triangles.clear();
+            }
+
+            void AddVertex( const VECTOR2I& aP )
+            {
+                m_vertices.push_back( aP );
+            }
+
+            void AddTriangle( int aA, int aB, int aC )
+            {
+                m_triangles.push_back( TRI( aA, aB, aC ) );
+            }
+
+            int GetVertexCount() const
+            {
+                return m_vertices.size();
+            }
+
+            int GetTriangleCount() const
+            {
+                return m_triangles.size();
+            }
+
+            void GetTriangle( int aIndex, VECTOR2I& aA, VECTOR2I& aB, VECTOR2I& aC ) const
+            {
+                const TRI& tri = m_triangles[aIndex];
+
+                aA = m_vertices[tri.a];
+                aB = m_vertices[tri.b];
+                aC = m_vertices[tri.c];
+            }
+
+            const std::vector<VECTOR2I>& Vertices() const
+            {
+                return m_vertices;
+            }
+
+            const std::vector<TRI>& Triangles() const
+            {
+                return m_triangles;
+            }
+
+            void Move( const VECTOR2I& aVector )
+            {
+                for( VECTOR2I& vertex : m_vertices )
+                    vertex += aVector;
+            }
+
+        private:
+            std::vector<VECTOR2I> m_vertices;
+            std::vector<TRI> m_triangles;
+        };
+
         /**
          * Struct VERTEX_INDEX
          *
@@ -163,7 +239,9 @@ class SHAPE_POLY_SET : public SHAPE
 
             T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Point( m_currentVertex );
+                // The polygons are read directly: Polygon() would mark the triangles as outdated
+                // for the const iterators too
+                return m_poly->m_polys[m_currentPolygon][m_currentContour].Point( m_currentVertex );
             }
 
             T& operator*()
@@ -285,7 +363,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->m_polys[m_currentPolygon][m_currentContour].Segment( m_currentSegment );
             }
 
             T operator*()
@@ -504,6 +582,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateTriangulation();
             return m_polys[aIndex][0];
         }
 
@@ -526,12 +605,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateTriangulation();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateTriangulation();
             return m_polys[aIndex];
         }
 
@@ -569,6 +650,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            invalidateTriangulation();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -681,6 +764,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             SEGMENT_ITERATOR iter;
 
+            invalidateTriangulation();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -721,6 +806,13 @@ class SHAPE_POLY_SET : public SHAPE
          * simple polygon, but calculations can be really significantly time consuming
          * Most of time PM_FAST is preferable.
          * PM_STRICTLY_SIMPLE can be used in critical cases (Gerber output for instance)
+         *
+         * Boolean operations, Inflate, Simplify and Fracture also accept an aParallel param.
+         * When true, polygons far from each other are processed in separate buckets on worker
+         * threads (see transformParallel). The result is the same polygon set as the single
+         * thread one, but polygons can be in another order.  It is worth only for sets of
+         * many polygons (lots of pad and track holes...), and should not be used from code
+         * already running on several threads.
          */
         enum POLYGON_MODE
         {
@@ -730,45 +822,82 @@ class SHAPE_POLY_SET : public SHAPE
 
         ///> Performs boolean polyset union
         ///> For aFastMode meaning, see function booleanOp
-        void BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode );
+        void BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                         bool aParallel = false );
 
         ///> Performs boolean polyset difference
         ///> For aFastMode meaning, see function booleanOp
-        void BooleanSubtract( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode );
+        void BooleanSubtract( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                              bool aParallel = false );
 
         ///> Performs boolean polyset intersection
         ///> For aFastMode meaning, see function booleanOp
-        void BooleanIntersection( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode );
+        void BooleanIntersection( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode,
+                                  bool aParallel = false );
 
         ///> Performs boolean polyset union between a and b, store the result in it self
         ///> For aFastMode meaning, see function booleanOp
         void BooleanAdd( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
-                         POLYGON_MODE aFastMode );
+                         POLYGON_MODE aFastMode, bool aParallel = false );
 
         ///> Performs boolean polyset difference between a and b, store the result in it self
         ///> For aFastMode meaning, see function booleanOp
         void BooleanSubtract( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
-                              POLYGON_MODE aFastMode );
+                              POLYGON_MODE aFastMode, bool aParallel = false );
 
         ///> Performs boolean polyset intersection between a and b, store the result in it self
         ///> For aFastMode meaning, see function booleanOp
         void BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
-                                  POLYGON_MODE aFastMode );
+                                  POLYGON_MODE aFastMode, bool aParallel = false );
 
         ///> Performs outline inflation/deflation, using round corners.
-        void Inflate( int aFactor, int aCircleSegmentsCount );
+        void Inflate( int aFactor, int aCircleSegmentsCount, bool aParallel = false );
 
         ///> Converts a set of polygons with holes to a singe outline with "slits"/"fractures" connecting the outer ring
         ///> to the inner holes
         ///> For aFastMode meaning, see function booleanOp
-        void Fracture( POLYGON_MODE aFastMode );
+        void Fracture( POLYGON_MODE aFastMode, bool aParallel = false );
 
         ///> Returns true if the polygon set has any holes.
         bool HasHoles() const;
 
+        /**
+         * Function CacheTriangulation
+         * splits the polygons in triangles, and keeps the triangles until the polygons change.
+         * Polygons with holes are fractured first, so the triangulated polygons are not always
+         * those of the set.  The copies of the set share the triangles.
+         * Nothing is done if the polygons did not change since the last call, so it can be
+         * called before each drawing.  If a polygon cannot be triangulated, no triangles are
+         * kept.
+         */
+        void CacheTriangulation();
+
+        /**
+         * Function IsTriangulationUpToDate
+         * @return bool - true if the cached triangles are those of the current polygons.
+         * All the functions which change the polygons, or give a non const access to them
+         * (Vertex(), Outline(), Iterate()...), mark the triangles as outdated.
+         */
+        bool IsTriangulationUpToDate() const
+        {
+            return m_triangulationValid;
+        }
+
+        ///> Returns the number of triangulated polygons (valid if IsTriangulationUpToDate())
+        unsigned int TriangulatedPolyCount() const
+        {
+            return m_triangulatedPolys.size();
+        }
+
+        ///> Returns the triangles of the aIndex-th triangulated polygon
+        const TRIANGULATED_POLYGON* TriangulatedPolygon( int aIndex ) const
+        {
+            return m_triangulatedPolys[aIndex].get();
+        }
+
         ///> Simplifies the polyset (merges overlapping polys, eliminates degeneracy/self-intersections)
         ///> For aFastMode meaning, see function booleanOp
-        void Simplify( POLYGON_MODE aFastMode );
+        void Simplify( POLYGON_MODE aFastMode, bool aParallel = false );
 
         /**
          * Function NormalizeAreaOutlines
@@ -1017,6 +1146,32 @@ class SHAPE_POLY_SET : public SHAPE
                         const SHAPE_POLY_SET& aShape,
                         const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
 
+        /**
+         * Function transformParallel
+         * applies a transform to aShape and aOtherShape on worker threads, and stores the
+         * result in it self.
+         * Polygons of both shapes are grouped in clusters: two polygons belong to the same
+         * cluster when their bounding boxes, inflated by aMargin, overlap (directly or through
+         * other polygons).  The transform of a cluster alone gives the same polygons as the
+         * transform of the whole set, so clusters are gathered in buckets of about the same
+         * vertex count, the buckets are transformed concurrently and their results appended
+         * in bucket order.  Small sets are transformed in the calling thread.
+         * @param aTransform is the transform applied to each bucket.
+         * @param aMargin is the bounding box inflation, half the distance from which two
+         * polygons can interact.
+         */
+        typedef std::function<void( const SHAPE_POLY_SET& aShape,
+                                    const SHAPE_POLY_SET& aOtherShape,
+                                    SHAPE_POLY_SET& aResult )> BUCKET_TRANSFORM;
+
+        void transformParallel( const BUCKET_TRANSFORM& aTransform, const SHAPE_POLY_SET& aShape,
+                                const SHAPE_POLY_SET& aOtherShape, int aMargin );
+
+        ///> Same as booleanOp, using transformParallel
+        void booleanOpParallel( ClipperLib::ClipType aType,
+                                const SHAPE_POLY_SET& aShape,
+                                const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
+
         bool pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath ) const;
 
         const ClipperLib::Path convertToClipper( const SHAPE_LINE_CHAIN& aPath, bool aRequiredOrientation );
@@ -1063,9 +1218,26 @@ class SHAPE_POLY_SET : public SHAPE
         POLYGON chamferFilletPolygon( CORNER_MODE aMode, unsigned int aDistance,
                                       int aIndex, int aSegments = -1 );
 
+        ///> Marks the cached triangles as outdated, before a change of the polygons
+        void invalidateTriangulation()
+        {
+            m_triangulationDirty = true;
+            m_triangulationValid = false;
+        }
+
         typedef std::vector<POLYGON> Polyset;
 
         Polyset m_polys;
+
+        ///> Triangles of the polygons, shared by the copies of the set.  They are not modified
+        ///> once built: a new triangulation replaces them
+        std::vector<std::shared_ptr<const TRIANGULATED_POLYGON> > m_triangulatedPolys;
+
+        ///> The polygons changed since the last CacheTriangulation()
+        bool m_triangulationDirty;
+
+        ///> The triangles are those of the polygons
+        bool m_triangulationValid;
 };
 
 #endif
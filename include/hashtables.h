@@ -95,6 +95,16 @@ struct WXSTRING_HASH : std::unary_function<wxString, std::size_t>
 };
 
 
+/// Hash function for wxPoint, to index items by position
+struct WXPOINT_HASH : std::unary_function<wxPoint, std::size_t>
+{
+    std::size_t operator()( const wxPoint& aPoint ) const
+    {
+        return std::hash<int>()( aPoint.x ) * 31 + std::hash<int>()( aPoint.y );
+    }
+};
+
+
 class NETINFO_ITEM;
 
 
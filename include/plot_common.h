@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <memory>
 #include <math/box2.h>
 #include <drawtxt.h>
 #include <class_page_info.h>
@@ -505,6 +506,42 @@ protected:
 
     double GetDashGapLenIU() const;
 
+    // Output helpers
+
+    /// Size of the write buffer of the plot files
+    static const size_t FILE_BUFFER_SIZE = 256 * 1024;
+
+    /// Max length of a number written by formatInt() or formatDouble()
+    static const int NUMBER_MAX_LEN = 32;
+
+    /**
+     * Gives a large write buffer to a plot file, so the many small writes of a plot are
+     * not each sent to the system.  Must be called before any I/O on aFile.
+     * @param aBuffer is allocated if needed, and must be kept until aFile is closed.
+     */
+    static void setFileBuffer( FILE* aFile, std::unique_ptr<char[]>& aBuffer );
+
+    /**
+     * Writes aValue at aBuffer like printf "%d" in the C locale, without the terminating
+     * null.  Much faster than printf, and independent of the locale.
+     * @return the end of the written chars.
+     */
+    static char* formatInt( char* aBuffer, int aValue );
+
+    /**
+     * Writes aValue at aBuffer like printf "%g" in the C locale, without the terminating
+     * null.  The usual plot coordinates are written without printf, so much faster and
+     * independently of the locale.
+     * @return the end of the written chars.
+     */
+    static char* formatDouble( char* aBuffer, double aValue );
+
+    /**
+     * Writes a point and a short suffix (usually a drawing operator) to aFile, like
+     * fprintf( aFile, "%g %g%s", aX, aY, aSuffix ), but without printf.
+     */
+    static void writeCoords( FILE* aFile, double aX, double aY, const char* aSuffix );
+
 protected:      // variables used in most of plotters:
     /// Plot scale - chosen by the user (even implicitly with 'fit in a4')
     double        plotScale;
@@ -530,6 +567,10 @@ protected:      // variables used in most of plotters:
     /// Output file
     FILE*         outputFile;
 
+    /// Write buffers of the output file, and of the work file of some plotters
+    std::unique_ptr<char[]> m_outputBuffer;
+    std::unique_ptr<char[]> m_workBuffer;
+
     // Pen handling
     bool          colorMode;        /// true to plot in color, false to plot in black and white
     bool          negativeMode;     /// true to generate a negative image (PS mode mainly)
@@ -793,8 +834,11 @@ public:
         // Avoid non initialized variables:
         pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
         pageTreeHandle = 0;
+        m_compressionLevel = 9;     // wxZ_BEST_COMPRESSION
     }
 
+    ~PDF_PLOTTER();
+
     virtual PlotFormat GetPlotterType() const override
     {
         return PLOT_FORMAT_PDF;
@@ -815,6 +859,16 @@ public:
      */
     virtual bool OpenFile( const wxString& aFullFilename ) override;
 
+    /**
+     * Sets the zlib compression level of the page streams, from 0 (no compression) to
+     * 9 (best compression, the default), or -1 for the zlib default level.  Lower levels
+     * are much faster on large plots.  Other values are clamped to this range.
+     */
+    void SetCompressionLevel( int aLevel )
+    {
+        m_compressionLevel = aLevel < -1 ? -1 : ( aLevel > 9 ? 9 : aLevel );
+    }
+
     virtual bool StartPlot() override;
     virtual bool EndPlot() override;
     virtual void StartPage();
@@ -872,6 +926,7 @@ protected:
     wxString workFilename;
     FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
     std::vector<long> xrefTable; /// The PDF xref offset table
+    int m_compressionLevel;      /// zlib compression level of the streams
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
@@ -985,6 +1040,7 @@ class GERBER_PLOTTER : public PLOTTER
 {
 public:
     GERBER_PLOTTER();
+    ~GERBER_PLOTTER();
 
     virtual PlotFormat GetPlotterType() const override
     {
@@ -473,6 +473,15 @@ public:
      */
     void Compile_Ratsnest( wxDC* aDC, bool aDisplayStatus );
 
+    /**
+     * Function Update_Ratsnest
+     * calls Compile_Ratsnest() only if the board changed since it was last called, i.e.
+     * if the LISTE_RATSNEST_ITEM_OK or CONNEXION_OK bit of the board status is cleared.
+     * @param aDC = the current device context (can be NULL)
+     * @param aDisplayStatus : if true, display the computation results
+     */
+    void Update_Ratsnest( wxDC* aDC, bool aDisplayStatus );
+
     /**
      * Function build_ratsnest_module
      * Build a ratsnest relative to one footprint. This is a simplified computation
@@ -545,6 +554,8 @@ public:
      * <p>
      * This function update the status of the ratsnest ( flag CH_ACTIF = 0 if a connection
      * is found, = 1 else) track segments are assumed to be sorted by net codes.
+     * It does nothing if the CONNEXION_OK bit of the board status is set, i.e. if no item
+     * was added, removed or changed since the last test.
      * This is the case because when a new track is added, it is inserted in the linked list
      * according to its net code. and when nets are changed (when a new netlist is read)
      * tracks are sorted before using this function.
@@ -43,6 +43,11 @@
 #include <cell.h>
 #include <colors_selection.h>
 
+#include <cfloat>
+#include <climits>
+#include <map>
+#include <vector>
+
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
@@ -100,16 +105,6 @@ int             genPlacementRoutingMatrix(  BOARD* aBrd, EDA_MSG_PANEL* messageP
 static int      getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame,
                                            MODULE* aModule, wxDC* aDC );
 
-/*
- * Function compute_Ratsnest_PlaceModule
- * displays the module's ratsnest during displacement, and assess the "cost"
- * of the position.
- *
- * The cost is the longest ratsnest distance with penalty for connections
- * approaching 45 degrees.
- */
-static double   compute_Ratsnest_PlaceModule( BOARD* aBrd );
-
 /* Place a footprint on the Routing matrix.
  */
 void            genModuleOnRoutingMatrix( MODULE* Module );
@@ -118,8 +113,6 @@ void            genModuleOnRoutingMatrix( MODULE* Module );
  */
 static void     drawPlacementRoutingMatrix( BOARD* aBrd, wxDC* DC );
 
-static int      TstModuleOnBoard( BOARD* Pcb, MODULE* Module, bool TstOtherSide );
-
 static void     CreateKeepOutRectangle( int ux0, int uy0, int ux1, int uy1,
                                         int marge, int aKeepOut, LSET aLayerMask );
 
@@ -536,9 +529,8 @@ int genPlacementRoutingMatrix( BOARD* aBrd, EDA_MSG_PANEL* messagePanel )
         ii = propagate();
 
     // Initialize top layer. to the same value as the bottom layer
-    if( RoutingMatrix.m_BoardSide[TOP] )
-        memcpy( RoutingMatrix.m_BoardSide[TOP], RoutingMatrix.m_BoardSide[BOTTOM],
-                nbCells * sizeof(MATRIX_CELL) );
+    if( RoutingMatrix.m_RoutingLayersCount > 1 )
+        RoutingMatrix.CopyBoardSide( BOTTOM, TOP );
 
     return 1;
 }
@@ -615,341 +607,576 @@ inline void draw_FootprintRect( EDA_RECT* aClipBox, wxDC* aDC, EDA_RECT& fpBBox,
 }
 
 
-int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aDC )
+/* Calculates the range of the matrix cells inside the rectangle aRect.
+ * Returns false if there is no cell inside.
+ */
+static bool getRectCells( const EDA_RECT& aRect, int& aRowMin, int& aRowMax,
+                          int& aColMin, int& aColMax )
 {
-    int     error = 1;
-    wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
-    bool    TstOtherSide;
-    DISPLAY_OPTIONS* displ_opts = (DISPLAY_OPTIONS*)aFrame->GetDisplayOptions();
-    BOARD*  brd = aFrame->GetBoard();
-
-    aModule->CalculateBoundingBox();
-
-    bool showRats = displ_opts->m_Show_Module_Ratsnest;
-    displ_opts->m_Show_Module_Ratsnest = false;
+    wxPoint start   = aRect.GetOrigin();
+    wxPoint end     = aRect.GetEnd();
 
-    brd->m_Status_Pcb &= ~RATSNEST_ITEM_LOCAL_OK;
-    aFrame->SetMsgPanel( aModule );
+    start   -= RoutingMatrix.m_BrdBox.GetOrigin();
+    end     -= RoutingMatrix.m_BrdBox.GetOrigin();
 
-    LastPosOK = RoutingMatrix.m_BrdBox.GetOrigin();
+    aRowMin = start.y / RoutingMatrix.m_GridRouting;
+    aRowMax = end.y / RoutingMatrix.m_GridRouting;
+    aColMin = start.x / RoutingMatrix.m_GridRouting;
+    aColMax = end.x / RoutingMatrix.m_GridRouting;
 
-    wxPoint     mod_pos = aModule->GetPosition();
-    EDA_RECT    fpBBox  = aModule->GetFootprintRect();
+    if( start.y > aRowMin * RoutingMatrix.m_GridRouting )
+        aRowMin++;
 
-    // Move fpBBox to have the footprint position at (0,0)
-    fpBBox.Move( -mod_pos );
-    wxPoint fpBBoxOrg = fpBBox.GetOrigin();
+    if( start.x > aColMin * RoutingMatrix.m_GridRouting )
+        aColMin++;
 
-    // Calculate the limit of the footprint position, relative
-    // to the routing matrix area
-    wxPoint xylimit = RoutingMatrix.m_BrdBox.GetEnd() - fpBBox.GetEnd();
+    if( aRowMin < 0 )
+        aRowMin = 0;
 
-    wxPoint initialPos = RoutingMatrix.m_BrdBox.GetOrigin() - fpBBoxOrg;
+    if( aRowMax >= ( RoutingMatrix.m_Nrows - 1 ) )
+        aRowMax = RoutingMatrix.m_Nrows - 1;
 
-    // Stay on grid.
-    initialPos.x    -= initialPos.x % RoutingMatrix.m_GridRouting;
-    initialPos.y    -= initialPos.y % RoutingMatrix.m_GridRouting;
+    if( aColMin < 0 )
+        aColMin = 0;
 
-    CurrPosition = initialPos;
+    if( aColMax >= ( RoutingMatrix.m_Ncols - 1 ) )
+        aColMax = RoutingMatrix.m_Ncols - 1;
 
-    // Undraw the current footprint
-    aModule->DrawOutlinesWhenMoving( aFrame->GetCanvas(), aDC, wxPoint( 0, 0 ) );
+    return aRowMin <= aRowMax && aColMin <= aColMax;
+}
 
-    g_Offset_Module = mod_pos - CurrPosition;
 
-    /* Examine pads, and set TstOtherSide to true if a footprint
-     * has at least 1 pad through.
-     */
-    TstOtherSide = false;
+/**
+ * Class PLACEMENT_AREA
+ * holds the summed-area tables of a side of the placement matrix: the count of cells
+ * out of the board, the count of cells occupied by a footprint and the sum of the keep
+ * out costs of the cells, above and left of each cell.  A rectangle of the matrix is
+ * then tested in constant time.
+ */
+class PLACEMENT_AREA
+{
+public:
+    PLACEMENT_AREA() : m_stride( 0 ) {}
 
-    if( RoutingMatrix.m_RoutingLayersCount > 1 )
+    void Build( int aSide )
     {
-        LSET    other( aModule->GetLayer() == B_Cu  ? F_Cu : B_Cu );
+        int rows = RoutingMatrix.m_Nrows;
+        int cols = RoutingMatrix.m_Ncols;
 
-        for( D_PAD* pad = aModule->PadsList(); pad; pad = pad->Next() )
-        {
-            if( !( pad->GetLayerSet() & other ).any() )
-                continue;
+        m_stride = cols + 1;
+        m_outOfBoard.assign( ( rows + 1 ) * m_stride, 0 );
+        m_modules.assign( ( rows + 1 ) * m_stride, 0 );
+        m_keepOut.assign( ( rows + 1 ) * m_stride, 0 );
 
-            TstOtherSide = true;
-            break;
-        }
-    }
+        for( int row = 0; row < rows; row++ )
+        {
+            unsigned  outOfBoard = 0;
+            unsigned  modules = 0;
+            long long keepOut = 0;
 
-    // Draw the initial bounding box position
-    COLOR4D color = COLOR4D( BROWN );
-    fpBBox.SetOrigin( fpBBoxOrg + CurrPosition );
-    draw_FootprintRect(aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color);
+            for( int col = 0; col < cols; col++ )
+            {
+                MATRIX_CELL data = RoutingMatrix.GetCell( row, col, aSide );
 
-    min_cost = -1.0;
-    aFrame->SetStatusText( wxT( "Score ??, pos ??" ) );
+                outOfBoard += ( data & CELL_is_ZONE ) == 0;
+                modules += ( data & CELL_is_MODULE ) != 0;
+                keepOut += RoutingMatrix.GetDist( row, col, aSide );
 
-    for( ; CurrPosition.x < xylimit.x; CurrPosition.x += RoutingMatrix.m_GridRouting )
-    {
-        wxYield();
+                int ii = ( row + 1 ) * m_stride + col + 1;
 
-        if( aFrame->GetCanvas()->GetAbortRequest() )
-        {
-            if( IsOK( aFrame, _( "OK to abort?" ) ) )
-            {
-                displ_opts->m_Show_Module_Ratsnest = showRats;
-                return ESC;
+                m_outOfBoard[ii] = m_outOfBoard[ii - m_stride] + outOfBoard;
+                m_modules[ii] = m_modules[ii - m_stride] + modules;
+                m_keepOut[ii] = m_keepOut[ii - m_stride] + keepOut;
             }
-            else
-                aFrame->GetCanvas()->SetAbortRequest( false );
         }
+    }
 
-        CurrPosition.y = initialPos.y;
+    /* Test if the rectangular area aRect:
+     * - is a free zone (otherwise returns OCCUPED_By_MODULE)
+     * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
+     *
+     * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+     */
+    int TstRectangle( const EDA_RECT& aRect ) const
+    {
+        EDA_RECT rect = aRect;
+        int      row_min, row_max, col_min, col_max;
 
-        for( ; CurrPosition.y < xylimit.y; CurrPosition.y += RoutingMatrix.m_GridRouting )
-        {
-            // Erase traces.
-            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+        rect.Inflate( RoutingMatrix.m_GridRouting / 2 );
 
-            fpBBox.SetOrigin( fpBBoxOrg + CurrPosition );
-            g_Offset_Module = mod_pos - CurrPosition;
-            int keepOutCost = TstModuleOnBoard( brd, aModule, TstOtherSide );
+        if( !getRectCells( rect, row_min, row_max, col_min, col_max ) )
+            return FREE_CELL;
 
-            // Draw at new place
-            color = keepOutCost >= 0 ? BROWN : RED;
-            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+        if( sum( m_outOfBoard, row_min, row_max, col_min, col_max ) )
+            return OUT_OF_BOARD;
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
-            {
-                error = 0;
-                aFrame->build_ratsnest_module( aModule );
-                curr_cost   = compute_Ratsnest_PlaceModule( brd );
-                Score       = curr_cost + keepOutCost;
+        if( sum( m_modules, row_min, row_max, col_min, col_max ) )
+            return OCCUPED_By_MODULE;
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
-                {
-                    LastPosOK   = CurrPosition;
-                    min_cost    = Score;
-                    wxString msg;
-                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    aFrame->SetStatusText( msg );
-                }
-            }
-        }
+        return FREE_CELL;
     }
 
-    // erasing the last traces
-    GRRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, 0, BROWN );
+    /* Calculates and returns the clearance area of the rectangular surface aRect:
+     * (Sum of cells in terms of distance)
+     */
+    unsigned int KeepOutArea( const EDA_RECT& aRect ) const
+    {
+        int row_min, row_max, col_min, col_max;
 
-    displ_opts->m_Show_Module_Ratsnest = showRats;
+        if( !getRectCells( aRect, row_min, row_max, col_min, col_max ) )
+            return 0;
 
-    // Regeneration of the modified variable.
-    CurrPosition = LastPosOK;
+        return (unsigned int) sum( m_keepOut, row_min, row_max, col_min, col_max );
+    }
 
-    brd->m_Status_Pcb &= ~( RATSNEST_ITEM_LOCAL_OK | LISTE_PAD_OK );
+private:
+    template <typename T>
+    T sum( const std::vector<T>& aTable, int aRowMin, int aRowMax,
+           int aColMin, int aColMax ) const
+    {
+        int top = aRowMin * m_stride;
+        int bottom = ( aRowMax + 1 ) * m_stride;
 
-    MinCout = min_cost;
-    return error;
-}
+        return aTable[bottom + aColMax + 1] - aTable[top + aColMax + 1]
+               - aTable[bottom + aColMin] + aTable[top + aColMin];
+    }
 
+    int                     m_stride;
+    std::vector<unsigned>   m_outOfBoard;
+    std::vector<unsigned>   m_modules;
+    std::vector<long long>  m_keepOut;
+};
 
-/* Test if the rectangular area (ux, ux .. y0, y1):
- * - is a free zone (except OCCUPED_By_MODULE returns)
- * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
- *
- * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+
+/**
+ * Class PLACEMENT_SCORER
+ * computes the cost of the candidate positions of a footprint: the keep out cost of the
+ * area it covers, plus the cost of its ratsnest to the other footprints, as the local
+ * ratsnest would give it.  Everything needed is copied from the board and the matrix
+ * when the scorer is built, so the positions can be scored concurrently.
  */
-int TstRectangle( BOARD* Pcb, const EDA_RECT& aRect, int side )
+class PLACEMENT_SCORER
 {
-    EDA_RECT rect = aRect;
-
-    rect.Inflate( RoutingMatrix.m_GridRouting / 2 );
+public:
+    PLACEMENT_SCORER( MODULE* aModule, bool aTstOtherSide );
+
+    /**
+     * Function Score
+     * @param aPosition = the candidate position of the footprint
+     * @param aBound = the score to beat.  When the score of the position is surely
+     *                 greater, it is not computed and a lower bound is returned instead.
+     * @param aScore = the score of the position, or its lower bound
+     * @return false if the footprint cannot be placed at aPosition
+     */
+    bool Score( const wxPoint& aPosition, double aBound, double& aScore ) const;
 
-    wxPoint start   = rect.GetOrigin();
-    wxPoint end     = rect.GetEnd();
+private:
+    struct EXTERNAL_PAD
+    {
+        wxPoint m_pos;
+        bool    m_inBoard;      // its footprint is inside the board area
+    };
 
-    start   -= RoutingMatrix.m_BrdBox.GetOrigin();
-    end     -= RoutingMatrix.m_BrdBox.GetOrigin();
+    struct PLACEMENT_NET
+    {
+        std::vector<wxPoint>        m_padOffsets;   // pads relative to the footprint position
+        std::vector<EXTERNAL_PAD>   m_externalPads;
+        EDA_RECT                    m_padsBox;      // bounding box of m_padOffsets
+        EDA_RECT                    m_externalBox;  // bounding box of m_externalPads
+        bool                        m_hasBound;     // all m_externalPads are in the board
+    };
+
+    double ratsnestCost( const wxPoint& aPosition ) const;
+    double ratsnestLowerBound( const wxPoint& aPosition ) const;
+
+    EDA_RECT                    m_fpRect;       // relative to the footprint position
+    int                         m_marge;
+    bool                        m_tstOtherSide;
+    int                         m_connectedPads;
+    PLACEMENT_AREA              m_area;
+    PLACEMENT_AREA              m_otherSideArea;
+    std::vector<PLACEMENT_NET>  m_nets;
+};
 
-    int row_min = start.y / RoutingMatrix.m_GridRouting;
-    int row_max = end.y / RoutingMatrix.m_GridRouting;
-    int col_min = start.x / RoutingMatrix.m_GridRouting;
-    int col_max = end.x / RoutingMatrix.m_GridRouting;
 
-    if( start.y > row_min * RoutingMatrix.m_GridRouting )
-        row_min++;
+PLACEMENT_SCORER::PLACEMENT_SCORER( MODULE* aModule, bool aTstOtherSide ) :
+    m_tstOtherSide( aTstOtherSide ),
+    m_connectedPads( 0 )
+{
+    int side = TOP;
+    int otherside = BOTTOM;
 
-    if( start.x > col_min * RoutingMatrix.m_GridRouting )
-        col_min++;
+    if( aModule->GetLayer() == B_Cu )
+    {
+        side = BOTTOM; otherside = TOP;
+    }
 
-    if( row_min < 0 )
-        row_min = 0;
+    m_fpRect = aModule->GetFootprintRect();
+    m_fpRect.Move( -aModule->GetPosition() );
+    m_marge = ( RoutingMatrix.m_GridRouting * aModule->GetPadCount() ) / GAIN;
 
-    if( row_max >= ( RoutingMatrix.m_Nrows - 1 ) )
-        row_max = RoutingMatrix.m_Nrows - 1;
+    m_area.Build( side );
 
-    if( col_min < 0 )
-        col_min = 0;
+    if( m_tstOtherSide )
+        m_otherSideArea.Build( otherside );
 
-    if( col_max >= ( RoutingMatrix.m_Ncols - 1 ) )
-        col_max = RoutingMatrix.m_Ncols - 1;
+    // Collect the pads of each net, like build_ratsnest_module() does
+    std::map<int, PLACEMENT_NET> nets;
 
-    for( int row = row_min; row <= row_max; row++ )
+    for( D_PAD* pad = aModule->PadsList(); pad; pad = pad->Next() )
     {
-        for( int col = col_min; col <= col_max; col++ )
+        if( pad->GetNetCode() == NETINFO_LIST::UNCONNECTED )
+            continue;
+
+        if( !( pad->GetLayerSet() & LSET::AllCuMask() ).any() )
+            continue;
+
+        m_connectedPads++;
+
+        bool           newNet = nets.find( pad->GetNetCode() ) == nets.end();
+        PLACEMENT_NET& net = nets[pad->GetNetCode()];
+
+        net.m_padOffsets.push_back( pad->GetPosition() - aModule->GetPosition() );
+
+        if( !newNet || !pad->GetNet() )
+            continue;
+
+        for( D_PAD* external : pad->GetNet()->m_PadInNetList )
         {
-            unsigned int data = RoutingMatrix.GetCell( row, col, side );
+            if( external->GetParent() == aModule )
+                continue;
 
-            if( ( data & CELL_is_ZONE ) == 0 )
-                return OUT_OF_BOARD;
+            EXTERNAL_PAD ext;
 
-            if( (data & CELL_is_MODULE) )
-                return OCCUPED_By_MODULE;
+            ext.m_pos = external->GetPosition();
+            ext.m_inBoard = RoutingMatrix.m_BrdBox.Contains( external->GetParent()->GetPosition() );
+            net.m_externalPads.push_back( ext );
         }
     }
 
-    return FREE_CELL;
+    for( auto& entry : nets )
+    {
+        PLACEMENT_NET& net = entry.second;
+
+        if( net.m_externalPads.empty() )
+            continue;
+
+        net.m_padsBox = EDA_RECT( net.m_padOffsets[0], wxSize( 0, 0 ) );
+
+        for( const wxPoint& offset : net.m_padOffsets )
+            net.m_padsBox.Merge( offset );
+
+        net.m_externalBox = EDA_RECT( net.m_externalPads[0].m_pos, wxSize( 0, 0 ) );
+        net.m_hasBound = true;
+
+        for( const EXTERNAL_PAD& ext : net.m_externalPads )
+        {
+            net.m_externalBox.Merge( ext.m_pos );
+            net.m_hasBound &= ext.m_inBoard;
+        }
+
+        m_nets.push_back( net );
+    }
 }
 
 
-/* Calculates and returns the clearance area of the rectangular surface
- * aRect):
- * (Sum of cells in terms of distance)
- */
-unsigned int CalculateKeepOutArea( const EDA_RECT& aRect, int side )
+bool PLACEMENT_SCORER::Score( const wxPoint& aPosition, double aBound, double& aScore ) const
 {
-    wxPoint start   = aRect.GetOrigin();
-    wxPoint end     = aRect.GetEnd();
+    EDA_RECT fpBBox = m_fpRect;
 
-    start   -= RoutingMatrix.m_BrdBox.GetOrigin();
-    end     -= RoutingMatrix.m_BrdBox.GetOrigin();
+    fpBBox.Move( aPosition );
 
-    int row_min = start.y / RoutingMatrix.m_GridRouting;
-    int row_max = end.y / RoutingMatrix.m_GridRouting;
-    int col_min = start.x / RoutingMatrix.m_GridRouting;
-    int col_max = end.x / RoutingMatrix.m_GridRouting;
+    if( m_area.TstRectangle( fpBBox ) != FREE_CELL )
+        return false;
 
-    if( start.y > row_min * RoutingMatrix.m_GridRouting )
-        row_min++;
+    if( m_tstOtherSide && m_otherSideArea.TstRectangle( fpBBox ) != FREE_CELL )
+        return false;
 
-    if( start.x > col_min * RoutingMatrix.m_GridRouting )
-        col_min++;
+    fpBBox.Inflate( m_marge );
 
-    if( row_min < 0 )
-        row_min = 0;
+    int keepOutCost = m_area.KeepOutArea( fpBBox );
 
-    if( row_max >= ( RoutingMatrix.m_Nrows - 1 ) )
-        row_max = RoutingMatrix.m_Nrows - 1;
+    if( !m_connectedPads )
+    {
+        aScore = keepOutCost - 1;   // no local ratsnest
+        return true;
+    }
 
-    if( col_min < 0 )
-        col_min = 0;
+    aScore = keepOutCost + ratsnestLowerBound( aPosition );
+
+    if( aScore > aBound )
+        return true;
+
+    aScore = keepOutCost + ratsnestCost( aPosition );
+    return true;
+}
 
-    if( col_max >= ( RoutingMatrix.m_Ncols - 1 ) )
-        col_max = RoutingMatrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
+/*
+ * The cost is the sum of the ratsnest distances, one for each net, with penalty for
+ * connections approaching 45 degrees.
+ */
+double PLACEMENT_SCORER::ratsnestCost( const wxPoint& aPosition ) const
+{
+    double curr_cost = 0;
 
-    for( int row = row_min; row <= row_max; row++ )
+    for( const PLACEMENT_NET& net : m_nets )
     {
-        for( int col = col_min; col <= col_max; col++ )
+        const EXTERNAL_PAD* end = NULL;
+        wxPoint             start;
+        int                 length = INT_MAX;
+
+        // Search the nearest external pad of the footprint pads
+        for( const wxPoint& offset : net.m_padOffsets )
         {
-            // RoutingMatrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += RoutingMatrix.GetDist( row, col, side );
+            wxPoint pad_pos = offset + aPosition;
+
+            for( const EXTERNAL_PAD& ext : net.m_externalPads )
+            {
+                int distance = abs( ext.m_pos.x - pad_pos.x ) + abs( ext.m_pos.y - pad_pos.y );
+
+                if( distance < length )
+                {
+                    end = &ext;
+                    start = pad_pos;
+                    length = distance;
+                }
+            }
         }
+
+        // Skip modules not inside the board area
+        if( !end || !end->m_inBoard )
+            continue;
+
+        int dx = abs( end->m_pos.x - start.x );
+        int dy = abs( end->m_pos.y - start.y );
+
+        // ttry to have always dx >= dy to calculate the cost of the rastsnet
+        if( dx < dy )
+            std::swap( dx, dy );
+
+        // Cost of the connection = length + penalty due to the slope
+        // dx is the biggest length relative to the X or Y axis
+        // the penalty is max for 45 degrees ratsnests,
+        // and 0 for horizontal or vertical ratsnests.
+        // For Horizontal and Vertical ratsnests, dy = 0;
+        double conn_cost = hypot( dx, dy * 2.0 );
+        curr_cost += conn_cost;    // Total cost = sum of costs of each connection
     }
 
-    return keepOutCost;
+    return curr_cost;
 }
 
 
-/* Test if the module can be placed on the board.
- * Returns the value TstRectangle().
- * Module is known by its bounding box
+/*
+ * A connection costs at least the euclidean distance of its pads, so a net costs at
+ * least the distance between the bounding boxes of its pads.
  */
-int TstModuleOnBoard( BOARD* Pcb, MODULE* aModule, bool TstOtherSide )
+double PLACEMENT_SCORER::ratsnestLowerBound( const wxPoint& aPosition ) const
 {
-    int side = TOP;
-    int otherside = BOTTOM;
+    double bound = 0;
 
-    if( aModule->GetLayer() == B_Cu )
+    for( const PLACEMENT_NET& net : m_nets )
     {
-        side = BOTTOM; otherside = TOP;
+        if( !net.m_hasBound )
+            continue;
+
+        const EDA_RECT& ext = net.m_externalBox;
+        int left = net.m_padsBox.GetX() + aPosition.x;
+        int right = net.m_padsBox.GetRight() + aPosition.x;
+        int top = net.m_padsBox.GetY() + aPosition.y;
+        int bottom = net.m_padsBox.GetBottom() + aPosition.y;
+
+        int gapX = std::max( 0, std::max( ext.GetX() - right, left - ext.GetRight() ) );
+        int gapY = std::max( 0, std::max( ext.GetY() - bottom, top - ext.GetBottom() ) );
+
+        bound += hypot( gapX, gapY );
     }
 
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
-    fpBBox.Move( -g_Offset_Module );
+    return bound;
+}
 
-    int         diag = TstRectangle( Pcb, fpBBox, side );
 
-    if( diag != FREE_CELL )
-        return diag;
+/**
+ * Struct PLACEMENT_CANDIDATE
+ * is a scored position.  Between positions of same score, the last one in the scan
+ * order, columns then rows, wins.
+ */
+struct PLACEMENT_CANDIDATE
+{
+    wxPoint m_Pos;
+    double  m_Score;
+    long    m_Index;    // rank in the scan order, -1 if no position
 
-    if( TstOtherSide )
+    PLACEMENT_CANDIDATE() : m_Score( 0.0 ), m_Index( -1 ) {}
+
+    bool IsBetterThan( const PLACEMENT_CANDIDATE& aOther ) const
     {
-        diag = TstRectangle( Pcb, fpBBox, otherside );
+        if( aOther.m_Index < 0 )
+            return m_Index >= 0;
 
-        if( diag != FREE_CELL )
-            return diag;
+        return m_Score < aOther.m_Score
+               || ( m_Score == aOther.m_Score && m_Index > aOther.m_Index );
     }
+};
 
-    int marge = ( RoutingMatrix.m_GridRouting * aModule->GetPadCount() ) / GAIN;
 
-    fpBBox.Inflate( marge );
-    return CalculateKeepOutArea( fpBBox, side );
-}
+int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aDC )
+{
+    bool    TstOtherSide;
+    DISPLAY_OPTIONS* displ_opts = (DISPLAY_OPTIONS*)aFrame->GetDisplayOptions();
+    BOARD*  brd = aFrame->GetBoard();
 
+    aModule->CalculateBoundingBox();
 
-double compute_Ratsnest_PlaceModule( BOARD* aBrd )
-{
-    double  curr_cost;
-    wxPoint start;      // start point of a ratsnest
-    wxPoint end;        // end point of a ratsnest
-    int     dx, dy;
+    bool showRats = displ_opts->m_Show_Module_Ratsnest;
+    displ_opts->m_Show_Module_Ratsnest = false;
 
-    if( ( aBrd->m_Status_Pcb & RATSNEST_ITEM_LOCAL_OK ) == 0 )
-        return -1;
+    brd->m_Status_Pcb &= ~RATSNEST_ITEM_LOCAL_OK;
+    aFrame->SetMsgPanel( aModule );
 
-    curr_cost = 0;
+    wxPoint     mod_pos = aModule->GetPosition();
+    EDA_RECT    fpBBox  = aModule->GetFootprintRect();
 
-    for( unsigned ii = 0; ii < aBrd->m_LocalRatsnest.size(); ii++ )
+    // Move fpBBox to have the footprint position at (0,0)
+    fpBBox.Move( -mod_pos );
+    wxPoint fpBBoxOrg = fpBBox.GetOrigin();
+
+    // Calculate the limit of the footprint position, relative
+    // to the routing matrix area
+    wxPoint xylimit = RoutingMatrix.m_BrdBox.GetEnd() - fpBBox.GetEnd();
+
+    wxPoint initialPos = RoutingMatrix.m_BrdBox.GetOrigin() - fpBBoxOrg;
+
+    // Stay on grid.
+    initialPos.x    -= initialPos.x % RoutingMatrix.m_GridRouting;
+    initialPos.y    -= initialPos.y % RoutingMatrix.m_GridRouting;
+
+    CurrPosition = initialPos;
+
+    // Undraw the current footprint
+    aModule->DrawOutlinesWhenMoving( aFrame->GetCanvas(), aDC, wxPoint( 0, 0 ) );
+
+    g_Offset_Module = mod_pos - CurrPosition;
+
+    /* Examine pads, and set TstOtherSide to true if a footprint
+     * has at least 1 pad through.
+     */
+    TstOtherSide = false;
+
+    if( RoutingMatrix.m_RoutingLayersCount > 1 )
     {
-        RATSNEST_ITEM* pt_local_rats_nest = &aBrd->m_LocalRatsnest[ii];
+        LSET    other( aModule->GetLayer() == B_Cu  ? F_Cu : B_Cu );
 
-        if( ( pt_local_rats_nest->m_Status & LOCAL_RATSNEST_ITEM ) )
-            continue; // Skip ratsnest between 2 pads of the current module
+        for( D_PAD* pad = aModule->PadsList(); pad; pad = pad->Next() )
+        {
+            if( !( pad->GetLayerSet() & other ).any() )
+                continue;
 
-        // Skip modules not inside the board area
-        MODULE* module = pt_local_rats_nest->m_PadEnd->GetParent();
+            TstOtherSide = true;
+            break;
+        }
+    }
 
-        if( !RoutingMatrix.m_BrdBox.Contains( module->GetPosition() ) )
-            continue;
+    // Build the pad lists of the nets, if needed, and the local ratsnest
+    aFrame->build_ratsnest_module( aModule );
 
-        start   = pt_local_rats_nest->m_PadStart->GetPosition() - g_Offset_Module;
-        end     = pt_local_rats_nest->m_PadEnd->GetPosition();
+    PLACEMENT_SCORER scorer( aModule, TstOtherSide );
 
-        // Cost of the ratsnest.
-        dx  = end.x - start.x;
-        dy  = end.y - start.y;
+    int grid = RoutingMatrix.m_GridRouting;
+    int colCount = std::max( 0, ( xylimit.x - initialPos.x + grid - 1 ) / grid );
+    int rowCount = std::max( 0, ( xylimit.y - initialPos.y + grid - 1 ) / grid );
 
-        dx  = abs( dx );
-        dy  = abs( dy );
+    // Draw the initial bounding box position
+    COLOR4D color = COLOR4D( BROWN );
+    fpBBox.SetOrigin( fpBBoxOrg + CurrPosition );
+    draw_FootprintRect(aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color);
 
-        // ttry to have always dx >= dy to calculate the cost of the rastsnet
-        if( dx < dy )
-            std::swap( dx, dy );
+    PLACEMENT_CANDIDATE best;
+    aFrame->SetStatusText( wxT( "Score ??, pos ??" ) );
 
-        // Cost of the connection = length + penalty due to the slope
-        // dx is the biggest length relative to the X or Y axis
-        // the penalty is max for 45 degrees ratsnests,
-        // and 0 for horizontal or vertical ratsnests.
-        // For Horizontal and Vertical ratsnests, dy = 0;
-        double conn_cost = hypot( dx, dy * 2.0 );
-        curr_cost += conn_cost;    // Total cost = sum of costs of each connection
+    // The columns are scored concurrently, by batches: between them the display is
+    // refreshed and the abort request tested.
+    const int batchSize = 32;
+
+    for( int firstCol = 0; firstCol < colCount; firstCol += batchSize )
+    {
+        wxYield();
+
+        if( aFrame->GetCanvas()->GetAbortRequest() )
+        {
+            if( IsOK( aFrame, _( "OK to abort?" ) ) )
+            {
+                displ_opts->m_Show_Module_Ratsnest = showRats;
+                return ESC;
+            }
+            else
+                aFrame->GetCanvas()->SetAbortRequest( false );
+        }
+
+        int                 lastCol = std::min( colCount, firstCol + batchSize );
+        PLACEMENT_CANDIDATE batchBest = best;
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for( int col = firstCol; col < lastCol; col++ )
+        {
+            PLACEMENT_CANDIDATE colBest = best;
+
+            for( int row = 0; row < rowCount; row++ )
+            {
+                PLACEMENT_CANDIDATE candidate;
+
+                candidate.m_Pos = wxPoint( initialPos.x + col * grid, initialPos.y + row * grid );
+
+                double bound = colBest.m_Index < 0 ? DBL_MAX : colBest.m_Score;
+
+                if( !scorer.Score( candidate.m_Pos, bound, candidate.m_Score ) )
+                    continue;
+
+                candidate.m_Index = long( col ) * rowCount + row;
+
+                if( candidate.IsBetterThan( colBest ) )
+                    colBest = candidate;
+            }
+
+            #pragma omp critical
+            {
+                if( colBest.IsBetterThan( batchBest ) )
+                    batchBest = colBest;
+            }
+        }
+
+        if( batchBest.m_Index == best.m_Index )
+            continue;
+
+        best = batchBest;
+
+        // Erase traces, and draw at the new best place
+        draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+        fpBBox.SetOrigin( fpBBoxOrg + best.m_Pos );
+        draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+
+        wxString msg;
+        msg.Printf( wxT( "Score %g, pos %s, %s" ),
+                    best.m_Score,
+                    GetChars( ::CoordinateToString( best.m_Pos.x ) ),
+                    GetChars( ::CoordinateToString( best.m_Pos.y ) ) );
+        aFrame->SetStatusText( msg );
     }
 
-    return curr_cost;
+    // erasing the last traces
+    GRRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, 0, BROWN );
+
+    displ_opts->m_Show_Module_Ratsnest = showRats;
+
+    // Regeneration of the modified variable.
+    CurrPosition = best.m_Index < 0 ? RoutingMatrix.m_BrdBox.GetOrigin() : best.m_Pos;
+    g_Offset_Module = mod_pos - CurrPosition;
+
+    brd->m_Status_Pcb &= ~( RATSNEST_ITEM_LOCAL_OK | LISTE_PAD_OK );
+
+    MinCout = best.m_Index < 0 ? -1.0 : best.m_Score;
+    return best.m_Index < 0 ? 1 : 0;
 }
 
 
@@ -100,15 +100,15 @@ struct AUTOROUTER_CONTEXT
 /**
  * class MATRIX_ROUTING_HEAD
  * handle the matrix routing that describes the actual board
+ *
+ * The cell, distance and direction of a point of the grid are read together while
+ * routing, so they are stored together, for the routed sides only.  A point holds
+ * m_RoutingLayersCount distances, then as many cells and directions, and is padded to
+ * the size of a distance: 8 bytes for one side, 12 bytes for two sides.
  */
 class MATRIX_ROUTING_HEAD
 {
 public:
-    MATRIX_CELL* m_BoardSide[MAX_ROUTING_LAYERS_COUNT]; // the image map of 2 board sides
-    DIST_CELL*   m_DistSide[MAX_ROUTING_LAYERS_COUNT];  // the image map of 2 board sides:
-                                                        // distance to cells
-    DIR_CELL*    m_DirSide[MAX_ROUTING_LAYERS_COUNT];   // the image map of 2 board sides:
-                                                        // pointers back to source
     bool         m_InitMatrixDone;
     int          m_RoutingLayersCount;          // Number of layers for autorouting (0 or 1)
     int          m_GridRouting;                 // Size of grid for autoplace/autoroute
@@ -118,6 +118,32 @@ public:
     int          m_RouteCount;                  // Number of routes
 
 private:
+    void*        m_cellsBuffer;                 // the allocated memory of m_points
+    char*        m_points;                      // the matrix, row by row, cache line aligned
+    int          m_pointSize;                   // size of a point, in bytes
+    int          m_cellOffset;                  // offset of the cells in a point
+    int          m_dirOffset;                   // offset of the directions in a point
+
+    char* point( int aRow, int aCol )
+    {
+        return m_points + ( aRow * m_Ncols + aCol ) * m_pointSize;
+    }
+
+    DIST_CELL& dist( int aRow, int aCol, int aSide )
+    {
+        return ( (DIST_CELL*) point( aRow, aCol ) )[aSide];
+    }
+
+    MATRIX_CELL& cell( int aRow, int aCol, int aSide )
+    {
+        return ( (MATRIX_CELL*) ( point( aRow, aCol ) + m_cellOffset ) )[aSide];
+    }
+
+    DIR_CELL& dir( int aRow, int aCol, int aSide )
+    {
+        return ( (DIR_CELL*) ( point( aRow, aCol ) + m_dirOffset ) )[aSide];
+    }
+
     // a pointer to the current selected cell operation
     void        (MATRIX_ROUTING_HEAD::* m_opWriteCell)( int aRow, int aCol,
                                                         int aSide, MATRIX_CELL aCell);
@@ -153,7 +179,7 @@ public:
 
     /**
      * Function InitBoard
-     * initializes the data structures.
+     * initializes the data structures, for m_RoutingLayersCount sides.
      *
      * @return the amount of memory used or -1 if default.
      */
@@ -161,20 +187,72 @@ public:
 
     void UnInitRoutingMatrix();
 
+    /**
+     * Function CopyBoardSide
+     * copies the cells (not the distances and directions) of a board side to the other one.
+     */
+    void CopyBoardSide( int aFromSide, int aToSide );
+
+    /**
+     * Function ClearDirections
+     * resets the directions of all the points to FROM_NOWHERE, before routing a track.
+     * @param aBothSides = false to clear only the BOTTOM side
+     */
+    void ClearDirections( bool aBothSides );
+
     // Initialize WriteCell to make the aLogicOp
     void SetCellOperation( int aLogicOp );
 
     // functions to read/write one cell ( point on grid routing matrix:
-    MATRIX_CELL GetCell( int aRow, int aCol, int aSide);
-    void SetCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell);
-    void OrCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell);
-    void XorCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell);
-    void AndCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell);
-    void AddCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell);
-    DIST_CELL GetDist( int aRow, int aCol, int aSide );
-    void SetDist( int aRow, int aCol, int aSide, DIST_CELL );
-    int GetDir( int aRow, int aCol, int aSide );
-    void SetDir( int aRow, int aCol, int aSide, int aDir);
+    MATRIX_CELL GetCell( int aRow, int aCol, int aSide)
+    {
+        return cell( aRow, aCol, aSide );
+    }
+
+    void SetCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell)
+    {
+        cell( aRow, aCol, aSide ) = aCell;
+    }
+
+    void OrCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell)
+    {
+        cell( aRow, aCol, aSide ) |= aCell;
+    }
+
+    void XorCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell)
+    {
+        cell( aRow, aCol, aSide ) ^= aCell;
+    }
+
+    void AndCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell)
+    {
+        cell( aRow, aCol, aSide ) &= aCell;
+    }
+
+    void AddCell( int aRow, int aCol, int aSide, MATRIX_CELL aCell)
+    {
+        cell( aRow, aCol, aSide ) += aCell;
+    }
+
+    DIST_CELL GetDist( int aRow, int aCol, int aSide )
+    {
+        return dist( aRow, aCol, aSide );
+    }
+
+    void SetDist( int aRow, int aCol, int aSide, DIST_CELL aDist )
+    {
+        dist( aRow, aCol, aSide ) = aDist;
+    }
+
+    int GetDir( int aRow, int aCol, int aSide )
+    {
+        return (int) dir( aRow, aCol, aSide );
+    }
+
+    void SetDir( int aRow, int aCol, int aSide, int aDir)
+    {
+        dir( aRow, aCol, aSide ) = (DIR_CELL) aDir;
+    }
 
     // calculate distance (with penalty) of a trace through a cell
     int CalcDist(int x,int y,int z ,int side );
@@ -27,7 +27,6 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-
 /**
  * @file queue.cpp
  */
@@ -35,6 +34,12 @@
 #include <fctsys.h>
 #include <common.h>
 
+#include <deque>
+#include <map>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
 #include <pcbnew.h>
 #include <autorout.h>
 #include <cell.h>
@@ -42,47 +47,148 @@
 
 struct PcbQueue /* search queue structure */
 {
-    struct PcbQueue* Next;
     int              Row;       /* current row                  */
     int              Col;       /* current column               */
     int              Side;      /* 0=top, 1=bottom              */
     int              Dist;      /* path distance to this cell so far        */
     int              ApxDist;   /* approximate distance to target from here */
+    bool             Goal;      /* the target cell                          */
+    long             Id;        /* insertion number                         */
 };
 
-static long             qlen = 0;   /* current queue length */
-static struct PcbQueue* Head = NULL;
-static struct PcbQueue* Tail = NULL;
-static struct PcbQueue* Save = NULL;    /* hold empty queue structs */
+/* The search queue gives the nodes in the order of the sorted linked list it replaces:
+ * by estimated path length (Dist + ApxDist), and between nodes of same length:
+ *  - the head of the list is never moved by a new node of same length
+ *  - else a new node goes in front of the nodes of same length, unless the first one is
+ *    the target, then it goes just after the target.
+ * The head is kept apart, and the other nodes are in one list for each path length.
+ *
+ * A node removed by ReSetQueue is not searched in its list: it is only marked as removed,
+ * and dropped when met at the front of its list.
+ */
+static PcbQueue                             Head;
+static bool                                 HeadQueued = false;
+static std::map<int, std::deque<PcbQueue>>  Lists;      /* the other nodes, by path length */
+static std::vector<char>                    Queued;     /* false for removed nodes, by Id */
+static std::unordered_map<long, std::vector<PcbQueue>> CellNodes; /* queued nodes of a cell */
+static long                                 qlen = 0;   /* current queue length */
 
 
-/* Free the memory used for storing all the queue */
-void FreeQueue()
+static inline int pathLength( const PcbQueue& p )
 {
-    struct PcbQueue* p;
+    return p.Dist + p.ApxDist;
+}
 
-    InitQueue();
 
-    while( (p = Save) != NULL )
+static inline long cellKey( int r, int c, int s )
+{
+    return ( long( r ) * RoutingMatrix.m_Ncols + c ) * 2 + s;
+}
+
+
+/* mark a node as removed from the queue */
+static void removeNode( std::vector<PcbQueue>& aCellNodes, unsigned aIndex )
+{
+    Queued[aCellNodes[aIndex].Id] = false;
+    aCellNodes.erase( aCellNodes.begin() + aIndex );
+}
+
+
+/* drop the removed nodes at the front of a list */
+static void dropRemoved( std::deque<PcbQueue>& aList )
+{
+    while( !aList.empty() && !Queued[aList.front().Id] )
+        aList.pop_front();
+}
+
+
+/* make sure Head is the first node still queued, return false if the queue is empty */
+static bool updateHead()
+{
+    if( HeadQueued && Queued[Head.Id] )
+        return true;
+
+    HeadQueued = false;
+
+    while( !Lists.empty() )
     {
-        Save = p->Next;
-        delete p;
+        auto first = Lists.begin();
+
+        dropRemoved( first->second );
+
+        if( !first->second.empty() )
+        {
+            Head = first->second.front();
+            HeadQueued = true;
+            first->second.pop_front();
+        }
+
+        if( first->second.empty() )
+            Lists.erase( first );
+
+        if( HeadQueued )
+            return true;
     }
+
+    return false;
 }
 
 
-/* initialize the search queue */
-void InitQueue()
+/* return the index of the node of aNodes coming first out of the queue */
+static unsigned firstQueued( const std::vector<PcbQueue>& aNodes )
 {
-    struct PcbQueue* p;
+    unsigned first = 0;
+    int      count = 0;     /* nodes of the shortest length */
+
+    for( unsigned ii = 0; ii < aNodes.size(); ii++ )
+    {
+        if( HeadQueued && aNodes[ii].Id == Head.Id )
+            return ii;
 
-    while( (p = Head) != NULL )
+        if( ii == 0 || pathLength( aNodes[ii] ) < pathLength( aNodes[first] ) )
+        {
+            first = ii;
+            count = 1;
+        }
+        else if( pathLength( aNodes[ii] ) == pathLength( aNodes[first] ) )
+        {
+            count++;
+        }
+    }
+
+    if( count == 1 )
+        return first;
+
+    /* nodes of same length: the first one in their list */
+    for( const PcbQueue& node : Lists[pathLength( aNodes[first] )] )
     {
-        Head    = p->Next;
-        p->Next = Save; Save = p;
+        for( unsigned ii = 0; ii < aNodes.size(); ii++ )
+        {
+            if( aNodes[ii].Id == node.Id )
+                return ii;
+        }
     }
 
-    Tail = NULL;
+    return first;
+}
+
+
+/* Free the memory used for storing all the queue */
+void FreeQueue()
+{
+    InitQueue();
+    std::vector<char>().swap( Queued );
+    std::unordered_map<long, std::vector<PcbQueue>>().swap( CellNodes );
+}
+
+
+/* initialize the search queue */
+void InitQueue()
+{
+    HeadQueued = false;
+    Lists.clear();
+    Queued.clear();
+    CellNodes.clear();
     OpenNodes = ClosNodes = MoveNodes = MaxNodes = qlen = 0;
 }
 
@@ -90,19 +196,28 @@ void InitQueue()
 /* get search queue item from list */
 void GetQueue( int* r, int* c, int* s, int* d, int* a )
 {
-    struct PcbQueue* p;
-
-    if( (p = Head) != NULL )  /* return first item in list */
+    if( updateHead() )  /* return first item in list */
     {
-        *r = p->Row; *c = p->Col;
-        *s = p->Side;
-        *d = p->Dist; *a = p->ApxDist;
+        *r = Head.Row; *c = Head.Col;
+        *s = Head.Side;
+        *d = Head.Dist; *a = Head.ApxDist;
+
+        HeadQueued = false;
 
-        if( (Head = p->Next) == NULL )
-            Tail = NULL;
+        auto cell = CellNodes.find( cellKey( Head.Row, Head.Col, Head.Side ) );
+
+        for( unsigned ii = 0; ii < cell->second.size(); ii++ )
+        {
+            if( cell->second[ii].Id == Head.Id )
+            {
+                removeNode( cell->second, ii );
+                break;
+            }
+        }
+
+        if( cell->second.empty() )
+            CellNodes.erase( cell );
 
-        /* put node on free list */
-        p->Next = Save; Save = p;
         ClosNodes++; qlen--;
     }
     else /* empty list */
@@ -119,57 +234,46 @@ void GetQueue( int* r, int* c, int* s, int* d, int* a )
  */
 bool SetQueue( int r, int c, int side, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q, * t;
-    int i, j;
+    PcbQueue p;
 
-    j = 0;                      // gcc warning fix
+    p.Row     = r;
+    p.Col     = c;
+    p.Side    = side;
+    p.Dist    = d;
+    p.ApxDist = a;
+    p.Goal    = r == r2 && c == c2;
+    p.Id      = Queued.size();
 
-    if( (p = Save) != NULL )    /* try free list first */
+    try
     {
-        Save = p->Next;
-    }
-    else if( ( p = (PcbQueue*) operator new( sizeof( PcbQueue ), std::nothrow ) ) == NULL )
-    {
-        return 0;
-    }
-
-    p->Row  = r;
-    p->Col  = c;
-    p->Side = side;
-    i = (p->Dist = d) + (p->ApxDist = a);
-    p->Next = NULL;
+        Queued.push_back( true );
+        CellNodes[cellKey( r, c, side )].push_back( p );
 
-    if( (q = Head) != NULL ) /* insert in proper position in list */
-    {
-        if( q->Dist + q->ApxDist > i ) /* insert at head */
+        if( !updateHead() ) /* empty search list */
         {
-            p->Next = q; Head = p;
+            Head = p;
+            HeadQueued = true;
         }
-        else   /* search for proper position */
+        else if( pathLength( Head ) > pathLength( p ) ) /* insert at head */
         {
-            for( t = q, q = q->Next; q && i > ( j = q->Dist + q->ApxDist ); t = q, q = q->Next )
-                ;
-
-            if( q && i == j && q->Row == r2 && q->Col == c2 )
-            {
-                /* insert after q, which is a goal node */
-                if( ( p->Next = q->Next ) == NULL )
-                    Tail = p;
+            Lists[pathLength( Head )].push_front( Head );
+            Head = p;
+        }
+        else    /* insert in proper position in list */
+        {
+            std::deque<PcbQueue>& list = Lists[pathLength( p )];
 
-                q->Next = p;
-            }
-            else  /* insert in front of q */
-            {
-                if( ( p->Next = q ) == NULL )
-                    Tail = p;
+            dropRemoved( list );
 
-                t->Next = p;
-            }
+            if( !list.empty() && list.front().Goal )
+                list.insert( list.begin() + 1, p );     /* insert after the goal node */
+            else
+                list.push_front( p );
         }
     }
-    else /* empty search list */
+    catch( const std::bad_alloc& )
     {
-        Head = Tail = p;
+        return 0;
     }
 
     OpenNodes++;
@@ -184,35 +288,28 @@ bool SetQueue( int r, int c, int side, int d, int a, int r2, int c2 )
 /* reposition node in list */
 void ReSetQueue( int r, int c, int s, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q;
+    /* first, see if it is already in the list.  A cell can be queued more than once
+     * (the sources): the first one in the list is removed.
+     */
+    auto cell = CellNodes.find( cellKey( r, c, s ) );
 
-    /* first, see if it is already in the list */
-    for( q = NULL, p = Head; p; q = p, p = p->Next )
+    if( cell != CellNodes.end() )
     {
-        if( p->Row == r && p->Col == c && p->Side == s )
-        {
-            /* old one to remove */
-            if( q )
-            {
-                if( ( q->Next = p->Next ) == NULL )
-                    Tail = q;
-            }
-            else if( ( Head = p->Next ) == NULL )
-            {
-                Tail = NULL;
-            }
+        std::vector<PcbQueue>& nodes = cell->second;
 
-            p->Next = Save;
-            Save = p;
-            OpenNodes--;
-            MoveNodes++;
-            qlen--;
-            break;
-        }
-    }
+        removeNode( nodes, firstQueued( nodes ) );
+
+        if( nodes.empty() )
+            CellNodes.erase( cell );
 
-    if( !p )            /* not found, it has already been closed once */
+        OpenNodes--;
+        MoveNodes++;
+        qlen--;
+    }
+    else                /* not found, it has already been closed once */
+    {
         ClosNodes--;    /* we will close it again, but just count once */
+    }
 
     /* if it was there, it's gone now; insert it at the proper position */
     bool res = SetQueue( r, c, s, d, a, r2, c2 );
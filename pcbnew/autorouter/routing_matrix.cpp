@@ -33,6 +33,9 @@
 #include <fctsys.h>
 #include <common.h>
 
+#include <cstdint>
+#include <new>
+
 #include <pcbnew.h>
 #include <cell.h>
 #include <autorout.h>
@@ -48,9 +51,11 @@
 
 MATRIX_ROUTING_HEAD::MATRIX_ROUTING_HEAD()
 {
-    m_BoardSide[0] = m_BoardSide[1] = NULL;
-    m_DistSide[0] = m_DistSide[1] = NULL;
-    m_DirSide[0] = m_DirSide[1] = NULL;
+    m_cellsBuffer        = NULL;
+    m_points             = NULL;
+    m_pointSize          = 0;
+    m_cellOffset         = 0;
+    m_dirOffset          = 0;
     m_opWriteCell        = NULL;
     m_InitMatrixDone     = false;
     m_Nrows              = 0;
@@ -107,39 +112,30 @@ int MATRIX_ROUTING_HEAD::InitRoutingMatrix()
     // give a small margin for memory allocation:
     int ii = (RoutingMatrix.m_Nrows + 1) * (RoutingMatrix.m_Ncols + 1);
 
-    int side = BOTTOM;
-    for( int jj = 0; jj < m_RoutingLayersCount; jj++ )  // m_RoutingLayersCount = 1 or 2
-    {
-        m_BoardSide[side] = NULL;
-        m_DistSide[side]  = NULL;
-        m_DirSide[side]   = NULL;
-
-        // allocate matrix & initialize everything to empty
-        m_BoardSide[side] = (MATRIX_CELL*) operator new( ii * sizeof(MATRIX_CELL) );
-        memset( m_BoardSide[side], 0, ii * sizeof(MATRIX_CELL) );
+    // the distances, cells and directions of the routed sides (1 or 2), the point
+    // being padded to keep the distances aligned
+    int sides = m_RoutingLayersCount > 1 ? 2 : 1;
 
-        if( m_BoardSide[side] == NULL )
-            return -1;
+    m_cellOffset = sides * sizeof(DIST_CELL);
+    m_dirOffset  = m_cellOffset + sides * sizeof(MATRIX_CELL);
+    m_pointSize  = m_dirOffset + sides * sizeof(DIR_CELL);
+    m_pointSize  = ( m_pointSize + sizeof(DIST_CELL) - 1 ) / sizeof(DIST_CELL)
+                   * sizeof(DIST_CELL);
 
-        // allocate Distances
-        m_DistSide[side] = (DIST_CELL*) operator new( ii * sizeof(DIST_CELL) );
-        memset( m_DistSide[side], 0, ii * sizeof(DIST_CELL) );
+    // allocate matrix & initialize everything to empty.  The rows are read one after
+    // the other, so the matrix starts on a cache line.
+    const size_t cacheLine = 64;
 
-        if( m_DistSide[side] == NULL )
-            return -1;
+    m_cellsBuffer = operator new( ii * m_pointSize + cacheLine, std::nothrow );
 
-        // allocate Dir (chars)
-        m_DirSide[side] = (char*) operator new( ii );
-        memset( m_DirSide[side], 0, ii );
+    if( m_cellsBuffer == NULL )
+        return -1;
 
-        if( m_DirSide[side] == NULL )
-            return -1;
-
-        side = TOP;
-    }
+    m_points = (char*) ( ( (uintptr_t) m_cellsBuffer + cacheLine - 1 )
+                         & ~( uintptr_t )( cacheLine - 1 ) );
+    memset( m_points, 0, ii * m_pointSize );
 
-    m_MemSize = m_RouteCount * ii * ( sizeof(MATRIX_CELL)
-                + sizeof(DIST_CELL) + sizeof(char) );
+    m_MemSize = ii * m_pointSize;
 
     return m_MemSize;
 }
@@ -147,35 +143,40 @@ int MATRIX_ROUTING_HEAD::InitRoutingMatrix()
 
 void MATRIX_ROUTING_HEAD::UnInitRoutingMatrix()
 {
-    int ii;
-
     m_InitMatrixDone = false;
 
-    for( ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
+    operator delete( m_cellsBuffer );
+    m_cellsBuffer = NULL;
+    m_points = NULL;
+
+    m_Nrows = m_Ncols = 0;
+}
+
+
+void MATRIX_ROUTING_HEAD::CopyBoardSide( int aFromSide, int aToSide )
+{
+    for( int row = 0; row < m_Nrows; row++ )
     {
-        // de-allocate Dir matrix
-        if( m_DirSide[ii] )
-        {
-            delete m_DirSide[ii];
-            m_DirSide[ii] = NULL;
-        }
+        for( int col = 0; col < m_Ncols; col++ )
+            cell( row, col, aToSide ) = cell( row, col, aFromSide );
+    }
+}
 
-        // de-allocate Distances matrix
-        if( m_DistSide[ii] )
-        {
-            delete m_DistSide[ii];
-            m_DistSide[ii] = NULL;
-        }
 
-        // de-allocate cells matrix
-        if( m_BoardSide[ii] )
+void MATRIX_ROUTING_HEAD::ClearDirections( bool aBothSides )
+{
+    // Called before each track, so the rows of big boards are cleared in parallel
+    #pragma omp parallel for schedule(static) if( m_Nrows * m_Ncols > 65536 )
+    for( int row = 0; row < m_Nrows; row++ )
+    {
+        for( int col = 0; col < m_Ncols; col++ )
         {
-            delete m_BoardSide[ii];
-            m_BoardSide[ii] = NULL;
+            dir( row, col, BOTTOM ) = FROM_NOWHERE;
+
+            if( aBothSides )
+                dir( row, col, TOP ) = FROM_NOWHERE;
         }
     }
-
-    m_Nrows = m_Ncols = 0;
 }
 
 
@@ -439,109 +440,3 @@ void MATRIX_ROUTING_HEAD::SetCellOperation( int aLogicOp )
         break;
     }
 }
-
-
-/* return the value stored in a cell
- */
-MATRIX_CELL MATRIX_ROUTING_HEAD::GetCell( int aRow, int aCol, int aSide )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    return p[aRow * m_Ncols + aCol];
-}
-
-
-/* basic cell operation : WRITE operation
- */
-void MATRIX_ROUTING_HEAD::SetCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] = x;
-}
-
-
-/* basic cell operation : OR operation
- */
-void MATRIX_ROUTING_HEAD::OrCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] |= x;
-}
-
-
-/* basic cell operation : XOR operation
- */
-void MATRIX_ROUTING_HEAD::XorCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] ^= x;
-}
-
-
-/* basic cell operation : AND operation
- */
-void MATRIX_ROUTING_HEAD::AndCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] &= x;
-}
-
-
-/* basic cell operation : ADD operation
- */
-void MATRIX_ROUTING_HEAD::AddCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
-{
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] += x;
-}
-
-
-// fetch distance cell
-DIST_CELL MATRIX_ROUTING_HEAD::GetDist( int aRow, int aCol, int aSide ) // fetch distance cell
-{
-    DIST_CELL* p;
-
-    p = RoutingMatrix.m_DistSide[aSide];
-    return p[aRow * m_Ncols + aCol];
-}
-
-
-// store distance cell
-void MATRIX_ROUTING_HEAD::SetDist( int aRow, int aCol, int aSide, DIST_CELL x )
-{
-    DIST_CELL* p;
-
-    p = RoutingMatrix.m_DistSide[aSide];
-    p[aRow * m_Ncols + aCol] = x;
-}
-
-
-// fetch direction cell
-int MATRIX_ROUTING_HEAD::GetDir( int aRow, int aCol, int aSide )
-{
-    DIR_CELL* p;
-
-    p = RoutingMatrix.m_DirSide[aSide];
-    return (int) (p[aRow * m_Ncols + aCol]);
-}
-
-
-// store direction cell
-void MATRIX_ROUTING_HEAD::SetDir( int aRow, int aCol, int aSide, int x )
-{
-    DIR_CELL* p;
-
-    p = RoutingMatrix.m_DirSide[aSide];
-    p[aRow * m_Ncols + aCol] = (char) x;
-}
@@ -435,11 +435,7 @@ static int Autoroute_One_Track( AUTOROUTER_CONTEXT& ctx,
     marge = s_Clearance + ( ctx.pcbframe->GetDesignSettings().GetCurrentTrackWidth() / 2 );
 
     // clear direction flags
-    i = RoutingMatrix.m_Nrows * RoutingMatrix.m_Ncols * sizeof(DIR_CELL);
-
-    if( two_sides )
-        memset( RoutingMatrix.m_DirSide[TOP], FROM_NOWHERE, i );
-    memset( RoutingMatrix.m_DirSide[BOTTOM], FROM_NOWHERE, i );
+    RoutingMatrix.ClearDirections( two_sides );
 
     lastopen = lastclos = lastmove = 0;
 
@@ -799,6 +799,11 @@ void PCB_BASE_FRAME::OnModify()
     GetScreen()->SetModify();
     GetScreen()->SetSave();
 
+    // Items may have been moved or changed their layer, so the subnets of connected
+    // items have to be computed again
+    if( m_Pcb )
+        m_Pcb->m_Status_Pcb &= ~CONNEXION_OK;
+
     if( IsGalCanvasActive() )
     {
         UpdateStatusBar();
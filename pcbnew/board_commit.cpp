@@ -72,6 +72,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 #ifdef PCBNEW_WITH_TRACKITEMS
     board->TrackItems()->Teardrops()->UpdateListClear();
     board->TrackItems()->RoundedTracksCorners()->UpdateListClear();
+    board->TrackItems()->DRC_OnlineClear();
 #endif
 
     for( COMMIT_LINE& ent : m_changes )
@@ -147,12 +148,18 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 
 #ifdef PCBNEW_WITH_TRACKITEMS
                 board->TrackItems()->GalRouteCommitAdd( boardItem, &undoList );
+                if( !m_editModules )
+                    board->TrackItems()->DRC_OnlineAdd( boardItem );
 #endif
                 break;
             }
 
             case CHT_REMOVE:
             {
+#ifdef PCBNEW_WITH_TRACKITEMS
+                if( !m_editModules )
+                    board->TrackItems()->DRC_OnlineRemove( boardItem );
+#endif
                 if( !m_editModules && aCreateUndoEntry )
                 {
 #ifdef PCBNEW_WITH_TRACKITEMS
@@ -286,6 +293,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 #ifdef PCBNEW_WITH_TRACKITEMS
                 board->TrackItems()->Teardrops()->UpdateListAdd( boardItem );
                 board->TrackItems()->RoundedTracksCorners()->UpdateListAdd( boardItem );
+                if( !m_editModules )
+                    board->TrackItems()->DRC_OnlineModify( boardItem,
+                                                           static_cast<BOARD_ITEM*>( ent.m_copy ) );
 #endif
                 view->Update ( boardItem );
                 ratsnest->Update( boardItem );
@@ -301,6 +311,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry )
 #ifdef PCBNEW_WITH_TRACKITEMS
     board->TrackItems()->RoundedTracksCorners()->UpdateListDo();
     board->TrackItems()->Teardrops()->UpdateListDo();
+    board->TrackItems()->DRC_OnlineDo();
 #endif
 
     if( !m_editModules && aCreateUndoEntry )
@@ -390,8 +401,13 @@ void BOARD_COMMIT::Revert()
 #ifdef PCBNEW_WITH_TRACKITEMS
             board->TrackItems()->Teardrops()->UpdateListAdd( item );
             board->TrackItems()->RoundedTracksCorners()->UpdateListAdd( item );
+            //SwapData() gives new pads to modules.
+            board->TrackItems()->DRC_OnlineIndexRemove( item );
 #endif
             item->SwapData( copy );
+#ifdef PCBNEW_WITH_TRACKITEMS
+            board->TrackItems()->DRC_OnlineIndexAdd( item );
+#endif
 
             item->ClearFlags( SELECTED );
 
@@ -50,9 +50,10 @@
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
 // so we cannot send them as arguments.
-static int s_textWidth;
-static int s_textCircle2SegmentCount;
-static SHAPE_POLY_SET* s_cornerBuffer;
+// They are thread local, as the layers of a board can be converted concurrently.
+static thread_local int s_textWidth;
+static thread_local int s_textCircle2SegmentCount;
+static thread_local SHAPE_POLY_SET* s_cornerBuffer;
 
 // This is a call back function, used by DrawGraphicText to draw the 3D text shape:
 static void addTextSegmToPoly( int x0, int y0, int xf, int yf )
@@ -361,12 +362,12 @@ void ZONE_CONTAINER::TransformSolidAreasShapesToPolygonSet(
         return;
 
     // add filled areas polygons
-    aCornerBuffer.Append( m_FilledPolysList );
+    aCornerBuffer.Append( *m_FilledPolysList );
 
     // add filled areas outlines, which are drawn with thick lines
-    for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
+    for( int i = 0; i < m_FilledPolysList->OutlineCount(); i++ )
     {
-        const SHAPE_LINE_CHAIN& path = m_FilledPolysList.COutline( i );
+        const SHAPE_LINE_CHAIN& path = m_FilledPolysList->COutline( i );
 
         for( int j = 0; j < path.PointCount(); j++ )
         {
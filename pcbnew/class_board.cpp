@@ -899,6 +899,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
     // this one uses a vector
     case PCB_ZONE_AREA_T:
         m_ZoneDescriptorList.push_back( (ZONE_CONTAINER*) aBoardItem );
+        m_Status_Pcb &= ~CONNEXION_OK;
         break;
 
     case PCB_TRACE_T:
@@ -920,8 +921,12 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
 
 #ifdef PCBNEW_WITH_TRACKITEMS
         TrackItems()->NetCodeFirstTrackItem()->Insert( (TRACK*) aBoardItem );
+        TrackItems()->NetScanIndex()->Insert( (TRACK*) aBoardItem );
+        TrackItems()->DRC_OnlineIndexAdd( aBoardItem );
 #endif
 
+        // Subnets of connected items have to be computed again
+        m_Status_Pcb &= ~CONNEXION_OK;
         break;
 
     case PCB_ZONE_T:
@@ -941,6 +946,9 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         // Because the list of pads has changed, reset the status
         // This indicate the list of pad and nets must be recalculated before use
         m_Status_Pcb = 0;
+#ifdef PCBNEW_WITH_TRACKITEMS
+        TrackItems()->DRC_OnlineIndexAdd( aBoardItem );
+#endif
         break;
 
     case PCB_DIMENSION_T:
@@ -1009,10 +1017,16 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
                 break;
             }
         }
+
+        m_Status_Pcb &= ~CONNEXION_OK;
         break;
 
     case PCB_MODULE_T:
+#ifdef PCBNEW_WITH_TRACKITEMS
+        TrackItems()->DRC_OnlineIndexRemove( aBoardItem );
+#endif
         m_Modules.Remove( (MODULE*) aBoardItem );
+        m_Status_Pcb &= ~CONNEXION_OK;
         break;
 
     case PCB_TRACE_T:
@@ -1021,8 +1035,11 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
     case PCB_TEARDROP_T:
     case PCB_ROUNDEDTRACKSCORNER_T:
         TrackItems()->NetCodeFirstTrackItem()->Remove( (TRACK*) aBoardItem );
+        TrackItems()->NetScanIndex()->Remove( (TRACK*) aBoardItem );
+        TrackItems()->DRC_OnlineIndexRemove( aBoardItem );
 #endif
         m_Track.Remove( (TRACK*) aBoardItem );
+        m_Status_Pcb &= ~CONNEXION_OK;
         break;
 
     case PCB_ZONE_T:
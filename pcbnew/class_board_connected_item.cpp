@@ -56,11 +56,17 @@ bool BOARD_CONNECTED_ITEM::SetNetCode( int aNetCode, bool aNoAssert )
     if( ratsnest )
         addRatsnest = ratsnest->Remove( this );
 
+    NETINFO_ITEM* oldNetinfo = m_netinfo;
+
     if( ( aNetCode >= 0 ) && board )
         m_netinfo = board->FindNet( aNetCode );
     else
         m_netinfo = &NETINFO_LIST::ORPHANED_ITEM;
 
+    // Subnets of connected items have to be computed again
+    if( board && m_netinfo != oldNetinfo )
+        board->m_Status_Pcb &= ~CONNEXION_OK;
+
     if( !aNoAssert )
         assert( m_netinfo );
 
@@ -28,6 +28,8 @@
  * @brief Implementation of class to handle copper zones.
  */
 
+#include <algorithm>
+
 #include <fctsys.h>
 #include <wxstruct.h>
 #include <trigo.h>
@@ -66,6 +68,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     m_cornerRadius = 0;
     SetLocalFlags( 0 );                         // flags tempoarry used in zone calculations
     m_Poly = new SHAPE_POLY_SET();              // Outlines
+    m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>();
     aBoard->GetZoneSettings().ExportSetting( *this );
 }
 
@@ -90,7 +93,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList;    // shared until changed
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_isKeepout = aZone.m_isKeepout;
@@ -128,8 +131,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;   // shared until changed
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -145,6 +147,54 @@ ZONE_CONTAINER::~ZONE_CONTAINER()
 }
 
 
+SHAPE_POLY_SET& ZONE_CONTAINER::filledPolys()
+{
+    if( m_FilledPolysList.use_count() > 1 )
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( *m_FilledPolysList );
+
+    return *m_FilledPolysList;
+}
+
+
+void ZONE_CONTAINER::CacheTriangulation() const
+{
+    // The triangles do not change the polygons: they are added to the shared ones
+    m_FilledPolysList->CacheTriangulation();
+}
+
+
+void ZONE_CONTAINER::setFilledPolys( const SHAPE_POLY_SET& aPolys )
+{
+    if( m_FilledPolysList.use_count() > 1 )
+        m_FilledPolysList = std::make_shared<SHAPE_POLY_SET>( aPolys );
+    else
+        *m_FilledPolysList = aPolys;
+}
+
+
+size_t ZONE_CONTAINER::GetMemorySize( std::unordered_set<const void*>& aCountedFills ) const
+{
+    size_t size = sizeof( ZONE_CONTAINER );
+
+    size += m_Poly->TotalVertices() * sizeof( VECTOR2I );
+    size += m_FillSegmList.capacity() * sizeof( SEGMENT );
+    size += m_HatchLines.capacity() * sizeof( SEG );
+
+    // A shared fill is counted once, in full: the use count of the fill does not tell
+    // which of its owners will be kept (the board zone can be refilled, freeing its share)
+    if( aCountedFills.insert( m_FilledPolysList.get() ).second )
+    {
+        size += m_FilledPolysList->TotalVertices() * sizeof( VECTOR2I );
+
+        // The cached triangles: about one triangle and one vertex copy per fill vertex
+        if( m_FilledPolysList->TriangulatedPolyCount() )
+            size += m_FilledPolysList->TotalVertices() * ( sizeof( VECTOR2I ) + 3 * sizeof( int ) );
+    }
+
+    return size;
+}
+
+
 EDA_ITEM* ZONE_CONTAINER::Clone() const
 {
     return new ZONE_CONTAINER( *this );
@@ -153,10 +203,10 @@ EDA_ITEM* ZONE_CONTAINER::Clone() const
 
 bool ZONE_CONTAINER::UnFill()
 {
-    bool change = ( !m_FilledPolysList.IsEmpty() ) ||
+    bool change = ( !m_FilledPolysList->IsEmpty() ) ||
                   ( m_FillSegmList.size() > 0 );
 
-    m_FilledPolysList.RemoveAllContours();
+    ClearFilledPolysList();
     m_FillSegmList.clear();
     m_IsFilled = false;
 
@@ -253,7 +303,7 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     if( displ_opts->m_DisplayZonesMode == 1 )     // Do not show filled areas
         return;
 
-    if( m_FilledPolysList.IsEmpty() )  // Nothing to draw
+    if( m_FilledPolysList->IsEmpty() )  // Nothing to draw
         return;
 
     BOARD*      brd = GetBoard();
@@ -277,9 +327,9 @@ void ZONE_CONTAINER::DrawFilledArea( EDA_DRAW_PANEL* panel,
     color.a = 0.588;
 
 
-    for ( int ic = 0; ic < m_FilledPolysList.OutlineCount(); ic++ )
+    for ( int ic = 0; ic < m_FilledPolysList->OutlineCount(); ic++ )
     {
-        const SHAPE_LINE_CHAIN& path = m_FilledPolysList.COutline( ic );
+        const SHAPE_LINE_CHAIN& path = m_FilledPolysList->COutline( ic );
 
         CornersBuffer.clear();
 
@@ -635,7 +685,7 @@ int ZONE_CONTAINER::GetClearance( BOARD_CONNECTED_ITEM* aItem ) const
 
 bool ZONE_CONTAINER::HitTestFilledArea( const wxPoint& aRefPos ) const
 {
-    return m_FilledPolysList.Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
+    return m_FilledPolysList->Contains( VECTOR2I( aRefPos.x, aRefPos.y ) );
 }
 
 
@@ -713,9 +763,9 @@ void ZONE_CONTAINER::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
     msg.Printf( wxT( "%d" ), (int) m_HatchLines.size() );
     aList.push_back( MSG_PANEL_ITEM( _( "Hatch Lines" ), msg, BLUE ) );
 
-    if( !m_FilledPolysList.IsEmpty() )
+    if( !m_FilledPolysList->IsEmpty() )
     {
-        msg.Printf( wxT( "%d" ), m_FilledPolysList.TotalVertices() );
+        msg.Printf( wxT( "%d" ), m_FilledPolysList->TotalVertices() );
         aList.push_back( MSG_PANEL_ITEM( _( "Corner Count" ), msg, BLUE ) );
     }
 }
@@ -730,7 +780,7 @@ void ZONE_CONTAINER::Move( const wxPoint& offset )
 
     Hatch();
 
-    m_FilledPolysList.Move( VECTOR2I( offset.x, offset.y ) );
+    filledPolys().Move( VECTOR2I( offset.x, offset.y ) );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
     {
@@ -768,7 +818,7 @@ void ZONE_CONTAINER::Rotate( const wxPoint& centre, double angle )
     Hatch();
 
     /* rotate filled areas: */
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = filledPolys().Iterate(); ic; ++ic )
         RotatePoint( &ic->x, &ic->y, centre.x, centre.y, angle );
 
     for( unsigned ic = 0; ic < m_FillSegmList.size(); ic++ )
@@ -797,7 +847,7 @@ void ZONE_CONTAINER::Mirror( const wxPoint& mirror_ref )
 
     Hatch();
 
-    for( auto ic = m_FilledPolysList.Iterate(); ic; ++ic )
+    for( auto ic = filledPolys().Iterate(); ic; ++ic )
     {
         int py = mirror_ref.y - ic->y;
         ic->y = py + mirror_ref.y;
@@ -1014,8 +1064,8 @@ void ZONE_CONTAINER::Hatch()
     #define MAXPTS 200      // Usually we store only few values per one hatch line
                             // depending on the complexity of the zone outline
 
-    static std::vector<VECTOR2I> pointbuffer;
-    pointbuffer.clear();
+    // Not static: the zones of several layers are hatched at the same time when plotting
+    std::vector<VECTOR2I> pointbuffer;
     pointbuffer.reserve( MAXPTS + 2 );
 
     for( int a = min_a; a < max_a; a += spacing )
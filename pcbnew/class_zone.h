@@ -32,6 +32,9 @@
 
 
 #include <vector>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
 #include <gr_basic.h>
 #include <class_board_item.h>
 #include <class_board_connected_item.h>
@@ -48,6 +51,7 @@ class PCB_EDIT_FRAME;
 class BOARD;
 class ZONE_CONTAINER;
 class MSG_PANEL_ITEM;
+class DRC_ITEM_INDEX;
 
 
 /**
@@ -313,6 +317,19 @@ public:
      */
     bool BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET* aOutlineBuffer = NULL );
 
+    /**
+     * Function RefillIfChanged
+     * rebuilds the filled areas like BuildFilledSolidAreasPolygons(), unless the zone
+     * settings and outline, and the board items which can modify its filled areas, are
+     * the same as when the zone was last filled: the filled areas saved then are
+     * restored instead.
+     * @param aPcb: the current board
+     * @param aItemIndex: an index of the board pads and tracks, used to find the items
+     * near the zone, or NULL to walk the board lists
+     * @return true if the zone was actually refilled
+     */
+    bool RefillIfChanged( BOARD* aPcb, DRC_ITEM_INDEX* aItemIndex = NULL );
+
     /**
      * Function AddClearanceAreasPolygonsToPolysList
      * Add non copper areas polygons (pads and tracks with clearance)
@@ -571,7 +588,7 @@ public:
      */
     void ClearFilledPolysList()
     {
-        m_FilledPolysList.RemoveAllContours();
+        setFilledPolys( SHAPE_POLY_SET() );
     }
 
    /**
@@ -581,7 +598,18 @@ public:
      */
     const SHAPE_POLY_SET& GetFilledPolysList() const
     {
-        return m_FilledPolysList;
+        return *m_FilledPolysList;
+    }
+
+   /**
+     * Function GetFilledPolysListForEdit
+     * returns a reference to the list of filled polygons, to change it.  The list is copied
+     * first if it is shared with another copy of the zone, like an undo image.
+     * @return Reference to the list of filled polygons.
+     */
+    SHAPE_POLY_SET& GetFilledPolysListForEdit()
+    {
+        return filledPolys();
     }
 
    /**
@@ -590,9 +618,30 @@ public:
      */
     void AddFilledPolysList( SHAPE_POLY_SET& aPolysList )
     {
-        m_FilledPolysList = aPolysList;
+        setFilledPolys( aPolysList );
     }
 
+    /**
+     * Function CacheTriangulation
+     * builds the triangles of the filled polygons, which are drawn without a new tesselation
+     * until the filled polygons change.  The zone copies sharing the filled polygons share
+     * the triangles.  It does nothing if the triangles are up to date, so the zones loaded
+     * or modified are triangulated when they are first drawn.
+     * The filled polygons are not changed, so it can be called for a const zone.
+     */
+    void CacheTriangulation() const;
+
+    /**
+     * Function GetMemorySize
+     * returns an estimate of the memory used by the zone, mainly to limit the memory
+     * used by the undo and redo lists.  The filled polygons can be shared with other
+     * copies of the zone: they are counted in full, only by the first copy estimated.
+     * @param aCountedFills = the filled polygons already counted.  The filled polygons of
+     *                        the zone are added to it.
+     * @return the size in bytes.
+     */
+    size_t GetMemorySize( std::unordered_set<const void*>& aCountedFills ) const;
+
     /**
      * Function GetSmoothedPoly
      * returns a pointer to the corner-smoothed version of
@@ -629,7 +678,7 @@ public:
      */
     void AddFilledPolygon( SHAPE_POLY_SET& aPolygon )
     {
-        m_FilledPolysList.Append( aPolygon );
+        filledPolys().Append( aPolygon );
     }
 
     void AddFillSegments( std::vector< SEGMENT >& aSegments )
@@ -715,8 +764,34 @@ public:
 
 
 private:
+    /**
+     * Function buildFillSignature
+     * collects in aSignature the zone settings and outline, and the position, size,
+     * net and clearance of the items near the zone which can create holes in its
+     * filled areas (pads, tracks, vias, drawings and other zones outlines).
+     * The items are known by their time stamp, not their address, and are sorted, so
+     * two equal signatures give the same filled areas.
+     * @param aItemIndex: if not NULL, gives the pads and tracks near the zone
+     */
+    void buildFillSignature( BOARD* aPcb, DRC_ITEM_INDEX* aItemIndex,
+                             std::vector<int64_t>& aSignature ) const;
+
     void buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeatures );
 
+    /**
+     * Function filledPolys
+     * returns the filled polygons to change them.  They are copied first if they are
+     * shared with another copy of the zone.
+     */
+    SHAPE_POLY_SET& filledPolys();
+
+    /**
+     * Function setFilledPolys
+     * replaces the filled polygons by a copy of \a aPolys, without changing the polygons
+     * shared with other copies of the zone.
+     */
+    void setFilledPolys( const SHAPE_POLY_SET& aPolys );
+
     SHAPE_POLY_SET*       m_Poly{nullptr};                ///< Outline of the zone.
     SHAPE_POLY_SET*       m_smoothedPoly{nullptr};        // Corner-smoothed version of m_Poly
     int                   m_cornerSmoothingType;
@@ -779,8 +854,17 @@ private:
      * a polygon equivalent to m_Poly, without holes but with extra outline segment
      * connecting "holes" with external main outline.  In complex cases an outline
      * described by m_Poly can have many filled areas
+     * The polygons are shared by the copies of the zone, like the undo and redo images
+     * and the fill cache, until one copy changes them (see filledPolys()).
+     */
+    std::shared_ptr<SHAPE_POLY_SET> m_FilledPolysList;
+
+    /* Filled areas saved by RefillIfChanged(), and the signature of the zone
+     * and the items used to build them (see buildFillSignature())
      */
-    SHAPE_POLY_SET        m_FilledPolysList;
+    std::vector<int64_t>  m_fillSignature;
+    std::shared_ptr<SHAPE_POLY_SET> m_fillCachePolys;
+    std::vector <SEGMENT> m_fillCacheSegments;
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
@@ -38,14 +38,125 @@
 #include <connect.h>
 #include <dialog_cleaning_options.h>
 #include <board_commit.h>
+#include <profile.h>
 
+#include <deque>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef PCBNEW_WITH_TRACKITEMS
 #include "trackitems/viastitching.h"
 #include "trackitems/trackitems.h"
 #endif
 
+static const wxString traceTracksCleaner( wxT( "KICAD_TRACKS_CLEANER" ) );
+
+
+/**
+ * Class TRACK_ENDPOINTS
+ * indexes the track segments and vias by their end points, so the items connected to an end
+ * point are found without scanning the track list.  Teardrops and rounded corners are not
+ * indexed: they are attached to the segments, and the cleaner does not test them.
+ * The index is not updated by the board: an item must be removed before its end points are
+ * modified or before it is removed from the board, and added again after the modification.
+ */
+class TRACK_ENDPOINTS
+{
+public:
+    void Build( TRACK* aFirstTrack )
+    {
+        m_ends.clear();
+
+        for( TRACK* track = aFirstTrack; track; track = track->Next() )
+            Add( track );
+    }
+
+    void Add( TRACK* aTrack )
+    {
+        if( aTrack->Type() != PCB_TRACE_T && aTrack->Type() != PCB_VIA_T )
+            return;
+
+        m_ends.emplace( aTrack->GetStart(), aTrack );
+
+        if( aTrack->GetEnd() != aTrack->GetStart() )
+            m_ends.emplace( aTrack->GetEnd(), aTrack );
+    }
+
+    void Remove( TRACK* aTrack )
+    {
+        removeAt( aTrack->GetStart(), aTrack );
+
+        if( aTrack->GetEnd() != aTrack->GetStart() )
+            removeAt( aTrack->GetEnd(), aTrack );
+    }
+
+    /**
+     * Function GetTrack
+     * is the indexed TRACK::GetTrack( ..., aSameNetOnly = true, ... ): it returns a segment
+     * or via of the net of aTrack, on one of its layers, having an end point at the aEndPoint
+     * end of aTrack, and not flagged BUSY or IS_DELETED.
+     */
+    TRACK* GetTrack( const TRACK* aTrack, ENDPOINT_T aEndPoint ) const
+    {
+        LSET layers = aTrack->GetLayerSet();
+        auto range = m_ends.equal_range( aTrack->GetEndPoint( aEndPoint ) );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            TRACK* candidate = it->second;
+
+            if( candidate != aTrack && candidate->GetNetCode() == aTrack->GetNetCode()
+                && !candidate->GetState( BUSY | IS_DELETED )
+                && ( layers & candidate->GetLayerSet() ).any() )
+                return candidate;
+        }
+
+        return NULL;
+    }
+
+    /**
+     * Function GetTracksAt
+     * appends to aList the indexed items having an end point at aPosition, whatever their
+     * net and layers.
+     */
+    void GetTracksAt( const wxPoint& aPosition, std::vector<TRACK*>& aList ) const
+    {
+        auto range = m_ends.equal_range( aPosition );
+
+        for( auto it = range.first; it != range.second; ++it )
+            aList.push_back( it->second );
+    }
+
+private:
+    struct POINT_HASH
+    {
+        size_t operator()( const wxPoint& aPoint ) const
+        {
+            unsigned long long key = (unsigned long long) (unsigned) aPoint.x << 32;
+
+            return std::hash<unsigned long long>()( key | (unsigned) aPoint.y );
+        }
+    };
+
+    void removeAt( const wxPoint& aPosition, TRACK* aTrack )
+    {
+        auto range = m_ends.equal_range( aPosition );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            if( it->second == aTrack )
+            {
+                m_ends.erase( it );
+                return;
+            }
+        }
+    }
+
+    std::unordered_multimap<wxPoint, TRACK*, POINT_HASH> m_ends;
+};
+
+
 // Helper class used to clean tracks and vias
 class TRACKS_CLEANER: CONNECTIONS
 {
@@ -89,8 +200,10 @@ private:
 
     /**
      * Removes dangling tracks
+     * @param aNeighbours = filled with the remaining tracks and vias which were connected
+     *                      to a removed track
      */
-    bool deleteDanglingTracks();
+    bool deleteDanglingTracks( std::vector<TRACK*>& aNeighbours );
 
     /// Delete null length track segments
     bool delete_null_segments();
@@ -103,13 +216,22 @@ private:
      */
     bool clean_segments();
 
+    /// Merge the segments of aSegments still on the board to their collinear neighbours
+    bool merge_collinear_segments( const std::vector<TRACK*>& aSegments );
+
     /**
      * helper function
-     * Rebuild list of tracks, and connected tracks
-     * this info must be rebuilt when tracks are erased
+     * Build the end points index, and the track to pad connection flags.
+     * The cleaner keeps them up to date when tracks are merged or erased.
      */
     void buildTrackConnectionInfo();
 
+    /// Remove a track or via from the board and from the end points index
+    void removeTrack( TRACK* aTrack );
+
+    /// Write the duration of a cleanup phase to the trace, and restart aTimer
+    void reportPhase( const wxChar* aPhase, PROF_COUNTER& aTimer );
+
     /**
      * helper function
      * merge aTrackRef and aCandidate, when possible,
@@ -125,6 +247,7 @@ private:
 
     BOARD* m_brd;
     BOARD_COMMIT& m_commit;
+    TRACK_ENDPOINTS m_endpoints;
 };
 
 
@@ -139,7 +262,7 @@ void PCB_EDIT_FRAME::Clean_Pcb()
 
     // Old model has to be refreshed, GAL normally does not keep updating it
 #ifndef PCBNEW_WITH_TRACKITEMS
-    Compile_Ratsnest( NULL, false );
+    Update_Ratsnest( NULL, false );
 #endif
 
     wxBusyCursor( dummy );
@@ -181,17 +304,23 @@ bool TRACKS_CLEANER::CleanupBoard( bool aRemoveMisConnected,
                                    bool aMergeSegments,
                                    bool aDeleteUnconnected )
 {
-    buildTrackConnectionInfo();
-
+    PROF_COUNTER timer;
     bool modified = false;
 
 #ifdef PCBNEW_WITH_TRACKITEMS
     modified |= ( m_brd->TrackItems()->RoundedTracksCorners()->Clean( &m_brd->m_Track, m_commit ) );
+    reportPhase( wxT( "rounded corners" ), timer );
 #endif
 
+    buildTrackConnectionInfo();
+    reportPhase( wxT( "connection info" ), timer );
+
     // delete redundant vias
     if( aCleanVias )
+    {
         modified |= clean_vias();
+        reportPhase( wxT( "vias" ), timer );
+    }
 
     // Remove null segments and intermediate points on aligned segments
     // If not asked, remove null segments only if remove misconnected is asked
@@ -200,44 +329,52 @@ bool TRACKS_CLEANER::CleanupBoard( bool aRemoveMisConnected,
     else if( aRemoveMisConnected )
         modified |= delete_null_segments();
 
+    reportPhase( wxT( "segments" ), timer );
+
     if( aRemoveMisConnected )
     {
-        if( removeBadTrackSegments() )
-        {
-            modified = true;
-
-            // Refresh track connection info
-            buildTrackConnectionInfo();
-        }
+        modified |= removeBadTrackSegments();
+        reportPhase( wxT( "misconnected tracks" ), timer );
     }
 
-    // Delete dangling tracks
+    // Delete dangling tracks.  The end points index and the pad flags are kept up to date
+    // by the previous phases, so they do not need to be rebuilt.
     if( aDeleteUnconnected )
     {
-        if( modified ) // Refresh track connection info
-            buildTrackConnectionInfo();
+        std::vector<TRACK*> neighbours;
 
-        if( deleteDanglingTracks() )
+        if( deleteDanglingTracks( neighbours ) )
         {
             modified = true;
 
             // Removed tracks can leave aligned segments
             // (when a T was formed by tracks and the "vertical" segment
-            // is removed)
+            // is removed).  Only the neighbours of the removed tracks can be merged.
             if( aMergeSegments )
-                clean_segments();
+                merge_collinear_segments( neighbours );
         }
+
+        reportPhase( wxT( "dangling tracks" ), timer );
     }
 
 #ifdef PCBNEW_WITH_TRACKITEMS
     //Clean broken teardrops.
     modified |= ( m_brd->TrackItems()->Teardrops()->Clean( &m_brd->m_Track ) );
+    reportPhase( wxT( "teardrops" ), timer );
 #endif
 
     return modified;
 }
 
 
+void TRACKS_CLEANER::reportPhase( const wxChar* aPhase, PROF_COUNTER& aTimer )
+{
+    wxLogTrace( traceTracksCleaner, wxT( "%s: %.1f ms, %u tracks left" ),
+                aPhase, aTimer.msecs(), (unsigned) m_brd->m_Track.GetCount() );
+    aTimer.Start();
+}
+
+
 TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit )
     : CONNECTIONS( aPcb ), m_brd( aPcb ), m_commit( aCommit )
 {
@@ -249,6 +386,7 @@ TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit )
 void TRACKS_CLEANER::buildTrackConnectionInfo()
 {
     BuildTracksCandidatesList( m_brd->m_Track, NULL );
+    m_endpoints.Build( m_brd->m_Track );
 
     // clear flags and variables used in cleanup
     for( TRACK* track = m_brd->m_Track; track != NULL; track = track->Next() )
@@ -285,6 +423,14 @@ void TRACKS_CLEANER::buildTrackConnectionInfo()
 }
 
 
+void TRACKS_CLEANER::removeTrack( TRACK* aTrack )
+{
+    m_endpoints.Remove( aTrack );
+    m_brd->Remove( aTrack );
+    m_commit.Removed( aTrack );
+}
+
+
 bool TRACKS_CLEANER::removeBadTrackSegments()
 {
     // The rastsnet is expected to be up to date (Compile_Ratsnest was called)
@@ -355,8 +501,7 @@ bool TRACKS_CLEANER::removeBadTrackSegments()
             m_brd->TrackItems()->RoundedTracksCorners()->Remove( segment, m_commit, true );
 #endif
             isModified = true;
-            m_brd->Remove( segment );
-            m_commit.Removed( segment );
+            removeTrack( segment );
         }
     }
 
@@ -377,21 +522,21 @@ bool TRACKS_CLEANER::remove_duplicates_of_via( const VIA *aVia )
 {
     bool modified = false;
 
-    // Search and delete others vias at same location
-    VIA* next_via;
+    // Search and delete others vias at same location.  The vias before aVia in the
+    // list were already handled, so there is no other through via among them.
+    std::vector<TRACK*> candidates;
+    m_endpoints.GetTracksAt( aVia->GetStart(), candidates );
 
-    for( VIA* alt_via = GetFirstVia( aVia->Next() ); alt_via != NULL; alt_via = next_via )
+    for( TRACK* candidate : candidates )
     {
-        next_via = GetFirstVia( alt_via->Next() );
+        VIA* alt_via = dyn_cast<VIA*>( candidate );
 
-        if( ( alt_via->GetViaType() == VIA_THROUGH ) &&
-                ( alt_via->GetStart() == aVia->GetStart() ) )
+        if( alt_via && alt_via != aVia && ( alt_via->GetViaType() == VIA_THROUGH ) )
         {
 #ifdef PCBNEW_WITH_TRACKITEMS
             m_brd->TrackItems()->Teardrops()->Remove( alt_via, m_commit, true );
 #endif
-            m_brd->Remove( alt_via );
-            m_commit.Removed( alt_via );
+            removeTrack( alt_via );
             modified = true;
         }
     }
@@ -402,30 +547,36 @@ bool TRACKS_CLEANER::remove_duplicates_of_via( const VIA *aVia )
 bool TRACKS_CLEANER::clean_vias()
 {
     bool modified = false;
+    VIA* next_via;
 
-    for( VIA* via = GetFirstVia( m_brd->m_Track ); via != NULL;
-            via = GetFirstVia( via->Next() ) )
+    for( VIA* via = GetFirstVia( m_brd->m_Track ); via != NULL; via = next_via )
     {
         // Correct via m_End defects (if any), should never happen
         if( via->GetStart() != via->GetEnd() )
         {
             wxFAIL_MSG( "Malformed via with mismatching ends" );
+            m_endpoints.Remove( via );
             via->SetEnd( via->GetStart() );
+            m_endpoints.Add( via );
         }
 
         /* Important: these cleanups only do thru hole vias, they don't
          * (yet) handle high density interconnects */
         if( via->GetViaType() == VIA_THROUGH )
-        {
             modified |= remove_duplicates_of_via( via );
 
+        // Get the next via now: a removed via is no more linked to the list
+        next_via = GetFirstVia( via->Next() );
+
+        if( via->GetViaType() == VIA_THROUGH )
+        {
 #ifdef PCBNEW_WITH_TRACKITEMS
             //Do not remove thermal via with netcode.
             if( via->GetThermalCode() )
                 if( via->GetNetCode() || const_cast<VIA*>(via)->GetThermalZones()->size() )
                     continue;
 #endif
-                
+
             /* To delete through Via on THT pads at same location
              * Examine the list of connected pads:
              * if one through pad is found, the via can be removed */
@@ -440,8 +591,7 @@ bool TRACKS_CLEANER::clean_vias()
 #ifdef PCBNEW_WITH_TRACKITEMS
                     m_brd->TrackItems()->Teardrops()->Remove( via, m_commit, true );
 #endif
-                    m_brd->Remove( via );
-                    m_commit.Removed( via );
+                    removeTrack( via );
                     modified = true;
                     break;
                 }
@@ -480,7 +630,7 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPo
 {
     bool flag_erase = false;
 
-    TRACK* other = aTrack->GetTrack( m_brd->m_Track, NULL, aEndPoint, true, false );
+    TRACK* other = m_endpoints.GetTrack( aTrack, aEndPoint );
 
     if( !other && !zoneForTrackEndpoint( aTrack, aEndPoint ) )
         flag_erase = true; // Start endpoint is neither on pad, zone or other track
@@ -502,7 +652,7 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPo
             // search for another segment following the via
             aTrack->SetState( BUSY, true );
 
-            other = via->GetTrack( m_brd->m_Track, NULL, aEndPoint, true, false );
+            other = m_endpoints.GetTrack( via, aEndPoint );
 
             // There is a via on the start but it goes nowhere
             if( !other && !zoneForTrackEndpoint( via, aEndPoint ) )
@@ -519,72 +669,95 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPo
 /* Delete dangling tracks
  *  Vias:
  *  If a via is only connected to a dangling track, it also will be removed
+ *  All the tracks are tested once, then only the tracks connected to a removed one.
  */
-bool TRACKS_CLEANER::deleteDanglingTracks()
+bool TRACKS_CLEANER::deleteDanglingTracks( std::vector<TRACK*>& aNeighbours )
 {
     if( m_brd->m_Track == NULL )
         return false;
 
     bool modified = false;
-    bool item_erased;
 
-    do // Iterate when at least one track is deleted
+    std::deque<TRACK*> candidates;
+    std::unordered_set<TRACK*> queued;
+    std::vector<TRACK*> connected;
+
+    for( TRACK* track = m_brd->m_Track; track != NULL; track = track->Next() )
     {
-        item_erased = false;
-        TRACK* next_track;
+        candidates.push_back( track );
+        queued.insert( track );
+    }
 
-        for( TRACK *track = m_brd->m_Track; track != NULL; track = next_track )
-        {
-            next_track = track->Next();
+    while( !candidates.empty() )
+    {
+        TRACK* track = candidates.front();
+        candidates.pop_front();
+        queued.erase( track );
+
+        // Already removed from the board
+        if( track->GetList() != &m_brd->m_Track )
+            continue;
 
 #ifdef PCBNEW_WITH_TRACKITEMS
-            if( track->Type() == PCB_TEARDROP_T )
-                continue;
-            if( track->Type() == PCB_ROUNDEDTRACKSCORNER_T )
-                continue;
+        if( track->Type() == PCB_TEARDROP_T )
+            continue;
+        if( track->Type() == PCB_ROUNDEDTRACKSCORNER_T )
+            continue;
 
-            //Do not remove thermal via.
-            if( dynamic_cast<const VIA*>( track ) )
-            {
-                if( dynamic_cast<const VIA*>( track )->GetThermalCode() 
-                    && const_cast<VIA*>( dynamic_cast<const VIA*>( track ) )->GetThermalZones()->size() ) 
-                    continue;
-            }
+        //Do not remove thermal via.
+        if( track->Type() == PCB_VIA_T )
+        {
+            VIA* via = static_cast<VIA*>( track );
+
+            if( via->GetThermalCode() && via->GetThermalZones()->size() )
+                continue;
+        }
 #endif
-            
-            bool flag_erase = false; // Start without a good reason to erase it
 
-            /* if a track endpoint is not connected to a pad, test if
-             * the endpoint is connected to another track or to a zone.
-             * For via test, an enhancement could be to test if
-             * connected to 2 items on different layers. Currently
-             * a via must be connected to 2 items, that can be on the
-             * same layer */
+        bool flag_erase = false; // Start without a good reason to erase it
 
-            // Check if there is nothing attached on the start
-            if( !( track->GetState( START_ON_PAD ) ) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
+        /* if a track endpoint is not connected to a pad, test if
+         * the endpoint is connected to another track or to a zone.
+         * For via test, an enhancement could be to test if
+         * connected to 2 items on different layers. Currently
+         * a via must be connected to 2 items, that can be on the
+         * same layer */
 
-            // If not sure about removal, then check if there is nothing attached on the end
-            if( !flag_erase && !track->GetState( END_ON_PAD ) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
+        // Check if there is nothing attached on the start
+        if( !( track->GetState( START_ON_PAD ) ) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
+
+        // If not sure about removal, then check if there is nothing attached on the end
+        if( !flag_erase && !track->GetState( END_ON_PAD ) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
+
+        if( flag_erase )
+        {
+            connected.clear();
+            m_endpoints.GetTracksAt( track->GetStart(), connected );
+            m_endpoints.GetTracksAt( track->GetEnd(), connected );
 
-            if( flag_erase )
-            {
 #ifdef PCBNEW_WITH_TRACKITEMS
-                m_brd->TrackItems()->Teardrops()->Remove( track, m_commit, true );
-                m_brd->TrackItems()->RoundedTracksCorners()->Remove( track, m_commit, true );
+            m_brd->TrackItems()->Teardrops()->Remove( track, m_commit, true );
+            m_brd->TrackItems()->RoundedTracksCorners()->Remove( track, m_commit, true );
 #endif
-                m_brd->Remove( track );
-                m_commit.Removed( track );
+            removeTrack( track );
+            modified = true;
 
-                /* keep iterating, because a track connected to the deleted track
-                 * now perhaps is not connected and should be deleted */
-                item_erased = true;
-                modified = true;
+            /* test again the tracks connected to the deleted track,
+             * because they now perhaps are not connected and should be deleted */
+            for( TRACK* other : connected )
+            {
+                if( other == track )
+                    continue;
+
+                aNeighbours.push_back( other );
+
+                if( queued.insert( other ).second )
+                    candidates.push_back( other );
             }
         }
-    } while( item_erased );
+    }
 
     return modified;
 }
@@ -607,8 +780,7 @@ bool TRACKS_CLEANER::delete_null_segments()
             m_brd->TrackItems()->Teardrops()->Remove( segment, m_commit, true );
             m_brd->TrackItems()->RoundedTracksCorners()->Remove( segment, m_commit, true );
 #endif
-            m_brd->Remove( segment );
-            m_commit.Removed( segment );
+            removeTrack( segment );
             modified = true;
         }
     }
@@ -620,27 +792,24 @@ bool TRACKS_CLEANER::delete_null_segments()
 bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
 {
     bool modified = false;
-    TRACK* nextsegment;
 
-    for( TRACK* other = aTrack->Next(); other; other = nextsegment )
-    {
-        nextsegment = other->Next();
+#ifdef PCBNEW_WITH_TRACKITEMS
+    //Do not delete teardrop(s).
+    if(aTrack->Type() == PCB_TEARDROP_T)
+        return false;
+    if(aTrack->Type() == PCB_ROUNDEDTRACKSCORNER_T)
+        return false;
+#endif
 
-        // New netcode, break out (can't be there any other)
-        if( aTrack->GetNetCode() != other->GetNetCode() )
-            break;
+    // A duplicate has an end point at the start of aTrack.  The duplicates before aTrack
+    // in the list were already handled, and removed aTrack if it was one of them.
+    std::vector<TRACK*> candidates;
+    m_endpoints.GetTracksAt( aTrack->GetStart(), candidates );
 
-#ifdef PCBNEW_WITH_TRACKITEMS
-        //Do not delete teardrop(s).
-        if(aTrack->Type() == PCB_TEARDROP_T)
-            break;
-        if(other->Type() == PCB_TEARDROP_T)
-            continue;
-        if(aTrack->Type() == PCB_ROUNDEDTRACKSCORNER_T)
-            break;
-        if(other->Type() == PCB_ROUNDEDTRACKSCORNER_T)
+    for( TRACK* other : candidates )
+    {
+        if( other == aTrack || aTrack->GetNetCode() != other->GetNetCode() )
             continue;
-#endif
 
         // Must be of the same type, on the same layer and the endpoints
         // must be the same (maybe swapped)
@@ -658,8 +827,7 @@ bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
                 m_brd->TrackItems()->RoundedTracksCorners()->ToMemory( other );
                 m_brd->TrackItems()->RoundedTracksCorners()->Remove( other, m_commit, true );
 #endif
-                m_brd->Remove( other );
-                m_commit.Removed( other );
+                removeTrack( other );
                 modified = true;
 
 #ifdef PCBNEW_WITH_TRACKITEMS
@@ -684,58 +852,57 @@ bool TRACKS_CLEANER::merge_collinear_of_track( TRACK* aSegment )
             endpoint = ENDPOINT_T( endpoint + 1 ) )
     {
         // search for a possible segment connected to the current endpoint of the current one
-        TRACK* other = aSegment->Next();
+        TRACK* other = m_endpoints.GetTrack( aSegment, endpoint );
 
         if( other )
         {
-            other = aSegment->GetTrack( other, NULL, endpoint, true, false );
-
-            if( other )
+            // the two segments must have the same width and the other
+            // cannot be a via
+            if( ( aSegment->GetWidth() == other->GetWidth() ) &&
+                    ( other->Type() == PCB_TRACE_T ) )
             {
-                // the two segments must have the same width and the other
-                // cannot be a via
-                if( ( aSegment->GetWidth() == other->GetWidth() ) &&
-                        ( other->Type() == PCB_TRACE_T ) )
-                {
-                    // There can be only one segment connected
-                    other->SetState( BUSY, true );
-                    TRACK* yet_another = aSegment->GetTrack( m_brd->m_Track, NULL,
-                            endpoint, true, false );
-                    other->SetState( BUSY, false );
+                // There can be only one segment connected
+                other->SetState( BUSY, true );
+                TRACK* yet_another = m_endpoints.GetTrack( aSegment, endpoint );
+                other->SetState( BUSY, false );
 
-                    if( !yet_another )
-                    {
+                if( !yet_another )
+                {
 #ifdef PCBNEW_WITH_TRACKITEMS
-                        EDA_ITEM* seg_clone = aSegment->Clone();
+                    EDA_ITEM* seg_clone = aSegment->Clone();
 #endif
-                        // Try to merge them
-                        TRACK* segDelete = mergeCollinearSegmentIfPossible( aSegment,
-                                other, endpoint );
-
-                        // Merge succesful, the other one has to go away
-                        if( segDelete )
-                        {
+                    // Try to merge them.  The merge moves an end point of aSegment.
+                    m_endpoints.Remove( aSegment );
+                    TRACK* segDelete = mergeCollinearSegmentIfPossible( aSegment,
+                            other, endpoint );
+                    m_endpoints.Add( aSegment );
+
+                    // Merge succesful, the other one has to go away
+                    if( segDelete )
+                    {
 #ifdef PCBNEW_WITH_TRACKITEMS
-                            m_brd->TrackItems()->Teardrops()->ToMemory( segDelete );
-                            m_brd->TrackItems()->Teardrops()->Remove( segDelete, m_commit, true );
-                            m_brd->TrackItems()->RoundedTracksCorners()->ToMemory( segDelete );
-                            m_brd->TrackItems()->RoundedTracksCorners()->Remove( segDelete, m_commit, true );
+                        m_brd->TrackItems()->Teardrops()->ToMemory( segDelete );
+                        m_brd->TrackItems()->Teardrops()->Remove( segDelete, m_commit, true );
+                        m_brd->TrackItems()->RoundedTracksCorners()->ToMemory( segDelete );
+                        m_brd->TrackItems()->RoundedTracksCorners()->Remove( segDelete, m_commit, true );
 #endif
-                            m_brd->Remove( segDelete );
-                            //TODO
-                            //If there are more than one tracks/nodes to be removed, m_comit.Removed() craches. hp
-                            m_commit.Removed( segDelete );
-                            merged_this = true;
+                        //TODO
+                        //If there are more than one tracks/nodes to be removed, m_comit.Removed() craches. hp
+                        removeTrack( segDelete );
+                        merged_this = true;
 
 #ifdef PCBNEW_WITH_TRACKITEMS
-                            m_commit.Modified( aSegment, seg_clone );
-                            m_brd->TrackItems()->Teardrops()->FromMemory( aSegment, m_commit );
-                            m_brd->TrackItems()->Teardrops()->Update( aSegment->GetNetCode(), aSegment );
-                            m_brd->TrackItems()->RoundedTracksCorners()->FromMemory( aSegment, m_commit );
-                            m_brd->TrackItems()->RoundedTracksCorners()->Update( aSegment );
+                        m_commit.Modified( aSegment, seg_clone );
+                        m_brd->TrackItems()->Teardrops()->FromMemory( aSegment, m_commit );
+                        m_brd->TrackItems()->Teardrops()->Update( aSegment->GetNetCode(), aSegment );
+                        m_brd->TrackItems()->RoundedTracksCorners()->FromMemory( aSegment, m_commit );
+                        m_brd->TrackItems()->RoundedTracksCorners()->Update( aSegment );
 #endif
-                        }
                     }
+#ifdef PCBNEW_WITH_TRACKITEMS
+                    else
+                        delete seg_clone;
+#endif
                 }
             }
         }
@@ -758,23 +925,35 @@ bool TRACKS_CLEANER::clean_segments()
     for( TRACK* segment = m_brd->m_Track; segment; segment = segment->Next() )
         modified |= remove_duplicates_of_track( segment );
 
-    // merge collinear segments:
-    TRACK* nextsegment;
+    // merge collinear segments.  The neighbours of a segment are found in the end points
+    // index, so a merge does not need a new walk of the track list
+    std::vector<TRACK*> segments;
 
-    for( TRACK* segment = m_brd->m_Track; segment; segment = nextsegment )
+    for( TRACK* segment = m_brd->m_Track; segment; segment = segment->Next() )
     {
-        nextsegment = segment->Next();
-
         if( segment->Type() == PCB_TRACE_T )
-        {
-            bool merged_this = merge_collinear_of_track( segment );
+            segments.push_back( segment );
+    }
 
-            if( merged_this ) // The current segment was modified, retry to merge it again
-            {
-                nextsegment = segment->Next();
-                modified = true;
-            }
-        }
+    modified |= merge_collinear_segments( segments );
+
+    return modified;
+}
+
+
+bool TRACKS_CLEANER::merge_collinear_segments( const std::vector<TRACK*>& aSegments )
+{
+    bool modified = false;
+
+    for( TRACK* segment : aSegments )
+    {
+        // Skip the segments removed by a previous merge
+        if( segment->GetList() != &m_brd->m_Track || segment->Type() != PCB_TRACE_T )
+            continue;
+
+        // The segment was modified by a merge: retry to merge it again
+        while( merge_collinear_of_track( segment ) )
+            modified = true;
     }
 
     return modified;
@@ -905,7 +1084,7 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
 bool PCB_EDIT_FRAME::RemoveMisConnectedTracks()
 {
     // Old model has to be refreshed, GAL normally does not keep updating it
-    Compile_Ratsnest( NULL, false );
+    Update_Ratsnest( NULL, false );
     BOARD_COMMIT commit( this );
 
     TRACKS_CLEANER cleaner( GetBoard(), commit );
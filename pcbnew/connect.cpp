@@ -29,6 +29,13 @@
  */
 
 #include <fctsys.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
 #include <common.h>
 #include <macros.h>
 #include <wxBasePcbFrame.h>
@@ -53,6 +60,81 @@ extern void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode );
 static void RebuildTrackChain( BOARD* pcb );
 
 
+/**
+ * Class UNION_FIND
+ * groups items, known by their index, in disjoint sets: used to build clusters of
+ * connected items without relabeling them at each merge.
+ */
+class UNION_FIND
+{
+public:
+    UNION_FIND( unsigned aCount ) : m_parents( aCount ), m_sizes( aCount, 1 )
+    {
+        for( unsigned ii = 0; ii < aCount; ++ii )
+            m_parents[ii] = ii;
+    }
+
+    int Find( int aItem )
+    {
+        while( m_parents[aItem] != aItem )
+        {
+            m_parents[aItem] = m_parents[m_parents[aItem]];
+            aItem = m_parents[aItem];
+        }
+
+        return aItem;
+    }
+
+    void Union( int aFirst, int aSecond )
+    {
+        aFirst = Find( aFirst );
+        aSecond = Find( aSecond );
+
+        if( aFirst == aSecond )
+            return;
+
+        if( m_sizes[aFirst] < m_sizes[aSecond] )
+            std::swap( aFirst, aSecond );
+
+        m_parents[aSecond] = aFirst;
+        m_sizes[aFirst] += m_sizes[aSecond];
+    }
+
+    /// @return the number of items in the set of aItem
+    int Size( int aItem )
+    {
+        return m_sizes[Find( aItem )];
+    }
+
+private:
+    std::vector<int> m_parents;
+    std::vector<int> m_sizes;
+};
+
+
+/**
+ * Function runWorkers
+ * runs aWorker on all cores, the calling thread being one of the workers.  Workers are
+ * expected to share their jobs, using an atomic counter.
+ * @param aJobCount = the number of jobs, no more workers than jobs are started
+ */
+static void runWorkers( size_t aJobCount, const std::function<void()>& aWorker )
+{
+    size_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount = std::min( threadCount, aJobCount );
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 1; ii < threadCount; ++ii )
+        threads.push_back( std::thread( aWorker ) );
+
+    aWorker();
+
+    for( auto& thread : threads )
+        thread.join();
+}
+
+
 CONNECTIONS::CONNECTIONS( BOARD * aBrd )
 {
     m_brd = aBrd;
@@ -354,7 +436,10 @@ int CONNECTIONS::SearchConnectedTracks( const TRACK* aTrack )
 
 #ifdef USE_EXTENDED_SEARCH
     int dist_max = aTrack->GetWidth() / 2;
-    static std::vector<CONNECTED_POINT*> tracks_candidates;
+
+    // A member, to avoid multiple memory realloc, and so several CONNECTIONS can be used
+    // by different threads
+    std::vector<CONNECTED_POINT*>& tracks_candidates = m_nearCandidates;
 #endif
 
     wxPoint position = aTrack->GetStart();
@@ -550,83 +635,6 @@ void CONNECTIONS::Build_CurrNet_SubNets_Connections( TRACK* aFirstTrack, TRACK*
 }
 
 
-/**
- * Change a subnet value to a new value, in m_sortedPads pad list
- * After that, 2 cluster (or subnets) are merged into only one.
- * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_PadsSubNets( int aOldSubNet, int aNewSubNet )
-{
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        std::swap( aOldSubNet, aNewSubNet );
-
-    // Examine connections between intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
-    {
-        D_PAD * curr_pad = m_sortedPads[ii];
-        if( curr_pad->GetSubNet() != aOldSubNet )
-            continue;
-
-        change_count++;
-        curr_pad->SetSubNet( aNewSubNet );
-    }
-
-    return change_count;
-}
-
-/*
- * Change a subnet value to a new value, for tracks and pads which are connected to.
- * The result is merging 2 clusters (or subnets) into only one cluster.
- * Note: the resulting sub net value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
-{
-    TRACK* curr_track;
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        std::swap( aOldSubNet, aNewSubNet );
-
-    curr_track = (TRACK*)m_firstTrack;
-
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
-    {
-        if( curr_track->GetSubNet() != aOldSubNet )
-        {
-            if( curr_track == m_lastTrack )
-                break;
-
-            continue;
-        }
-
-        change_count++;
-        curr_track->SetSubNet( aNewSubNet );
-
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
-        {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
-            if( pad->GetSubNet() == aOldSubNet )
-            {
-                pad->SetSubNet( curr_track->GetSubNet() );
-            }
-        }
-
-        if( curr_track == m_lastTrack )
-            break;
-    }
-
-    return change_count;
-}
-
-
 /* Test a list of track segments, to create or propagate a sub netcode to pads and
  * segments connected together.
  * The track list must be sorted by nets, and all segments
@@ -641,147 +649,79 @@ int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
  */
 void CONNECTIONS::Propagate_SubNets()
 {
-    int sub_netcode = 1;
+    // Items of the net: tracks first, then pads
+    std::vector<BOARD_CONNECTED_ITEM*> items;
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, int> indexes;
+
+    for( TRACK* track = (TRACK*) m_firstTrack; track; track = track->Next() )
+    {
+        indexes[track] = items.size();
+        items.push_back( track );
+
+        if( track == m_lastTrack )
+            break;
+    }
 
-    TRACK* curr_track = (TRACK*)m_firstTrack;
-    if( curr_track )
-        curr_track->SetSubNet( sub_netcode );
+    unsigned trackCount = items.size();
 
-    // Examine connections between tracks and pads
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
+    for( D_PAD* pad : m_sortedPads )
     {
-        // First: handling connections to pads
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
-        {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
+        indexes[pad] = items.size();
+        items.push_back( pad );
+    }
 
-            if( curr_track->GetSubNet() )        // the track segment is already a cluster member
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    Merge_SubNets( pad->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    /* The pad is not yet attached to a cluster , so we can add this pad to
-                     * the cluster */
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else                              // the track segment is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // it is connected to a pad in a cluster, merge this track
-                    curr_track->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    /* it is connected to a pad not in a cluster, so we must create a new
-                     * cluster (only with the 2 items: the track and the pad) */
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-        }
+    UNION_FIND clusters( items.size() );
 
-        // Test connections between segments
-        for( unsigned ii = 0; ii < curr_track->m_TracksConnected.size(); ii++ )
-        {
-            BOARD_CONNECTED_ITEM* track = curr_track->m_TracksConnected[ii];
+    auto connect = [&]( int aIndex, const BOARD_CONNECTED_ITEM* aOther )
+    {
+        auto other = indexes.find( aOther );
 
-            if( curr_track->GetSubNet() )   // The current track is already a cluster member
-            {
-                // The other track is already a cluster member, so we can merge the 2 clusters
-                if( track->GetSubNet() )
-                {
-                    Merge_SubNets( track->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    // The other track is not yet attached to a cluster , so we can add this
-                    // other track to the cluster
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else        // the current track segment is not yet attached to a cluster
-            {
-                if( track->GetSubNet() )
-                {
-                    // The other track is already a cluster member, so we can add
-                    // the current segment to the cluster
-                    curr_track->SetSubNet( track->GetSubNet() );
-                }
-                else
-                {
-                    // it is connected to an other segment not in a cluster, so we must
-                    // create a new cluster (only with the 2 track segments)
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-        }
+        if( other != indexes.end() )
+            clusters.Union( aIndex, other->second );
+    };
 
-        if( curr_track == m_lastTrack )
-            break;
+    // Connections between tracks and pads, and between tracks
+    for( unsigned ii = 0; ii < trackCount; ++ii )
+    {
+        TRACK* track = static_cast<TRACK*>( items[ii] );
+
+        for( D_PAD* pad : track->m_PadsConnected )
+            connect( ii, pad );
+
+        for( TRACK* other : track->m_TracksConnected )
+            connect( ii, other );
     }
 
-    // Examine connections between intersecting pads, and propagate
-    // sub_netcodes to intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
+    // Connections between intersecting pads
+    for( unsigned ii = trackCount; ii < items.size(); ++ii )
     {
-        D_PAD* curr_pad = m_sortedPads[ii];
-
-        for( unsigned jj = 0; jj < curr_pad->m_PadsConnected.size(); jj++ )
-        {
-            D_PAD* pad = curr_pad->m_PadsConnected[jj];
+        for( D_PAD* pad : static_cast<D_PAD*>( items[ii] )->m_PadsConnected )
+            connect( ii, pad );
+    }
 
-            if( curr_pad->GetSubNet() )   // the current pad is already attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    // Store the initial subnets, which will be modified by Merge_PadsSubNets
-                    int subnet1 = pad->GetSubNet();
-                    int subnet2 = curr_pad->GetSubNet();
+    // Give a sub netcode to each cluster, in the order of their first item.
+    // Items connected to nothing are not a cluster member (but the first track is)
+    std::vector<int> subnets( items.size(), 0 );
+    int sub_netcode = 0;
 
-                    // merge subnets of pads only, even those not connected by tracks
-                    Merge_PadsSubNets( subnet1, subnet2 );
+    for( unsigned ii = 0; ii < items.size(); ++ii )
+    {
+        int root = clusters.Find( ii );
 
-                    // merge subnets of tracks (and pads, which are already merged)
-                    Merge_SubNets( subnet1, subnet2 );
-                }
-                else
-                {
-                    // The pad is not yet attached to a cluster,
-                    // so we can add this pad to the cluster
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
-            else   // the current pad is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // the connected pad is in a cluster,
-                    // so we can add the current pad to the cluster
-                    curr_pad->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    // the connected pad is not in a cluster,
-                    // so we must create a new cluster, with the 2 pads.
-                    sub_netcode++;
-                    curr_pad->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
+        if( clusters.Size( root ) < 2 && !( ii == 0 && trackCount ) )
+        {
+            items[ii]->SetSubNet( 0 );
+            continue;
         }
+
+        if( !subnets[root] )
+            subnets[root] = ++sub_netcode;
+
+        items[ii]->SetSubNet( subnets[root] );
     }
 }
 
+
 /*
  * Test all connections of the board,
  * and update subnet variable of pads and tracks
@@ -790,54 +730,66 @@ void CONNECTIONS::Propagate_SubNets()
  */
 void PCB_BASE_FRAME::TestConnections()
 {
+    CONNECTIONS::TestBoardConnections( m_Pcb );
+}
+
+
+void CONNECTIONS::TestBoardConnections( BOARD* aBoard )
+{
+    // Nothing changed since the last test: the subnets are up to date
+    if( aBoard->m_Status_Pcb & CONNEXION_OK )
+        return;
+
     // Clear the cluster identifier for all pads
-    for( unsigned i = 0;  i< m_Pcb->GetPadCount();  ++i )
+    for( unsigned i = 0;  i< aBoard->GetPadCount();  ++i )
     {
-        D_PAD* pad = m_Pcb->GetPad(i);
+        D_PAD* pad = aBoard->GetPad(i);
 
         pad->SetZoneSubNet( 0 );
         pad->SetSubNet( 0 );
     }
 
-    m_Pcb->Test_Connections_To_Copper_Areas();
+    aBoard->Test_Connections_To_Copper_Areas();
 
     // Test existing connections net by net
     // note some nets can have no tracks, and pads intersecting
-    // so Build_CurrNet_SubNets_Connections must be called for each net
-    CONNECTIONS connections( m_Pcb );
+    // so Build_CurrNet_SubNets_Connections must be called for each net.
+    // The first and last tracks of each net, NULL for nets having no tracks
+    int netsCount = aBoard->GetNetCount();
+    std::vector< std::pair<TRACK*, TRACK*> > netTracks( std::max( netsCount, 1 ) );
 
-    int last_net_tested = 0;
-    int current_net_code = 0;
-
-    for( TRACK* track = m_Pcb->m_Track; track; )
+    for( TRACK* track = aBoard->m_Track; track; )
     {
         // At this point, track is the first track of a given net
-        current_net_code = track->GetNetCode();
+        int current_net_code = track->GetNetCode();
 
         // Get last track of the current net
         TRACK* lastTrack = track->GetEndNetCode( current_net_code );
 
-        if( current_net_code > 0 )  // do not spend time if net code = 0 ( dummy net )
-        {
-            // Test all previous nets having no tracks
-            for( int net = last_net_tested+1; net < current_net_code; net++ )
-                connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
-
-            connections.Build_CurrNet_SubNets_Connections( track, lastTrack, current_net_code );
-            last_net_tested = current_net_code;
-        }
+        // do not spend time if net code = 0 ( dummy net )
+        if( current_net_code > 0 && current_net_code < netsCount )
+            netTracks[current_net_code] = std::make_pair( track, lastTrack );
 
         track = lastTrack->Next();    // this is now the first track of the next net
     }
 
-    // Test last nets without tracks, if any
-    int netsCount = m_Pcb->GetNetCount();
-    for( int net = last_net_tested+1; net < netsCount; net++ )
-        connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
+    // Nets do not share items, so they are tested in parallel
+    std::atomic<int> nextNet( 1 );
 
-    Merge_SubNets_Connected_By_CopperAreas( m_Pcb );
+    runWorkers( netsCount, [&]()
+    {
+        CONNECTIONS connections( aBoard );
 
-    return;
+        for( int net = nextNet++; net < netsCount; net = nextNet++ )
+        {
+            connections.Build_CurrNet_SubNets_Connections( netTracks[net].first,
+                                                           netTracks[net].second, net );
+        }
+    } );
+
+    Merge_SubNets_Connected_By_CopperAreas( aBoard );
+
+    aBoard->m_Status_Pcb |= CONNEXION_OK;
 }
 
 
@@ -921,6 +873,9 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     // Build the net info list
     GetBoard()->BuildListOfNets();
 
+    // Subnets have to be computed again for the new net codes
+    m_Pcb->m_Status_Pcb &= ~CONNEXION_OK;
+
 #ifdef PCBNEW_WITH_TRACKITEMS
     // Via Stitching. Temp container.
     std::unordered_map<const VIA*, int> collected_vias;
@@ -970,17 +925,35 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
             t->SetNetCode( t->m_PadsConnected[0]->GetNetCode() );
     }
 
-    // Pass 2: build connections between track ends
+    // Pass 2: build connections between track ends.
+    // Each track only writes its own list, so the tracks are shared between threads.
+    // The propagation below stays serial: it reads the net codes in the track list order,
+    // so the net given to a group of shorted tracks is the same as before
+    std::vector<TRACK*> tracks;
+
     for( TRACK* t = m_Pcb->m_Track;  t;  t = t->Next() )
+        tracks.push_back( t );
+
+    std::atomic<size_t> nextTrack( 0 );
+
+    runWorkers( tracks.size() / 256 + 1, [&]()
     {
+        // Each thread needs its own search buffers
+        CONNECTIONS threadConnections( connections );
+
+        for( size_t ii = nextTrack++; ii < tracks.size(); ii = nextTrack++ )
+        {
+            TRACK* t = tracks[ii];
+
 #ifdef PCBNEW_WITH_TRACKITEMS
-        if( (t->Type() == PCB_VIA_T) && dynamic_cast<VIA*>(t)->GetThermalCode() )
-            continue;
+            if( (t->Type() == PCB_VIA_T) && dynamic_cast<VIA*>(t)->GetThermalCode() )
+                continue;
 #endif
 
-        connections.SearchConnectedTracks( t );
-        connections.GetConnectedTracks( t );
-    }
+            threadConnections.SearchConnectedTracks( t );
+            threadConnections.GetConnectedTracks( t );
+        }
+    } );
 
     // Propagate net codes from a segment to other connected segments
     bool new_pass_request = true;   // set to true if a track has its netcode changed from 0
@@ -99,11 +99,25 @@ private:
     const TRACK * m_firstTrack;                 // The first track used to build m_Candidates
     const TRACK * m_lastTrack;                  // The last track used to build m_Candidates
     std::vector<D_PAD*> m_sortedPads;           // list of sorted pads by X (then Y) coordinate
+    std::vector<CONNECTED_POINT*> m_nearCandidates; // Buffer used by SearchConnectedTracks
 
 public:
     CONNECTIONS( BOARD * aBrd );
     ~CONNECTIONS() {};
 
+    /**
+     * Function TestBoardConnections
+     * computes the subnets (clusters of connected items) of all nets of aBoard:
+     * the nets are processed in parallel, then the subnets connected by copper areas
+     * are merged.
+     * After that, the subnets of pads and tracks, and the m_PadsConnected and
+     * m_TracksConnected lists of tracks, can be used until an item is added, removed,
+     * moved, changes its layer or its net: the CONNEXION_OK bit of aBoard->m_Status_Pcb
+     * says they are up to date, and nothing is computed while it is set.
+     * Track segments are assumed to be sorted by net codes.
+     */
+    static void TestBoardConnections( BOARD* aBoard );
+
     /**
      * Function BuildPadsList
      * Fills m_sortedPads with all pads that be connected to tracks
@@ -215,9 +229,8 @@ private:
      * The track list must be sorted by nets, and all segments
      * from m_firstTrack to m_lastTrack have the same net.
      * When 2 items are connected (a track to a pad, or a track to an other track),
-     * they are grouped in a cluster.
-     * For pads, this is the .m_physical_connexion member which is a cluster identifier
-     * For tracks, this is the .m_Subnet member which is a cluster identifier
+     * they are grouped in a cluster, using a union-find structure.
+     * For pads and tracks, the .m_Subnet member is the cluster identifier
      * For a given net, if all tracks are created, there is only one cluster.
      * but if not all tracks are created, there are more than one cluster,
      * and some ratsnests will be left active.
@@ -235,30 +248,6 @@ private:
      * @return the index of item found or -1 if no candidate
      */
     int searchEntryPointInCandidatesList( const wxPoint & aPoint);
-
-    /**
-     * Function Merge_SubNets
-     * Change a subnet old value to a new value, for tracks and pads which are connected to
-     * tracks from m_firstTrack to m_lastTrack and their connected pads.
-     * and modify the subnet parameter (change the old value to the new value).
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting sub net value is the smallest between aOldSubNet and aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
-     */
-    int Merge_SubNets( int aOldSubNet, int aNewSubNet );
-
-    /**
-     * Function Merge_PadsSubNets
-     * Change a subnet value to a new value, in m_sortedPads pad list
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
-     */
-    int Merge_PadsSubNets( int aOldSubNet, int aNewSubNet );
 };
 
 #endif      //  ifndef CONNECT_H
@@ -31,6 +31,7 @@
 #include <confirm.h>
 #include <wxPcbStruct.h>
 #include <pcbplot.h>
+#include <plotcontroller.h>
 #include <base_units.h>
 #include <macros.h>
 #include <reporter.h>
@@ -782,8 +783,6 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
     if( m_PSFineAdjustWidthOpt->IsEnabled() )
         m_plotOpts.SetWidthAdjust( m_PSWidthAdjust );
 
-    wxString file_ext( GetDefaultPlotExtension( m_plotOpts.GetFormat() ) );
-
     // Test for a reasonable scale value
     // XXX could this actually happen? isn't it constrained in the apply
     // function?
@@ -800,6 +799,9 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    PLOT_CONTROLLER plotController( m_board );
+    plotController.GetPlotOptions() = m_plotOpts;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -813,38 +815,27 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         if( ( LSET::AllCuMask() & ~m_board->GetEnabledLayers() )[layer] )
             continue;
 
-        // Pick the basename from the board file
-        wxFileName fn( boardFilename );
-
-        // Use Gerber Extensions based on layer number
-        // (See http://en.wikipedia.org/wiki/Gerber_File)
-        if( m_plotOpts.GetFormat() == PLOT_FORMAT_GERBER && m_useGerberExtensions->GetValue() )
-            file_ext = GetGerberProtelExtension( layer );
-
-        BuildPlotFileName( &fn, outputDir.GetPath(),
-                           m_board->GetLayerName( layer ),
-                           file_ext );
+        plotController.AddLayerPlot( layer, m_board->GetLayerName( layer ), wxEmptyString );
+    }
 
-        LOCALE_IO toggle;
+    // The layers are plotted at the same time, each one in its own file
+    plotController.PlotLayers( m_plotOpts.GetFormat() );
 
-        BOARD*      board = m_parent->GetBoard();
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    for( int ii = 0; ii < plotController.GetLayerPlotCount(); ++ii )
+    {
+        const PLOT_LAYER_JOB& job = plotController.GetLayerPlot( ii );
 
         // Print diags in messages box:
         wxString msg;
 
-        if( plotter )
+        if( job.m_success )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file '%s' created." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Plot file '%s' created." ), GetChars( job.m_fileName ) );
             reporter.Report( msg, REPORTER::RPT_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file '%s'." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Unable to create file '%s'." ), GetChars( job.m_fileName ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
@@ -48,14 +48,21 @@
 
 #include <pcbnew.h>
 #include <drc_stuff.h>
+#include <drc_item_index.h>
 
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
 #include <board_commit.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #ifdef PCBNEW_WITH_TRACKITEMS
 #include "trackitems/trackitems.h"
 #include "trackitems/viastitching.h"
+
+thread_local std::vector<MARKER_PCB*>* DRC::m_collectedMarkers = nullptr;
 #endif
 
 
@@ -116,11 +123,19 @@ void DRC::DestroyDRCDialog( int aReason )
 }
 
 
-DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
+DRC::DRC( PCB_EDIT_FRAME* aPcbWindow ) :
+    DRC( aPcbWindow->GetBoard() )
 {
     m_pcbEditorFrame = aPcbWindow;
-    m_pcb = aPcbWindow->GetBoard();
+}
+
+
+DRC::DRC( BOARD* aBoard )
+{
+    m_pcbEditorFrame = NULL;
+    m_pcb = aBoard;
     m_drcDialog  = NULL;
+    m_itemIndex  = NULL;
 
     // establish initial values for everything:
     m_doPad2PadTest     = true;     // enable pad to pad clearance tests
@@ -205,6 +220,40 @@ int DRC::Drc( ZONE_CONTAINER* aArea, int aCornerIndex )
 }
 
 
+#ifdef PCBNEW_WITH_TRACKITEMS
+bool DRC::OnlineTrackDrc( TRACK* aRefSeg, DRC_ITEM_INDEX* aIndex )
+{
+    // the board can be reloaded
+    m_pcb = m_pcbEditorFrame->GetBoard();
+
+    // Only the items near aRefSeg are tested
+    m_itemIndex = aIndex;
+    bool ok = doTrackDrc( aRefSeg, m_pcb->m_Track, true );
+    m_itemIndex = NULL;
+
+    if( !ok )
+    {
+        wxASSERT( m_currentMarker );
+
+        m_currentMarker->SetItem( aRefSeg );
+
+        if( m_collectedMarkers )
+            m_collectedMarkers->push_back( m_currentMarker );
+        else
+        {
+            m_pcb->Add( m_currentMarker );
+            m_pcbEditorFrame->GetGalCanvas()->GetView()->Add( static_cast<BOARD_ITEM*>( m_currentMarker ) );
+        }
+
+        m_currentMarker = nullptr;
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
     // be sure m_pcb is the current board, not a old one
@@ -530,16 +579,21 @@ void DRC::testPad2Pad()
 }
 
 
+// This is the number of tests between 2 calls to the progress bar
+static const int TRACK_PROGRESS_DELTA = 500;
+
+
 void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 {
     wxProgressDialog * progressDialog = NULL;
-    const int delta = 500;  // This is the number of tests between 2 calls to the
-                            // progress bar
-    int count = 0;
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
-        count++;
+    const int delta = TRACK_PROGRESS_DELTA;
+
+    std::vector<TRACK*> segments;
 
-    int deltamax = count/delta;
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        segments.push_back( segm );
+
+    int deltamax = segments.size() / delta;
 
     if( aShowProgressBar && deltamax > 3 )
     {
@@ -550,43 +604,148 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    // Do not spawn threads for small boards: one thread handles at least delta segments.
+    size_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount = std::min( threadCount, segments.size() / delta + 1 );
 
-    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+    std::vector<SEGMENT_MARKERS> markers;
+
+    collectTrackMarkers( segments, threadCount, markers, progressDialog, aActiveWindow );
+
+    for( auto& segmMarkers : markers )
     {
-        if ( ii++ > delta )
+        for( MARKER_PCB* marker : segmMarkers.itemMarkers )
         {
-            ii = 0;
-            count++;
+            m_pcb->Add( marker );
+            m_pcbEditorFrame->GetGalCanvas()->GetView()->Add( static_cast<BOARD_ITEM*>( marker ) );
+        }
 
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
-#ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
-#endif
-            }
+        if( segmMarkers.drcMarker )
+            addMarkerToPcb( segmMarkers.drcMarker );
+
+        for( MARKER_PCB* marker : segmMarkers.ruleMarkers )
+        {
+            m_pcb->Add( marker );
+            m_pcbEditorFrame->GetGalCanvas()->GetView()->Add( static_cast<BOARD_ITEM*>( marker ) );
         }
+    }
+
+    if( progressDialog )
+        progressDialog->Destroy();
+}
+
 
-        if( !doTrackDrc( segm, segm->Next(), true ) )
+void DRC::collectTrackMarkers( const std::vector<TRACK*>& aSegments, size_t aThreadCount,
+                               std::vector<SEGMENT_MARKERS>& aMarkers,
+                               wxProgressDialog* aProgressDialog, wxWindow* aActiveWindow )
+{
+    const int delta = TRACK_PROGRESS_DELTA;
+
+    // Tracks and pads near each reference segment are found from this index,
+    // instead of testing all of them
+    DRC_ITEM_INDEX itemIndex( m_pcb );
+    m_itemIndex = &itemIndex;
+
+    aMarkers.clear();
+    aMarkers.resize( aSegments.size() );
+
+    std::atomic<size_t> nextSegment( 0 );
+    std::atomic<bool>   abort( false );
+
+    auto testSegment = [&]( DRC& aDrc, size_t aIndex )
+    {
+        TRACK* segm = aSegments[aIndex];
+
+#ifdef PCBNEW_WITH_TRACKITEMS
+        m_collectedMarkers = &aMarkers[aIndex].itemMarkers;
+#endif
+        if( !aDrc.doTrackDrc( segm, segm->Next(), true ) )
         {
-            wxASSERT( m_currentMarker );
-            addMarkerToPcb ( m_currentMarker );
-            m_currentMarker = nullptr;
+            wxASSERT( aDrc.m_currentMarker );
+            aMarkers[aIndex].drcMarker = aDrc.m_currentMarker;
+            aDrc.m_currentMarker = nullptr;
         }
 
 #ifdef PCBNEW_WITH_TRACKITEMS
         //Test Thermal via.
-        m_pcb->ViaStitching()->RuleCheck( segm, this );
+        m_collectedMarkers = &aMarkers[aIndex].ruleMarkers;
+        m_pcb->ViaStitching()->RuleCheck( segm, &aDrc );
+        m_collectedMarkers = nullptr;
 #endif
+    };
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 1; ii < aThreadCount; ++ii )
+    {
+        threads.push_back( std::thread( [&]() {
+            DRC drc( m_pcb );
+            drc.m_itemIndex = &itemIndex;
+            size_t index;
+
+            while( !abort.load() && ( index = nextSegment++ ) < aSegments.size() )
+                testSegment( drc, index );
+        } ) );
     }
 
-    if( progressDialog )
-        progressDialog->Destroy();
+    // This thread also tests segments, and keeps the progress bar alive.
+    size_t index;
+    int count = 0;
+
+    while( !abort.load() && ( index = nextSegment++ ) < aSegments.size() )
+    {
+        testSegment( *this, index );
+
+        if( aProgressDialog && int( index / delta ) > count )
+        {
+            count = index / delta;
+
+            if( !aProgressDialog->Update( count, wxEmptyString ) )
+            {
+                abort.store( true );    // Aborted by user
+                break;
+            }
+#ifdef __WXMAC__
+            // Work around a dialog z-order issue on OS X
+            if( count == int( aSegments.size() / delta ) )
+                aActiveWindow->Raise();
+#endif
+        }
+    }
+
+    for( auto& thread : threads )
+        thread.join();
+
+    m_itemIndex = NULL;
+}
+
+
+std::vector<MARKER_PCB*> DRC::TestTrackClearances( size_t aThreadCount )
+{
+    std::vector<TRACK*> segments;
+
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        segments.push_back( segm );
+
+    std::vector<SEGMENT_MARKERS> markers;
+
+    collectTrackMarkers( segments, std::max<size_t>( aThreadCount, 1 ), markers, NULL, NULL );
+
+    std::vector<MARKER_PCB*> result;
+
+    for( auto& segmMarkers : markers )
+    {
+        result.insert( result.end(), segmMarkers.itemMarkers.begin(),
+                       segmMarkers.itemMarkers.end() );
+
+        if( segmMarkers.drcMarker )
+            result.push_back( segmMarkers.drcMarker );
+
+        result.insert( result.end(), segmMarkers.ruleMarkers.begin(),
+                       segmMarkers.ruleMarkers.end() );
+    }
+
+    return result;
 }
 
 
@@ -597,6 +756,12 @@ void DRC::testUnconnected()
         wxClientDC dc( m_pcbEditorFrame->GetCanvas() );
         m_pcbEditorFrame->Compile_Ratsnest( &dc, true );
     }
+    else if( (m_pcb->m_Status_Pcb & CONNEXION_OK) == 0 )
+    {
+        // Only the connections changed since the ratsnest was built
+        m_pcbEditorFrame->TestConnections();
+        m_pcbEditorFrame->TestForActiveLinksInRatsnest( 0 );
+    }
 
     if( m_pcb->GetRatsnestsCount() == 0 )
         return;
@@ -37,6 +37,7 @@
 
 #include <pcbnew.h>
 #include <drc_stuff.h>
+#include <drc_item_index.h>
 
 #include <class_board.h>
 #include <class_module.h>
@@ -290,15 +291,26 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
     dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
 
+    // Only items in the reference segment neighbourhood are tested when the
+    // broadphase index is available.  It is used only for the tracks after aRefSeg
+    // in the track list or for the whole list, because other callers give an
+    // arbitrary aStart list.
+    bool allTracks = aStart == m_pcb->m_Track;
+    bool useIndex = m_itemIndex && m_itemIndex->Contains( aRefSeg )
+                    && ( aStart == aRefSeg->Next() || allTracks );
+
     // Compute the min distance to pads
     if( testPads )
     {
-        unsigned pad_count = m_pcb->GetPadCount();
+        std::vector<D_PAD*> nearPads;
 
-        for( unsigned ii = 0;  ii<pad_count;  ++ii )
-        {
-            D_PAD* pad = m_pcb->GetPad( ii );
+        if( useIndex )
+            m_itemIndex->QueryPads( aRefSeg, nearPads );
+
+        const std::vector<D_PAD*>& pads = useIndex ? nearPads : m_pcb->GetPads();
 
+        for( D_PAD* pad : pads )
+        {
             /* No problem if pads are on an other layer,
              * But if a drill hole exists	(a pad on a single layer can have a hole!)
              * we must test the hole
@@ -381,7 +393,23 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
     // Test the reference segment with other track segments
     wxPoint segStartPoint;
     wxPoint segEndPoint;
-    for( track = aStart; track; track = track->Next() )
+    std::vector<TRACK*> candidates;
+    size_t candidate = 0;
+
+    if( useIndex )
+        m_itemIndex->QueryTracks( aRefSeg, candidates, !allTracks );
+
+    auto nextTrack = [&]( TRACK* aTrack ) -> TRACK*
+    {
+        if( !useIndex )
+            return aTrack->Next();
+
+        return ++candidate < candidates.size() ? candidates[candidate] : nullptr;
+    };
+
+    track = useIndex ? ( candidates.empty() ? nullptr : candidates[0] ) : aStart;
+
+    for( ; track; track = nextTrack( track ) )
     {
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
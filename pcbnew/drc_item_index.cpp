@@ -0,0 +1,365 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drc_item_index.cpp
+ */
+
+#include <fctsys.h>
+#include <algorithm>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_module.h>
+
+#include <drc_item_index.h>
+
+
+DRC_ITEM_INDEX::DRC_ITEM_INDEX( BOARD* aPcb )
+{
+    // Tracks have no local clearance, so the netclass clearance is their biggest one.
+    // Pads can have a local (or footprint) clearance bigger than the netclasses clearance.
+    // One nanometer is added to be safe against rounding in the fine tests.
+    m_netclassClearance = aPcb->GetDesignSettings().GetBiggestClearanceValue() + 1;
+
+    for( TRACK* track = aPcb->m_Track; track; track = track->Next() )
+        addTrack( track );
+
+    for( unsigned ii = 0; ii < aPcb->GetPadCount(); ++ii )
+        addPad( aPcb->GetPad( ii ) );
+}
+
+
+DRC_ITEM_INDEX::~DRC_ITEM_INDEX()
+{
+}
+
+
+void DRC_ITEM_INDEX::setTrackPlace( const TRACK* aTrack, ITEM_ENTRY& aEntry )
+{
+    aEntry.m_box = aTrack->GetBoundingBox();
+    aEntry.m_box.Inflate( m_netclassClearance );
+    aEntry.m_layers = aTrack->GetLayerSet() & LSET::AllCuMask();
+}
+
+
+void DRC_ITEM_INDEX::addTrack( TRACK* aTrack )
+{
+    ITEM_ENTRY entry;
+
+    entry.m_id = m_tracks.size();
+    setTrackPlace( aTrack, entry );
+
+    m_tracks.push_back( aTrack );
+    m_trackEntries[aTrack] = entry;
+    insert( m_trackTrees, entry );
+}
+
+
+void DRC_ITEM_INDEX::addPad( D_PAD* aPad )
+{
+    ITEM_ENTRY entry;
+
+    entry.m_id = m_pads.size();
+    entry.m_box = aPad->GetBoundingBox();
+    entry.m_layers = aPad->GetLayerSet() & LSET::AllCuMask();
+
+    // A pad hole is tested on every copper layer, even if the pad is not on this layer
+    if( aPad->GetDrillSize().x )
+    {
+        EDA_RECT hole( aPad->GetPosition(), wxSize( 0, 0 ) );
+        hole.Inflate( std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2 );
+        entry.m_box.Merge( hole );
+        entry.m_layers = LSET::AllCuMask();
+    }
+
+    entry.m_box.Inflate( std::max( std::max( m_netclassClearance, aPad->GetClearance() + 1 ),
+                                   aPad->GetThermalGap() ) );
+
+    m_pads.push_back( aPad );
+    m_padEntries[aPad] = entry;
+    m_modulePads[aPad->GetParent()].push_back( aPad );
+    insert( m_padTrees, entry );
+}
+
+
+void DRC_ITEM_INDEX::removeTrack( const TRACK* aTrack )
+{
+    auto it = m_trackEntries.find( aTrack );
+
+    if( it == m_trackEntries.end() )
+        return;
+
+    remove( m_trackTrees, it->second );
+    m_tracks[it->second.m_id] = NULL;
+    m_trackEntries.erase( it );
+
+    compact( m_tracks, m_trackEntries, m_trackTrees );
+}
+
+
+void DRC_ITEM_INDEX::removePad( const D_PAD* aPad )
+{
+    auto it = m_padEntries.find( aPad );
+
+    if( it == m_padEntries.end() )
+        return;
+
+    remove( m_padTrees, it->second );
+    m_pads[it->second.m_id] = NULL;
+    m_padEntries.erase( it );
+
+    compact( m_pads, m_padEntries, m_padTrees );
+}
+
+
+template <class T>
+void DRC_ITEM_INDEX::compact( std::vector<T*>& aItems,
+                              std::unordered_map<const T*, ITEM_ENTRY>& aEntries,
+                              ITEM_TREE* aTrees )
+{
+    // Small lists are not worth it, and the removed ids are compacted only when they are
+    // more than the live ones, so the cost of the rebuild is shared by many removals
+    const size_t MIN_COMPACT_SIZE = 256;
+
+    if( aItems.size() < MIN_COMPACT_SIZE || 2 * aEntries.size() >= aItems.size() )
+        return;
+
+    for( int layer = 0; layer < MAX_CU_LAYERS; ++layer )
+        aTrees[layer].RemoveAll();
+
+    int count = 0;
+
+    for( T* item : aItems )
+    {
+        if( !item )
+            continue;
+
+        ITEM_ENTRY& entry = aEntries[item];
+
+        entry.m_id = count;
+        aItems[count++] = item;
+        insert( aTrees, entry );
+    }
+
+    aItems.resize( count );
+}
+
+
+void DRC_ITEM_INDEX::Add( BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+#ifdef PCBNEW_WITH_TRACKITEMS
+    case PCB_TEARDROP_T:
+    case PCB_ROUNDEDTRACKSCORNER_T:
+#endif
+        if( !Contains( static_cast<TRACK*>( aItem ) ) )
+            addTrack( static_cast<TRACK*>( aItem ) );
+        break;
+
+    case PCB_MODULE_T:
+        for( D_PAD* pad = static_cast<MODULE*>( aItem )->PadsList(); pad; pad = pad->Next() )
+        {
+            if( !m_padEntries.count( pad ) )
+                addPad( pad );
+        }
+        break;
+
+    case PCB_PAD_T:
+        if( !m_padEntries.count( static_cast<D_PAD*>( aItem ) ) )
+            addPad( static_cast<D_PAD*>( aItem ) );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void DRC_ITEM_INDEX::Remove( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+#ifdef PCBNEW_WITH_TRACKITEMS
+    case PCB_TEARDROP_T:
+    case PCB_ROUNDEDTRACKSCORNER_T:
+#endif
+        removeTrack( static_cast<const TRACK*>( aItem ) );
+        break;
+
+    case PCB_MODULE_T:
+    {
+        auto it = m_modulePads.find( aItem );
+
+        if( it == m_modulePads.end() )
+            break;
+
+        for( const D_PAD* pad : it->second )
+            removePad( pad );
+
+        m_modulePads.erase( it );
+        break;
+    }
+
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+        auto it = m_modulePads.find( pad->GetParent() );
+
+        removePad( pad );
+
+        if( it != m_modulePads.end() )
+            it->second.erase( std::remove( it->second.begin(), it->second.end(), pad ),
+                              it->second.end() );
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+void DRC_ITEM_INDEX::Update( BOARD_ITEM* aItem )
+{
+    auto it = m_trackEntries.find( dynamic_cast<TRACK*>( aItem ) );
+
+    if( it == m_trackEntries.end() )
+    {
+        Remove( aItem );
+        Add( aItem );
+        return;
+    }
+
+    // A track keeps its id, so the id list does not grow when items are edited
+    remove( m_trackTrees, it->second );
+    setTrackPlace( it->first, it->second );
+    insert( m_trackTrees, it->second );
+}
+
+
+void DRC_ITEM_INDEX::insert( ITEM_TREE* aTrees, const ITEM_ENTRY& aEntry )
+{
+    const int mmin[2] = { aEntry.m_box.GetX(), aEntry.m_box.GetY() };
+    const int mmax[2] = { aEntry.m_box.GetRight(), aEntry.m_box.GetBottom() };
+
+    for( PCB_LAYER_ID layer : aEntry.m_layers.Seq() )
+        aTrees[layer].Insert( mmin, mmax, aEntry.m_id );
+}
+
+
+void DRC_ITEM_INDEX::remove( ITEM_TREE* aTrees, const ITEM_ENTRY& aEntry )
+{
+    const int mmin[2] = { aEntry.m_box.GetX(), aEntry.m_box.GetY() };
+    const int mmax[2] = { aEntry.m_box.GetRight(), aEntry.m_box.GetBottom() };
+
+    for( PCB_LAYER_ID layer : aEntry.m_layers.Seq() )
+        aTrees[layer].Remove( mmin, mmax, aEntry.m_id );
+}
+
+
+void DRC_ITEM_INDEX::query( ITEM_TREE* aTrees, const EDA_RECT& aBox, LSET aLayers,
+                            std::vector<int>& aItems )
+{
+    const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+    const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+    auto visitor = [&aItems]( intptr_t aItem ) -> bool
+    {
+        aItems.push_back( int( aItem ) );
+        return true;
+    };
+
+    for( PCB_LAYER_ID layer : aLayers.Seq() )
+        aTrees[layer].Search( mmin, mmax, visitor );
+
+    // Vias and pad holes are in several layers
+    std::sort( aItems.begin(), aItems.end() );
+    aItems.erase( std::unique( aItems.begin(), aItems.end() ), aItems.end() );
+}
+
+
+void DRC_ITEM_INDEX::QueryTracks( const TRACK* aRefSeg, std::vector<TRACK*>& aTracks,
+                                  bool aAfterOnly )
+{
+    aTracks.clear();
+
+    auto it = m_trackEntries.find( aRefSeg );
+
+    if( it == m_trackEntries.end() )
+        return;
+
+    std::vector<int> items;
+    query( m_trackTrees, aRefSeg->GetBoundingBox(),
+           aRefSeg->GetLayerSet() & LSET::AllCuMask(), items );
+
+    for( int item : items )
+    {
+        if( item > it->second.m_id || ( !aAfterOnly && item != it->second.m_id ) )
+            aTracks.push_back( m_tracks[item] );
+    }
+}
+
+
+void DRC_ITEM_INDEX::QueryTracks( const EDA_RECT& aArea, std::vector<TRACK*>& aTracks,
+                                  LSET aLayers )
+{
+    aTracks.clear();
+
+    std::vector<int> items;
+    query( m_trackTrees, aArea, aLayers & LSET::AllCuMask(), items );
+
+    for( int item : items )
+        aTracks.push_back( m_tracks[item] );
+}
+
+
+void DRC_ITEM_INDEX::QueryPads( const TRACK* aRefSeg, std::vector<D_PAD*>& aPads )
+{
+    aPads.clear();
+
+    std::vector<int> items;
+    query( m_padTrees, aRefSeg->GetBoundingBox(),
+           aRefSeg->GetLayerSet() & LSET::AllCuMask(), items );
+
+    for( int item : items )
+        aPads.push_back( m_pads[item] );
+}
+
+
+void DRC_ITEM_INDEX::QueryPads( const EDA_RECT& aArea, LSET aLayers, std::vector<D_PAD*>& aPads )
+{
+    aPads.clear();
+
+    std::vector<int> items;
+    query( m_padTrees, aArea, aLayers & LSET::AllCuMask(), items );
+
+    for( int item : items )
+        aPads.push_back( m_pads[item] );
+}
@@ -0,0 +1,192 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drc_item_index.h
+ */
+
+#ifndef DRC_ITEM_INDEX_H
+#define DRC_ITEM_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include <class_eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+class BOARD;
+class BOARD_ITEM;
+class TRACK;
+class D_PAD;
+
+
+/**
+ * Class DRC_ITEM_INDEX
+ * is a board wide spatial index of the tracks, vias and pads used as broadphase
+ * by DRC::doTrackDrc(), and to find the items near a zone.  One R-tree is kept for each
+ * copper layer, and every item bounding box is inflated by the biggest clearance it can
+ * have (and by the pad thermal gap), so a query with the bounding box of a reference
+ * segment returns all the items that may be too close.
+ *
+ * DRC::testTracks() builds the index as a snapshot of the board, which must not be
+ * used after items were added, removed or moved.  Queries only read the trees, so they
+ * can be made from several threads.
+ *
+ * The online DRC of the track items keeps its index from one commit to the next, and
+ * updates it with Add(), Remove() and Update() when board items change.  Items keep the
+ * order of the board lists only in a snapshot, so QueryTracks() of a kept index must
+ * be used with aAfterOnly = false.
+ */
+class DRC_ITEM_INDEX
+{
+public:
+    DRC_ITEM_INDEX( BOARD* aPcb );
+    ~DRC_ITEM_INDEX();
+
+    /**
+     * Function QueryTracks
+     * collects the tracks and vias which may be within clearance of aRefSeg on one of
+     * its copper layers.
+     * @param aRefSeg = the reference segment, which must be in the index
+     * @param aTracks = the found items, in track list order for a snapshot
+     * @param aAfterOnly = true to collect only the items placed after aRefSeg in the
+     * board track list, false to collect all of them but aRefSeg
+     */
+    void QueryTracks( const TRACK* aRefSeg, std::vector<TRACK*>& aTracks,
+                      bool aAfterOnly = true );
+
+    /**
+     * Function QueryTracks
+     * collects the tracks and vias which may be within clearance of an item which
+     * bounding box is aArea, on one of aLayers.
+     */
+    void QueryTracks( const EDA_RECT& aArea, std::vector<TRACK*>& aTracks,
+                      LSET aLayers = LSET::AllCuMask() );
+
+    /**
+     * Function QueryPads
+     * collects the pads which may be within clearance of aRefSeg, either because they
+     * are on a common copper layer or because they have a hole.
+     * @param aRefSeg = the reference segment
+     * @param aPads = the found pads, in BOARD::GetPad() order for a snapshot
+     */
+    void QueryPads( const TRACK* aRefSeg, std::vector<D_PAD*>& aPads );
+
+    /**
+     * Function QueryPads
+     * collects the pads which may be within clearance or thermal gap of an item which
+     * bounding box is aArea, on one of aLayers or with a hole.
+     */
+    void QueryPads( const EDA_RECT& aArea, LSET aLayers, std::vector<D_PAD*>& aPads );
+
+    /**
+     * Function Contains
+     * @return true if aTrack was indexed.
+     */
+    bool Contains( const TRACK* aTrack ) const
+    {
+        return m_trackEntries.find( aTrack ) != m_trackEntries.end();
+    }
+
+    /**
+     * Function Add
+     * indexes aItem: a track or a via, a pad or all the pads of a footprint.  Other
+     * items are ignored.
+     */
+    void Add( BOARD_ITEM* aItem );
+
+    /**
+     * Function Remove
+     * removes aItem from the index: a track or a via, a pad or all the pads of a
+     * footprint.
+     */
+    void Remove( const BOARD_ITEM* aItem );
+
+    /**
+     * Function Update
+     * indexes aItem again after it was moved or changed.
+     */
+    void Update( BOARD_ITEM* aItem );
+
+    /**
+     * Function GetClearance
+     * @return the biggest netclass clearance when the index was built.  The index must be
+     * built again if the board design rules have a bigger clearance.
+     */
+    int GetClearance() const
+    {
+        return m_netclassClearance;
+    }
+
+private:
+    // Items are stored by their index in m_tracks or m_pads, so query results can be
+    // sorted back to the order used by the unindexed tests.  The R-tree stores its data in
+    // a pointer, so the index is stored as a pointer sized integer.  A removed item leaves
+    // a NULL in its list, until compact() drops them.
+    typedef RTree<intptr_t, int, 2, double> ITEM_TREE;
+
+    /// The place of an item in the trees, needed to remove it
+    struct ITEM_ENTRY
+    {
+        int         m_id;
+        EDA_RECT    m_box;          ///< inflated bounding box
+        LSET        m_layers;
+    };
+
+    void setTrackPlace( const TRACK* aTrack, ITEM_ENTRY& aEntry );
+    void addTrack( TRACK* aTrack );
+    void addPad( D_PAD* aPad );
+    void removeTrack( const TRACK* aTrack );
+    void removePad( const D_PAD* aPad );
+
+    /**
+     * Gives new ids to the items of aItems still indexed, in the same order, once more
+     * than half of the ids are those of removed items, and indexes them again.
+     */
+    template <class T>
+    void compact( std::vector<T*>& aItems, std::unordered_map<const T*, ITEM_ENTRY>& aEntries,
+                  ITEM_TREE* aTrees );
+
+    void insert( ITEM_TREE* aTrees, const ITEM_ENTRY& aEntry );
+    void remove( ITEM_TREE* aTrees, const ITEM_ENTRY& aEntry );
+    void query( ITEM_TREE* aTrees, const EDA_RECT& aBox, LSET aLayers,
+                std::vector<int>& aItems );
+
+    int                                         m_netclassClearance;
+
+    std::vector<TRACK*>                         m_tracks;   ///< by id, NULL when removed
+    std::vector<D_PAD*>                         m_pads;     ///< by id, NULL when removed
+    std::unordered_map<const TRACK*, ITEM_ENTRY> m_trackEntries;
+    std::unordered_map<const D_PAD*, ITEM_ENTRY> m_padEntries;
+
+    /// The indexed pads of each footprint.  A footprint can be removed after its pads were
+    /// replaced or deleted, so they are found here and not from its pad list.
+    std::unordered_map<const BOARD_ITEM*, std::vector<const D_PAD*>> m_modulePads;
+
+    ITEM_TREE m_trackTrees[MAX_CU_LAYERS];
+    ITEM_TREE m_padTrees[MAX_CU_LAYERS];
+};
+
+#endif // DRC_ITEM_INDEX_H
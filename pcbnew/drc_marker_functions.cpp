@@ -264,7 +264,9 @@ void DRC::AddMarker( const BOARD_CONNECTED_ITEM* aItem, const wxPoint aMarkerPos
             aFillMarker->SetItem( aItem );
         }
 
-        if( aFillMarker )
+        if( aFillMarker && m_collectedMarkers )
+            m_collectedMarkers->push_back( aFillMarker );
+        else if( aFillMarker )
         {
             wxASSERT( aFillMarker );
             m_pcb->Add( aFillMarker );
@@ -136,7 +136,9 @@ class ZONE_CONTAINER;
 class TRACK;
 class MARKER_PCB;
 class DRC_ITEM;
+class DRC_ITEM_INDEX;
 class NETCLASS;
+class wxProgressDialog;
 
 
 /**
@@ -248,6 +250,7 @@ private:
     PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board
     BOARD*              m_pcb;
     DIALOG_DRC_CONTROL* m_drcDialog;
+    DRC_ITEM_INDEX*     m_itemIndex;        ///< Broadphase for doTrackDrc, valid during testTracks
 
     DRC_LIST            m_unconnected;      ///< list of unconnected pads, as DRC_ITEMs
 
@@ -331,12 +334,35 @@ private:
      * Function testTracks
      * performs the DRC on all tracks.
      * because this test can take a while, a progress bar can be displayed
+     * Reference segments are shared between worker threads, each with its own DRC
+     * instance.  Markers are added to the board afterwards in track list order, so the
+     * result is the same as when tested in one thread.
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
      * (Note: it is shown only if there are many tracks)
      */
     void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
 
+    /// The markers found for one reference segment by collectTrackMarkers(), in the order
+    /// the single threaded test adds them to the board
+    struct SEGMENT_MARKERS
+    {
+        std::vector<MARKER_PCB*> itemMarkers;   ///< added by track items rules during doTrackDrc
+        MARKER_PCB*              drcMarker = nullptr;
+        std::vector<MARKER_PCB*> ruleMarkers;   ///< added by via stitching rule check
+    };
+
+    /**
+     * Function collectTrackMarkers
+     * tests aSegments on aThreadCount threads, and stores the markers of each segment
+     * in aMarkers instead of adding them to the board.
+     * @param aProgressDialog is updated by the calling thread, can be NULL
+     * @param aActiveWindow is the parent of aProgressDialog
+     */
+    void collectTrackMarkers( const std::vector<TRACK*>& aSegments, size_t aThreadCount,
+                              std::vector<SEGMENT_MARKERS>& aMarkers,
+                              wxProgressDialog* aProgressDialog, wxWindow* aActiveWindow );
+
     void testPad2Pad();
 
     void testUnconnected();
@@ -444,7 +470,7 @@ private:
      */
 #ifdef PCBNEW_WITH_TRACKITEMS
 public:
-    bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
+    static bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
 private:
 #else
     static bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
@@ -466,6 +492,13 @@ private:
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Constructor
+     * for the tests run without an editor frame, which can only use
+     * TestTrackClearances().
+     */
+    DRC( BOARD* aBoard );
+
     ~DRC();
 
     /**
@@ -582,6 +615,16 @@ int Drc( TRACK* aRefSegm, TRACK* aList, const bool aSetMsgPanel = true );
      */
     void ListUnconnectedPads();
 
+    /**
+     * Function TestTrackClearances
+     * runs the track clearance test of the DRC on aThreadCount threads, without
+     * adding the markers to the board.  Used by qa/drc_tracks to check that the
+     * threaded test finds the same markers as the single threaded one.
+     * @return the markers, in the order testTracks() would add them to the board.
+     * The caller owns them.
+     */
+    std::vector<MARKER_PCB*> TestTrackClearances( size_t aThreadCount );
+
     /**
      * @return a pointer to the current marker (last created marker
      */
@@ -592,6 +635,41 @@ int Drc( TRACK* aRefSegm, TRACK* aList, const bool aSetMsgPanel = true );
 
 #ifdef PCBNEW_WITH_TRACKITEMS
     void AddMarker( const BOARD_CONNECTED_ITEM* aItem, const wxPoint aMarkerPos, const int aErrorCode, MARKER_PCB* aFillMarker );
+
+    /**
+     * Function CollectedMarkers
+     * @return the list where markers created in the calling thread are collected instead of
+     * adding them to the board, or NULL when they are added to the board. testTracks() sets
+     * it while track items rules are checked from its worker threads.
+     */
+    static std::vector<MARKER_PCB*>* CollectedMarkers()
+    {
+        return m_collectedMarkers;
+    }
+
+    /**
+     * Function SetCollectedMarkers
+     * sets the list where the markers created in the calling thread are collected, or
+     * NULL to add them to the board again.
+     */
+    static void SetCollectedMarkers( std::vector<MARKER_PCB*>* aMarkers )
+    {
+        m_collectedMarkers = aMarkers;
+    }
+
+    /**
+     * Function OnlineTrackDrc
+     * tests aRefSeg clearances to the tracks and pads near it, found from aIndex, and
+     * adds the marker of the first error to CollectedMarkers(), or directly to the board
+     * and view, with aRefSeg as marker item.
+     * Used by the track items online DRC, which runs inside BOARD_COMMIT::Push()
+     * and so cannot add markers by a new commit like addMarkerToPcb().
+     * @return false if an error was found.
+     */
+    bool OnlineTrackDrc( TRACK* aRefSeg, DRC_ITEM_INDEX* aIndex );
+
+private:
+    static thread_local std::vector<MARKER_PCB*>* m_collectedMarkers;
 #endif
 };
 
@@ -820,6 +820,7 @@ void PCB_EDIT_FRAME::Process_Special_Functions( wxCommandEvent& event )
         }
 
         SetCurItem( NULL );        // CurItem might be deleted by this command, clear the pointer
+        GetBoard()->m_Status_Pcb &= ~CONNEXION_OK;     // the zones no longer connect items
         TestConnections();
         TestForActiveLinksInRatsnest( 0 );   // Recalculate the active ratsnest, i.e. the unconnected links
         OnModify();
@@ -0,0 +1,457 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_info_cache.cpp
+ */
+
+#include <fctsys.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <common.h>
+#include <macros.h>
+#include <utf8.h>
+
+#include <wx/datetime.h>
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <footprint_info_cache.h>
+
+
+// Change the version when the file layout changes: older files are then ignored.
+static const char     CACHE_MAGIC[8] = { 'K', 'I', 'F', 'P', 'I', 'D', 'X', 0 };
+static const uint32_t CACHE_VERSION = 2;
+
+
+/**
+ * Class CACHE_WRITER
+ * writes the index file fields, little endian.
+ */
+class CACHE_WRITER
+{
+public:
+    CACHE_WRITER( wxFFile& aFile ) : m_file( aFile ), m_ok( true ) {}
+
+    void Write( const void* aData, size_t aSize )
+    {
+        if( m_ok && m_file.Write( aData, aSize ) != aSize )
+            m_ok = false;
+    }
+
+    void Write( uint32_t aValue )
+    {
+        uint8_t bytes[4];
+
+        for( int ii = 0; ii < 4; ++ii )
+            bytes[ii] = uint8_t( aValue >> ( 8 * ii ) );
+
+        Write( bytes, sizeof( bytes ) );
+    }
+
+    void Write( long long aValue )
+    {
+        Write( uint32_t( (unsigned long long) aValue ) );
+        Write( uint32_t( (unsigned long long) aValue >> 32 ) );
+    }
+
+    void Write( const wxString& aString )
+    {
+        UTF8 utf8( aString );
+
+        Write( uint32_t( utf8.size() ) );
+        Write( utf8.c_str(), utf8.size() );
+    }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    wxFFile&    m_file;
+    bool        m_ok;
+};
+
+
+/**
+ * Class CACHE_READER
+ * reads the index file fields from its content.  Reading past the end gives zero values
+ * and makes the reader not ok.
+ */
+class CACHE_READER
+{
+public:
+    CACHE_READER( const std::vector<char>& aData ) : m_data( aData ), m_pos( 0 ), m_ok( true ) {}
+
+    bool Read( void* aData, size_t aSize )
+    {
+        if( !m_ok || m_data.size() - m_pos < aSize )
+        {
+            m_ok = false;
+            memset( aData, 0, aSize );
+            return false;
+        }
+
+        memcpy( aData, &m_data[m_pos], aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    uint32_t ReadU32()
+    {
+        uint8_t  bytes[4];
+        uint32_t value = 0;
+
+        Read( bytes, sizeof( bytes ) );
+
+        for( int ii = 0; ii < 4; ++ii )
+            value |= uint32_t( bytes[ii] ) << ( 8 * ii );
+
+        return value;
+    }
+
+    long long ReadI64()
+    {
+        unsigned long long low = ReadU32();
+        unsigned long long high = ReadU32();
+
+        return (long long) ( low | ( high << 32 ) );
+    }
+
+    wxString ReadString()
+    {
+        uint32_t size = ReadU32();
+
+        if( !m_ok || m_data.size() - m_pos < size )
+        {
+            m_ok = false;
+            return wxEmptyString;
+        }
+
+        wxString str = FROM_UTF8( std::string( &m_data[m_pos], size ).c_str() );
+        m_pos += size;
+        return str;
+    }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    const std::vector<char>&    m_data;
+    size_t                      m_pos;
+    bool                        m_ok;
+};
+
+
+FOOTPRINT_INFO_CACHE::FOOTPRINT_INFO_CACHE( const wxString& aFileName ) :
+    m_fileName( aFileName ),
+    m_modified( false )
+{
+}
+
+
+wxString FOOTPRINT_INFO_CACHE::DefaultFileName()
+{
+    wxFileName fn( GetKicadConfigPath(), wxT( "fp-info-cache" ) );
+
+    return fn.GetFullPath();
+}
+
+
+// Mixes a value in a hash, so the timestamp changes if any file time changes
+static long long mixTimestamp( long long aHash, long long aValue )
+{
+    unsigned long long hash = (unsigned long long) aHash;
+
+    hash ^= (unsigned long long) aValue + 0x9E3779B97F4A7C15ULL + ( hash << 6 ) + ( hash >> 2 );
+    return (long long) hash;
+}
+
+
+long long FOOTPRINT_INFO_CACHE::LibraryTimestamp( const wxString& aUri )
+{
+    wxFileName fn;
+
+    if( wxFileName::DirExists( aUri ) )
+        fn.AssignDir( aUri );
+    else if( wxFileName::FileExists( aUri ) )
+        fn.Assign( aUri );
+    else
+        return 0;   // a remote library, or a missing one
+
+    long long timestamp = mixTimestamp( 1, fn.GetModificationTime().GetValue().GetValue() );
+
+    if( !fn.IsDir() )
+        return timestamp;
+
+    // A footprint file modified in place does not change the directory time.  The files
+    // are mixed in the order given by the file system, but this order is stable.
+    wxDir    dir( aUri );
+    wxString name;
+
+    for( bool found = dir.GetFirst( &name, wxEmptyString, wxDIR_FILES );  found;
+         found = dir.GetNext( &name ) )
+    {
+        wxFileName file( aUri, name );
+
+        timestamp = mixTimestamp( timestamp, std::hash<std::wstring>()( name.ToStdWstring() ) );
+        timestamp = mixTimestamp( timestamp, file.GetModificationTime().GetValue().GetValue() );
+    }
+
+    return timestamp ? timestamp : 1;
+}
+
+
+bool FOOTPRINT_INFO_CACHE::Load()
+{
+    m_libraries.clear();
+    m_modified = false;
+
+    if( !wxFileName::FileExists( m_fileName ) )
+        return false;
+
+    wxLogNull           noLog;
+    wxFFile             file( m_fileName, wxT( "rb" ) );
+    std::vector<char>   data;
+
+    if( !file.IsOpened() )
+        return false;
+
+    data.resize( file.Length() );
+
+    if( data.empty() || file.Read( &data[0], data.size() ) != data.size() )
+        return false;
+
+    CACHE_READER reader( data );
+    char         magic[sizeof( CACHE_MAGIC )];
+
+    reader.Read( magic, sizeof( magic ) );
+
+    if( memcmp( magic, CACHE_MAGIC, sizeof( magic ) ) || reader.ReadU32() != CACHE_VERSION )
+        return false;
+
+    uint32_t libCount = reader.ReadU32();
+
+    for( uint32_t ii = 0; ii < libCount && reader.IsOk(); ++ii )
+    {
+        LIBRARY library;
+
+        library.m_uri = reader.ReadString();
+        library.m_type = reader.ReadString();
+        library.m_timestamp = reader.ReadI64();
+        library.m_lastUse = reader.ReadI64();
+
+        uint32_t fpCount = reader.ReadU32();
+
+        for( uint32_t jj = 0; jj < fpCount && reader.IsOk(); ++jj )
+        {
+            FOOTPRINT footprint;
+
+            footprint.m_name = reader.ReadString();
+            footprint.m_doc = reader.ReadString();
+            footprint.m_keywords = reader.ReadString();
+            footprint.m_padCount = (int) reader.ReadU32();
+            footprint.m_uniquePadCount = (int) reader.ReadU32();
+            library.m_footprints.push_back( footprint );
+        }
+
+        if( reader.IsOk() )
+            m_libraries[library.m_uri] = std::move( library );
+    }
+
+    if( !reader.IsOk() )
+    {
+        m_libraries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool FOOTPRINT_INFO_CACHE::Save()
+{
+    if( !m_modified )
+        return true;
+
+    trim();
+
+    // Write a temporary file, so a concurrent reader never sees a partial index.  Its name
+    // is unique, so two running instances do not write the same file.
+    wxLogNull   noLog;
+    wxString    tmpFileName = wxFileName::CreateTempFileName( m_fileName );
+
+    if( tmpFileName.IsEmpty() )
+        return false;
+
+    {
+        wxFFile file( tmpFileName, wxT( "wb" ) );
+
+        if( !file.IsOpened() )
+        {
+            wxRemoveFile( tmpFileName );
+            return false;
+        }
+
+        CACHE_WRITER writer( file );
+
+        writer.Write( CACHE_MAGIC, sizeof( CACHE_MAGIC ) );
+        writer.Write( CACHE_VERSION );
+        writer.Write( uint32_t( m_libraries.size() ) );
+
+        for( const auto& entry : m_libraries )
+        {
+            const LIBRARY& library = entry.second;
+
+            writer.Write( library.m_uri );
+            writer.Write( library.m_type );
+            writer.Write( library.m_timestamp );
+            writer.Write( library.m_lastUse );
+            writer.Write( uint32_t( library.m_footprints.size() ) );
+
+            for( const FOOTPRINT& footprint : library.m_footprints )
+            {
+                writer.Write( footprint.m_name );
+                writer.Write( footprint.m_doc );
+                writer.Write( footprint.m_keywords );
+                writer.Write( uint32_t( footprint.m_padCount ) );
+                writer.Write( uint32_t( footprint.m_uniquePadCount ) );
+            }
+        }
+
+        if( !writer.IsOk() || !file.Close() )
+        {
+            wxRemoveFile( tmpFileName );
+            return false;
+        }
+    }
+
+    if( !wxRenameFile( tmpFileName, m_fileName, true ) )
+    {
+        wxRemoveFile( tmpFileName );
+        return false;
+    }
+
+    m_modified = false;
+    return true;
+}
+
+
+const FOOTPRINT_INFO_CACHE::LIBRARY* FOOTPRINT_INFO_CACHE::Find( const wxString& aUri,
+        const wxString& aType, long long aTimestamp ) const
+{
+    auto it = m_libraries.find( aUri );
+
+    if( !aTimestamp || it == m_libraries.end() )
+        return NULL;
+
+    const LIBRARY& library = it->second;
+
+    if( library.m_type != aType || library.m_timestamp != aTimestamp )
+        return NULL;
+
+    return &library;
+}
+
+
+void FOOTPRINT_INFO_CACHE::Store( const LIBRARY& aLibrary )
+{
+    LIBRARY& library = m_libraries[aLibrary.m_uri];
+
+    library = aLibrary;
+    library.m_lastUse = today();
+    m_modified = true;
+}
+
+
+void FOOTPRINT_INFO_CACHE::MarkUsed( const std::set<wxString>& aUris )
+{
+    long long day = today();
+
+    // The use is recorded by day, so the file is not written again at each listing
+    for( const wxString& uri : aUris )
+    {
+        auto it = m_libraries.find( uri );
+
+        if( it != m_libraries.end() && it->second.m_lastUse != day )
+        {
+            it->second.m_lastUse = day;
+            m_modified = true;
+        }
+    }
+}
+
+
+long long FOOTPRINT_INFO_CACHE::today()
+{
+    return (long long) wxDateTime::Now().GetTicks() / ( 24 * 60 * 60 );
+}
+
+
+void FOOTPRINT_INFO_CACHE::trim()
+{
+    if( m_libraries.size() <= MAX_LIBRARIES )
+        return;
+
+    std::vector<long long> lastUses;
+
+    for( const auto& entry : m_libraries )
+        lastUses.push_back( entry.second.m_lastUse );
+
+    // Drop the libraries used before the last use of the MAX_LIBRARIES-th most recent one,
+    // and then, in URI order, enough of those used on that day
+    auto nth = lastUses.end() - MAX_LIBRARIES;
+    std::nth_element( lastUses.begin(), nth, lastUses.end() );
+
+    long long limit = *nth;
+    size_t    extra = m_libraries.size() - MAX_LIBRARIES;
+
+    for( auto it = m_libraries.begin(); it != m_libraries.end() && extra; )
+    {
+        if( it->second.m_lastUse < limit )
+        {
+            it = m_libraries.erase( it );
+            extra--;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for( auto it = m_libraries.begin(); it != m_libraries.end() && extra; )
+    {
+        if( it->second.m_lastUse == limit )
+        {
+            it = m_libraries.erase( it );
+            extra--;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    m_modified = true;
+}
@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_info_cache.h
+ */
+
+#ifndef FOOTPRINT_INFO_CACHE_H
+#define FOOTPRINT_INFO_CACHE_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class FOOTPRINT_INFO_CACHE
+ * is the on-disk index of the footprint libraries used by FOOTPRINT_LIST_IMPL, so the
+ * footprints of a library are not enumerated and parsed again at each startup when the
+ * library did not change.
+ *
+ * For each library URI, with the environment variables substituted, the index records the
+ * plugin type, a timestamp made of the modification times of the library files, and the
+ * name, description, keywords and pad counts of each footprint.  A library entry is used
+ * only when its type and timestamp still match.  Entries are keyed on the URI and not on
+ * the nickname, so the libraries of several projects or library tables share the index,
+ * which keeps the MAX_LIBRARIES most recently used ones.
+ */
+class FOOTPRINT_INFO_CACHE
+{
+public:
+    struct FOOTPRINT
+    {
+        wxString    m_name;
+        wxString    m_doc;
+        wxString    m_keywords;
+        int         m_padCount;
+        int         m_uniquePadCount;
+    };
+
+    struct LIBRARY
+    {
+        wxString                m_uri;
+        wxString                m_type;
+        long long               m_timestamp;
+        long long               m_lastUse;      ///< the day the library was last listed
+        std::vector<FOOTPRINT>  m_footprints;
+    };
+
+    ///> The count of libraries kept in the index
+    static const size_t MAX_LIBRARIES = 1000;
+
+    /**
+     * @param aFileName = the index file, usually DefaultFileName()
+     */
+    FOOTPRINT_INFO_CACHE( const wxString& aFileName = DefaultFileName() );
+
+    /**
+     * Function DefaultFileName
+     * @return the index file in the KiCad config directory.
+     */
+    static wxString DefaultFileName();
+
+    /**
+     * Function LibraryTimestamp
+     * computes the timestamp of a library from the modification times of the library file,
+     * or of a library directory and of all the files it contains.
+     * @param aUri = the full library URI, with the environment variables substituted
+     * @return the timestamp, or 0 if the library is not a local file or directory.
+     */
+    static long long LibraryTimestamp( const wxString& aUri );
+
+    /**
+     * Function Load
+     * reads the index file.  A missing, unreadable or outdated file gives an empty index.
+     * @return true if the file was read.
+     */
+    bool Load();
+
+    /**
+     * Function Save
+     * writes the index file, if it was modified, without the least recently used libraries
+     * above MAX_LIBRARIES.
+     * @return false on a write error.
+     */
+    bool Save();
+
+    /**
+     * Function Find
+     * @return the index entry of library aUri, or NULL if there is none or if it is
+     *         outdated.
+     */
+    const LIBRARY* Find( const wxString& aUri, const wxString& aType,
+                         long long aTimestamp ) const;
+
+    /**
+     * Function Store
+     * adds or replaces the index entry of library aLibrary.m_uri, used today.
+     */
+    void Store( const LIBRARY& aLibrary );
+
+    /**
+     * Function MarkUsed
+     * records that the libraries aUris were used today, so they are the last ones removed
+     * from the index.  Find() does not do it, as it is called from the loader threads.
+     */
+    void MarkUsed( const std::set<wxString>& aUris );
+
+private:
+    /// @return the current day, the unit of LIBRARY::m_lastUse
+    static long long today();
+
+    /// Removes the least recently used libraries above MAX_LIBRARIES
+    void trim();
+
+    wxString                        m_fileName;
+    std::map<wxString, LIBRARY>     m_libraries;    ///< entries by library URI
+    bool                            m_modified;
+};
+
+#endif // FOOTPRINT_INFO_CACHE_H
@@ -102,11 +102,23 @@ void FOOTPRINT_LIST_IMPL::loader_job()
 
     while( m_queue_in.pop( nickname ) )
     {
-        CatchErrors( [this, &nickname]() {
-            m_lib_table->PrefetchLib( nickname );
+        LIB_STATE& state = m_lib_states.at( nickname );
+
+        bool ok = CatchErrors( [this, &nickname, &state]() {
+            // The timestamp is taken before reading, so a library modified while it is
+            // read is read again next time.
+            state.m_timestamp = FOOTPRINT_INFO_CACHE::LibraryTimestamp( state.m_uri );
+            state.m_cached = m_cache.Find( state.m_uri, state.m_type, state.m_timestamp );
+
+            if( !state.m_cached )
+                m_lib_table->PrefetchLib( nickname );
+
             m_queue_out.push( nickname );
         } );
 
+        if( !ok )
+            state.m_timestamp = 0;
+
         m_count_finished.fetch_add( 1 );
     }
 
@@ -145,13 +157,38 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_lib_states.clear();
+
+    m_cache.Load();
+
+    std::vector<wxString> nicknames;
 
     if( aNickname )
-        m_queue_in.push( *aNickname );
+        nicknames.push_back( *aNickname );
     else
+        nicknames = aTable->GetLogicalLibs();
+
+    // The table rows are read here: the workers only use the states
+    for( auto const& nickname : nicknames )
     {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
+        LIB_STATE& state = m_lib_states[nickname];
+
+        state.m_timestamp = 0;
+        state.m_cached = NULL;
+
+        try
+        {
+            const FP_LIB_TABLE_ROW* row = aTable->FindRow( nickname );
+
+            state.m_uri = row->GetFullURI( true );
+            state.m_type = row->GetType();
+        }
+        catch( const IO_ERROR& )
+        {
+            // The worker reading the library reports the error
+        }
+
+        m_queue_in.push( nickname );
     }
 
     m_loader->m_total_libs = m_queue_in.size();
@@ -190,6 +227,19 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
             while( this->m_queue_out.pop( nickname ) )
             {
                 wxArrayString fpnames;
+                LIB_STATE&    state = m_lib_states.at( nickname );
+
+                // An up to date library is not read: its footprints come from the index
+                if( state.m_cached )
+                {
+                    for( auto const& cached : state.m_cached->m_footprints )
+                    {
+                        FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, cached );
+                        queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                    }
+
+                    continue;
+                }
 
                 try
                 {
@@ -197,10 +247,13 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                 }
                 catch( const IO_ERROR& ioe )
                 {
+                    state.m_timestamp = 0;
                     m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
                 }
                 catch( const std::exception& se )
                 {
+                    state.m_timestamp = 0;
+
                     // This is a round about way to do this, but who knows what THROW_IO_ERROR()
                     // may be tricked out to do someday, keep it in the game.
                     try
@@ -234,10 +287,66 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
             []( std::unique_ptr<FOOTPRINT_INFO> const&     lhs,
                     std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool { return *lhs < *rhs; } );
 
+    updateCache();
+
     return m_errors.empty();
 }
 
 
+void FOOTPRINT_LIST_IMPL::updateCache()
+{
+    std::map<wxString, FOOTPRINT_INFO_CACHE::LIBRARY> libraries;
+    std::set<wxString>                                uris;
+
+    for( auto const& entry : m_lib_states )
+    {
+        const LIB_STATE& state = entry.second;
+
+        if( !state.m_timestamp )
+            continue;
+
+        uris.insert( state.m_uri );
+
+        if( state.m_cached )
+            continue;
+
+        FOOTPRINT_INFO_CACHE::LIBRARY& library = libraries[entry.first];
+
+        library.m_uri = state.m_uri;
+        library.m_type = state.m_type;
+        library.m_timestamp = state.m_timestamp;
+    }
+
+    // The footprints are already loaded, unless USE_FPI_LAZY
+    for( auto const& fpinfo : m_list )
+    {
+        auto it = libraries.find( fpinfo->GetNickname() );
+
+        if( it == libraries.end() )
+            continue;
+
+        FOOTPRINT_INFO_CACHE::FOOTPRINT footprint;
+
+        footprint.m_name = fpinfo->GetFootprintName();
+        footprint.m_doc = fpinfo->GetDoc();
+        footprint.m_keywords = fpinfo->GetKeywords();
+        footprint.m_padCount = fpinfo->GetPadCount();
+        footprint.m_uniquePadCount = fpinfo->GetUniquePadCount();
+        it->second.m_footprints.push_back( footprint );
+    }
+
+    for( auto const& library : libraries )
+        m_cache.Store( library.second );
+
+    // The libraries removed from the table are kept, as another table may use them, until
+    // they are the least recently used ones
+    m_cache.MarkUsed( uris );
+
+    m_lib_states.clear();
+    m_cache.Save();
+}
+
+
 size_t FOOTPRINT_LIST_IMPL::CountFinished()
 {
     return m_count_finished.load();
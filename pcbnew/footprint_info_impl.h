@@ -23,11 +23,13 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
 
 #include <footprint_info.h>
+#include <footprint_info_cache.h>
 #include <sync_queue.h>
 
 class LOCALE_IO;
@@ -50,6 +52,24 @@ public:
 #endif
     }
 
+    /**
+     * Constructor
+     * uses the footprint data of the footprint index, instead of loading the footprint.
+     */
+    FOOTPRINT_INFO_IMPL( FOOTPRINT_LIST* aOwner, const wxString& aNickname,
+                         const FOOTPRINT_INFO_CACHE::FOOTPRINT& aCached )
+    {
+        m_owner = aOwner;
+        m_loaded = true;
+        m_nickname = aNickname;
+        m_fpname = aCached.m_name;
+        m_num = 0;
+        m_pad_count = aCached.m_padCount;
+        m_unique_pad_count = aCached.m_uniquePadCount;
+        m_doc = aCached.m_doc;
+        m_keywords = aCached.m_keywords;
+    }
+
 protected:
     virtual void load() override;
 };
@@ -64,6 +84,19 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::atomic_size_t       m_count_finished;
     std::atomic_bool         m_first_to_finish;
 
+    /// State of a library being read.  The map is filled before the workers start, then
+    /// each entry is modified only by the worker reading its library.
+    struct LIB_STATE
+    {
+        wxString    m_uri;
+        wxString    m_type;
+        long long   m_timestamp;    ///< 0 if the library cannot be indexed
+        const FOOTPRINT_INFO_CACHE::LIBRARY* m_cached; ///< valid index entry, or NULL
+    };
+
+    FOOTPRINT_INFO_CACHE             m_cache;
+    std::map<wxString, LIB_STATE>    m_lib_states;
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
@@ -83,6 +116,13 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Function updateCache
+     * stores the footprints of the libraries read without error in the footprint index,
+     * and saves it.
+     */
+    void updateCache();
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
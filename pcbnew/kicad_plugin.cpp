@@ -301,9 +301,10 @@ void FP_CACHE::Load()
             // Queue I/O errors so only files that fail to parse don't get loaded.
             try
             {
-                FILE_LINE_READER    reader( fullPath.GetFullPath() );
+                std::unique_ptr<LINE_READER> reader(
+                        m_owner->openReader( fullPath.GetFullPath() ) );
 
-                m_owner->m_parser->SetLineReader( &reader );
+                m_owner->m_parser->SetLineReader( reader.get() );
 
                 std::string name = TO_UTF8( fullPath.GetName() );
                 MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
@@ -1786,11 +1787,11 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
-
     init( aProperties );
 
-    m_parser->SetLineReader( &reader );
+    std::unique_ptr<LINE_READER> reader( openReader( aFileName ) );
+
+    m_parser->SetLineReader( reader.get() );
     m_parser->SetBoard( aAppendToMe );
 
     BOARD* board;
@@ -1837,6 +1838,17 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 }
 
 
+LINE_READER* PCB_IO::openReader( const wxString& aFileName ) const
+{
+    UTF8 readerType;
+
+    if( m_props && m_props->Value( "line_reader", &readerType ) && readerType == "file" )
+        return new FILE_LINE_READER( aFileName );
+
+    return new MAPPED_FILE_LINE_READER( aFileName );
+}
+
+
 void PCB_IO::cacheLib( const wxString& aLibraryPath, const wxString& aFootprintName )
 {
     if( !m_cache || m_cache->IsModified( aLibraryPath, aFootprintName ) )
@@ -2097,6 +2109,17 @@ bool PCB_IO::FootprintLibDelete( const wxString& aLibraryPath, const PROPERTIES*
 }
 
 
+void PCB_IO::FootprintLibOptions( PROPERTIES* aListToAppendTo ) const
+{
+    PLUGIN::FootprintLibOptions( aListToAppendTo );
+
+    (*aListToAppendTo)["line_reader"] = UTF8( _(
+        "Set to <b>file</b> to read the footprint files line by line, instead of "
+        "mapping them in memory."
+        ));
+}
+
+
 bool PCB_IO::IsFootprintLibWritable( const wxString& aLibraryPath )
 {
     LOCALE_IO   toggle;
@@ -131,6 +131,8 @@ public:
 
     bool IsFootprintLibWritable( const wxString& aLibraryPath ) override;
 
+    void FootprintLibOptions( PROPERTIES* aListToAppendTo ) const override;
+
     //-----</PLUGIN API>--------------------------------------------------------
 
     PCB_IO( int aControlFlags = CTL_FOR_BOARD );
@@ -186,6 +188,15 @@ protected:
 
     void init( const PROPERTIES* aProperties );
 
+    /**
+     * Function openReader
+     * opens aFileName for parsing.  The file is memory mapped (see MAPPED_FILE_LINE_READER),
+     * unless the "line_reader" property of m_props is "file".
+     * @return LINE_READER* - the reader, owned by the caller.
+     * @throw IO_ERROR if the file cannot be opened.
+     */
+    LINE_READER* openReader( const wxString& aFileName ) const;
+
 private:
     void format( BOARD* aBoard, int aNestLevel = 0 ) const;
 
@@ -1102,6 +1102,21 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone )
             m_gal->SetIsStroke( true );
         }
 
+        // The cached triangles of the filling are drawn at once, without a new tesselation.
+        // They are built on the first drawing of the filling
+        if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_FILLED )
+            aZone->CacheTriangulation();
+
+        bool triangulated = displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_FILLED
+                            && polySet.IsTriangulationUpToDate();
+
+        if( triangulated )
+        {
+            m_gal->SetIsStroke( false );
+            m_gal->DrawPolygon( polySet );
+            m_gal->SetIsStroke( true );
+        }
+
         for( int i = 0; i < polySet.OutlineCount(); i++ )
         {
             const SHAPE_LINE_CHAIN& outline = polySet.COutline( i );
@@ -1115,7 +1130,9 @@ void PCB_PAINTER::draw( const ZONE_CONTAINER* aZone )
 
             if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_FILLED )
             {
-                m_gal->DrawPolygon( corners );
+                if( !triangulated )
+                    m_gal->DrawPolygon( corners );
+
                 m_gal->DrawPolyline( corners );
             }
             else if( displayMode == PCB_RENDER_SETTINGS::DZ_SHOW_OUTLINED )
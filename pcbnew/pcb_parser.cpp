@@ -28,6 +28,11 @@
  */
 
 #include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
@@ -474,6 +479,31 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 
         token = NextTok();
 
+        // Modules, tracks, vias and zones are parsed later on worker threads.  The other
+        // sections can change what they depend on (layers, nets...) or depend on them.
+        switch( token )
+        {
+        case T_module:
+        case T_segment:
+        case T_via:
+        case T_zone:
+            captureSection( token );
+            continue;
+
+        case T_gr_arc:
+        case T_gr_circle:
+        case T_gr_curve:
+        case T_gr_line:
+        case T_gr_poly:
+        case T_gr_text:
+        case T_dimension:
+        case T_target:
+            break;
+
+        default:
+            parseSections();
+        }
+
         switch( token )
         {
         case T_general:
@@ -520,22 +550,6 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
             m_board->Add( parseDIMENSION(), ADD_APPEND );
             break;
 
-        case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
-
-        case T_segment:
-            m_board->Add( parseTRACK(), ADD_APPEND );
-            break;
-
-        case T_via:
-            m_board->Add( parseVIA(), ADD_APPEND );
-            break;
-
-        case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
-            break;
-
         case T_target:
             m_board->Add( parsePCB_TARGET(), ADD_APPEND );
             break;
@@ -557,10 +571,182 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    parseSections();
+
     return m_board;
 }
 
 
+void PCB_PARSER::captureSection( T aToken )
+{
+    SECTION section;
+
+    section.token = aToken;
+    section.lineNumber = CurLineNumber();
+    section.item = NULL;
+    section.zoneNetMismatch = false;
+
+    // Keep the section keyword at its column, so error offsets are the file ones
+    section.text.assign( std::max( CurOffset() - 2, 0 ), ' ' );
+    section.text += '(';
+    section.text += CurText();
+
+    const char* cur = next;
+    int         depth = 1;
+    bool        inString = false;
+
+    while( depth )
+    {
+        if( cur >= limit )
+        {
+            section.text.append( next, cur );
+
+            if( !readLine() )
+                THROW_PARSE_ERROR( _( "Unexpected end of file" ), CurSource(), CurLine(),
+                                   CurLineNumber(), CurOffset() );
+
+            cur = next;
+            continue;
+        }
+
+        char cc = *cur++;
+
+        if( inString )
+        {
+            if( cc == '\\' && cur < limit )
+                ++cur;
+            else if( cc == stringDelimiter )
+                inString = false;
+        }
+        else if( cc == stringDelimiter )
+            inString = true;
+        else if( cc == '(' )
+            ++depth;
+        else if( cc == ')' )
+            --depth;
+    }
+
+    section.text.append( next, cur );
+
+    // Continue after the section, as if its closing parenthesis was just read
+    next = cur;
+    curTok = DSN_RIGHT;
+
+    m_sections.push_back( std::move( section ) );
+}
+
+
+void PCB_PARSER::parseSections()
+{
+    if( m_sections.empty() )
+        return;
+
+    std::atomic<size_t> nextSection( 0 );
+    std::mutex          lock;
+    const wxString      source = CurSource();
+
+    auto worker = [&]()
+    {
+        PCB_PARSER parser;
+
+        parser.m_board = m_board;
+        parser.m_layerIndices = m_layerIndices;
+        parser.m_layerMasks = m_layerMasks;
+        parser.m_netCodes = m_netCodes;
+        parser.m_tooRecent = m_tooRecent;
+        parser.m_requiredVersion = m_requiredVersion;
+        parser.m_sectionWorker = true;
+
+        for( size_t ii = nextSection++; ii < m_sections.size(); ii = nextSection++ )
+        {
+            SECTION& section = m_sections[ii];
+            STRING_LINE_READER reader( section.text, source, section.lineNumber - 1 );
+
+            parser.SetLineReader( &reader );
+            parser.curTok = DSN_NONE;
+            parser.m_zoneNetMismatch = false;
+
+            try
+            {
+                parser.NeedLEFT();
+                parser.NextTok();
+
+                switch( section.token )
+                {
+                case T_module:
+                    section.item = parser.parseMODULE();
+                    break;
+
+                case T_segment:
+                    section.item = parser.parseTRACK();
+                    break;
+
+                case T_via:
+                    section.item = parser.parseVIA();
+                    break;
+
+                default:
+                    section.item = parser.parseZONE_CONTAINER();
+                    section.zoneNetMismatch = parser.m_zoneNetMismatch;
+                    section.zoneNetname = parser.m_zoneNetname;
+                    break;
+                }
+            }
+            catch( ... )
+            {
+                section.error = std::current_exception();
+            }
+
+            parser.PopReader();
+        }
+
+        // A module can require a newer version than the board
+        std::lock_guard<std::mutex> guard( lock );
+        m_requiredVersion = std::max( m_requiredVersion, parser.m_requiredVersion );
+        m_tooRecent = m_tooRecent || parser.m_tooRecent;
+    };
+
+    // Not worth starting threads for a few items
+    size_t threadCount = m_sections.size() < 64 ? 1 : std::thread::hardware_concurrency();
+    threadCount = std::min( std::max<size_t>( threadCount, 1 ), m_sections.size() );
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 1; ii < threadCount; ++ii )
+        threads.push_back( std::thread( worker ) );
+
+    worker();
+
+    for( auto& thread : threads )
+        thread.join();
+
+    // Add the items in file order, up to the first error
+    std::exception_ptr error;
+
+    for( SECTION& section : m_sections )
+    {
+        if( !error && section.error )
+            error = section.error;
+
+        if( error )
+        {
+            delete section.item;
+            continue;
+        }
+
+        if( section.zoneNetMismatch )
+            resolveZoneNet( static_cast<ZONE_CONTAINER*>( section.item ), section.zoneNetname );
+
+        m_board->Add( section.item, ADD_APPEND );
+    }
+
+    m_sections.clear();
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3014,38 +3200,51 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
     // Ensure the zone net name is valid, and matches the net code, for copper zones
     if( zone_has_net && ( zone->GetNet()->GetNetname() != netnameFromfile ) )
     {
-        // Can happens which old boards, with nonexistent nets ...
-        // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-            zone->SetNetCode( net->GetNet() );
-        else    // Not existing net: add a new net to keep trace of the zone netname
+        // A section worker cannot modify the board: parseSections() will fix the net
+        if( m_sectionWorker )
         {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNet() );
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNet() );
-
-            // Prompt the user
-            wxString msg;
-            msg.Printf( _( "There is a zone that belongs to a not existing net\n"
-                           "\"%s\"\n"
-                           "you should verify and edit it (run DRC test)." ),
-                           GetChars( netnameFromfile ) );
-            DisplayError( NULL, msg );
+            m_zoneNetMismatch = true;
+            m_zoneNetname = netnameFromfile;
         }
+        else
+            resolveZoneNet( zone.get(), netnameFromfile );
     }
 
     return zone.release();
 }
 
 
+void PCB_PARSER::resolveZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetname )
+{
+    // Can happens which old boards, with nonexistent nets ...
+    // or after being edited by hand
+    // We try to fix the mismatch.
+    NETINFO_ITEM* net = m_board->FindNet( aNetname );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+        aZone->SetNetCode( net->GetNet() );
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetname, newnetcode );
+        m_board->Add( net );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNet() );
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNet() );
+
+        // Prompt the user
+        wxString msg;
+        msg.Printf( _( "There is a zone that belongs to a not existing net\n"
+                       "\"%s\"\n"
+                       "you should verify and edit it (run DRC test)." ),
+                       GetChars( aNetname ) );
+        DisplayError( NULL, msg );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, NULL,
@@ -40,6 +40,8 @@
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <exception>
+
 
 class BOARD;
 class BOARD_ITEM;
@@ -80,6 +82,27 @@ class PCB_PARSER : public PCB_LEXER
     bool                m_tooRecent;        ///< true if version parses as later than supported
     int                 m_requiredVersion;  ///< set to the KiCad format version this board requires
 
+    /**
+     * Struct SECTION
+     * is a top level module, segment, via or zone section of a board file, parsed on a
+     * worker thread by parseSections().
+     */
+    struct SECTION
+    {
+        PCB_KEYS_T::T       token;          ///< the section keyword
+        std::string         text;           ///< the section text, at its file line and column
+        int                 lineNumber;     ///< the file line number of the section start
+        BOARD_ITEM*         item;           ///< the parsed item, NULL if not (yet) parsed
+        bool                zoneNetMismatch;///< the zone net name does not match its net code
+        wxString            zoneNetname;    ///< the zone net name in the file
+        std::exception_ptr  error;          ///< the parse error, if any
+    };
+
+    std::vector<SECTION> m_sections;        ///< sections waiting for parseSections()
+    bool                m_sectionWorker;    ///< true for the parsers run by parseSections()
+    bool                m_zoneNetMismatch;  ///< set by parseZONE_CONTAINER() in a section worker
+    wxString            m_zoneNetname;      ///< the zone net name, when m_zoneNetMismatch
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -142,6 +165,30 @@ class PCB_PARSER : public PCB_LEXER
     TRACK*          parseTRACK();
     VIA*            parseVIA();
     ZONE_CONTAINER* parseZONE_CONTAINER();
+
+    /**
+     * Function resolveZoneNet
+     * gives to aZone the net named aNetname, which does not match the zone net code.
+     * The net is created if it does not exist.
+     */
+    void resolveZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetname );
+
+    /**
+     * Function captureSection
+     * copies the text of the current top level section, starting at its keyword aToken,
+     * to m_sections, and skips it.  The text is found by counting the parentheses outside
+     * of the quoted strings, which is much faster than parsing it.
+     */
+    void captureSection( PCB_KEYS_T::T aToken );
+
+    /**
+     * Function parseSections
+     * parses the sections of m_sections concurrently, each worker thread using its own
+     * copy of this parser, then adds the items to the board in file order.  A parse error
+     * is reported for the first section in error, after adding the previous items.
+     */
+    void parseSections();
+
     PCB_TARGET*     parsePCB_TARGET();
     BOARD*          parseBOARD();
 
@@ -285,7 +332,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_sectionWorker( false ),
+        m_zoneNetMismatch( false )
     {
         init();
     }
@@ -40,6 +40,8 @@
 #define HPGL_PEN_SPEED_MAX        99        // this param is always in cm/s
 #define HPGL_PEN_NUMBER_MIN       1
 #define HPGL_PEN_NUMBER_MAX       16
+#define PDF_COMPRESSION_MIN       -1        // the zlib default level
+#define PDF_COMPRESSION_MAX       9         // the best compression, the default
 
 
 /**
@@ -93,6 +95,7 @@ PCB_PLOT_PARAMS::PCB_PLOT_PARAMS()
     m_HPGLPenNum                 = 1;
     m_HPGLPenSpeed               = 20;        // this param is always in cm/s
     m_HPGLPenDiam                = 15;        // in mils
+    m_PDFCompressionLevel        = PDF_COMPRESSION_MAX;
     m_negative                   = false;
     m_A4Output                   = false;
     m_plotReference              = true;
@@ -186,6 +189,13 @@ void PCB_PLOT_PARAMS::Format( OUTPUTFORMATTER* aFormatter,
                        m_HPGLPenSpeed );
     aFormatter->Print( aNestLevel+1, "(%s %d)\n", getTokenName( T_hpglpendiameter ),
                        m_HPGLPenDiam );
+
+    if( m_PDFCompressionLevel != PDF_COMPRESSION_MAX )  // save this option only if it is not
+                                                        // the default value, to avoid
+                                                        // incompatibility with older Pcbnew
+        aFormatter->Print( aNestLevel+1, "(%s %d)\n", getTokenName( T_pdfcompression ),
+                           m_PDFCompressionLevel );
+
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_psnegative ),
                        m_negative ? trueStr : falseStr );
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_psa4output ),
@@ -252,6 +262,8 @@ bool PCB_PLOT_PARAMS::operator==( const PCB_PLOT_PARAMS &aPcbPlotParams ) const
         return false;
     if( m_HPGLPenDiam != aPcbPlotParams.m_HPGLPenDiam )
         return false;
+    if( m_PDFCompressionLevel != aPcbPlotParams.m_PDFCompressionLevel )
+        return false;
     if( m_negative != aPcbPlotParams.m_negative )
         return false;
     if( m_A4Output != aPcbPlotParams.m_A4Output )
@@ -321,6 +333,12 @@ bool PCB_PLOT_PARAMS::SetLineWidth( int aValue )
     return setInt( &m_lineWidth, aValue, PLOT_LINEWIDTH_MIN, PLOT_LINEWIDTH_MAX );
 }
 
+
+bool PCB_PLOT_PARAMS::SetPDFCompressionLevel( int aValue )
+{
+    return setInt( &m_PDFCompressionLevel, aValue, PDF_COMPRESSION_MIN, PDF_COMPRESSION_MAX );
+}
+
 // PCB_PLOT_PARAMS_PARSER
 
 PCB_PLOT_PARAMS_PARSER::PCB_PLOT_PARAMS_PARSER( LINE_READER* aReader ) :
@@ -402,6 +420,11 @@ void PCB_PLOT_PARAMS_PARSER::Parse( PCB_PLOT_PARAMS* aPcbPlotParams )
                 parseInt( gbrDefaultPrecision-1, gbrDefaultPrecision);
             break;
 
+        case T_pdfcompression:
+            aPcbPlotParams->m_PDFCompressionLevel = parseInt( PDF_COMPRESSION_MIN,
+                                                              PDF_COMPRESSION_MAX );
+            break;
+
         case T_psa4output:
             aPcbPlotParams->m_A4Output = parseBool();
             break;
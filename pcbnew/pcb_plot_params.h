@@ -155,6 +155,7 @@ private:
     int         m_HPGLPenNum;           ///< HPGL only: pen number selection(1 to 9)
     int         m_HPGLPenSpeed;         ///< HPGL only: pen speed, always in cm/s (1 to 99 cm/s)
     int         m_HPGLPenDiam;          ///< HPGL only: pen diameter in MILS, useful to fill areas
+    int         m_PDFCompressionLevel;  ///< PDF only: zlib level of the page streams (-1 to 9)
     COLOR4D     m_color;                ///< Color for plotting the current layer
     COLOR4D     m_referenceColor;       ///< Color for plotting references
     COLOR4D     m_valueColor;           ///< Color for plotting values
@@ -278,6 +279,9 @@ public:
 
     int         GetLineWidth() const { return m_lineWidth; };
     bool        SetLineWidth( int aValue );
+
+    int         GetPDFCompressionLevel() const { return m_PDFCompressionLevel; };
+    bool        SetPDFCompressionLevel( int aValue );
 };
 
 
@@ -388,6 +388,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
     SetScreen( new PCB_SCREEN( GetPageSettings().GetSizeIU() ) );
     GetScreen()->SetMaxUndoItems( m_UndoRedoCountMax );
+    GetScreen()->SetMaxUndoMemory( m_UndoRedoMemoryMax );
 
     // PCB drawings start in the upper left corner.
     GetScreen()->m_Center = false;
@@ -1009,6 +1010,10 @@ void PCB_EDIT_FRAME::OnModify( )
 {
     PCB_BASE_FRAME::OnModify();
 
+#ifdef PCBNEW_WITH_TRACKITEMS
+    GetBoard()->TrackItems()->DRC_OnlineBoardModified();
+#endif
+
     EDA_3D_VIEWER* draw3DFrame = Get3DViewerFrame();
 
     if( draw3DFrame )
@@ -43,6 +43,7 @@
 #include <dialog_plot.h>
 #include <macros.h>
 #include <build_version.h>
+#include <profile.h>
 
 
 const wxString GetGerberProtelExtension( LAYER_NUM aLayer )
@@ -508,6 +509,97 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+void PLOT_CONTROLLER::AddLayerPlot( LAYER_NUM aLayer, const wxString& aSuffix,
+                                    const wxString& aSheetDesc )
+{
+    PLOT_LAYER_JOB job;
+
+    job.m_layer = aLayer;
+    job.m_suffix = aSuffix;
+    job.m_sheetDesc = aSheetDesc;
+    job.m_success = false;
+    job.m_time = 0.0;
+
+    m_layerJobs.push_back( job );
+}
+
+
+bool PLOT_CONTROLLER::PlotLayers( PlotFormat aFormat )
+{
+    LOCALE_IO toggle;
+
+    GetPlotOptions().SetFormat( aFormat );
+
+    // Ensure that the previous plot is closed
+    ClosePlot();
+
+    for( PLOT_LAYER_JOB& job : m_layerJobs )
+    {
+        job.m_fileName.Empty();
+        job.m_success = false;
+        job.m_time = 0.0;
+    }
+
+    wxString outputDirName = GetPlotOptions().GetOutputDirectory();
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return false;
+
+    // The files are opened here, one after the other, as OpenPlotfile() does: the page
+    // layout is plotted when opening a file, and it is not thread safe.
+    std::vector<PLOTTER*> plotters;
+
+    for( PLOT_LAYER_JOB& job : m_layerJobs )
+    {
+        wxFileName fn = boardFilename;
+        wxString fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( aFormat == PLOT_FORMAT_GERBER && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( job.m_layer );
+
+        BuildPlotFileName( &fn, outputDir.GetPath(), job.m_suffix, fileExt );
+        job.m_fileName = fn.GetFullPath();
+
+        plotters.push_back( StartPlotBoard( m_board, &GetPlotOptions(),
+                                            ToLAYER_ID( job.m_layer ),
+                                            job.m_fileName, job.m_sheetDesc ) );
+    }
+
+    // The board is only read by the layer plots, and each layer has its own plotter, so the
+    // layers are plotted in parallel.  Each file is written in the same order as by
+    // PlotLayer().
+    #pragma omp parallel for schedule(dynamic, 1)
+    for( int ii = 0; ii < (int) m_layerJobs.size(); ++ii )
+    {
+        PLOT_LAYER_JOB& job = m_layerJobs[ii];
+
+        if( !plotters[ii] )
+            continue;
+
+        PROF_COUNTER timer;
+
+        // The layers are already plotted on several threads: no parallel polygon operations
+        PlotOneBoardLayer( m_board, plotters[ii], ToLAYER_ID( job.m_layer ), GetPlotOptions(),
+                           false );
+        plotters[ii]->EndPlot();
+        delete plotters[ii];
+
+        job.m_time = timer.msecs();
+        job.m_success = true;
+    }
+
+    for( const PLOT_LAYER_JOB& job : m_layerJobs )
+    {
+        if( !job.m_success )
+            return false;
+    }
+
+    return true;
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
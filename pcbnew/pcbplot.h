@@ -179,9 +179,11 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
  * @param aPlotter = the plotter to use
  * @param aLayer = the layer id to plot
  * @param aPlotOpt = the plot options (files, sketch). Has meaning for some formats only
+ * @param aParallel = true to use the parallel polygon operations (see SHAPE_POLY_SET),
+ *                    false when the layer is plotted from a worker thread
  */
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
-                        const PCB_PLOT_PARAMS& aPlotOpt );
+                        const PCB_PLOT_PARAMS& aPlotOpt, bool aParallel = true );
 
 /**
  * Function PlotStandardLayer
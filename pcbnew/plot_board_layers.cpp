@@ -65,7 +65,7 @@
  */
 static void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
                                  LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt,
-                                 int aMinThickness );
+                                 int aMinThickness, bool aParallel );
 
 /* Creates the plot for silkscreen layers
  * Silkscreen layers have specific requirement for pads (not filled) and texts
@@ -157,7 +157,7 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 }
 
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
-                        const PCB_PLOT_PARAMS& aPlotOpt )
+                        const PCB_PLOT_PARAMS& aPlotOpt, bool aParallel )
 {
     PCB_PLOT_PARAMS plotOpt = aPlotOpt;
     int soldermask_min_thickness = aBoard->GetDesignSettings().m_SolderMaskMinWidth;
@@ -209,7 +209,7 @@ void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
             }
             else
                 PlotSolderMaskLayer( aBoard, aPlotter, layer_mask, plotOpt,
-                                     soldermask_min_thickness );
+                                     soldermask_min_thickness, aParallel );
 
             break;
 
@@ -372,7 +372,10 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+
+            // The pad is plotted from a copy with the plot size, so the board is only read
+            // and several layers can be plotted at the same time.
+            D_PAD plotPad( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -405,7 +408,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                plotPad.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -422,17 +425,15 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->GetVisibleElementColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-            pad->SetSize( padPlotsSize );
+            plotPad.SetSize( padPlotsSize );
 
-            switch( pad->GetShape() )
+            switch( plotPad.GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    (pad->GetSize() == pad->GetDrillSize()) &&
-                    (pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED) )
+                    (plotPad.GetSize() == plotPad.GetDrillSize()) &&
+                    (plotPad.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED) )
                     break;
 
                 // Fall through:
@@ -440,12 +441,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             default:
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -750,7 +748,7 @@ void PlotLayerOutlines( BOARD* aBoard, PLOTTER* aPlotter,
  */
 void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
                           LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt,
-                          int aMinThickness )
+                          int aMinThickness, bool aParallel )
 {
     PCB_LAYER_ID    layer = aLayerMask[B_Mask] ? B_Mask : F_Mask;
     int         inflate = aMinThickness/2;
@@ -880,13 +878,15 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
     zone.SetMinThickness( 0 );      // trace polygons only
     zone.SetLayer ( layer );
 
-    areas.BooleanAdd( initialPolys, SHAPE_POLY_SET::PM_FAST );
-    areas.Inflate( -inflate, circleToSegmentsCount );
+    // These sets hold a shape for each pad of the layer: use the parallel operations,
+    // unless the layer is plotted on a worker thread
+    areas.BooleanAdd( initialPolys, SHAPE_POLY_SET::PM_FAST, aParallel );
+    areas.Inflate( -inflate, circleToSegmentsCount, aParallel );
 
     // Combine the current areas to initial areas. This is mandatory because
     // inflate/deflate transform is not perfect, and we want the initial areas perfectly kept
-    areas.BooleanAdd( initialPolys, SHAPE_POLY_SET::PM_FAST );
-    areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    areas.BooleanAdd( initialPolys, SHAPE_POLY_SET::PM_FAST, aParallel );
+    areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE, aParallel );
 
     zone.AddFilledPolysList( areas );
 
@@ -1044,7 +1044,10 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts,
         break;
 
     case PLOT_FORMAT_PDF:
-        plotter = new PDF_PLOTTER();
+        PDF_PLOTTER* PDF_plotter;
+        PDF_plotter = new PDF_PLOTTER();
+        PDF_plotter->SetCompressionLevel( aPlotOpts->GetPDFCompressionLevel() );
+        plotter = PDF_plotter;
         break;
 
     case PLOT_FORMAT_HPGL:
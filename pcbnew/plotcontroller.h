@@ -30,6 +30,8 @@
 #ifndef PLOTCONTROLLER_H_
 #define PLOTCONTROLLER_H_
 
+#include <vector>
+
 #include <pcb_plot_params.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -37,6 +39,22 @@ class PLOTTER;
 class BOARD;
 
 
+/**
+ * A layer plot of a batch, see PLOT_CONTROLLER::AddLayerPlot()
+ */
+struct PLOT_LAYER_JOB
+{
+    LAYER_NUM   m_layer;
+    wxString    m_suffix;       ///< added to the base filename, like in OpenPlotfile()
+    wxString    m_sheetDesc;
+
+    // Set by PLOT_CONTROLLER::PlotLayers():
+    wxString    m_fileName;     ///< full filename of the plot
+    bool        m_success;      ///< false if the file could not be created
+    double      m_time;         ///< plot time, in ms
+};
+
+
 /**
  * Batch plotter state object. Keeps the plot options and handles multiple
  * plot requests
@@ -84,6 +102,38 @@ public:
      */
     bool PlotLayer();
 
+    /**
+     * Add a layer to the batch plotted by PlotLayers()
+     * @param aLayer is the layer to plot, in its own file
+     * @param aSuffix and aSheetDesc are used as in OpenPlotfile()
+     */
+    void AddLayerPlot( LAYER_NUM aLayer, const wxString& aSuffix,
+                       const wxString& aSheetDesc );
+
+    /** Remove all the layers of the batch
+     */
+    void ClearLayerPlots() { m_layerJobs.clear(); }
+
+    /**
+     * Plot the layers added by AddLayerPlot(), each one in its own file.
+     * The files are the ones SetLayer(), OpenPlotfile() and PlotLayer() would create for
+     * each layer, but the layers are plotted at the same time, each one by its own plotter.
+     * @param aFormat is the plot file format identifier
+     * @return true if all the files are plotted
+     */
+    bool PlotLayers( PlotFormat aFormat );
+
+    /**
+     * @return the count of layers of the batch
+     */
+    int GetLayerPlotCount() const { return m_layerJobs.size(); }
+
+    /**
+     * @return a layer of the batch; after PlotLayers(), it gives the plot filename,
+     * the status and the plot time of the layer
+     */
+    const PLOT_LAYER_JOB& GetLayerPlot( int aIndex ) const { return m_layerJobs[aIndex]; }
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
@@ -123,6 +173,9 @@ private:
 
     /// The current plot filename, set by OpenPlotfile
     wxFileName m_plotFile;
+
+    /// The layers plotted by PlotLayers()
+    std::vector<PLOT_LAYER_JOB> m_layerJobs;
 };
 
 #endif
@@ -205,6 +205,15 @@ void PCB_BASE_FRAME::Compile_Ratsnest( wxDC* aDC, bool aDisplayStatus )
 }
 
 
+void PCB_BASE_FRAME::Update_Ratsnest( wxDC* aDC, bool aDisplayStatus )
+{
+    const int upToDate = LISTE_RATSNEST_ITEM_OK | CONNEXION_OK;
+
+    if( ( m_Pcb->m_Status_Pcb & upToDate ) != upToDate )
+        Compile_Ratsnest( aDC, aDisplayStatus );
+}
+
+
 /* Sort function used by  QSORT
  *  Sort pads by net code
  */
@@ -566,6 +575,9 @@ void PCB_BASE_FRAME::build_ratsnest_module( MODULE* aModule )
         localPadList.clear();
         m_Pcb->m_LocalRatsnest.clear();
 
+        // The subnets of the pads are used here, so they have to be computed again later
+        m_Pcb->m_Status_Pcb &= ~CONNEXION_OK;
+
         // collect active pads of the module:
         for( pad_ref = aModule->PadsList(); pad_ref; pad_ref = pad_ref->Next() )
         {
@@ -71,9 +71,41 @@ static bool sortDistance( const RN_NODE_PTR& aOrigin, const RN_NODE_PTR& aNode1,
 }
 
 
+static bool sortPosition( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode2 )
+{
+    if( aNode1->GetX() != aNode2->GetX() )
+        return aNode1->GetX() < aNode2->GetX();
+
+    return aNode1->GetY() < aNode2->GetY();
+}
+
+
 static bool sortWeight( const RN_EDGE_PTR& aEdge1, const RN_EDGE_PTR& aEdge2 )
 {
-    return aEdge1->GetWeight() < aEdge2->GetWeight();
+    if( aEdge1->GetWeight() != aEdge2->GetWeight() )
+        return aEdge1->GetWeight() < aEdge2->GetWeight();
+
+    // Edges of the same weight are sorted by the positions of their nodes, so the ratsnest
+    // does not depend on the order of the connections in their hash set
+    auto ends = []( const RN_EDGE_PTR& aEdge )
+    {
+        const RN_NODE_PTR& source = aEdge->GetSourceNode();
+        const RN_NODE_PTR& target = aEdge->GetTargetNode();
+
+        return sortPosition( target, source ) ? std::make_pair( target, source )
+                                              : std::make_pair( source, target );
+    };
+
+    std::pair<RN_NODE_PTR, RN_NODE_PTR> ends1 = ends( aEdge1 );
+    std::pair<RN_NODE_PTR, RN_NODE_PTR> ends2 = ends( aEdge2 );
+
+    if( sortPosition( ends1.first, ends2.first ) )
+        return true;
+
+    if( sortPosition( ends2.first, ends1.first ) )
+        return false;
+
+    return sortPosition( ends1.second, ends2.second );
 }
 
 
@@ -113,8 +145,83 @@ static bool isEdgeConnectingNode( const RN_EDGE_PTR& aEdge, const RN_NODE_PTR& a
 }
 
 
-static std::vector<RN_EDGE_MST_PTR>* kruskalMST( RN_LINKS::RN_EDGE_LIST& aEdges,
-                                                 std::vector<RN_NODE_PTR>& aNodes )
+/**
+ * Function findClosestNodes()
+ * Finds the nodes closest to a node, among nodes sorted by sortPosition(). Nodes which
+ * are known to be connected to aNode (they have the same, valid tag) are skipped.
+ * @param aSortedNodes are the nodes, sorted by their x then y coordinate.
+ * @param aNode is the node whose neighbours are searched.
+ * @param aCount is the maximal number of returned nodes.
+ * @param aOutput receives the closest nodes.
+ */
+static void findClosestNodes( const std::vector<RN_NODE_PTR>& aSortedNodes,
+                              const RN_NODE_PTR& aNode, unsigned int aCount,
+                              std::vector<RN_NODE_PTR>& aOutput )
+{
+    // Heap of the closest nodes found so far (distance, index), the farthest one on the top
+    std::vector<std::pair<uint64_t, int> > closest;
+
+    auto farther = []( const std::pair<uint64_t, int>& aFirst,
+                       const std::pair<uint64_t, int>& aSecond )
+    {
+        // Nodes at the same distance are kept in their sorted order
+        return aFirst < aSecond;
+    };
+
+    // Returns false when the next nodes in the scanning direction cannot be closer
+    auto check = [&]( int aIndex )
+    {
+        const RN_NODE_PTR& node = aSortedNodes[aIndex];
+        int64_t dx = ( node->GetX() - aNode->GetX() ) >> 16;
+
+        if( closest.size() == aCount && (uint64_t) ( dx * dx ) > closest.front().first )
+            return false;
+
+        if( node.get() == aNode.get() || ( aNode->GetTag() >= 0
+                                           && node->GetTag() == aNode->GetTag() ) )
+            return true;
+
+        uint64_t distance = getDistance( aNode, node );
+
+        if( closest.size() < aCount )
+        {
+            closest.push_back( std::make_pair( distance, aIndex ) );
+            std::push_heap( closest.begin(), closest.end(), farther );
+        }
+        else if( distance < closest.front().first )
+        {
+            std::pop_heap( closest.begin(), closest.end(), farther );
+            closest.back() = std::make_pair( distance, aIndex );
+            std::push_heap( closest.begin(), closest.end(), farther );
+        }
+
+        return true;
+    };
+
+    int start = std::lower_bound( aSortedNodes.begin(), aSortedNodes.end(), aNode,
+                                  sortPosition ) - aSortedNodes.begin();
+
+    // Scan the nodes to the right, then to the left
+    for( int i = start; i < (int) aSortedNodes.size(); ++i )
+    {
+        if( !check( i ) )
+            break;
+    }
+
+    for( int i = start - 1; i >= 0; --i )
+    {
+        if( !check( i ) )
+            break;
+    }
+
+    for( const std::pair<uint64_t, int>& node : closest )
+        aOutput.push_back( aSortedNodes[node.second] );
+}
+
+
+static std::vector<RN_EDGE_MST_PTR>* kruskalMST( std::vector<RN_EDGE_PTR>& aEdges,
+                                                 std::vector<RN_NODE_PTR>& aNodes,
+                                                 const RN_LINKS& aLinks )
 {
     unsigned int nodeNumber = aNodes.size();
     unsigned int mstExpectedSize = nodeNumber - 1;
@@ -125,84 +232,95 @@ static std::vector<RN_EDGE_MST_PTR>* kruskalMST( RN_LINKS::RN_EDGE_LIST& aEdges,
     std::vector<RN_EDGE_MST_PTR>* mst = new std::vector<RN_EDGE_MST_PTR>;
     mst->reserve( mstExpectedSize );
 
-    // Set tags for marking cycles
-    std::unordered_map<RN_NODE_PTR, int> tags;
-    unsigned int tag = 0;
+    // Node tags are indexes in aNodes, until they are set to the connected subtree of the node
+    for( unsigned int i = 0; i < nodeNumber; ++i )
+        aNodes[i]->SetTag( i );
 
-    for( RN_NODE_PTR& node : aNodes )
-    {
-        node->SetTag( tag );
-        tags[node] = tag++;
-    }
+    // Subtrees of nodes connected together (union-find), to detect cycles in the graph
+    std::vector<int> parents( nodeNumber );
+    std::vector<int> connectedTags;
 
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
     for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+        parents[i] = i;
+
+    auto findRoot = [&parents]( int aNode )
+    {
+        while( parents[aNode] != aNode )
+        {
+            parents[aNode] = parents[parents[aNode]];
+            aNode = parents[aNode];
+        }
+
+        return aNode;
+    };
 
     // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    std::stable_sort( aEdges.begin(), aEdges.end(), sortWeight );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    for( const RN_EDGE_PTR& dt : aEdges )
     {
-        RN_EDGE_PTR& dt = aEdges.front();
+        if( mstSize >= mstExpectedSize )
+            break;
 
-        int srcTag = tags[dt->GetSourceNode()];
-        int trgTag = tags[dt->GetTargetNode()];
+        int srcTag = findRoot( dt->GetSourceNode()->GetTag() );
+        int trgTag = findRoot( dt->GetTargetNode()->GetTag() );
 
         // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
+        if( srcTag == trgTag )
+            continue;
+
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( !ratsnestLines && dt->GetWeight() != 0 )
         {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt->GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                RN_EDGE_MST_PTR newEdge = std::make_shared<RN_EDGE_MST>( dt->GetSourceNode(),
-                                                                         dt->GetTargetNode(),
-                                                                         dt->GetWeight() );
-
-                assert( newEdge->GetSourceNode()->GetTag() != newEdge->GetTargetNode()->GetTag() );
-                assert( newEdge->GetWeight() > 0 );
-
-                mst->push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                //for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                //for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
+            ratsnestLines = true;
 
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
+            // Save the subtrees of connected nodes, they become the node tags
+            connectedTags.resize( nodeNumber );
 
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
+            for( unsigned int i = 0; i < nodeNumber; ++i )
+                connectedTags[i] = findRoot( i );
         }
 
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
+        if( ratsnestLines )
+        {
+            // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
+            // RN_EDGE_MST saves both source and target node and does not require any other
+            // edges to exist for getting source/target nodes
+            RN_EDGE_MST_PTR newEdge = aLinks.CreateEdge( dt->GetSourceNode(),
+                                                         dt->GetTargetNode(),
+                                                         dt->GetWeight() );
+
+            assert( newEdge->GetWeight() > 0 );
+
+            mst->push_back( newEdge );
+            ++mstSize;
+        }
+        else
+        {
+            // Processing a connection, decrease the expected size of the ratsnest MST
+            --mstExpectedSize;
+        }
+
+        parents[trgTag] = srcTag;
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst->resize( mstSize );
+    if( !ratsnestLines )
+    {
+        connectedTags.resize( nodeNumber );
+
+        for( unsigned int i = 0; i < nodeNumber; ++i )
+            connectedTags[i] = findRoot( i );
+    }
+
+    for( unsigned int i = 0; i < nodeNumber; ++i )
+        aNodes[i]->SetTag( connectedTags[i] );
+
+#ifndef NDEBUG
+    for( const RN_EDGE_MST_PTR& edge : *mst )
+        assert( edge->GetSourceNode()->GetTag() != edge->GetTargetNode()->GetTag() );
+#endif
 
     return mst;
 }
@@ -266,7 +384,7 @@ void RN_NET::validateEdge( RN_EDGE_MST_PTR& aEdge )
 
     // Replace an invalid edge with new, valid one
     if( update )
-        aEdge.reset( new RN_EDGE_MST( source, target ) );
+        aEdge = m_links.CreateEdge( source, target );
 }
 
 
@@ -276,12 +394,60 @@ void RN_NET::removeNode( RN_NODE_PTR& aNode, const BOARD_CONNECTED_ITEM* aParent
 
     if( m_links.RemoveNode( aNode ) )
     {
+        int connections = m_links.GetConnectionCount( aNode );
+
+        // Removing a node with a single connection does not split the connected items,
+        // otherwise the connected subtrees have to be found again
+        if( connections == 1 )
+            removeHelperConnection( aNode );
+        else if( connections > 1 )
+            m_fullUpdate = true;
+
+        m_changedNodes.erase( aNode );
         clearNode( aNode );
         m_dirty = true;
     }
 }
 
 
+void RN_NET::removeHelperConnection( const RN_NODE_PTR& aNode )
+{
+    auto connectsNode = [&aNode]( const RN_EDGE_MST_PTR& aEdge )
+    {
+        return aEdge->GetSourceNode().get() == aNode.get()
+            || aEdge->GetTargetNode().get() == aNode.get();
+    };
+
+    auto removeFrom = [&]( std::deque<RN_EDGE_MST_PTR>& aEdges )
+    {
+        auto it = std::find_if( aEdges.begin(), aEdges.end(), connectsNode );
+
+        if( it == aEdges.end() )
+            return false;
+
+        m_links.RemoveConnection( *it );
+        aEdges.erase( it );
+
+        return true;
+    };
+
+    for( PAD_NODE_MAP::iterator it = m_pads.begin(); it != m_pads.end(); ++it )
+    {
+        if( removeFrom( it->second.m_Edges ) )
+            return;
+    }
+
+    for( ZONE_DATA_MAP::iterator it = m_zones.begin(); it != m_zones.end(); ++it )
+    {
+        if( removeFrom( it->second.m_Edges ) )
+            return;
+    }
+
+    // The connection is not made by a pad or a zone
+    m_fullUpdate = true;
+}
+
+
 void RN_NET::removeEdge( RN_EDGE_MST_PTR& aEdge, const BOARD_CONNECTED_ITEM* aParent )
 {
     // Save nodes, so they can be cleared later
@@ -294,6 +460,7 @@ void RN_NET::removeEdge( RN_EDGE_MST_PTR& aEdge, const BOARD_CONNECTED_ITEM* aPa
     // Connection has to be removed before running RemoveNode(),
     // as RN_NODE influences the reference counter
     m_links.RemoveConnection( aEdge );
+    m_fullUpdate = true;
 
     // Remove nodes associated with the edge. It is done in a safe way, there is a check
     // if nodes are not used by other edges.
@@ -307,12 +474,91 @@ void RN_NET::removeEdge( RN_EDGE_MST_PTR& aEdge, const BOARD_CONNECTED_ITEM* aPa
 }
 
 
+bool RN_POOL::s_heapAllocation = false;
+
+
+RN_POOL::~RN_POOL()
+{
+    for( char* block : m_blocks )
+        delete[] block;
+}
+
+
+void* RN_POOL::Allocate( size_t aSize )
+{
+    size_t size = ( aSize + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+
+    if( m_heapAllocation || size > MAX_BLOCK_SIZE / 4 )
+    {
+        m_allocated += size;
+        return ::operator new( size );
+    }
+
+    size_t index = size / ALIGNMENT;
+
+    if( index < m_freeLists.size() && m_freeLists[index] )
+    {
+        void* ptr = m_freeLists[index];
+        m_freeLists[index] = *static_cast<void**>( ptr );
+        return ptr;
+    }
+
+    if( m_blockUsed + size > m_blockSize )
+    {
+        m_blockSize = m_blockSize ? m_blockSize * 2 : MIN_BLOCK_SIZE;
+
+        while( m_blockSize < size )
+            m_blockSize *= 2;
+
+        if( m_blockSize > MAX_BLOCK_SIZE )
+            m_blockSize = MAX_BLOCK_SIZE;
+
+        // new[] memory is aligned for any fundamental type
+        m_blocks.push_back( new char[m_blockSize] );
+        m_blockUsed = 0;
+        m_reserved += m_blockSize;
+    }
+
+    void* ptr = m_blocks.back() + m_blockUsed;
+    m_blockUsed += size;
+
+    return ptr;
+}
+
+
+void RN_POOL::Free( void* aPtr, size_t aSize )
+{
+    size_t size = ( aSize + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+
+    if( m_heapAllocation || size > MAX_BLOCK_SIZE / 4 )
+    {
+        m_allocated -= size;
+        ::operator delete( aPtr );
+        return;
+    }
+
+    size_t index = size / ALIGNMENT;
+
+    if( index >= m_freeLists.size() )
+        m_freeLists.resize( index + 1, nullptr );
+
+    *static_cast<void**>( aPtr ) = m_freeLists[index];
+    m_freeLists[index] = aPtr;
+}
+
+
 const RN_NODE_PTR& RN_LINKS::AddNode( int aX, int aY )
 {
-    RN_NODE_SET::iterator node;
-    bool wasNewElement;
+    // Look for an existing node first, using a probe which does not own the node, so no
+    // memory is allocated for an existing node
+    RN_NODE probe( aX, aY );
+    RN_NODE_SET::iterator node = m_nodes.find( RN_NODE_PTR( RN_NODE_PTR(), &probe ) );
 
-    std::tie( node, wasNewElement ) = m_nodes.emplace( std::make_shared<RN_NODE>( aX, aY ) );
+    if( node != m_nodes.end() )
+        return *node;
+
+    node = m_nodes.insert( std::allocate_shared<RN_NODE>( RN_POOL_ALLOCATOR<RN_NODE>( m_pool ),
+                                                          aX, aY ) ).first;
 
     return *node;
 }
@@ -335,17 +581,34 @@ RN_EDGE_MST_PTR RN_LINKS::AddConnection( const RN_NODE_PTR& aNode1, const RN_NOD
                                          unsigned int aDistance )
 {
     assert( aNode1 != aNode2 );
-    RN_EDGE_MST_PTR edge = std::make_shared<RN_EDGE_MST>( aNode1, aNode2, aDistance );
-    m_edges.push_back( edge );
+    RN_EDGE_MST_PTR edge = CreateEdge( aNode1, aNode2, aDistance );
+    m_edges.insert( edge );
+    m_connectionCount[aNode1.get()]++;
+    m_connectionCount[aNode2.get()]++;
 
     return edge;
 }
 
 
+void RN_LINKS::RemoveConnection( const RN_EDGE_PTR& aEdge )
+{
+    if( !m_edges.erase( aEdge ) )
+        return;
+
+    for( const RN_NODE* node : { aEdge->GetSourceNode().get(), aEdge->GetTargetNode().get() } )
+    {
+        auto it = m_connectionCount.find( node );
+
+        if( it != m_connectionCount.end() && --it->second == 0 )
+            m_connectionCount.erase( it );
+    }
+}
+
+
 void RN_NET::compute()
 {
     const RN_LINKS::RN_NODE_SET& boardNodes = m_links.GetNodes();
-    const RN_LINKS::RN_EDGE_LIST& boardEdges = m_links.GetConnections();
+    const RN_LINKS::RN_EDGE_SET& boardEdges = m_links.GetConnections();
 
     // Special cases do not need complicated algorithms (actually, it does not work well with
     // the Delaunay triangulator)
@@ -359,7 +622,7 @@ void RN_NET::compute()
             RN_LINKS::RN_NODE_SET::const_iterator last = ++boardNodes.begin();
 
             // There can be only one possible connection, but it is missing
-            RN_EDGE_MST_PTR edge = std::make_shared<RN_EDGE_MST>( *boardNodes.begin(), *last );
+            RN_EDGE_MST_PTR edge = m_links.CreateEdge( *boardNodes.begin(), *last );
             edge->GetSourceNode()->SetTag( 0 );
             edge->GetTargetNode()->SetTag( 1 );
             m_rnEdges->push_back( edge );
@@ -375,24 +638,183 @@ void RN_NET::compute()
         return;
     }
 
-    // Move and sort (sorting speeds up) all nodes to a vector for the Delaunay triangulation
-    std::vector<RN_NODE_PTR> nodes( boardNodes.size() );
-    std::partial_sort_copy( boardNodes.begin(), boardNodes.end(), nodes.begin(), nodes.end() );
+    // Move and sort (sorting speeds up) all nodes to a vector for the Delaunay triangulation.
+    // They are sorted by position, so the triangulation does not depend on the hash set order
+    std::vector<RN_NODE_PTR> nodes( boardNodes.begin(), boardNodes.end() );
+    std::sort( nodes.begin(), nodes.end(), sortPosition );
 
     TRIANGULATOR triangulator;
     triangulator.CreateDelaunay( nodes.begin(), nodes.end() );
     std::unique_ptr<RN_LINKS::RN_EDGE_LIST> triangEdges( triangulator.GetEdges() );
 
-    // Compute weight/distance for edges resulting from triangulation
-    RN_LINKS::RN_EDGE_LIST::iterator eit, eitEnd;
-    for( eit = (*triangEdges).begin(), eitEnd = (*triangEdges).end(); eit != eitEnd; ++eit )
-        (*eit)->SetWeight( getDistance( (*eit)->GetSourceNode(), (*eit)->GetTargetNode() ) );
+    // The currently existing connections go first, then the results of triangulation
+    std::vector<RN_EDGE_PTR> edges;
+    edges.reserve( boardEdges.size() + triangEdges->size() );
+    edges.insert( edges.end(), boardEdges.begin(), boardEdges.end() );
 
-    // Add the currently existing connections list to the results of triangulation
-    std::copy( boardEdges.begin(), boardEdges.end(), std::front_inserter( *triangEdges ) );
+    // Compute weight/distance for edges resulting from triangulation
+    for( const RN_EDGE_PTR& edge : *triangEdges )
+    {
+        edge->SetWeight( getDistance( edge->GetSourceNode(), edge->GetTargetNode() ) );
+        edges.push_back( edge );
+    }
 
     // Get the minimal spanning tree
-    m_rnEdges.reset( kruskalMST( *triangEdges, nodes ) );
+    m_rnEdges.reset( kruskalMST( edges, nodes, m_links ) );
+}
+
+
+bool RN_NET::computeIncremental()
+{
+    // Nets smaller than that are recomputed from scratch, it is fast enough
+    const unsigned int MIN_NODES = 16;
+
+    // Number of neighbours of a changed node that may be connected to it.  The minimal tree
+    // may need an edge to a farther Delaunay neighbour, or between two unchanged nodes after
+    // a node removal: such a tree is not minimal, but it still joins all the subtrees
+    const unsigned int CLOSEST_COUNT = 6;
+
+    const RN_LINKS::RN_NODE_SET& boardNodes = m_links.GetNodes();
+
+    if( m_fullUpdate || !m_rnEdges )
+        return false;
+
+    if( m_changedNodes.empty() )
+        return true;
+
+    // Past this number of changes, the triangulation is faster.  The changes of the previous
+    // incremental updates are counted too, so the longer lines they may have left are
+    // replaced by the minimal tree after a while
+    if( boardNodes.size() < MIN_NODES
+            || ( m_incrementalChanges + m_changedNodes.size() ) * 4 > boardNodes.size() )
+        return false;
+
+    std::vector<RN_NODE_PTR> changed, created;
+
+    for( const RN_NODE_PTR& node : m_changedNodes )
+    {
+        // The node might have been removed after it was changed
+        RN_LINKS::RN_NODE_SET::const_iterator it = boardNodes.find( node );
+
+        if( it == boardNodes.end() || it->get() != node.get() )
+            continue;
+
+        changed.push_back( node );
+
+        // Nodes which have never been tagged are new
+        if( node->GetTag() < 0 )
+            created.push_back( node );
+    }
+
+    connectNewNodes( created );
+
+    std::vector<RN_NODE_PTR> nodes( boardNodes.begin(), boardNodes.end() );
+    std::sort( nodes.begin(), nodes.end(), sortPosition );
+
+    // The currently existing connections go first, then the previous ratsnest (connections
+    // were only added, so it still joins the unchanged subtrees) and the neighbours of the
+    // changed nodes
+    const RN_LINKS::RN_EDGE_SET& boardEdges = m_links.GetConnections();
+    std::vector<RN_EDGE_PTR> edges;
+    edges.reserve( boardEdges.size() + m_rnEdges->size() + changed.size() * CLOSEST_COUNT );
+    edges.insert( edges.end(), boardEdges.begin(), boardEdges.end() );
+
+    for( const RN_EDGE_MST_PTR& edge : *m_rnEdges )
+    {
+        // Edges modified by validateEdge() do not have their weight set
+        edge->SetWeight( getDistance( edge->GetSourceNode(), edge->GetTargetNode() ) );
+        edges.push_back( edge );
+    }
+
+    std::vector<RN_NODE_PTR> closest;
+
+    for( const RN_NODE_PTR& node : changed )
+    {
+        closest.clear();
+        findClosestNodes( nodes, node, CLOSEST_COUNT, closest );
+
+        for( const RN_NODE_PTR& neighbour : closest )
+            edges.push_back( m_links.CreateEdge( node, neighbour, getDistance( node, neighbour ) ) );
+    }
+
+    std::shared_ptr< std::vector<RN_EDGE_MST_PTR> > mst( kruskalMST( edges, nodes, m_links ) );
+
+    // Check if the candidate edges were enough to join all connected subtrees
+    std::unordered_set<int> subtrees;
+
+    for( const RN_NODE_PTR& node : nodes )
+        subtrees.insert( node->GetTag() );
+
+    if( mst->size() + 1 < subtrees.size() )
+        return false;
+
+    m_rnEdges = mst;
+    m_incrementalChanges += changed.size();
+
+    return true;
+}
+
+
+void RN_NET::connectNewNodes( const std::vector<RN_NODE_PTR>& aNodes )
+{
+    if( aNodes.empty() )
+        return;
+
+    std::unordered_set<const RN_NODE*> created;
+
+    for( const RN_NODE_PTR& node : aNodes )
+        created.insert( node.get() );
+
+    // Pads, as in processPads(): a new pad may contain any node, others only the new nodes
+    for( PAD_NODE_MAP::iterator it = m_pads.begin(); it != m_pads.end(); ++it )
+    {
+        const D_PAD* pad = it->first;
+        RN_NODE_PTR node = it->second.m_Node;
+        std::deque<RN_EDGE_MST_PTR>& edges = it->second.m_Edges;
+        LSET layers = pad->GetLayerSet();
+
+        auto connect = [&]( const RN_NODE_PTR& aPoint )
+        {
+            if( aPoint != node && ( aPoint->GetLayers() & layers ).any() &&
+                    pad->HitTest( wxPoint( aPoint->GetX(), aPoint->GetY() ) ) )
+            {
+                edges.push_back( m_links.AddConnection( node, aPoint ) );
+            }
+        };
+
+        if( created.count( node.get() ) )
+        {
+            for( const RN_NODE_PTR& point : m_links.GetNodes() )
+                connect( point );
+        }
+        else
+        {
+            for( const RN_NODE_PTR& point : aNodes )
+                connect( point );
+        }
+    }
+
+    // Zones, as in processZones(): a node is connected to the first polygon containing it
+    for( ZONE_DATA_MAP::iterator it = m_zones.begin(); it != m_zones.end(); ++it )
+    {
+        RN_ZONE_DATA& zoneData = it->second;
+        LSET layers = it->first->GetLayerSet();
+
+        for( const RN_NODE_PTR& point : aNodes )
+        {
+            if( !( point->GetLayers() & layers ).any() )
+                continue;
+
+            for( const RN_POLY& poly : zoneData.m_Polygons )
+            {
+                if( point != poly.GetNode() && poly.HitTest( point ) )
+                {
+                    zoneData.m_Edges.push_back( m_links.AddConnection( poly.GetNode(), point ) );
+                    break;
+                }
+            }
+        }
+    }
 }
 
 
@@ -403,6 +825,19 @@ void RN_NET::clearNode( const RN_NODE_PTR& aNode )
 
     std::vector<RN_EDGE_MST_PTR>::iterator newEnd;
 
+    // The other ends of the removed edges have to be connected again
+    for( const RN_EDGE_MST_PTR& edge : *m_rnEdges )
+    {
+        if( !isEdgeConnectingNode( edge, aNode ) )
+            continue;
+
+        for( const RN_NODE_PTR& node : { edge->GetSourceNode(), edge->GetTargetNode() } )
+        {
+            if( node.get() != aNode.get() )
+                m_changedNodes.insert( node );
+        }
+    }
+
     // Remove all ratsnest edges for associated with the node
     newEnd = std::remove_if( m_rnEdges->begin(), m_rnEdges->end(),
                              std::bind( isEdgeConnectingNode, _1, std::cref( aNode ) ) );
@@ -432,17 +867,27 @@ bool RN_POLY::HitTest( const RN_NODE_PTR& aNode ) const
 {
     VECTOR2I p( aNode->GetX(), aNode->GetY() );
 
+    if( !m_bbox.Contains( p ) )
+        return false;
+
     return m_parentPolyset->Contains( p, m_subpolygonIndex );
 }
 
 
 void RN_NET::Update()
 {
-    // Add edges resulting from nodes being connected by zones
-    processZones();
-    processPads();
+    if( !computeIncremental() )
+    {
+        // Add edges resulting from nodes being connected by zones
+        processZones();
+        processPads();
+
+        compute();
+        m_incrementalChanges = 0;
+    }
 
-    compute();
+    m_changedNodes.clear();
+    m_fullUpdate = false;
 
     for( RN_EDGE_MST_PTR& edge : *m_rnEdges )
         validateEdge( edge );
@@ -460,6 +905,7 @@ bool RN_NET::AddItem( const D_PAD* aPad )
     RN_NODE_PTR node = m_links.AddNode( aPad->GetPosition().x, aPad->GetPosition().y );
     node->AddParent( aPad );
     m_pads[aPad].m_Node = node;
+    m_changedNodes.insert( node );
     m_dirty = true;
 
     return true;
@@ -471,6 +917,7 @@ bool RN_NET::AddItem( const VIA* aVia )
     RN_NODE_PTR node = m_links.AddNode( aVia->GetPosition().x, aVia->GetPosition().y );
     node->AddParent( aVia );
     m_vias[aVia] = node;
+    m_changedNodes.insert( node );
     m_dirty = true;
 
     return true;
@@ -488,6 +935,8 @@ bool RN_NET::AddItem( const TRACK* aTrack )
     start->AddParent( aTrack );
     end->AddParent( aTrack );
     m_tracks[aTrack] = m_links.AddConnection( start, end );
+    m_changedNodes.insert( start );
+    m_changedNodes.insert( end );
     m_dirty = true;
 
     return true;
@@ -510,6 +959,7 @@ bool RN_NET::AddItem( const ZONE_CONTAINER* aZone )
         m_zones[aZone].m_Polygons.push_back( poly );
     }
 
+    m_fullUpdate = true;
     m_dirty = true;
 
     return true;
@@ -1037,6 +1487,7 @@ void RN_NET::processPads()
         for( RN_EDGE_MST_PTR edge : edges )
             m_links.RemoveConnection( edge );
 
+        edges.clear();
         LSET layers = pad->GetLayerSet();
         const RN_LINKS::RN_NODE_SET& candidates = m_links.GetNodes();
         RN_LINKS::RN_NODE_SET::const_iterator point, pointEnd;
@@ -36,6 +36,8 @@
 #include <math/box2.h>
 
 #include <deque>
+#include <memory>
+#include <vector>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -191,6 +193,141 @@ struct RN_NODE_HASH : std::unary_function<RN_NODE_PTR, std::size_t>
 };
 
 
+/**
+ * Class RN_POOL
+ * Allocates the nodes and edges of a net in blocks, instead of one allocation per object,
+ * so they are stored close to each other.  The first block is small and each new block is
+ * twice as big as the previous one, up to MAX_BLOCK_SIZE, so boards with many small nets do
+ * not reserve a big block for each of them.  Freed memory is kept in a free list for each
+ * allocation size and reused.  A pool is used by a single net, which is modified by one thread
+ * at a time, so it is not thread safe.
+ */
+class RN_POOL
+{
+public:
+    RN_POOL() : m_blockSize( 0 ), m_blockUsed( 0 ), m_reserved( 0 ), m_allocated( 0 ),
+        m_heapAllocation( s_heapAllocation )
+    {}
+
+    ~RN_POOL();
+
+    /**
+     * Function SetHeapAllocation()
+     * Makes the pools created from now on allocate each object on the heap, like before the
+     * pools were used.  The pools already created keep their mode.  Used by
+     * qa/ratsnest_perf to compare both allocations.
+     */
+    static void SetHeapAllocation( bool aHeap )
+    {
+        s_heapAllocation = aHeap;
+    }
+
+    /**
+     * Function Allocate()
+     * Returns memory for an object of aSize bytes.
+     */
+    void* Allocate( size_t aSize );
+
+    /**
+     * Function Free()
+     * Gives back the memory of an object of aSize bytes returned by Allocate().
+     */
+    void Free( void* aPtr, size_t aSize );
+
+    /**
+     * Function GetMemoryUsage()
+     * Returns the number of bytes reserved by the pool.
+     */
+    size_t GetMemoryUsage() const
+    {
+        return m_reserved + m_allocated;
+    }
+
+private:
+    RN_POOL( const RN_POOL& ) = delete;
+    RN_POOL& operator=( const RN_POOL& ) = delete;
+
+    ///> Size of the first block
+    static const size_t MIN_BLOCK_SIZE = 256;
+
+    ///> Size of the blocks, when they stop growing
+    static const size_t MAX_BLOCK_SIZE = 16384;
+
+    ///> Allocation granularity, which is also the alignment of the objects
+    static const size_t ALIGNMENT = 16;
+
+    ///> Blocks the objects are taken from
+    std::vector<char*> m_blocks;
+
+    ///> Size of the last block
+    size_t m_blockSize;
+
+    ///> Number of bytes used in the last block
+    size_t m_blockUsed;
+
+    ///> Number of bytes of all the blocks
+    size_t m_reserved;
+
+    ///> Heads of the lists of freed objects, indexed by size / ALIGNMENT
+    std::vector<void*> m_freeLists;
+
+    ///> Number of bytes of the objects too big to be taken from blocks
+    size_t m_allocated;
+
+    ///> True if each object is allocated on the heap, see SetHeapAllocation()
+    const bool m_heapAllocation;
+
+    ///> Mode of the new pools
+    static bool s_heapAllocation;
+};
+
+
+/**
+ * Class RN_POOL_ALLOCATOR
+ * Standard allocator taking memory from a RN_POOL, to be used with std::allocate_shared().  It
+ * holds a reference to the pool, so the pool is kept until all its objects are destroyed.
+ */
+template <typename T>
+class RN_POOL_ALLOCATOR
+{
+public:
+    typedef T value_type;
+
+    RN_POOL_ALLOCATOR( const std::shared_ptr<RN_POOL>& aPool ) :
+        m_pool( aPool )
+    {}
+
+    template <typename U>
+    RN_POOL_ALLOCATOR( const RN_POOL_ALLOCATOR<U>& aOther ) :
+        m_pool( aOther.m_pool )
+    {}
+
+    T* allocate( size_t aCount )
+    {
+        return static_cast<T*>( m_pool->Allocate( aCount * sizeof( T ) ) );
+    }
+
+    void deallocate( T* aPtr, size_t aCount )
+    {
+        m_pool->Free( aPtr, aCount * sizeof( T ) );
+    }
+
+    template <typename U>
+    bool operator==( const RN_POOL_ALLOCATOR<U>& aOther ) const
+    {
+        return m_pool == aOther.m_pool;
+    }
+
+    template <typename U>
+    bool operator!=( const RN_POOL_ALLOCATOR<U>& aOther ) const
+    {
+        return m_pool != aOther.m_pool;
+    }
+
+    std::shared_ptr<RN_POOL> m_pool;
+};
+
+
 /**
  * Class RN_LINKS
  * Manages data describing nodes and connections for a given net.
@@ -201,6 +338,11 @@ public:
     // Helper typedefs
     typedef std::unordered_set<RN_NODE_PTR, RN_NODE_HASH, RN_NODE_COMPARE> RN_NODE_SET;
     typedef std::list<RN_EDGE_PTR> RN_EDGE_LIST;
+    typedef std::unordered_set<RN_EDGE_PTR> RN_EDGE_SET;
+
+    RN_LINKS() :
+        m_pool( std::make_shared<RN_POOL>() )
+    {}
 
     /**
      * Function AddNode()
@@ -243,32 +385,70 @@ public:
     RN_EDGE_MST_PTR AddConnection( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode2,
                                     unsigned int aDistance = 0 );
 
+    /**
+     * Function CreateEdge()
+     * Creates an edge between two nodes, without adding it to the connections.
+     * @param aNode1 is the origin node of the edge.
+     * @param aNode2 is the end node of the edge.
+     * @param aDistance is the distance of the connection.
+     */
+    RN_EDGE_MST_PTR CreateEdge( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode2,
+                                unsigned int aDistance = 0 ) const
+    {
+        return std::allocate_shared<RN_EDGE_MST>( RN_POOL_ALLOCATOR<RN_EDGE_MST>( m_pool ),
+                                                  aNode1, aNode2, aDistance );
+    }
+
     /**
      * Function RemoveConnection()
      * Removes a connection described by a given edge pointer.
      * @param aEdge is a pointer to edge to be removed.
      */
-    void RemoveConnection( const RN_EDGE_PTR& aEdge )
+    void RemoveConnection( const RN_EDGE_PTR& aEdge );
+
+    /**
+     * Function GetConnectionCount()
+     * Returns the number of connections of a node.
+     * @param aNode is the node.
+     */
+    int GetConnectionCount( const RN_NODE_PTR& aNode ) const
     {
-        m_edges.remove( aEdge );
+        auto it = m_connectionCount.find( aNode.get() );
+
+        return it == m_connectionCount.end() ? 0 : it->second;
     }
 
     /**
      * Function GetConnections()
-     * Returns the list of edges that currently connect nodes.
-     * @return the list of edges that currently connect nodes.
+     * Returns the set of edges that currently connect nodes.
+     * @return the set of edges that currently connect nodes.
      */
-    const RN_EDGE_LIST& GetConnections() const
+    const RN_EDGE_SET& GetConnections() const
     {
         return m_edges;
     }
 
+    /**
+     * Function GetMemoryUsage()
+     * Returns the number of bytes used by the nodes and edges of the net.
+     */
+    size_t GetMemoryUsage() const
+    {
+        return m_pool->GetMemoryUsage();
+    }
+
 protected:
+    ///> Memory of the nodes and edges.
+    std::shared_ptr<RN_POOL> m_pool;
+
     ///> Set of nodes that are expected to be connected together (vias, tracks, pads).
     RN_NODE_SET m_nodes;
 
-    ///> List of edges that currently connect nodes.
-    RN_EDGE_LIST m_edges;
+    ///> Set of edges that currently connect nodes.
+    RN_EDGE_SET m_edges;
+
+    ///> Number of connections of each node, for the nodes which have some.
+    std::unordered_map<const RN_NODE*, int> m_connectionCount;
 };
 
 
@@ -334,7 +514,8 @@ class RN_NET
 {
 public:
     ///> Default constructor.
-    RN_NET() : m_dirty( true ), m_visible( true )
+    RN_NET() : m_dirty( true ), m_fullUpdate( true ), m_incrementalChanges( 0 ),
+        m_visible( true )
     {}
 
     /**
@@ -560,6 +741,15 @@ public:
                             std::list<BOARD_CONNECTED_ITEM*>& aOutput,
                             RN_ITEM_TYPE aTypes = RN_ALL ) const;
 
+    /**
+     * Function GetMemoryUsage()
+     * Returns the number of bytes used by the nodes and edges of the net.
+     */
+    size_t GetMemoryUsage() const
+    {
+        return m_links.GetMemoryUsage();
+    }
+
 protected:
     ///> Validates edge, i.e. modifies source and target nodes for an edge
     ///> to make sure that they are not ones with the flag set.
@@ -585,6 +775,22 @@ protected:
     ///> Recomputes ratsnset from scratch.
     void compute();
 
+    ///> Recomputes ratsnest for the nodes changed since the last computation, reusing the
+    ///> connections and ratsnest edges of the other nodes. Returns false if the changes are
+    ///> too many or not local, so the ratsnest has to be recomputed from scratch.
+    ///> The result is an approximation of the minimal spanning tree: a changed node is only
+    ///> linked to its closest neighbours, not to all its Delaunay neighbours, and the other
+    ///> nodes keep their previous edges.  Some lines may be longer than those of compute(),
+    ///> so the net is recomputed from scratch once a quarter of its nodes were changed by
+    ///> incremental updates.
+    bool computeIncremental();
+
+    ///> Adds connections made by pads and zones to the nodes created since the last computation.
+    void connectNewNodes( const std::vector<RN_NODE_PTR>& aNodes );
+
+    ///> Removes the only connection of a node, made by a pad or a zone.
+    void removeHelperConnection( const RN_NODE_PTR& aNode );
+
     ////> Stores information about connections for a given net.
     RN_LINKS m_links;
 
@@ -600,6 +806,17 @@ protected:
     ///> Flag indicating necessity of recalculation of ratsnest for a net.
     bool m_dirty;
 
+    ///> Nodes added, or which lost their ratsnest edges, since the last computation.
+    std::unordered_set<RN_NODE_PTR> m_changedNodes;
+
+    ///> Flag indicating that connections were removed, so the ratsnest has to be recomputed
+    ///> from scratch.
+    bool m_fullUpdate;
+
+    ///> Number of nodes changed by the incremental updates since the last computation from
+    ///> scratch, which limits the drift of the approximated ratsnest.
+    unsigned int m_incrementalChanges;
+
     ///> Structure to hold ratsnest data for ZONE_CONTAINER objects.
     typedef struct
     {
@@ -0,0 +1,456 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2013-2014 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "pns_index.h"
+
+namespace PNS {
+
+INDEX::INDEX()
+{
+    m_tree = new TREE_NODE;
+    m_tree->m_leaf = true;
+    m_tree->m_count = 0;
+}
+
+
+INDEX::~INDEX()
+{
+    freeTree( m_tree );
+}
+
+
+void INDEX::TREE_BOX::Merge( const TREE_BOX& aB )
+{
+    m_x0 = std::min( m_x0, aB.m_x0 );
+    m_y0 = std::min( m_y0, aB.m_y0 );
+    m_x1 = std::max( m_x1, aB.m_x1 );
+    m_y1 = std::max( m_y1, aB.m_y1 );
+}
+
+
+INDEX::LAYER_MASK INDEX::layerMask( const LAYER_RANGE& aLayers )
+{
+    const int bits = 8 * sizeof( LAYER_MASK );
+    int start = std::max( aLayers.Start(), 0 );
+
+    // items without layers, or above the capacity of the mask, are put on all layers
+    if( aLayers.End() < 0 || start >= bits )
+        return ~LAYER_MASK( 0 );
+
+    LAYER_MASK mask = ~LAYER_MASK( 0 ) << start;
+
+    if( aLayers.End() < bits - 1 )
+        mask &= ~LAYER_MASK( 0 ) >> ( bits - 1 - aLayers.End() );
+
+    return mask;
+}
+
+
+INDEX::TREE_BOX INDEX::shapeBox( const SHAPE* aShape, int aMinDistance )
+{
+    BOX2I bbox = aShape->BBox();
+    bbox.Inflate( aMinDistance );
+
+    TREE_BOX box = { bbox.GetX(), bbox.GetY(), bbox.GetRight(), bbox.GetBottom() };
+
+    return box;
+}
+
+
+INDEX::TREE_ENTRY INDEX::itemEntry( ITEM* aItem )
+{
+    TREE_ENTRY entry;
+
+    entry.m_box = shapeBox( aItem->Shape(), 0 );
+    entry.m_layers = layerMask( aItem->Layers() );
+    entry.m_child = NULL;
+    entry.m_item = aItem;
+
+    return entry;
+}
+
+
+INDEX::TREE_ENTRY INDEX::nodeEntry( TREE_NODE* aNode )
+{
+    TREE_ENTRY entry;
+
+    entry.m_box = aNode->m_entries[0].m_box;
+    entry.m_layers = 0;
+    entry.m_child = aNode;
+    entry.m_item = NULL;
+
+    for( int i = 0; i < aNode->m_count; i++ )
+    {
+        entry.m_box.Merge( aNode->m_entries[i].m_box );
+        entry.m_layers |= aNode->m_entries[i].m_layers;
+    }
+
+    return entry;
+}
+
+
+void INDEX::Add( ITEM* aItem )
+{
+    if( !m_allItems.insert( aItem ).second )
+        return;
+
+    m_pending.push_back( aItem );
+    m_pendingSet.insert( aItem );
+
+    int net = aItem->Net();
+
+    if( net >= 0 )
+        m_netMap[net].push_back( aItem );
+}
+
+
+void INDEX::Remove( ITEM* aItem )
+{
+    if( !m_allItems.erase( aItem ) )
+        return;
+
+    // A pending item is only dropped from the set: flush() skips it in m_pending
+    if( !m_pendingSet.erase( aItem ) )
+    {
+        TREE_BOX box = shapeBox( aItem->Shape(), 0 );
+
+        // the item has moved since it was added? look for it everywhere
+        if( !remove( m_tree, &box, aItem ) )
+            remove( m_tree, NULL, aItem );
+    }
+
+    // shorten the tree when the root is left with a single child
+    while( !m_tree->m_leaf && m_tree->m_count <= 1 )
+    {
+        if( m_tree->m_count == 0 )
+        {
+            m_tree->m_leaf = true;
+            break;
+        }
+
+        TREE_NODE* child = m_tree->m_entries[0].m_child;
+        delete m_tree;
+        m_tree = child;
+    }
+
+    int net = aItem->Net();
+    std::map<int, NET_ITEMS_LIST>::iterator f = m_netMap.find( net );
+
+    if( net >= 0 && f != m_netMap.end() )
+    {
+        NET_ITEMS_LIST& items = f->second;
+        NET_ITEMS_LIST::iterator i = std::find( items.begin(), items.end(), aItem );
+
+        if( i != items.end() )
+        {
+            *i = items.back();
+            items.pop_back();
+        }
+    }
+}
+
+
+void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
+{
+    Remove( aOldItem );
+    Add( aNewItem );
+}
+
+
+void INDEX::Clear()
+{
+    freeTree( m_tree );
+
+    m_tree = new TREE_NODE;
+    m_tree->m_leaf = true;
+    m_tree->m_count = 0;
+
+    m_pending.clear();
+    m_pendingSet.clear();
+    m_netMap.clear();
+    m_allItems.clear();
+}
+
+
+INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
+{
+    std::map<int, NET_ITEMS_LIST>::iterator f = m_netMap.find( aNet );
+
+    if( f == m_netMap.end() )
+        return NULL;
+
+    return &f->second;
+}
+
+
+void INDEX::flush()
+{
+    if( m_pending.empty() )
+        return;
+
+    // more new items than items in the tree: rebuilding the tree is faster
+    if( 2 * m_pendingSet.size() > m_allItems.size() )
+    {
+        bulkLoad();
+    }
+    else
+    {
+        // An item removed, or removed and added again, is in m_pending more than once or
+        // not in m_pendingSet: it is inserted only the first time it is found in both
+        for( ITEM* item : m_pending )
+        {
+            if( m_pendingSet.erase( item ) )
+                insertItem( item );
+        }
+    }
+
+    m_pending.clear();
+    m_pendingSet.clear();
+}
+
+
+void INDEX::bulkLoad()
+{
+    // Sort-Tile-Recursive packing: the entries of a level are sorted in vertical
+    // slices along x, each slice is sorted along y and cut in full nodes.
+    std::vector<TREE_ENTRY> entries;
+    bool leaf = true;
+
+    entries.reserve( m_allItems.size() );
+
+    for( ITEM* item : m_allItems )
+        entries.push_back( itemEntry( item ) );
+
+    while( entries.size() > MaxNodeEntries )
+    {
+        size_t nodeCount = ( entries.size() + MaxNodeEntries - 1 ) / MaxNodeEntries;
+        size_t sliceSize = MaxNodeEntries * (size_t) std::ceil( std::sqrt( (double) nodeCount ) );
+        std::vector<TREE_ENTRY> parents;
+
+        parents.reserve( nodeCount );
+
+        std::sort( entries.begin(), entries.end(),
+                   []( const TREE_ENTRY& aA, const TREE_ENTRY& aB )
+                   {
+                       return aA.m_box.Center2( 0 ) < aB.m_box.Center2( 0 );
+                   } );
+
+        for( size_t slice = 0; slice < entries.size(); slice += sliceSize )
+        {
+            size_t sliceEnd = std::min( slice + sliceSize, entries.size() );
+
+            std::sort( entries.begin() + slice, entries.begin() + sliceEnd,
+                       []( const TREE_ENTRY& aA, const TREE_ENTRY& aB )
+                       {
+                           return aA.m_box.Center2( 1 ) < aB.m_box.Center2( 1 );
+                       } );
+
+            for( size_t first = slice; first < sliceEnd; first += MaxNodeEntries )
+            {
+                TREE_NODE* node = new TREE_NODE;
+
+                node->m_leaf = leaf;
+                node->m_count = std::min( sliceEnd - first, (size_t) MaxNodeEntries );
+                std::copy( entries.begin() + first, entries.begin() + first + node->m_count,
+                           node->m_entries );
+
+                parents.push_back( nodeEntry( node ) );
+            }
+        }
+
+        entries.swap( parents );
+        leaf = false;
+    }
+
+    freeTree( m_tree );
+
+    m_tree = new TREE_NODE;
+    m_tree->m_leaf = leaf;
+    m_tree->m_count = entries.size();
+    std::copy( entries.begin(), entries.end(), m_tree->m_entries );
+}
+
+
+void INDEX::insertItem( ITEM* aItem )
+{
+    TREE_NODE* split = insert( m_tree, itemEntry( aItem ) );
+
+    if( split )
+    {
+        TREE_NODE* root = new TREE_NODE;
+
+        root->m_leaf = false;
+        root->m_count = 2;
+        root->m_entries[0] = nodeEntry( m_tree );
+        root->m_entries[1] = nodeEntry( split );
+        m_tree = root;
+    }
+}
+
+
+INDEX::TREE_NODE* INDEX::insert( TREE_NODE* aNode, const TREE_ENTRY& aEntry )
+{
+    if( aNode->m_leaf )
+        return addEntry( aNode, aEntry );
+
+    // descend in the child needing the least enlargement to contain the new entry
+    int best = 0;
+    double bestGrowth = 0.0, bestArea = 0.0;
+
+    for( int i = 0; i < aNode->m_count; i++ )
+    {
+        TREE_BOX merged = aNode->m_entries[i].m_box;
+        double area = merged.Area();
+
+        merged.Merge( aEntry.m_box );
+
+        double growth = merged.Area() - area;
+
+        if( i == 0 || growth < bestGrowth || ( growth == bestGrowth && area < bestArea ) )
+        {
+            best = i;
+            bestGrowth = growth;
+            bestArea = area;
+        }
+    }
+
+    TREE_ENTRY& child = aNode->m_entries[best];
+    TREE_NODE* split = insert( child.m_child, aEntry );
+
+    if( !split )
+    {
+        child.m_box.Merge( aEntry.m_box );
+        child.m_layers |= aEntry.m_layers;
+        return NULL;
+    }
+
+    child = nodeEntry( child.m_child );
+
+    return addEntry( aNode, nodeEntry( split ) );
+}
+
+
+INDEX::TREE_NODE* INDEX::addEntry( TREE_NODE* aNode, const TREE_ENTRY& aEntry )
+{
+    if( aNode->m_count < MaxNodeEntries )
+    {
+        aNode->m_entries[aNode->m_count++] = aEntry;
+        return NULL;
+    }
+
+    // full node: split the entries in two halves, along the axis they spread the most
+    TREE_ENTRY entries[MaxNodeEntries + 1];
+    long long lo[2] = { LLONG_MAX, LLONG_MAX };
+    long long hi[2] = { LLONG_MIN, LLONG_MIN };
+
+    std::copy( aNode->m_entries, aNode->m_entries + MaxNodeEntries, entries );
+    entries[MaxNodeEntries] = aEntry;
+
+    for( const TREE_ENTRY& entry : entries )
+    {
+        for( int axis = 0; axis < 2; axis++ )
+        {
+            lo[axis] = std::min( lo[axis], entry.m_box.Center2( axis ) );
+            hi[axis] = std::max( hi[axis], entry.m_box.Center2( axis ) );
+        }
+    }
+
+    int axis = ( hi[1] - lo[1] > hi[0] - lo[0] ) ? 1 : 0;
+
+    std::sort( entries, entries + MaxNodeEntries + 1,
+               [axis]( const TREE_ENTRY& aA, const TREE_ENTRY& aB )
+               {
+                   return aA.m_box.Center2( axis ) < aB.m_box.Center2( axis );
+               } );
+
+    const int half = ( MaxNodeEntries + 1 ) / 2;
+    TREE_NODE* sibling = new TREE_NODE;
+
+    aNode->m_count = half;
+    std::copy( entries, entries + half, aNode->m_entries );
+
+    sibling->m_leaf = aNode->m_leaf;
+    sibling->m_count = MaxNodeEntries + 1 - half;
+    std::copy( entries + half, entries + MaxNodeEntries + 1, sibling->m_entries );
+
+    return sibling;
+}
+
+
+bool INDEX::remove( TREE_NODE* aNode, const TREE_BOX* aBox, ITEM* aItem )
+{
+    for( int i = 0; i < aNode->m_count; i++ )
+    {
+        TREE_ENTRY& entry = aNode->m_entries[i];
+        bool removeEntry = false;
+
+        if( aNode->m_leaf )
+        {
+            if( entry.m_item != aItem )
+                continue;
+
+            removeEntry = true;
+        }
+        else
+        {
+            if( aBox && !entry.m_box.Contains( *aBox ) )
+                continue;
+
+            if( !remove( entry.m_child, aBox, aItem ) )
+                continue;
+
+            // underfull nodes are kept, only the empty ones are dropped
+            if( entry.m_child->m_count == 0 )
+            {
+                delete entry.m_child;
+                removeEntry = true;
+            }
+            else
+            {
+                entry = nodeEntry( entry.m_child );
+            }
+        }
+
+        if( removeEntry )
+            aNode->m_entries[i] = aNode->m_entries[--aNode->m_count];
+
+        return true;
+    }
+
+    return false;
+}
+
+
+void INDEX::freeTree( TREE_NODE* aNode )
+{
+    if( !aNode->m_leaf )
+    {
+        for( int i = 0; i < aNode->m_count; i++ )
+            freeTree( aNode->m_entries[i].m_child );
+    }
+
+    delete aNode;
+}
+
+}
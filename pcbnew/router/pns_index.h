@@ -22,13 +22,13 @@
 #ifndef __PNS_INDEX_H
 #define __PNS_INDEX_H
 
-#include <layers_id_colors_and_visibility.h>
 #include <map>
+#include <vector>
+#include <cstdint>
 
-#include <boost/range/adaptor/map.hpp>
+#include <boost/unordered_set.hpp>
 
-#include <list>
-#include <geometry/shape_index.h>
+#include <geometry/shape.h>
 
 #include "pns_item.h"
 
@@ -38,15 +38,17 @@ namespace PNS {
 /**
  * Class INDEX
  *
- * Custom spatial index, holding our board items and allowing for very fast searches. Items
- * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
- * overlap and improving search time.
+ * Custom spatial index, holding our board items and allowing for very fast searches. All the
+ * items are stored in a single R-Tree, whose entries carry the layers spanned by the items
+ * below them: a search skips the subtrees on other layers, and finds the items colliding with
+ * a multilayer item (e.g. a through-hole via) in a single descent. The items added to an
+ * almost empty index (e.g. the whole board, when syncing the world) are bulk loaded at the
+ * next search, which gives a better packed tree than inserting them one by one.
  **/
 class INDEX
 {
 public:
-    typedef std::list<ITEM*>            NET_ITEMS_LIST;
-    typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
+    typedef std::vector<ITEM*>          NET_ITEMS_LIST;
     typedef boost::unordered_set<ITEM*> ITEM_SET;
 
     INDEX();
@@ -140,149 +142,127 @@ public:
     ITEM_SET::iterator end() { return m_allItems.end(); }
 
 private:
-    static const int    MaxSubIndices   = 128;
-    static const int    SI_Multilayer   = 2;
-    static const int    SI_SegDiagonal  = 0;
-    static const int    SI_SegStraight  = 1;
-    static const int    SI_Traces       = 3;
-    static const int    SI_PadsTop      = 0;
-    static const int    SI_PadsBottom   = 1;
+    ///> one bit per layer
+    typedef uint64_t LAYER_MASK;
 
-    template <class Visitor>
-    int querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor );
-
-    ITEM_SHAPE_INDEX* getSubindex( const ITEM* aItem );
+    ///> maximum number of entries in a tree node
+    static const int MaxNodeEntries = 16;
 
-    ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
-    std::map<int, NET_ITEMS_LIST> m_netMap;
-    ITEM_SET m_allItems;
-};
+    struct TREE_NODE;
 
-INDEX::INDEX()
-{
-    memset( m_subIndices, 0, sizeof( m_subIndices ) );
-}
+    struct TREE_BOX
+    {
+        int m_x0, m_y0, m_x1, m_y1;
 
-INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
-{
-    int idx_n = -1;
+        bool Intersects( const TREE_BOX& aB ) const
+        {
+            return m_x0 <= aB.m_x1 && aB.m_x0 <= m_x1 && m_y0 <= aB.m_y1 && aB.m_y0 <= m_y1;
+        }
 
-    const LAYER_RANGE l = aItem->Layers();
+        bool Contains( const TREE_BOX& aB ) const
+        {
+            return m_x0 <= aB.m_x0 && aB.m_x1 <= m_x1 && m_y0 <= aB.m_y0 && aB.m_y1 <= m_y1;
+        }
 
-    switch( aItem->Kind() )
-    {
-    case ITEM::VIA_T:
-        idx_n = SI_Multilayer;
-        break;
+        void Merge( const TREE_BOX& aB );
 
-    case ITEM::SOLID_T:
+        double Area() const
         {
-            if( l.IsMultilayer() )
-                idx_n = SI_Multilayer;
-            else if( l.Start() == B_Cu ) // fixme: use kicad layer codes
-                idx_n = SI_PadsTop;
-            else if( l.Start() == F_Cu )
-                idx_n = SI_PadsBottom;
+            return double( m_x1 - m_x0 ) * double( m_y1 - m_y0 );
         }
-        break;
-
-    case ITEM::SEGMENT_T:
-    case ITEM::LINE_T:
-        idx_n = SI_Traces + 2 * l.Start() + SI_SegStraight;
-        break;
 
-    default:
-        break;
-    }
+        ///> twice the center coordinate along axis aAxis (0: x, 1: y)
+        long long Center2( int aAxis ) const
+        {
+            return aAxis ? (long long) m_y0 + m_y1 : (long long) m_x0 + m_x1;
+        }
+    };
 
-    if( idx_n < 0 || idx_n >= MaxSubIndices )
+    ///> a child node (in the internal nodes) or an item (in the leaves), with its
+    ///> bounding box and layers
+    struct TREE_ENTRY
     {
-        assert( false );
-        return nullptr;
-    }
+        TREE_BOX    m_box;
+        LAYER_MASK  m_layers;
+        TREE_NODE*  m_child;
+        ITEM*       m_item;
+    };
 
-    if( !m_subIndices[idx_n] )
-        m_subIndices[idx_n] = new ITEM_SHAPE_INDEX;
+    struct TREE_NODE
+    {
+        bool        m_leaf;
+        int         m_count;
+        TREE_ENTRY  m_entries[MaxNodeEntries];
+    };
 
-    return m_subIndices[idx_n];
-}
+    static LAYER_MASK layerMask( const LAYER_RANGE& aLayers );
+    static TREE_BOX shapeBox( const SHAPE* aShape, int aMinDistance );
+    static TREE_ENTRY itemEntry( ITEM* aItem );
+    static TREE_ENTRY nodeEntry( TREE_NODE* aNode );
 
-void INDEX::Add( ITEM* aItem )
-{
-    ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
+    ///> puts the pending items in the tree
+    void flush();
+    void bulkLoad();
+    void insertItem( ITEM* aItem );
 
-    if( !idx )
-        return;
+    ///> inserts an entry below aNode, and returns the new sibling of aNode if it was split
+    TREE_NODE* insert( TREE_NODE* aNode, const TREE_ENTRY& aEntry );
 
-    idx->Add( aItem );
-    m_allItems.insert( aItem );
-    int net = aItem->Net();
+    ///> adds an entry to aNode, and returns the new sibling of aNode if it was split
+    TREE_NODE* addEntry( TREE_NODE* aNode, const TREE_ENTRY& aEntry );
 
-    if( net >= 0 )
-    {
-        m_netMap[net].push_back( aItem );
-    }
-}
+    ///> removes an item from the subtree of aNode, looking only in the nodes
+    ///> containing aBox, or everywhere if aBox is NULL
+    bool remove( TREE_NODE* aNode, const TREE_BOX* aBox, ITEM* aItem );
+    void freeTree( TREE_NODE* aNode );
 
-void INDEX::Remove( ITEM* aItem )
-{
-    ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
+    template <class Visitor>
+    bool search( const TREE_NODE* aNode, const TREE_BOX& aBox, LAYER_MASK aLayers,
+                 Visitor& aVisitor, int& aCount );
 
-    if( !idx )
-        return;
+    TREE_NODE* m_tree;
+    std::vector<ITEM*> m_pending;   ///< items added, not in the tree yet, in order
+    ITEM_SET m_pendingSet;          ///< the items of m_pending not removed since
+    std::map<int, NET_ITEMS_LIST> m_netMap;
+    ITEM_SET m_allItems;
+};
 
-    idx->Remove( aItem );
-    m_allItems.erase( aItem );
-    int net = aItem->Net();
+template <class Visitor>
+bool INDEX::search( const TREE_NODE* aNode, const TREE_BOX& aBox, LAYER_MASK aLayers,
+                    Visitor& aVisitor, int& aCount )
+{
+    for( int i = 0; i < aNode->m_count; i++ )
+    {
+        const TREE_ENTRY& entry = aNode->m_entries[i];
 
-    if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
-}
+        if( !( entry.m_layers & aLayers ) || !entry.m_box.Intersects( aBox ) )
+            continue;
 
-void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
-{
-    Remove( aOldItem );
-    Add( aNewItem );
-}
+        if( !aNode->m_leaf )
+        {
+            if( !search( entry.m_child, aBox, aLayers, aVisitor, aCount ) )
+                return false;
+        }
+        else
+        {
+            if( !aVisitor( entry.m_item ) )
+                return false;
 
-template<class Visitor>
-int INDEX::querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor )
-{
-    if( !m_subIndices[index] )
-        return 0;
+            aCount++;
+        }
+    }
 
-    return m_subIndices[index]->Query( aShape, aMinDistance, aVisitor, false );
+    return true;
 }
 
 template<class Visitor>
 int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor )
 {
-    const SHAPE* shape = aItem->Shape();
     int total = 0;
 
-    total += querySingle( SI_Multilayer, shape, aMinDistance, aVisitor );
-
-    const LAYER_RANGE layers = aItem->Layers();
-
-    if( layers.IsMultilayer() )
-    {
-        total += querySingle( SI_PadsTop, shape, aMinDistance, aVisitor );
-        total += querySingle( SI_PadsBottom, shape, aMinDistance, aVisitor );
-
-        for( int i = layers.Start(); i <= layers.End(); ++i )
-            total += querySingle( SI_Traces + 2 * i + SI_SegStraight, shape, aMinDistance, aVisitor );
-    }
-    else
-    {
-        int l = layers.Start();
-
-        if( l == B_Cu )
-            total += querySingle( SI_PadsTop, shape, aMinDistance, aVisitor );
-        else if( l == F_Cu )
-            total += querySingle( SI_PadsBottom, shape, aMinDistance, aVisitor );
-
-        total += querySingle(  SI_Traces + 2 * l + SI_SegStraight, shape, aMinDistance, aVisitor );
-    }
+    flush();
+    search( m_tree, shapeBox( aItem->Shape(), aMinDistance ), layerMask( aItem->Layers() ),
+            aVisitor, total );
 
     return total;
 }
@@ -292,38 +272,12 @@ int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor )
 {
     int total = 0;
 
-    for( int i = 0; i < MaxSubIndices; i++ )
-        total += querySingle( i, aShape, aMinDistance, aVisitor );
+    flush();
+    search( m_tree, shapeBox( aShape, aMinDistance ), ~LAYER_MASK( 0 ), aVisitor, total );
 
     return total;
 }
 
-void INDEX::Clear()
-{
-    for( int i = 0; i < MaxSubIndices; ++i )
-    {
-        ITEM_SHAPE_INDEX* idx = m_subIndices[i];
-
-        if( idx )
-            delete idx;
-
-        m_subIndices[i] = NULL;
-    }
-}
-
-INDEX::~INDEX()
-{
-    Clear();
-}
-
-INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
-{
-    if( m_netMap.find( aNet ) == m_netMap.end() )
-        return NULL;
-
-    return &m_netMap[aNet];
-}
-
 }
 
 #endif
@@ -421,6 +421,9 @@ public:
 
     void AddLine( const SHAPE_LINE_CHAIN& aLine, int aType, int aWidth ) override
     {
+        if( !m_view )
+            return;
+
         ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( NULL, m_view );
 
         pitem->Line( aLine, aWidth, aType );
@@ -809,6 +812,9 @@ void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
 
 void PNS_KICAD_IFACE::EraseView()
 {
+    if( !m_view )
+        return;
+
     for( auto item : m_hiddenItems )
         m_view->SetVisible( item, true );
 
@@ -829,6 +835,9 @@ void PNS_KICAD_IFACE::DisplayItem( const PNS::ITEM* aItem, int aColor, int aClea
 {
     wxLogTrace( "PNS", "DisplayItem %p", aItem );
 
+    if( !m_view )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( aItem, m_view );
 
     if( aColor >= 0 )
@@ -857,7 +866,7 @@ void PNS_KICAD_IFACE::HideItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_view )
     {
         if( m_view->IsVisible( parent ) )
             m_hiddenItems.insert( parent );
@@ -872,7 +881,7 @@ void PNS_KICAD_IFACE::RemoveItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_commit )
     {
         m_commit->Remove( parent );
     }
@@ -883,6 +892,10 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* newBI = NULL;
 
+    // Without a host frame (router benchmark), the board is not modified
+    if( !m_commit )
+        return;
+
     switch( aItem->Kind() )
     {
     case PNS::ITEM::SEGMENT_T:
@@ -931,6 +944,10 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 void PNS_KICAD_IFACE::Commit()
 {
     EraseView();
+
+    if( !m_commit )
+        return;
+
     m_commit->Push( wxT( "Added a track" ) );
     m_commit.reset( new BOARD_COMMIT( m_frame ) );
 }
@@ -947,9 +964,15 @@ void PNS_KICAD_IFACE::SetView( KIGFX::VIEW* aView )
     }
 
     m_view = aView;
-    m_previewItems = new KIGFX::VIEW_GROUP( m_view );
-    m_previewItems->SetLayer( LAYER_GP_OVERLAY ) ;
-    m_view->Add( m_previewItems );
+    m_previewItems = nullptr;
+
+    // A NULL view is used to route without display (router benchmark)
+    if( m_view )
+    {
+        m_previewItems = new KIGFX::VIEW_GROUP( m_view );
+        m_previewItems->SetLayer( LAYER_GP_OVERLAY ) ;
+        m_view->Add( m_previewItems );
+    }
 
     delete m_debugDecorator;
     m_debugDecorator = new PNS_PCBNEW_DEBUG_DECORATOR();
@@ -26,6 +26,8 @@
 #include "pns_segment.h"
 #include "pns_solid.h"
 
+#include <fstream>
+
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_rect.h>
@@ -139,6 +141,86 @@ void LOGGER::Log( const VECTOR2I& aStart, const VECTOR2I& aEnd,
 }
 
 
+static const char* eventNames[LOGGER::EVT_LAST] =
+{
+    "start", "drag", "move", "fix", "stop", "layer", "via", "posture", "mode", "settings",
+    "sizes"
+};
+
+
+const char* LOGGER::EventName( EVENT_TYPE aType )
+{
+    return eventNames[aType];
+}
+
+
+void LOGGER::LogEvent( EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       const std::vector<int>& aParams )
+{
+    m_theLog << "event " << eventNames[aType] << " " << aP.x << " " << aP.y << " ";
+
+    if( aItem )
+        m_theLog << aItem->Kind() << " " << aItem->Net() << " " << aItem->Layers().Start() <<
+                    " " << aItem->Layers().End();
+    else
+        m_theLog << "0 0 0 0";
+
+    m_theLog << " " << aParams.size();
+
+    for( int param : aParams )
+        m_theLog << " " << param;
+
+    m_theLog << std::endl;
+}
+
+
+bool LOGGER::LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents )
+{
+    std::ifstream f( aFilename.c_str() );
+
+    if( !f )
+        return false;
+
+    std::string line;
+
+    while( std::getline( f, line ) )
+    {
+        std::istringstream tokens( line );
+        std::string keyword, name;
+        EVENT_ENTRY evt;
+        size_t paramCount;
+
+        if( !( tokens >> keyword ) || keyword != "event" )
+            continue;
+
+        if( !( tokens >> name >> evt.m_p.x >> evt.m_p.y >> evt.m_itemKind >> evt.m_itemNet
+                      >> evt.m_itemLayerStart >> evt.m_itemLayerEnd >> paramCount ) )
+            return false;
+
+        int type = 0;
+
+        while( type < EVT_LAST && name != eventNames[type] )
+            type++;
+
+        if( type == EVT_LAST )
+            return false;
+
+        evt.m_type = (EVENT_TYPE) type;
+        evt.m_params.resize( paramCount );
+
+        for( int& param : evt.m_params )
+        {
+            if( !( tokens >> param ) )
+                return false;
+        }
+
+        aEvents.push_back( evt );
+    }
+
+    return true;
+}
+
+
 void LOGGER::dumpShape( const SHAPE* aSh )
 {
     switch( aSh->Type() )
@@ -39,6 +39,36 @@ class ITEM;
 class LOGGER
 {
 public:
+    ///> Router operations recorded in a session log, to be replayed by a benchmark
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_MOVE,
+        EVT_FIX,
+        EVT_STOP,
+        EVT_SWITCH_LAYER,
+        EVT_TOGGLE_VIA,
+        EVT_FLIP_POSTURE,
+        EVT_SET_MODE,
+        EVT_SETTINGS,
+        EVT_SIZES,
+        EVT_LAST
+    };
+
+    ///> A recorded router operation.  The item is identified by its kind, net and layers,
+    ///> so it can be found again at the event position in a replayed world.
+    struct EVENT_ENTRY
+    {
+        EVENT_TYPE          m_type;
+        VECTOR2I            m_p;
+        int                 m_itemKind;     ///< 0 if there is no item
+        int                 m_itemNet;
+        int                 m_itemLayerStart;
+        int                 m_itemLayerEnd;
+        std::vector<int>    m_params;
+    };
+
     LOGGER();
     ~LOGGER();
 
@@ -53,6 +83,23 @@ public:
     void Log( const VECTOR2I& aStart, const VECTOR2I& aEnd, int aKind = 0,
               const std::string aName = std::string() );
 
+    /**
+     * Function LogEvent
+     * records a router operation, as an "event" line of the log.
+     * @param aParams = the operation parameters (layer, mode, sizes...)
+     */
+    void LogEvent( EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem = nullptr,
+                   const std::vector<int>& aParams = std::vector<int>() );
+
+    /**
+     * Function LoadEvents
+     * reads the router operations recorded in a saved log.  The other lines are ignored.
+     * @return false if the file cannot be read or has a malformed event.
+     */
+    static bool LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents );
+
+    static const char* EventName( EVENT_TYPE aType );
+
 private:
     void dumpShape( const SHAPE* aSh );
 
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <cassert>
+#include <algorithm>
 
 #include <math/vector2d.h>
 
@@ -47,6 +48,10 @@ namespace PNS {
 static boost::unordered_set<NODE*> allocNodes;
 #endif
 
+// Branch statistics, reported by the router benchmark
+static unsigned long long branchCount = 0;
+static unsigned long long branchCopiedJoints = 0;
+
 NODE::NODE()
 {
     wxLogTrace( "PNS", "NODE::create %p", this );
@@ -56,6 +61,7 @@ NODE::NODE()
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
     m_index = new INDEX;
+    m_ancestors.push_back( this );
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -92,6 +98,18 @@ NODE::~NODE()
     }
 
     releaseGarbage();
+
+    for( ITEM* item : m_override )
+    {
+        auto f = m_root->m_overridingNodes.find( item );
+        std::vector<NODE*>& nodes = f->second;
+
+        nodes.erase( std::find( nodes.begin(), nodes.end(), this ) );
+
+        if( nodes.empty() )
+            m_root->m_overridingNodes.erase( f );
+    }
+
     unlinkParent();
 
     delete m_index;
@@ -113,30 +131,53 @@ NODE* NODE::Branch()
     wxLogTrace( "PNS", "NODE::branch %p (parent %p)", child, this );
 
     m_children.insert( child );
+    branchCount++;
 
     child->m_depth = m_depth + 1;
     child->m_parent = this;
     child->m_ruleResolver = m_ruleResolver;
     child->m_root = isRoot() ? this : m_root;
+    child->m_ancestors = m_ancestors;
+    child->m_ancestors.push_back( child );
 
-    // immmediate offspring of the root branch needs not copy anything.
-    // For the rest, deep-copy joints, overridden item map and pointers
-    // to stored items.
-    if( !isRoot() )
-    {
-        JOINT_MAP::iterator j;
+    // nothing else is copied: the child finds the items and joints of its
+    // parents in the parents, and copies a joint only when modifying it.
+    wxLogTrace( "PNS", "depth %d, %d items, %d joints, %d overrides in the parent", child->m_depth,
+            m_index->Size(), (int) m_joints.size(), (int) m_override.size() );
 
-        for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-            child->m_index->Add( *i );
+    return child;
+}
 
-        child->m_joints = m_joints;
-        child->m_override = m_override;
-    }
 
-    wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+unsigned long long NODE::BranchCount()
+{
+    return branchCount;
+}
 
-    return child;
+
+unsigned long long NODE::BranchCopiedJoints()
+{
+    return branchCopiedJoints;
+}
+
+
+bool NODE::Overrides( ITEM* aItem ) const
+{
+    if( isRoot() || aItem->Owner() == this )
+        return false;
+
+    auto f = m_root->m_overridingNodes.find( aItem );
+
+    if( f == m_root->m_overridingNodes.end() )
+        return false;
+
+    for( const NODE* node : f->second )
+    {
+        if( node->isAncestorOf( this ) )
+            return true;
+    }
+
+    return false;
 }
 
 
@@ -264,11 +305,11 @@ int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
     aVisitor.SetWorld( this, NULL );
     m_index->Query( aItem, m_maxClearance, aVisitor );
 
-    // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() )
+    // look in the parent branches as well.
+    for( NODE* node = m_parent; node; node = node->m_parent )
     {
-        aVisitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, aVisitor );
+        aVisitor.SetWorld( node, this );
+        node->m_index->Query( aItem, m_maxClearance, aVisitor );
     }
 
     return 0;
@@ -290,11 +331,14 @@ int NODE::QueryColliding( const ITEM* aItem,
     // first, look for colliding items in the local index
     m_index->Query( aItem, m_maxClearance, visitor );
 
-    // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() && ( visitor.m_matchCount < aLimitCount || aLimitCount < 0 ) )
+    // if we haven't found enough items, look in the parent branches as well.
+    for( NODE* node = m_parent; node; node = node->m_parent )
     {
-        visitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, visitor );
+        if( visitor.m_matchCount >= aLimitCount && aLimitCount >= 0 )
+            break;
+
+        visitor.SetWorld( node, this );
+        node->m_index->Query( aItem, m_maxClearance, visitor );
     }
 
     return aObstacles.size();
@@ -514,14 +558,14 @@ const ITEM_SET NODE::HitTest( const VECTOR2I& aPoint ) const
 
     m_index->Query( &s, m_maxClearance, visitor );
 
-    if( !isRoot() )    // fixme: could be made cleaner
+    for( const NODE* node = m_parent; node; node = node->m_parent )    // fixme: could be made cleaner
     {
-        ITEM_SET items_root;
-        visitor.SetWorld( m_root, NULL );
-        HIT_VISITOR  visitor_root( items_root, aPoint );
-        m_root->m_index->Query( &s, m_maxClearance, visitor_root );
+        ITEM_SET items_parent;
+        HIT_VISITOR  visitor_parent( items_parent, aPoint );
+        visitor_parent.SetWorld( node, NULL );
+        node->m_index->Query( &s, m_maxClearance, visitor_parent );
 
-        for( ITEM* item : items_root.Items() )
+        for( ITEM* item : items_parent.Items() )
         {
             if( !Overrides( item ) )
                 items.Add( item );
@@ -636,22 +680,21 @@ void NODE::Add( std::unique_ptr< ITEM > aItem, bool aAllowRedundant )
 
 void NODE::doRemove( ITEM* aItem )
 {
-    // case 1: removing an item that is stored in the root node from any branch:
-    // mark it as overridden, but do not remove
-    if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
-
-    // case 2: the item belongs to this branch or a parent, non-root branch,
-    // or the root itself and we are the root: remove from the index
-    else if( !aItem->BelongsTo( m_root ) || isRoot() )
-        m_index->Remove( aItem );
-
-    // the item belongs to this particular branch: un-reference it
+    // case 1: the item belongs to this particular branch (or we are the root):
+    // remove it from the index and un-reference it
     if( aItem->BelongsTo( this ) )
     {
+        m_index->Remove( aItem );
         aItem->SetOwner( NULL );
         m_root->m_garbageItems.insert( aItem );
     }
+
+    // case 2: removing an item that is stored in a parent node from a branch:
+    // mark it as overridden, but do not remove, as the parent still uses it
+    else if( !isRoot() && m_override.insert( aItem ).second )
+    {
+        m_root->m_overridingNodes[aItem].push_back( this );
+    }
 }
 
 
@@ -672,8 +715,9 @@ void NODE::removeViaIndex( VIA* aVia )
     LAYER_RANGE vLayers( aVia->Layers() );
     int net = aVia->Net();
 
-    JOINT* jt = FindJoint( p, vLayers.Start(), net );
-    JOINT::LINKED_ITEMS links( jt->LinkList() );
+    // get a local copy of the via joint, so it can be erased below
+    JOINT& jt = touchJoint( p, vLayers, net );
+    JOINT::LINKED_ITEMS links( jt.LinkList() );
 
     tag.net = net;
     tag.pos = p;
@@ -972,23 +1016,29 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
-
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
+    JOINT_MAP* joints = findJoints( tag );
 
-    if( f == end )
+    if( !joints )
         return NULL;
 
-    while( f != end )
+    std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = joints->equal_range( tag );
+
+    for( JOINT_MAP::iterator f = range.first; f != range.second; ++f )
     {
         if( f->second.Layers().Overlaps( aLayer ) )
             return &f->second;
+    }
 
-        ++f;
+    return NULL;
+}
+
+
+NODE::JOINT_MAP* NODE::findJoints( const JOINT::HASH_TAG& aTag )
+{
+    for( NODE* node = this; node; node = node->m_parent )
+    {
+        if( node->m_joints.find( aTag ) != node->m_joints.end() )
+            return &node->m_joints;
     }
 
     return NULL;
@@ -1014,13 +1064,19 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
 
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    // not found and we are not root? find in the parents and copy results here.
+    JOINT_MAP* parentJoints = ( f == m_joints.end() && !isRoot() ) ? m_parent->findJoints( tag )
+                                                                     : NULL;
+
+    if( parentJoints )
     {
-        range = m_root->m_joints.equal_range( tag );
+        range = parentJoints->equal_range( tag );
 
         for( f = range.first; f != range.second; ++f )
+        {
             m_joints.insert( *f );
+            branchCopiedJoints++;
+        }
     }
 
     // now insert and combine overlapping joints
@@ -1162,17 +1218,35 @@ void NODE::Dump( bool aLong )
 
 void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
 {
-    aRemoved.reserve( m_override.size() );
-    aAdded.reserve( m_index->Size() );
-
     if( isRoot() )
         return;
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
+    for( NODE* node = this; node != m_root; node = node->m_parent )
+    {
+        for( ITEM* item : node->m_override )
+        {
+            if( item->BelongsTo( m_root ) )
+                aRemoved.push_back( item );
+        }
+    }
 
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-        aAdded.push_back( *i );
+    getBranchItems( aAdded );
+}
+
+
+void NODE::getBranchItems( ITEM_VECTOR& aItems )
+{
+    for( NODE* node = this; node; node = node->m_parent )
+    {
+        if( node == m_root && !isRoot() )
+            break;
+
+        for( INDEX::ITEM_SET::iterator i = node->m_index->begin(); i != node->m_index->end(); ++i )
+        {
+            if( node == this || !Overrides( *i ) )
+                aItems.push_back( *i );
+        }
+    }
 }
 
 void NODE::releaseChildren()
@@ -1208,15 +1282,18 @@ void NODE::Commit( NODE* aNode )
     if( aNode->isRoot() )
         return;
 
-    for( ITEM* item : aNode->m_override )
-    Remove( item );
+    ITEM_VECTOR removed, added;
+
+    aNode->GetUpdatedItems( removed, added );
 
-    for( INDEX::ITEM_SET::iterator i = aNode->m_index->begin();
-         i != aNode->m_index->end(); ++i )
+    for( ITEM* item : removed )
+        Remove( item );
+
+    for( ITEM* item : added )
     {
-        (*i)->SetRank( -1 );
-        (*i)->Unmark();
-        Add( std::unique_ptr<ITEM>( *i ) );
+        item->SetRank( -1 );
+        item->Unmark();
+        Add( std::unique_ptr<ITEM>( item ) );
     }
 
     releaseChildren();
@@ -1241,12 +1318,12 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
             aItems.insert( item );
     }
 
-    if( !isRoot() )
+    for( NODE* node = m_parent; node; node = node->m_parent )
     {
-        INDEX::NET_ITEMS_LIST* l_root = m_root->m_index->GetItemsForNet( aNet );
+        INDEX::NET_ITEMS_LIST* l_parent = node->m_index->GetItemsForNet( aNet );
 
-        if( l_root )
-            for( INDEX::NET_ITEMS_LIST::iterator i = l_root->begin(); i!= l_root->end(); ++i )
+        if( l_parent )
+            for( INDEX::NET_ITEMS_LIST::iterator i = l_parent->begin(); i!= l_parent->end(); ++i )
                 if( !Overrides( *i ) )
                     aItems.insert( *i );
     }
@@ -1255,20 +1332,28 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
 
 void NODE::ClearRanks( int aMarkerMask )
 {
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
+    ITEM_VECTOR items;
+
+    getBranchItems( items );
+
+    for( ITEM* item : items )
     {
-        (*i)->SetRank( -1 );
-        (*i)->Mark( (*i)->Marker() & (~aMarkerMask) );
+        item->SetRank( -1 );
+        item->Mark( item->Marker() & (~aMarkerMask) );
     }
 }
 
 
 int NODE::FindByMarker( int aMarker, ITEM_SET& aItems )
 {
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
+    ITEM_VECTOR items;
+
+    getBranchItems( items );
+
+    for( ITEM* item : items )
     {
-        if( (*i)->Marker() & aMarker )
-            aItems.Add( *i );
+        if( item->Marker() & aMarker )
+            aItems.Add( item );
     }
 
     return 0;
@@ -1278,12 +1363,15 @@ int NODE::FindByMarker( int aMarker, ITEM_SET& aItems )
 int NODE::RemoveByMarker( int aMarker )
 {
     std::list<ITEM*> garbage;
+    ITEM_VECTOR items;
 
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
+    getBranchItems( items );
+
+    for( ITEM* item : items )
     {
-        if( (*i)->Marker() & aMarker )
+        if( item->Marker() & aMarker )
         {
-            garbage.push_back( *i );
+            garbage.push_back( item );
         }
     }
 
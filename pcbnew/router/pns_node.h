@@ -170,7 +170,7 @@ public:
         return m_ruleResolver;
     }
 
-    ///> Returns the number of joints
+    ///> Returns the number of joints stored in this node
     int JointCount() const
     {
         return m_joints.size();
@@ -317,12 +317,22 @@ public:
      * Function Branch()
      *
      * Creates a lightweight copy (called branch) of self that tracks
-     * the changes (added/removed items) wrs to the root. Note that if there are
-     * any branches in use, their parents must NOT be deleted.
+     * the changes (added/removed items) wrs to its parent. Nothing is copied:
+     * the branch stores only the items it adds, the items of its parents
+     * it removes and the joints it modifies, and looks up the rest in its
+     * parents. Note that if there are any branches in use, their parents must
+     * NOT be deleted, and the non-root parents must not be modified, as the
+     * branches would see the changes.
      * @return the new branch
      */
     NODE* Branch();
 
+    ///> Number of branches created since the start of the program
+    static unsigned long long BranchCount();
+
+    ///> Number of joints copied from the parent nodes into the branches that modify them
+    static unsigned long long BranchCopiedJoints();
+
     /**
      * Function AssembleLine()
      *
@@ -411,12 +421,9 @@ public:
         return !m_children.empty();
     }
 
-    ///> checks if this branch contains an updated version of the m_item
-    ///> from the root branch.
-    bool Overrides( ITEM* aItem ) const
-    {
-        return m_override.find( aItem ) != m_override.end();
-    }
+    ///> checks if this branch (or one of its parents) contains an updated version
+    ///> of the m_item from a parent branch.
+    bool Overrides( ITEM* aItem ) const;
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
@@ -427,6 +434,10 @@ private:
     NODE( const NODE& aB );
     NODE& operator=( const NODE& aB );
 
+    ///> finds the joints at a given position and net, in this node or in the nearest
+    ///> parent node having some
+    JOINT_MAP* findJoints( const JOINT::HASH_TAG& aTag );
+
     ///> tries to find matching joint and creates a new one if not found
     JOINT& touchJoint( const VECTOR2I&     aPos,
                        const LAYER_RANGE&  aLayers,
@@ -458,6 +469,16 @@ private:
         return m_parent == NULL;
     }
 
+    ///> checks if aNode is this node or one of its branches (at any depth)
+    bool isAncestorOf( const NODE* aNode ) const
+    {
+        return aNode->m_depth >= m_depth && aNode->m_ancestors[m_depth] == this;
+    }
+
+    ///> returns the items added in this branch and in its non-root parents and
+    ///> still present in this branch, or all the items of the root node
+    void getBranchItems( ITEM_VECTOR& aItems );
+
     SEGMENT* findRedundantSegment( const VECTOR2I& A, const VECTOR2I& B,
                                    const LAYER_RANGE & lr, int aNet );
     SEGMENT* findRedundantSegment( SEGMENT* aSeg );
@@ -472,8 +493,8 @@ private:
                      bool&       aGuardHit,
                      bool        aStopAtLockedJoints );
 
-    ///> hash table with the joints, linking the items. Joints are hashed by
-    ///> their position, layer set and net.
+    ///> hash table with the joints modified in this node, linking the items.
+    ///> Joints are hashed by their position, layer set and net.
     JOINT_MAP m_joints;
 
     ///> node this node was branched from
@@ -485,16 +506,23 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
+    ///> nodes of the inheritance chain, by depth, from the root to this node
+    std::vector<NODE*> m_ancestors;
+
+    ///> hash of parents' items that have been changed in this node
     boost::unordered_set<ITEM*> m_override;
 
+    ///> (root only) the branches overriding each item, so checking if a branch
+    ///> overrides an item does not walk its parents
+    boost::unordered_map<ITEM*, std::vector<NODE*> > m_overridingNodes;
+
     ///> worst case item-item clearance
     int m_maxClearance;
 
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
+    ///> Geometric/Net index of the items added in this node
     INDEX* m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
@@ -136,6 +136,9 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem )
     if( !aStartItem || aStartItem->OfKind( ITEM::SOLID_T ) )
         return false;
 
+    logSettings();
+    logEvent( LOGGER::EVT_START_DRAG, aP, aStartItem );
+
     m_dragger.reset( new DRAGGER( this ) );
     m_dragger->SetWorld( m_world.get() );
     m_dragger->SetDebugDecorator ( m_iface->GetDebugDecorator () );
@@ -155,6 +158,9 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem )
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    logSettings();
+    logEvent( LOGGER::EVT_START_ROUTE, aP, aStartItem, { aLayer } );
+
     switch( m_mode )
     {
         case PNS_MODE_ROUTE_SINGLE:
@@ -201,6 +207,8 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    logEvent( LOGGER::EVT_MOVE, aP, endItem );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -289,6 +297,8 @@ void ROUTER::UpdateSizes( const SIZES_SETTINGS& aSizes )
     // Change track/via size settings
     if( m_state == ROUTE_TRACK)
     {
+        logSettings();
+
         m_placer->UpdateSizes( m_sizes );
     }
 }
@@ -342,6 +352,8 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem )
 {
     bool rv = false;
 
+    logEvent( LOGGER::EVT_FIX, aP, aEndItem );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -380,6 +392,11 @@ void ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    logEvent( LOGGER::EVT_STOP, m_currentEnd );
+
+    if( m_sessionLog )
+        m_sessionLog->Save( m_sessionLogFile );
+
     m_placer.reset();
     m_dragger.reset();
 
@@ -395,6 +412,7 @@ void ROUTER::FlipPosture()
 {
     if( m_state == ROUTE_TRACK )
     {
+        logEvent( LOGGER::EVT_FLIP_POSTURE, m_currentEnd );
         m_placer->FlipPosture();
     }
 }
@@ -405,6 +423,7 @@ void ROUTER::SwitchLayer( int aLayer )
     switch( m_state )
     {
     case ROUTE_TRACK:
+        logEvent( LOGGER::EVT_SWITCH_LAYER, m_currentEnd, nullptr, { aLayer } );
         m_placer->SetLayer( aLayer );
         break;
     default:
@@ -417,6 +436,7 @@ void ROUTER::ToggleViaPlacement()
 {
     if( m_state == ROUTE_TRACK )
     {
+        logEvent( LOGGER::EVT_TOGGLE_VIA, m_currentEnd );
         bool toggle = !m_placer->IsPlacingVia();
         m_placer->ToggleVia( toggle );
     }
@@ -483,10 +503,49 @@ void ROUTER::SetOrthoMode( bool aEnable )
 
 void ROUTER::SetMode( ROUTER_MODE aMode )
 {
+    logEvent( LOGGER::EVT_SET_MODE, m_currentEnd, nullptr, { aMode } );
     m_mode = aMode;
 }
 
 
+void ROUTER::SetSessionLog( const std::string& aFilename )
+{
+    m_sessionLogFile = aFilename;
+
+    if( aFilename.empty() )
+        m_sessionLog.reset();
+    else if( !m_sessionLog )
+        m_sessionLog.reset( new LOGGER );
+}
+
+
+void ROUTER::logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       const std::vector<int>& aParams )
+{
+    if( m_sessionLog )
+        m_sessionLog->LogEvent( aType, aP, aItem, aParams );
+}
+
+
+void ROUTER::logSettings()
+{
+    if( !m_sessionLog )
+        return;
+
+    logEvent( LOGGER::EVT_SETTINGS, m_currentEnd, nullptr,
+              { m_settings.Mode(), m_settings.OptimizerEffort() } );
+
+    // The layer pair is recorded only if there is one
+    bool hasLayerPair = m_sizes.PairedLayer( m_sizes.GetLayerTop() ).is_initialized();
+
+    logEvent( LOGGER::EVT_SIZES, m_currentEnd, nullptr,
+              { m_sizes.TrackWidth(), m_sizes.ViaDiameter(), m_sizes.ViaDrill(),
+                m_sizes.ViaType(), m_sizes.DiffPairWidth(), m_sizes.DiffPairGap(),
+                m_sizes.DiffPairViaGap(), m_sizes.DiffPairViaGapSameAsTraceGap(),
+                hasLayerPair, m_sizes.GetLayerTop(), m_sizes.GetLayerBottom() } );
+}
+
+
 void ROUTER::SetInterface( ROUTER_IFACE *aIface )
 {
     m_iface = aIface;
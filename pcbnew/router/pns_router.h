@@ -36,6 +36,7 @@
 #include "pns_itemset.h"
 #include "pns_node.h"
 #include "pns_placement_algo.h"
+#include "pns_logger.h"
 
 namespace KIGFX
 {
@@ -152,6 +153,13 @@ public:
 
     void DumpLog();
 
+    /**
+     * Records the routing operations in a session log, which is saved to aFilename each
+     * time a routing or dragging operation ends.  The log can be replayed by the router
+     * benchmark (qa/pns_perf).  An empty file name stops the recording.
+     */
+    void SetSessionLog( const std::string& aFilename );
+
     RULE_RESOLVER* GetRuleResolver() const
     {
         return m_iface->GetRuleResolver();
@@ -242,6 +250,10 @@ private:
 
     void markViolations( NODE* aNode, ITEM_SET& aCurrent, NODE::ITEM_VECTOR& aRemoved );
 
+    void logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem = nullptr,
+                   const std::vector<int>& aParams = std::vector<int>() );
+    void logSettings();
+
     VECTOR2I m_currentEnd;
     RouterState m_state;
 
@@ -265,6 +277,9 @@ private:
 
     wxString m_toolStatusbarName;
     wxString m_failureReason;
+
+    std::unique_ptr< LOGGER > m_sessionLog;
+    std::string               m_sessionLogFile;
 };
 
 }
@@ -118,6 +118,13 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
     m_router->LoadSettings( m_savedSettings );
     m_router->UpdateSizes( m_savedSizes );
 
+    // Record the routing session, to replay it with the router benchmark.
+    // The board must be saved before routing, as the replay starts from the saved board.
+    wxString sessionLog;
+
+    if( wxGetEnv( wxT( "KICAD_PNS_SESSION_LOG" ), &sessionLog ) && !sessionLog.IsEmpty() )
+        m_router->SetSessionLog( TO_UTF8( sessionLog ) );
+
     m_gridHelper = new GRID_HELPER( m_frame );
 }
 
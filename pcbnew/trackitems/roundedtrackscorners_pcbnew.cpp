@@ -92,7 +92,7 @@ void ROUNDED_TRACKS_CORNERS::Convert( const DLIST<TRACK>* aTracksAt, PICKED_ITEM
     if( tracks_convert )
     {
         tracks_convert->Execute();
-        m_EditFrame->Compile_Ratsnest( nullptr, false );
+        m_EditFrame->Update_Ratsnest( nullptr, false );
 
         if( created_undoredo_list && aUndoRedoList->GetCount() )
             m_EditFrame->SaveCopyInUndoList( *aUndoRedoList, UR_CHANGED );
@@ -314,6 +314,7 @@ TEARDROPS::MODULES_PROGRESS_ADD_TEARS::MODULES_PROGRESS_ADD_TEARS( const TEARDRO
     TEARDROPS_MODULES_PROGRESS( aParent, aModules, aUndoRedoList )
 {
     m_progress_title.Printf( _( "Adding Teardrops to Footprints" ) );
+    m_use_net_scan_index = true;
 }
 
 unsigned int TEARDROPS::MODULES_PROGRESS_ADD_TEARS::DoAtPad( const D_PAD* aPadAt )
@@ -422,6 +423,7 @@ TEARDROPS::TRACKS_PROGRESS_ADD_TEARS_VIAS::TRACKS_PROGRESS_ADD_TEARS_VIAS( const
     TEARDROPS_TRACKS_PROGRESS( aParent, aTracks, aUndoRedoList )
 {
     m_progress_title.Printf( _( "Adding Teardrops to Vias" ) );
+    m_use_net_scan_index = true;
 }
 
 unsigned int TEARDROPS::TRACKS_PROGRESS_ADD_TEARS_VIAS::ExecuteItem( const BOARD_ITEM* aItemAt )
@@ -93,13 +93,13 @@ bool TEARDROPS::DRC_ClearanceTest( const TEARDROP* aTear, const TRACK* aTrackSeg
                 //First poly point.
                 wxPoint segStartPoint = aTear->GetPolyPoint( 0 ) - track_start_pos;
                 RotatePoint( &segStartPoint, angle );
-                if( !m_EditFrame->GetDrcController()->checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
+                if( !DRC::checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
                     return false;
 
                 //Last poly point.
                 segStartPoint = aTear->GetPolyPoint( aTear->GetPolyPointsNum() - 1 ) - track_start_pos;
                 RotatePoint( &segStartPoint, angle );
-                if( !m_EditFrame->GetDrcController()->checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
+                if( !DRC::checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
                     return false;
 
                 break;
@@ -108,7 +108,7 @@ bool TEARDROPS::DRC_ClearanceTest( const TEARDROP* aTear, const TRACK* aTrackSeg
             {
                 wxPoint segStartPoint = aTear->GetPosition() - track_start_pos;
                 RotatePoint( &segStartPoint, angle );
-                if( !m_EditFrame->GetDrcController()->checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
+                if( !DRC::checkMarginToCircle( segStartPoint, aMinDist, delta.x ) )
                     return false;
             }
         }
@@ -587,6 +587,7 @@ TEARDROPS::MODULES_PROGRESS_MARK_WARNINGS::MODULES_PROGRESS_MARK_WARNINGS( const
     m_DRC = aDRC;
     aParent->GetBoard()->DeleteMARKERs();
     m_progress_title.Printf( _( "Searching Warnings of Teardrops of Footprints" ) );
+    m_use_net_scan_index = true;
 }
 
 TEARDROPS::MODULES_PROGRESS_MARK_WARNINGS::~MODULES_PROGRESS_MARK_WARNINGS()
@@ -755,6 +756,7 @@ TEARDROPS::TRACKS_PROGRESS_MARK_WARNINGS::TRACKS_PROGRESS_MARK_WARNINGS( const T
 {
     m_DRC = aDRC;
     m_type_todo = aTypeToDo;
+    m_use_net_scan_index = true;
     if( aTypeToDo != TEARDROPS::ALL_TYPES_T )
         aParent->GetBoard()->DeleteMARKERs();
     switch( aTypeToDo )
@@ -33,6 +33,12 @@
 #include "teardrops.h"
 #include "roundedtrackscorners.h"
 
+#include <unordered_map>
+#include <unordered_set>
+#include <geometry/rtree.h>
+
+class DRC_ITEM_INDEX;
+
 namespace TrackItems
 {
 
@@ -116,6 +122,33 @@ public:
                                const wxPoint aMarkerPos,
                                const int aErrorCode
                              );
+
+    //Online DRC. Places of items changed by BOARD_COMMIT push are collected, and after
+    //push teardrops, rounded corners and thermal vias near them are checked again against
+    //their neighbours only. Neighbours are found from an item index kept between pushes.
+    void DRC_OnlineClear( void );
+    void DRC_OnlineAdd( const BOARD_ITEM* aItem );
+    void DRC_OnlineRemove( const BOARD_ITEM* aItem );
+    void DRC_OnlineModify( const BOARD_ITEM* aItem, const BOARD_ITEM* aOldItem );
+    void DRC_OnlineDo( void );
+
+    //Online DRC item index follows tracks and footprints added to and removed from board,
+    //and items changed by commits.
+    void DRC_OnlineIndexAdd( const BOARD_ITEM* aItem );
+    void DRC_OnlineIndexRemove( const BOARD_ITEM* aItem );
+    //Board is modified. Index is dropped if changes were not pushed by a commit, and built
+    //again at next online DRC.
+    void DRC_OnlineBoardModified( void );
+
+private:
+    bool DRC_OnlineIsItemsError( const int aErrorCode ) const;
+    bool DRC_OnlineIsCheckItem( const TRACK* aTrack ) const;
+    void DRC_OnlineAddArea( const EDA_RECT& aArea );
+
+    DRC_ITEM_INDEX* m_drc_online_index{nullptr};
+    bool m_drc_online_pushed{false};
+    std::vector<EDA_RECT> m_drc_online_areas;
+    std::unordered_set<const BOARD_ITEM*> m_drc_online_removed;
 //---------------------------------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------------------------------
@@ -472,6 +505,72 @@ public:
 
 //---------------------------------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------------------------------
+// Speedup net scans with per net spatial index of m_Track items.
+//---------------------------------------------------------------------------------------------------
+private:
+
+    class NET_SCAN_INDEX
+    {
+    public:
+        NET_SCAN_INDEX( const BOARD* aBoard )
+        {
+            m_Board = aBoard;
+            m_enabled_count = 0;
+        }
+        ~NET_SCAN_INDEX();
+
+        //Index is in use only between Enable() and Disable(). Track items must not move
+        //meanwhile, only added and removed (BOARD::Add(), BOARD::Remove(), TracksDList_*()).
+        void Enable( void );
+        void Disable( void );
+        bool IsEnabled( void ) const { return m_enabled_count > 0; }
+
+        void Insert( const TRACK* aTrackItem );
+        void Remove( const TRACK* aTrackItem );
+
+        //Collect aNetCode items which bounding box contains aPos.
+        void Query( const int aNetCode, const wxPoint aPos, std::vector<TRACK*>& aResult );
+
+        //Pads of aNetCode collected once with one modules walk. Nullptr if not enabled.
+        const std::vector<D_PAD*>* GetPads( const int aNetCode );
+
+    private:
+        NET_SCAN_INDEX(){;}
+
+        using NET_RTREE = RTree<TRACK*, int, 2, double>;
+
+        struct ITEM_ENTRY
+        {
+            int netcode;
+            int min[2];
+            int max[2];
+        };
+
+        const BOARD* m_Board{nullptr};
+        unsigned int m_enabled_count{0};
+
+        std::vector<NET_RTREE*> m_net_trees;    //Built lazily, nullptr if not built.
+        std::unordered_map<const TRACK*, ITEM_ENTRY> m_items;
+
+        bool m_net_pads_collected{false};
+        std::vector<std::vector<D_PAD*>> m_net_pads;
+
+        NET_RTREE* GetNetTree( const int aNetCode );
+        void InsertItem( NET_RTREE* aNetTree, const TRACK* aTrackItem );
+        void Clear( void );
+    };
+
+    NET_SCAN_INDEX* m_NetScanIndex{nullptr};
+
+public:
+    NET_SCAN_INDEX* NetScanIndex( void ) const
+    {
+        return m_NetScanIndex;
+    }
+
+//---------------------------------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------------------------------
 // Sort tracks by netcode.
 //---------------------------------------------------------------------------------------------------
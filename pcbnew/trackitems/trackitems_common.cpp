@@ -25,6 +25,7 @@
 
 #include <class_marker_pcb.h>
 #include <view/view.h>
+#include <drc_item_index.h>
 #ifdef NEWCONALGO
 #include <connectivity_data.h>
 #endif
@@ -45,6 +46,7 @@ TRACKITEMS::TRACKITEMS( const BOARD* aBoard )
     m_Teardrops = new TEARDROPS( this, aBoard );
     m_RoundedTracksCorners = new ROUNDED_TRACKS_CORNERS( this, aBoard );
     m_NetCodeFirstTrackItem = new NETCODE_FIRST_TRACKITEM( aBoard );
+    m_NetScanIndex = new NET_SCAN_INDEX( aBoard );
 }
 
 TRACKITEMS::~TRACKITEMS()
@@ -55,6 +57,10 @@ TRACKITEMS::~TRACKITEMS()
     m_RoundedTracksCorners = nullptr;
     delete m_NetCodeFirstTrackItem;
     m_NetCodeFirstTrackItem = nullptr;
+    delete m_NetScanIndex;
+    m_NetScanIndex = nullptr;
+    delete m_drc_online_index;
+    m_drc_online_index = nullptr;
 }
 
 
@@ -145,6 +151,8 @@ TRACKITEMS::NET_SCAN_GET_VIA::NET_SCAN_GET_VIA( const TRACK* aStartTrack,
 {
     m_pos = aPos;
     m_result_via = nullptr;
+    m_scan_pos = aPos;
+    m_scan_at_pos = true;
 }
 
 bool TRACKITEMS::NET_SCAN_GET_VIA::ExecuteAt( TRACK* aTrack )
@@ -181,6 +189,7 @@ TRACKITEMS::NET_SCAN_GET_ENDPOS_VIA::NET_SCAN_GET_ENDPOS_VIA( const TRACK* aStar
                                                         ) :
     NET_SCAN_GET_VIA( aStartTrack, wxPoint{0,0}, aParent )
 {
+    m_scan_pos = m_scan_start_track->GetEnd();
 }
 
 bool TRACKITEMS::NET_SCAN_GET_ENDPOS_VIA::ExecuteAt( TRACK* aTrack )
@@ -217,6 +226,7 @@ TRACKITEMS::NET_SCAN_GET_STARTPOS_VIA::NET_SCAN_GET_STARTPOS_VIA( const TRACK* a
     NET_SCAN_GET_VIA( aStartTrack, wxPoint{0,0}, aParent )
 {
     m_reverse = true;
+    m_scan_pos = m_scan_start_track->GetStart();
 }
 
 bool TRACKITEMS::NET_SCAN_GET_STARTPOS_VIA::ExecuteAt( TRACK* aTrack )
@@ -313,6 +323,10 @@ bool TRACKITEMS::PADS_SCAN_GET_PADS_IN_NET::ExecutePad( const D_PAD* aPad )
 
 std::vector<D_PAD*> TRACKITEMS::GetPads( const int aNetCode ) const
 {
+    const std::vector<D_PAD*>* indexed_pads = m_NetScanIndex->GetPads( aNetCode );
+    if( indexed_pads )
+        return *indexed_pads;
+
     std::vector<D_PAD*> pads_list;
     pads_list.clear();
     std::unique_ptr<PADS_SCAN_GET_PADS_IN_NET> get_pads(
@@ -407,40 +421,31 @@ void TRACKITEMS::PickTrackSize( const TRACK* aTrack )
 
 
 //----------------------------------------------------------------------------------------
-// DRC
+// Online DRC item index
 //----------------------------------------------------------------------------------------
 
-MARKER_PCB* TRACKITEMS::DRC_AddMarker( const BOARD_CONNECTED_ITEM* aItem1,
-                                       const BOARD_ITEM* aItem2,
-                                       const wxPoint aMarkerPos,
-                                       const int aErrorCode
-                                     )
+void TRACKITEMS::DRC_OnlineIndexAdd( const BOARD_ITEM* aItem )
 {
-    MARKER_PCB* marker{nullptr};
-    if( aItem1 )
-    {
-        if( aItem2 )
-            marker = new MARKER_PCB( aErrorCode,
-                                     aMarkerPos,
-                                     aItem1->GetSelectMenuText(),
-                                     aItem1->GetPosition(),
-                                     aItem2->GetSelectMenuText(),
-                                     aItem2->GetPosition() );
-        else
-            marker = new MARKER_PCB( aErrorCode,
-                                     aMarkerPos,
-                                     aItem1->GetSelectMenuText(),
-                                     aItem1->GetPosition() );
+    if( m_drc_online_index && aItem )
+        m_drc_online_index->Add( const_cast<BOARD_ITEM*>( aItem ) );
+}
 
-        if( marker )
-        {
-            marker->SetItem( aItem1 );
-            m_Board->Add( static_cast<BOARD_ITEM*>( marker ) );
-            //GAL canvas
-            m_EditFrame->GetGalCanvas()->GetView()->Add( static_cast<BOARD_ITEM*>( marker ) );
-        }
+void TRACKITEMS::DRC_OnlineIndexRemove( const BOARD_ITEM* aItem )
+{
+    if( m_drc_online_index && aItem )
+        m_drc_online_index->Remove( aItem );
+}
+
+void TRACKITEMS::DRC_OnlineBoardModified( void )
+{
+    //Items may have been moved or deleted without commit. Index is built again when needed.
+    if( m_drc_online_pushed )
+        m_drc_online_pushed = false;
+    else
+    {
+        delete m_drc_online_index;
+        m_drc_online_index = nullptr;
     }
-    return marker;
 }
 
 //----------------------------------------------------------------------------------------
@@ -701,6 +706,8 @@ TRACKITEMS::NET_SCAN_DRAW_TARGET_NODE_POS::NET_SCAN_DRAW_TARGET_NODE_POS( const
 {
     m_result = false;
     m_pos = aPosition;
+    m_scan_pos = aPosition;
+    m_scan_at_pos = true;
     m_drag_segments = const_cast<std::vector<DRAG_SEGM_PICKER>*>( aDragSegmentList );
 }
 
@@ -1057,6 +1064,147 @@ void TRACKITEMS::NETCODE_FIRST_TRACKITEM::Remove( const TRACK* aTrackItem )
 
 //---------------------------------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------------------------------
+// Per net spatial index of m_Track items.
+//---------------------------------------------------------------------------------------------------
+TRACKITEMS::NET_SCAN_INDEX::~NET_SCAN_INDEX()
+{
+    Clear();
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::Clear( void )
+{
+    for( auto net_tree : m_net_trees )
+        delete net_tree;
+    m_net_trees.clear();
+    m_items.clear();
+
+    m_net_pads.clear();
+    m_net_pads_collected = false;
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::Enable( void )
+{
+    ++m_enabled_count;
+}
+
+//Index is dropped when last user disables it, so it never becomes out of date.
+void TRACKITEMS::NET_SCAN_INDEX::Disable( void )
+{
+    if( m_enabled_count )
+        if( !--m_enabled_count )
+            Clear();
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::InsertItem( NET_RTREE* aNetTree, const TRACK* aTrackItem )
+{
+    if( m_items.find( aTrackItem ) == m_items.end() )
+    {
+        ITEM_ENTRY entry;
+        entry.netcode = aTrackItem->GetNetCode();
+        entry.min[0] = std::min( aTrackItem->GetStart().x, aTrackItem->GetEnd().x );
+        entry.min[1] = std::min( aTrackItem->GetStart().y, aTrackItem->GetEnd().y );
+        entry.max[0] = std::max( aTrackItem->GetStart().x, aTrackItem->GetEnd().x );
+        entry.max[1] = std::max( aTrackItem->GetStart().y, aTrackItem->GetEnd().y );
+
+        aNetTree->Insert( entry.min, entry.max, const_cast<TRACK*>( aTrackItem ) );
+        m_items[aTrackItem] = entry;
+    }
+}
+
+//Net tree is built at first query from m_Track, which is sorted by netcode.
+TRACKITEMS::NET_SCAN_INDEX::NET_RTREE* TRACKITEMS::NET_SCAN_INDEX::GetNetTree( const int aNetCode )
+{
+    if( aNetCode < 0 )
+        return nullptr;
+
+    if( aNetCode >= (int)m_net_trees.size() )
+        m_net_trees.resize( aNetCode + 1, nullptr );
+
+    NET_RTREE* net_tree = m_net_trees[aNetCode];
+    if( !net_tree )
+    {
+        net_tree = new NET_RTREE;
+        m_net_trees[aNetCode] = net_tree;
+
+        TRACK* track = m_Board->TrackItems()->NetCodeFirstTrackItem()->GetFirst( aNetCode );
+        while( track && ( track->GetNetCode() == aNetCode ) )
+        {
+            InsertItem( net_tree, track );
+            track = track->Next();
+        }
+    }
+    return net_tree;
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::Insert( const TRACK* aTrackItem )
+{
+    if( aTrackItem && IsEnabled() )
+    {
+        int netcode = aTrackItem->GetNetCode();
+        //Not built nets are collected later when queried.
+        if( ( netcode >= 0 ) && ( netcode < (int)m_net_trees.size() ) && m_net_trees[netcode] )
+            InsertItem( m_net_trees[netcode], aTrackItem );
+    }
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::Remove( const TRACK* aTrackItem )
+{
+    if( aTrackItem && IsEnabled() )
+    {
+        auto item = m_items.find( aTrackItem );
+        if( item != m_items.end() )
+        {
+            ITEM_ENTRY& entry = item->second;
+            m_net_trees[entry.netcode]->Remove( entry.min, entry.max, const_cast<TRACK*>( aTrackItem ) );
+            m_items.erase( item );
+        }
+    }
+}
+
+void TRACKITEMS::NET_SCAN_INDEX::Query( const int aNetCode,
+                                        const wxPoint aPos,
+                                        std::vector<TRACK*>& aResult
+                                      )
+{
+    NET_RTREE* net_tree = GetNetTree( aNetCode );
+    if( net_tree )
+    {
+        const int pos[2] = { aPos.x, aPos.y };
+        auto collect = [&aResult]( TRACK* aTrackItem ) -> bool
+        {
+            aResult.push_back( aTrackItem );
+            return true;
+        };
+        net_tree->Search( pos, pos, collect );
+    }
+}
+
+const std::vector<D_PAD*>* TRACKITEMS::NET_SCAN_INDEX::GetPads( const int aNetCode )
+{
+    if( !IsEnabled() || ( aNetCode < 0 ) )
+        return nullptr;
+
+    if( !m_net_pads_collected )
+    {
+        for( MODULE* module = m_Board->m_Modules; module; module = module->Next() )
+            for( D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+            {
+                int netcode = pad->GetNetCode();
+                if( netcode >= (int)m_net_pads.size() )
+                    m_net_pads.resize( netcode + 1 );
+                m_net_pads[netcode].push_back( pad );
+            }
+        m_net_pads_collected = true;
+    }
+
+    if( aNetCode >= (int)m_net_pads.size() )
+        m_net_pads.resize( aNetCode + 1 );
+    return &m_net_pads[aNetCode];
+}
+
+//---------------------------------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------------------------------
 // Sort tracks by netcode
 //---------------------------------------------------------------------------------------------------
@@ -161,6 +161,7 @@ TRACKITEMS::TRACKS_PROGRESS_MARK_SHARP_ANGLES::TRACKS_PROGRESS_MARK_SHARP_ANGLES
     marked_tracks_sharp_angle.clear();
     aParent->GetBoard()->DeleteMARKERs();
     m_progress_title.Printf( _( "Searching Sharp Angles of Tracks" ) );
+    m_use_net_scan_index = true;
 }
 
 unsigned int TRACKITEMS::TRACKS_PROGRESS_MARK_SHARP_ANGLES::ExecuteItem( const BOARD_ITEM* aItemAt )
@@ -275,6 +276,8 @@ TRACKITEMS::NET_SCAN_SHARP_ANGLES::NET_SCAN_SHARP_ANGLES( const TRACK* aTrackSeg
     m_layer_id = m_scan_start_track->GetLayer();
     m_pos = aPos;
     m_result_track = nullptr;
+    m_scan_pos = aPos;
+    m_scan_at_pos = true;
 }
 
 bool TRACKITEMS::NET_SCAN_SHARP_ANGLES::ExecuteAt( TRACK* aTrack )
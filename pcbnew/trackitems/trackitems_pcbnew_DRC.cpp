@@ -0,0 +1,270 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014- Heikki Pulkkinen.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "trackitems.h"
+#include "viastitching.h"
+
+#include <class_marker_pcb.h>
+#include <view/view.h>
+#include <drc_item_index.h>
+
+#include <set>
+
+using namespace TrackNodeItem;
+
+
+//-----------------------------------------------------------------------------------------------------/
+// DRC
+//-----------------------------------------------------------------------------------------------------/
+MARKER_PCB* TRACKITEMS::DRC_AddMarker( const BOARD_CONNECTED_ITEM* aItem1,
+                                       const BOARD_ITEM* aItem2,
+                                       const wxPoint aMarkerPos,
+                                       const int aErrorCode
+                                     )
+{
+    MARKER_PCB* marker{nullptr};
+    if( aItem1 )
+    {
+        if( aItem2 )
+            marker = new MARKER_PCB( aErrorCode,
+                                     aMarkerPos,
+                                     aItem1->GetSelectMenuText(),
+                                     aItem1->GetPosition(),
+                                     aItem2->GetSelectMenuText(),
+                                     aItem2->GetPosition() );
+        else
+            marker = new MARKER_PCB( aErrorCode,
+                                     aMarkerPos,
+                                     aItem1->GetSelectMenuText(),
+                                     aItem1->GetPosition() );
+
+        if( marker && DRC::CollectedMarkers() )
+        {
+            marker->SetItem( aItem1 );
+            DRC::CollectedMarkers()->push_back( marker );
+        }
+        else if( marker )
+        {
+            marker->SetItem( aItem1 );
+            m_Board->Add( static_cast<BOARD_ITEM*>( marker ) );
+            //GAL canvas
+            m_EditFrame->GetGalCanvas()->GetView()->Add( static_cast<BOARD_ITEM*>( marker ) );
+        }
+    }
+    return marker;
+}
+//-----------------------------------------------------------------------------------------------------/
+
+//-----------------------------------------------------------------------------------------------------/
+// Online DRC
+//-----------------------------------------------------------------------------------------------------/
+void TRACKITEMS::DRC_OnlineClear( void )
+{
+    m_drc_online_areas.clear();
+    m_drc_online_removed.clear();
+}
+
+void TRACKITEMS::DRC_OnlineAddArea( const EDA_RECT& aArea )
+{
+    //Areas of one item, like old and new places of moved item, are merged.
+    for( EDA_RECT& area : m_drc_online_areas )
+    {
+        if( area.Intersects( aArea ) )
+        {
+            area.Merge( aArea );
+            return;
+        }
+    }
+
+    m_drc_online_areas.push_back( aArea );
+}
+
+void TRACKITEMS::DRC_OnlineAdd( const BOARD_ITEM* aItem )
+{
+    //Markers are added with commits by DRC. They do not change anything.
+    if( !aItem || ( aItem->Type() == PCB_MARKER_T ) )
+        return;
+
+    DRC_OnlineAddArea( aItem->GetBoundingBox() );
+    DRC_OnlineIndexAdd( aItem );
+}
+
+void TRACKITEMS::DRC_OnlineRemove( const BOARD_ITEM* aItem )
+{
+    if( !aItem || ( aItem->Type() == PCB_MARKER_T ) )
+        return;
+
+    DRC_OnlineAddArea( aItem->GetBoundingBox() );
+    DRC_OnlineIndexRemove( aItem );
+    //Removed item is only compared to marker items, never used.
+    m_drc_online_removed.insert( aItem );
+}
+
+void TRACKITEMS::DRC_OnlineModify( const BOARD_ITEM* aItem, const BOARD_ITEM* aOldItem )
+{
+    if( !aItem || ( aItem->Type() == PCB_MARKER_T ) )
+        return;
+
+    //Both old and new places.
+    if( aOldItem )
+        DRC_OnlineAddArea( aOldItem->GetBoundingBox() );
+    DRC_OnlineAddArea( aItem->GetBoundingBox() );
+
+    if( m_drc_online_index )
+        m_drc_online_index->Update( const_cast<BOARD_ITEM*>( aItem ) );
+}
+
+//Errors which are checked again. Teardrop warnings are marked only by MarkWarnings.
+bool TRACKITEMS::DRC_OnlineIsItemsError( const int aErrorCode ) const
+{
+    return ( ( aErrorCode >= DRCE_TEARDROP_NEAR_TEARDROP ) && ( aErrorCode <= DRCE_JUNCTION_INSIDE_TEXT ) ) ||
+           ( aErrorCode == DRCE_TRACKNODEITEM_UNSPECIFIED ) ||
+           ( aErrorCode == DRCE_THERMAL_VIA_UNCONNECTED ) ||
+           ( aErrorCode == DRCE_THERMAL_VIA_CONNECTED_POURS );
+}
+
+bool TRACKITEMS::DRC_OnlineIsCheckItem( const TRACK* aTrack ) const
+{
+    return ( aTrack->Type() == PCB_TEARDROP_T ) ||
+           ( aTrack->Type() == PCB_ROUNDEDTRACKSCORNER_T ) ||
+           ( ( aTrack->Type() == PCB_VIA_T ) && static_cast<const VIA*>( aTrack )->GetThermalCode() );
+}
+
+//Same error between same items at same places gives one marker only.
+static wxString drcOnlineMarkerKey( const MARKER_PCB* aMarker )
+{
+    const DRC_ITEM& item = aMarker->GetReporter();
+    wxString first = wxString::Format( wxT( "%d,%d " ), item.GetPointA().x, item.GetPointA().y ) +
+                     item.GetMainText();
+    wxString second;
+
+    if( item.HasSecondItem() )
+        second = wxString::Format( wxT( "%d,%d " ), item.GetPointB().x, item.GetPointB().y ) +
+                 item.GetAuxiliaryText();
+
+    //Items can be in either order.
+    if( second < first )
+        std::swap( first, second );
+
+    return wxString::Format( wxT( "%d\n" ), item.GetErrorCode() ) + first + wxT( "\n" ) + second;
+}
+
+void TRACKITEMS::DRC_OnlineDo( void )
+{
+    //Board changes done before OnModify() are pushed, index is still valid.
+    m_drc_online_pushed = true;
+
+    if( m_drc_online_areas.empty() || !g_Drc_On || !m_EditFrame ||
+        !m_EditFrame->GetDrcController() )
+    {
+        DRC_OnlineClear();
+        return;
+    }
+
+    DRC* drc = m_EditFrame->GetDrcController();
+    KIGFX::VIEW* view = m_EditFrame->GetGalCanvas()->GetView();
+    int clearance = m_Board->GetDesignSettings().GetBiggestClearanceValue();
+
+    //Index is built once and then kept up to date by board changes. New one is needed if
+    //design rules have now bigger clearance.
+    if( !m_drc_online_index || ( m_drc_online_index->GetClearance() <= clearance ) )
+    {
+        delete m_drc_online_index;
+        m_drc_online_index = new DRC_ITEM_INDEX( m_Board );
+    }
+
+    //Items which clearance may have changed. Index boxes are inflated by clearance.
+    std::unordered_set<const BOARD_ITEM*> check_items;
+    std::vector<TRACK*> check_tracks;
+    std::vector<TRACK*> found;
+    for( const EDA_RECT& area : m_drc_online_areas )
+    {
+        m_drc_online_index->QueryTracks( area, found );
+
+        for( TRACK* track : found )
+            if( DRC_OnlineIsCheckItem( track ) && check_items.insert( track ).second )
+                check_tracks.push_back( track );
+    }
+
+    //Teardrops and corners are changed by push without commit.
+    for( TRACK* track : check_tracks )
+        m_drc_online_index->Update( track );
+
+    //Remove old markers of checked and removed items, and item errors inside areas.
+    std::vector<EDA_RECT> areas = m_drc_online_areas;
+    for( EDA_RECT& area : areas )
+        area.Inflate( clearance );
+
+    for( int n = m_Board->GetMARKERCount() - 1; n >= 0; --n )
+    {
+        MARKER_PCB* marker = m_Board->GetMARKER( n );
+        const BOARD_ITEM* item = marker->GetItem();
+        bool remove = check_items.count( item ) || m_drc_online_removed.count( item );
+
+        if( !remove && DRC_OnlineIsItemsError( marker->GetReporter().GetErrorCode() ) )
+            for( const EDA_RECT& area : areas )
+                if( area.Contains( marker->GetPos() ) )
+                {
+                    remove = true;
+                    break;
+                }
+
+        if( remove )
+        {
+            view->Remove( static_cast<BOARD_ITEM*>( marker ) );
+            m_Board->Remove( marker );
+            delete marker;
+        }
+    }
+
+    //Only changed items are checked, and only against their neighbours.
+    std::vector<MARKER_PCB*> markers;
+    DRC::SetCollectedMarkers( &markers );
+    for( TRACK* track : check_tracks )
+    {
+        if( track->Type() == PCB_VIA_T )
+            m_Board->ViaStitching()->RuleCheck( track, drc );
+        else
+            drc->OnlineTrackDrc( track, m_drc_online_index );   //Includes teardrop rules.
+    }
+    DRC::SetCollectedMarkers( nullptr );
+
+    //Error between two checked items is found by both of them.
+    std::set<wxString> marker_keys;
+    for( int n = 0; n < m_Board->GetMARKERCount(); ++n )
+        marker_keys.insert( drcOnlineMarkerKey( m_Board->GetMARKER( n ) ) );
+
+    for( MARKER_PCB* marker : markers )
+    {
+        if( marker_keys.insert( drcOnlineMarkerKey( marker ) ).second )
+        {
+            m_Board->Add( marker );
+            view->Add( static_cast<BOARD_ITEM*>( marker ) );
+        }
+        else
+            delete marker;
+    }
+
+    DRC_OnlineClear();
+}
+//-----------------------------------------------------------------------------------------------------/
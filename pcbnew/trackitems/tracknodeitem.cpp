@@ -357,6 +357,8 @@ SCAN_NET_COLLECT_TRACKSEGS_CONNECTED::SCAN_NET_COLLECT_TRACKSEGS_CONNECTED( cons
     m_pos = aPosAt;
     m_layer = aTrackSegAt->GetLayer();
     m_connected_item_type = PCB_TRACE_T;
+    m_scan_pos = m_pos;
+    m_scan_at_pos = true;
 
     m_tracks_list = aTracksList;
 }
@@ -370,6 +372,8 @@ SCAN_NET_COLLECT_TRACKSEGS_CONNECTED::SCAN_NET_COLLECT_TRACKSEGS_CONNECTED( cons
     m_pad = aPad;
     m_pos = m_pad->GetPosition();
     m_connected_item_type = PCB_PAD_T;
+    m_scan_pos = m_pos;
+    m_scan_at_pos = true;
 
     m_tracks_list = aTracksList;
 }
@@ -520,6 +524,9 @@ void SCAN_NET_BASE::Execute( void )
 {
     if( m_scan_start_track )
     {
+        if( m_scan_at_pos && ExecuteIndexed() )
+            return;
+
         int net_code = m_scan_start_track->GetNetCode();
         for( unsigned int n = 0; n < 2; ++n )
         {
@@ -556,6 +563,26 @@ void SCAN_NET_BASE::Execute( void )
         }
     }
 }
+
+//Scan only net items at m_scan_pos with net scan index. Returns false if index is not enabled.
+bool SCAN_NET_BASE::ExecuteIndexed( void )
+{
+    BOARD* board = m_scan_start_track->GetBoard();
+    if( !board || !board->TrackItems() || !board->TrackItems()->NetScanIndex()->IsEnabled() )
+        return false;
+
+    int net_code = m_scan_start_track->GetNetCode();
+    std::vector<TRACK*> tracks;
+    board->TrackItems()->NetScanIndex()->Query( net_code, m_scan_pos, tracks );
+
+    for( auto track : tracks )
+    {
+        if( track->GetNetCode() == net_code )
+            if( ExecuteAt( track ) ) //Break when virtual function true.
+                break;
+    }
+    return true;
+}
 //------------------------------------------------------------------------------------------------------
 
 
@@ -335,6 +335,14 @@ namespace TrackNodeItem
 
         bool m_reverse{false};
         bool m_return_at_break{true};
+
+        //Set when ExecuteAt() accepts only items at m_scan_pos. Then net scan index is used
+        //instead of walking net, if it is enabled.
+        bool m_scan_at_pos{false};
+        wxPoint m_scan_pos{0,0};
+
+    private:
+        bool ExecuteIndexed( void );
     };
 
     void TracksConnected( const TRACK* aTrackSegAt, const wxPoint aPosAt, Tracks_Container& aTracksList );
@@ -75,7 +75,13 @@ namespace TrackNodeItems
         int m_progress_style {0};
         bool m_cancelled {false};
 
+        //Set in derived class when ExecuteItem() does not move tracks. Net scans at pos
+        //use then per net spatial index instead of walking whole net.
+        bool m_use_net_scan_index {false};
+
     private:
+        void NetScanIndex( const bool aEnable );
+
         int m_items_to_count {0};
         int m_progress_to_count {0};
 
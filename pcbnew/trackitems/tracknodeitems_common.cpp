@@ -78,7 +78,12 @@ void TRACKNODEITEMS::TracksDList_Insert( DLIST<TRACK>* aTracksList, const TRACK*
         aTracksList->Insert( const_cast<TRACK*>( aInsertItem ), const_cast<TRACK*>( aInsertItemBefore ) );
 
         if( m_Board->m_Track == aTracksList->GetFirst() )
+        {
+            m_Board->m_Status_Pcb &= ~CONNEXION_OK;
             m_Board->TrackItems()->NetCodeFirstTrackItem()->Insert( aInsertItem );
+            m_Board->TrackItems()->NetScanIndex()->Insert( aInsertItem );
+            m_Board->TrackItems()->DRC_OnlineIndexAdd( aInsertItem );
+        }
     }
 }
 
@@ -87,7 +92,12 @@ void TRACKNODEITEMS::TracksDList_Remove( DLIST<TRACK>* aTracksList, const TRACK*
     if( aTracksList && aRemoveItem )
     {
         if( m_Board->m_Track == aTracksList->GetFirst() )
+        {
+            m_Board->m_Status_Pcb &= ~CONNEXION_OK;
             m_Board->TrackItems()->NetCodeFirstTrackItem()->Remove( aRemoveItem );
+            m_Board->TrackItems()->NetScanIndex()->Remove( aRemoveItem );
+            m_Board->TrackItems()->DRC_OnlineIndexRemove( aRemoveItem );
+        }
 
         aTracksList->Remove( const_cast<TRACK*>( aRemoveItem ) );
     }
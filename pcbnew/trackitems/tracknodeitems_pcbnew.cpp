@@ -23,6 +23,7 @@
 
 #include"tracknodeitems.h"
 #include "teardrops.h"
+#include "trackitems.h"
 
 
 using namespace TrackNodeItem;
@@ -94,6 +95,7 @@ unsigned int ITEMS_PROGRESS_BASE::Execute( void )
 
         if( m_progress )
         {
+            NetScanIndex( true );
             BOARD_ITEM* item = const_cast<BOARD_ITEM*>( m_list_first_item );
             unsigned int operations_count = 0;
             int progress_count = 0;
@@ -112,6 +114,7 @@ unsigned int ITEMS_PROGRESS_BASE::Execute( void )
                         if( m_can_cancel )
                         {
                             m_cancelled = true;
+                            NetScanIndex( false );
                             return 0;
                         }
                     }
@@ -121,12 +124,24 @@ unsigned int ITEMS_PROGRESS_BASE::Execute( void )
             }
             UpdateProgress( m_progress_to_count, operations_count );
             ExecuteEnd();
+            NetScanIndex( false );
             return operations_count;
         }
     }
     return 0;
 }
 
+void ITEMS_PROGRESS_BASE::NetScanIndex( const bool aEnable )
+{
+    if( m_use_net_scan_index && m_frame )
+    {
+        if( aEnable )
+            m_frame->GetBoard()->TrackItems()->NetScanIndex()->Enable();
+        else
+            m_frame->GetBoard()->TrackItems()->NetScanIndex()->Disable();
+    }
+}
+
 
 //-----------------------------------------------------------------------------------------------------/
 // MODULES_PROGRESS
@@ -173,7 +188,7 @@ bool TRACKNODEITEMS::TestSegment( const wxPoint aStartPoint,
     RotatePoint( &delta, angle );
     RotatePoint( &seg_start_point, angle );
 
-    if( !m_EditFrame->GetDrcController()->checkMarginToCircle( seg_start_point, aMinDist, delta.x ) )
+    if( !DRC::checkMarginToCircle( seg_start_point, aMinDist, delta.x ) )
         return false;
 
     return true;
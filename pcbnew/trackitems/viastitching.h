@@ -263,7 +263,6 @@ private:
         {
             m_connected_polys = aPolygons;
             m_zone = aZone;
-            m_zone_polys = &m_zone->GetFilledPolysList();
         };
 
         ~SCAN_NET_COLLECT_HITTED_POLYS(){};
@@ -273,7 +272,6 @@ private:
 
     private:
         const ZONE_CONTAINER* m_zone{nullptr};
-        const SHAPE_POLY_SET* m_zone_polys{nullptr};
         ZonePolygonsContainer* m_connected_polys{nullptr};
 
         SCAN_NET_COLLECT_HITTED_POLYS(){};
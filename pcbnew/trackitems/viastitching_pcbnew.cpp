@@ -24,9 +24,8 @@
 #include "viastitching.h"
 #include "trackitems.h"
 
-#ifdef USE_OPENMP
-#include <omp.h>
-#endif
+#include <zone_fill_scheduler.h>
+#include <drc_item_index.h>
 
 using namespace ViaStitching;
 
@@ -678,7 +677,7 @@ bool VIASTITCHING::SCAN_NET_COLLECT_HITTED_POLYS::ExecuteAt( TRACK* aTrack )
                 if( m_zone->HitTestInsideZone( seg_pos ) )
                 {
                     const SHAPE_POLY_SET::POLYGON* seg_poly =
-                        m_zone_polys->GetPolygon( VECTOR2I( seg_pos.x, seg_pos.y ) );
+                        m_zone->GetFilledPolysList().GetPolygon( VECTOR2I( seg_pos.x, seg_pos.y ) );
 
                     if( seg_poly )
                     {
@@ -736,18 +735,15 @@ void VIASTITCHING::FillAndConnectZones(  wxWindow* aActiveWindow, PCB_EDIT_FRAME
     if( progressDialog )
         progressDialog->Update( ++progress_counter, _( "Filling zones..." ) );
 
-#ifdef USE_OPENMP
-    #pragma omp parallel for schedule(dynamic)
-#endif
+    ZONE_FILL_SCHEDULER scheduler( zones );
+
 #ifdef NEWCONALGO
-    for( int n = 0; n < zones.size(); ++n )
-    {
-        ZONE_CONTAINER* zone = zones[n];
+    scheduler.Run( [&]( ZONE_CONTAINER* zone ) {
         zone->ClearFilledPolysList();
         zone->UnFill();
         zone->BuildFilledSolidAreasPolygons( const_cast<BOARD*>(m_Board), nullptr, false );
         zone->SetIsFilled( true );
-    }
+    }, true );
 
 #ifndef MYCONALGO
     for( auto zone : zones )
@@ -755,14 +751,14 @@ void VIASTITCHING::FillAndConnectZones(  wxWindow* aActiveWindow, PCB_EDIT_FRAME
 #endif
 
 #else
-    for( int m = 0; m < zones.size(); ++m )
-    {
-        ZONE_CONTAINER* zone = zones[m];
-        zone->ClearFilledPolysList();
-        zone->UnFill();
-        zone->BuildFilledSolidAreasPolygons( const_cast<BOARD*>(m_Board) );
-    }
+    //Unchanged zones get back their last raw fill, islands are removed again below.
+    //The items near each zone are found in a shared index, read only while filling.
+    DRC_ITEM_INDEX itemIndex( const_cast<BOARD*>(m_Board) );
+    scheduler.Run( [&]( ZONE_CONTAINER* zone ) {
+        zone->RefillIfChanged( const_cast<BOARD*>(m_Board), &itemIndex );
+    }, true );
 #endif
+    scheduler.ReportTimings( wxT( "Fill" ) );
 
     if( progressDialog )
         progressDialog->Update( ++progress_counter, _( "Calculating copper pour connections..." ) );
@@ -775,12 +771,8 @@ void VIASTITCHING::FillAndConnectZones(  wxWindow* aActiveWindow, PCB_EDIT_FRAME
     if( progressDialog )
         progressDialog->Update( ++progress_counter, _( "Cleaning insulated areas..." ) );
 
-#ifdef USE_OPENMP
-    #pragma omp parallel for schedule(dynamic)
-#endif
-    for( int n = 0; n < zones.size(); ++n )
-    {
-        ZONE_CONTAINER* zone = zones[n];
+    //Each zone islands are removed only from its own polygons.
+    scheduler.Run( [&]( ZONE_CONTAINER* zone ) {
         PCB_LAYER_ID zone_layer = zone->GetLayer();
 
         if( zone && IsCopperLayer( zone_layer) )
@@ -834,16 +826,21 @@ void VIASTITCHING::FillAndConnectZones(  wxWindow* aActiveWindow, PCB_EDIT_FRAME
 
             std::sort( islands.begin(), islands.end(), std::greater<int>() );
 
-            for( auto idx : islands )
+            //The fill can be shared with undo images: it is copied before removing the islands.
+            if( islands.size() )
             {
-                const SHAPE_POLY_SET* polylist = &zone->GetFilledPolysList();
-                const_cast<SHAPE_POLY_SET*>(polylist)->DeletePolygon( idx );
-            }
+                SHAPE_POLY_SET& polylist = zone->GetFilledPolysListForEdit();
 
-            if( aEditFrame->IsGalCanvasActive() )
-                aEditFrame->GetGalCanvas()->GetView()->Update( zone, KIGFX::ALL );
+                for( auto idx : islands )
+                    polylist.DeletePolygon( idx );
+            }
         }
-    }
+    }, false );
+    scheduler.ReportTimings( wxT( "Remove islands" ) );
+
+    if( aEditFrame->IsGalCanvasActive() )
+        for( auto zone : zones )
+            aEditFrame->GetGalCanvas()->GetView()->Update( zone, KIGFX::ALL );
 
     if( progressDialog )
         progressDialog->Update( ++progress_counter, _( "Updating ratsnest..." ) );
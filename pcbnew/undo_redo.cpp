@@ -44,6 +44,8 @@ using namespace std::placeholders;
 #include <class_dimension.h>
 #include <class_zone.h>
 #include <class_edge_mod.h>
+#include <class_pad.h>
+#include <class_text_mod.h>
 
 #include <ratsnest_data.h>
 
@@ -704,6 +706,74 @@ void BOARD_ITEM::SwapData( BOARD_ITEM* aImage )
 }
 
 
+/**
+ * Function itemMemorySize
+ * returns an estimate of the memory used by a copy of a board item, in bytes.
+ * The zone fills in aCounted are not counted, the other ones are added to it.
+ */
+static size_t itemMemorySize( const EDA_ITEM* aItem, std::unordered_set<const void*>& aCounted )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+        return static_cast<const ZONE_CONTAINER*>( aItem )->GetMemorySize( aCounted );
+
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t        size = sizeof( MODULE );
+
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+            size += sizeof( D_PAD );
+
+        for( const BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+            size += itemMemorySize( item, aCounted );
+
+        return size;
+    }
+
+    case PCB_MODULE_EDGE_T:     return sizeof( EDGE_MODULE );
+    case PCB_MODULE_TEXT_T:     return sizeof( TEXTE_MODULE );
+    case PCB_LINE_T:            return sizeof( DRAWSEGMENT );
+    case PCB_TEXT_T:            return sizeof( TEXTE_PCB );
+    case PCB_DIMENSION_T:       return sizeof( DIMENSION );
+    case PCB_TARGET_T:          return sizeof( PCB_TARGET );
+    case PCB_VIA_T:             return sizeof( VIA );
+    default:                    return sizeof( TRACK );
+    }
+}
+
+
+size_t PCB_SCREEN::GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand,
+                                         std::unordered_set<const void*>& aCounted ) const
+{
+    size_t size = 0;
+
+    for( unsigned ii = 0; ii < aCommand.GetCount(); ii++ )
+    {
+        // Only the copies of items are owned by the command, like in ClearListAndDeleteItems()
+        switch( aCommand.GetPickedItemStatus( ii ) )
+        {
+        case UR_CHANGED:
+        case UR_EXCHANGE_T:
+            if( aCommand.GetPickedItemLink( ii ) )
+                size += itemMemorySize( aCommand.GetPickedItemLink( ii ), aCounted );
+            break;
+
+        case UR_DELETED:
+            if( aCommand.GetPickedItem( ii ) )
+                size += itemMemorySize( aCommand.GetPickedItem( ii ), aCounted );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return size;
+}
+
+
 void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount )
 {
     if( aItemCount == 0 )
@@ -0,0 +1,196 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file zone_fill_scheduler.cpp
+ */
+
+#include <fctsys.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <profile.h>
+#include <class_zone.h>
+
+#include <zone_fill_scheduler.h>
+
+
+static const wxString traceZoneFill( wxT( "KICAD_ZONE_FILL" ) );
+
+
+ZONE_FILL_SCHEDULER::ZONE_FILL_SCHEDULER( const std::vector<ZONE_CONTAINER*>& aZones ) :
+    m_zones( aZones ),
+    m_dependents( aZones.size() ),
+    m_dependencyCount( aZones.size(), 0 ),
+    m_timings( aZones.size(), 0.0 )
+{
+    buildDependencies();
+}
+
+
+void ZONE_FILL_SCHEDULER::buildDependencies()
+{
+    std::vector<EDA_RECT> bboxes;
+
+    for( ZONE_CONTAINER* zone : m_zones )
+        bboxes.push_back( zone->GetBoundingBox() );
+
+    // Zone jj waits for zone ii if ii is knocked out of jj.  Edges always go from a
+    // higher to a lower priority, so the graph has no cycle.
+    for( unsigned ii = 0; ii < m_zones.size(); ++ii )
+    {
+        for( unsigned jj = 0; jj < m_zones.size(); ++jj )
+        {
+            if( m_zones[ii]->GetLayer() != m_zones[jj]->GetLayer() )
+                continue;
+
+            if( m_zones[ii]->GetPriority() <= m_zones[jj]->GetPriority() )
+                continue;
+
+            if( !bboxes[ii].Intersects( bboxes[jj] ) )
+                continue;
+
+            m_dependents[ii].push_back( jj );
+            m_dependencyCount[jj]++;
+        }
+    }
+}
+
+
+bool ZONE_FILL_SCHEDULER::Run( const ZONE_TASK& aTask, bool aUseDependencies,
+                               const PROGRESS_CALLBACK& aProgress )
+{
+    const size_t count = m_zones.size();
+
+    std::vector<int>        waiting( count, 0 );
+    std::deque<int>         ready;
+    size_t                  finished = 0;
+    std::atomic<bool>       abort( false );
+    std::mutex              lock;
+    std::condition_variable changed;
+
+    for( unsigned ii = 0; ii < count; ++ii )
+    {
+        if( aUseDependencies )
+            waiting[ii] = m_dependencyCount[ii];
+
+        if( !waiting[ii] )
+            ready.push_back( ii );
+    }
+
+    // Each worker takes the next ready zone, and makes ready the zones waiting for it.
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+
+        while( true )
+        {
+            changed.wait( guard, [&]() {
+                return !ready.empty() || finished == count || abort.load();
+            } );
+
+            if( abort.load() || ready.empty() )
+                return;
+
+            int ii = ready.front();
+            ready.pop_front();
+            guard.unlock();
+
+            PROF_COUNTER timer;
+            aTask( m_zones[ii] );
+            m_timings[ii] = timer.msecs();
+
+            guard.lock();
+            finished++;
+
+            if( aUseDependencies )
+            {
+                for( int dependent : m_dependents[ii] )
+                {
+                    if( --waiting[dependent] == 0 )
+                        ready.push_back( dependent );
+                }
+            }
+
+            changed.notify_all();
+        }
+    };
+
+    size_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount = std::min( threadCount, count );
+
+    // The calling thread runs tasks too, unless it must keep the progress bar alive.
+    if( !aProgress && threadCount )
+        threadCount--;
+
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+        threads.push_back( std::thread( worker ) );
+
+    if( aProgress )
+    {
+        std::unique_lock<std::mutex> guard( lock );
+
+        while( finished < count && !abort.load() )
+        {
+            changed.wait_for( guard, std::chrono::milliseconds( 100 ) );
+
+            int done = finished;
+            guard.unlock();
+
+            if( !aProgress( done ) )
+                abort.store( true );
+
+            guard.lock();
+        }
+
+        changed.notify_all();
+    }
+    else
+    {
+        worker();
+    }
+
+    for( auto& thread : threads )
+        thread.join();
+
+    return !abort.load();
+}
+
+
+void ZONE_FILL_SCHEDULER::ReportTimings( const wxString& aPassName ) const
+{
+    for( unsigned ii = 0; ii < m_zones.size(); ++ii )
+    {
+        wxLogTrace( traceZoneFill, wxT( "%s: zone %u (net '%s', priority %u): %.1f ms" ),
+                    GetChars( aPassName ), ii, GetChars( m_zones[ii]->GetNetname() ),
+                    m_zones[ii]->GetPriority(), m_timings[ii] );
+    }
+}
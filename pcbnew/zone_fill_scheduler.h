@@ -0,0 +1,99 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file zone_fill_scheduler.h
+ */
+
+#ifndef ZONE_FILL_SCHEDULER_H
+#define ZONE_FILL_SCHEDULER_H
+
+#include <vector>
+#include <functional>
+
+#include <wx/string.h>
+
+class ZONE_CONTAINER;
+
+
+/**
+ * Class ZONE_FILL_SCHEDULER
+ * runs a task (filling, island removal...) for each zone of a list on worker threads.
+ *
+ * A zone with a higher priority is knocked out of the overlapping zones with a lower
+ * priority on the same layer, so a dependency graph is built from priorities, layers and
+ * bounding boxes: when dependencies are used, the task of a zone starts only after the
+ * tasks of all the zones which knock it out are finished.  Zones on other layers, or not
+ * overlapping, are handled in parallel.
+ *
+ * Each task must modify only its own zone, so the result does not depend on the thread
+ * count or on the execution order, and is the same with or without USE_OPENMP.
+ */
+class ZONE_FILL_SCHEDULER
+{
+public:
+    /// The task run for each zone
+    typedef std::function<void( ZONE_CONTAINER* aZone )> ZONE_TASK;
+
+    /// Called periodically from the calling thread with the count of finished tasks.
+    /// Returns false to abort the tasks not yet started.
+    typedef std::function<bool( int aFinished )> PROGRESS_CALLBACK;
+
+    ZONE_FILL_SCHEDULER( const std::vector<ZONE_CONTAINER*>& aZones );
+
+    /**
+     * Function Run
+     * runs aTask once for each zone.
+     * @param aTask = the task, which must only modify the zone it is given
+     * @param aUseDependencies = true to wait for the zones knocking out a zone before
+     *                           running its task
+     * @param aProgress = optional progress callback.  When given, the calling thread only
+     *                    calls it, otherwise the calling thread runs tasks too.
+     * @return false if aborted by aProgress.
+     */
+    bool Run( const ZONE_TASK& aTask, bool aUseDependencies,
+              const PROGRESS_CALLBACK& aProgress = PROGRESS_CALLBACK() );
+
+    /**
+     * Function GetTiming
+     * @return the duration in ms of the task of zone aIndex in the last Run().
+     */
+    double GetTiming( unsigned aIndex ) const { return m_timings[aIndex]; }
+
+    /**
+     * Function ReportTimings
+     * writes the durations of the last Run() tasks to the "KICAD_ZONE_FILL" trace.
+     * @param aPassName = the name of the pass printed with the timings
+     */
+    void ReportTimings( const wxString& aPassName ) const;
+
+private:
+    void buildDependencies();
+
+    std::vector<ZONE_CONTAINER*>    m_zones;
+    std::vector<std::vector<int>>   m_dependents;       ///< zones waiting for each zone
+    std::vector<int>                m_dependencyCount;  ///< number of zones each zone waits for
+    std::vector<double>             m_timings;          ///< last Run() task durations in ms
+};
+
+#endif // ZONE_FILL_SCHEDULER_H
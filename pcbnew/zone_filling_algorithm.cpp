@@ -34,10 +34,16 @@
 #include <wxPcbStruct.h>
 #include <convert_basic_shapes_to_polygon.h>
 
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_edge_mod.h>
 #include <class_zone.h>
 
 #include <pcbnew.h>
 #include <zones.h>
+#include <drc_item_index.h>
 
 /* Build the filled solid areas data from real outlines (stored in m_Poly)
  * The solid areas can be more than one on copper layers, and do not have holes
@@ -119,7 +125,7 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET*
      */
     else
     {
-        m_FilledPolysList.RemoveAllContours();
+        ClearFilledPolysList();
 
         if( IsOnCopperLayer() )
         {
@@ -135,15 +141,16 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET*
         {
             m_FillMode = 0;     // Fill by segments is no more used in non copper layers
                                 // force use solid polygons (usefull only for old boards)
-            m_FilledPolysList = *m_smoothedPoly;
+            setFilledPolys( *m_smoothedPoly );
 
             // The filled areas are deflated by -m_ZoneMinThickness / 2, because
             // the outlines are drawn with a line thickness = m_ZoneMinThickness to
             // give a good shape with the minimal thickness
-            m_FilledPolysList.Inflate( -m_ZoneMinThickness / 2, 16 );
-            m_FilledPolysList.Fracture( SHAPE_POLY_SET::PM_FAST );
+            filledPolys().Inflate( -m_ZoneMinThickness / 2, 16 );
+            filledPolys().Fracture( SHAPE_POLY_SET::PM_FAST );
         }
 
+        CacheTriangulation();
         m_IsFilled = true;
     }
 
@@ -151,6 +158,289 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET*
 }
 
 
+bool ZONE_CONTAINER::RefillIfChanged( BOARD* aPcb, DRC_ITEM_INDEX* aItemIndex )
+{
+    std::vector<int64_t> signature;
+    buildFillSignature( aPcb, aItemIndex, signature );
+
+    if( !m_fillSignature.empty() && signature == m_fillSignature )
+    {
+        m_FilledPolysList = m_fillCachePolys;
+        m_FillSegmList = m_fillCacheSegments;
+        m_IsFilled = true;
+        return false;
+    }
+
+    ClearFilledPolysList();
+    UnFill();
+
+    if( BuildFilledSolidAreasPolygons( aPcb ) && m_IsFilled )
+    {
+        // Save the filled areas.  The fill does not change the items of the signature
+        m_fillSignature.swap( signature );
+        m_fillCachePolys = m_FilledPolysList;     // shared until changed
+        m_fillCacheSegments = m_FillSegmList;
+    }
+    else
+    {
+        m_fillSignature.clear();
+    }
+
+    return true;
+}
+
+
+void ZONE_CONTAINER::buildFillSignature( BOARD* aPcb, DRC_ITEM_INDEX* aItemIndex,
+                                         std::vector<int64_t>& aSignature ) const
+{
+    aSignature.clear();
+
+    // The items are described by their time stamp and geometry, and the descriptions are
+    // sorted, so the signature does not depend on the order of the board lists
+    std::vector< std::vector<int64_t> > items;
+    std::vector<int64_t>* record = &aSignature;
+
+    auto newRecord = [&]( KICAD_T aType, time_t aTimeStamp )
+    {
+        items.push_back( std::vector<int64_t>() );
+        record = &items.back();
+        record->push_back( aType );
+        record->push_back( aTimeStamp );
+    };
+
+    auto add = [&record]( int64_t aValue )
+    {
+        record->push_back( aValue );
+    };
+
+    auto addPoint = [&add]( const wxPoint& aPoint )
+    {
+        add( aPoint.x );
+        add( aPoint.y );
+    };
+
+    auto addSize = [&add]( const wxSize& aSize )
+    {
+        add( aSize.x );
+        add( aSize.y );
+    };
+
+    auto addRect = [&]( const EDA_RECT& aRect )
+    {
+        addPoint( aRect.GetOrigin() );
+        addPoint( aRect.GetEnd() );
+    };
+
+    // The corners of a polygon drawing, which are not given by its start and end points
+    auto addPolyPoints = [&]( const DRAWSEGMENT* aSegment )
+    {
+        if( aSegment->GetShape() != S_POLYGON )
+            return;
+
+        add( aSegment->GetPolyPoints().size() );
+
+        for( const wxPoint& corner : aSegment->GetPolyPoints() )
+            addPoint( corner );
+    };
+
+    auto addOutline = [&add]( const SHAPE_POLY_SET* aPoly )
+    {
+        add( aPoly->TotalVertices() );
+
+        for( auto it = aPoly->CIterateWithHoles(); it; it++ )
+        {
+            add( it->x );
+            add( it->y );
+            add( it.IsEndContour() );
+        }
+    };
+
+    // The zone itself
+    add( GetLayer() );
+    add( GetNetCode() );
+    add( m_priority );
+    add( m_ZoneClearance );
+    add( m_ZoneMinThickness );
+    add( m_FillMode );
+    add( m_ArcToSegmentsCount );
+    add( m_PadConnection );
+    add( m_ThermalReliefGap );
+    add( m_ThermalReliefCopperBridge );
+    add( m_cornerSmoothingType );
+    add( m_cornerRadius );
+    addOutline( m_Poly );
+
+    if( !aPcb || !IsOnCopperLayer() )
+        return;
+
+    add( GetClearance() );
+    add( aPcb->GetDesignSettings().GetBiggestClearanceValue() );
+
+    // Same area as buildFeatureHoleList(), with the thermal gap added for pads
+    int outline_half_thickness = m_ZoneMinThickness / 2;
+    int zone_clearance = std::max( m_ZoneClearance, GetClearance() ) + outline_half_thickness;
+    EDA_RECT zone_boundingbox = GetBoundingBox();
+    zone_boundingbox.Inflate( std::max( aPcb->GetDesignSettings().GetBiggestClearanceValue(),
+                                        zone_clearance ) );
+
+    // Only the pads and tracks near the zone are given by the item index, if any.  Its boxes
+    // are inflated by the item clearance and the pad thermal gap, so the query area only
+    // needs the outline thickness and the zone thermal gap
+    std::vector<D_PAD*> pads;
+    std::vector<TRACK*> tracks;
+
+    if( aItemIndex )
+    {
+        EDA_RECT area = zone_boundingbox;
+        area.Inflate( outline_half_thickness + m_ThermalReliefGap );
+        aItemIndex->QueryPads( area, LSET( GetLayer() ), pads );
+        aItemIndex->QueryTracks( area, tracks, LSET( GetLayer() ) );
+    }
+    else
+    {
+        for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+        {
+            for( D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+                pads.push_back( pad );
+        }
+
+        for( TRACK* track = aPcb->m_Track; track; track = track->Next() )
+            tracks.push_back( track );
+    }
+
+    for( D_PAD* pad : pads )
+    {
+        if( !pad->IsOnLayer( GetLayer() ) && !pad->GetDrillSize().x && !pad->GetDrillSize().y )
+            continue;
+
+        EDA_RECT item_boundingbox = pad->GetBoundingBox();
+        item_boundingbox.Inflate( std::max( pad->GetClearance(), GetThermalReliefGap( pad ) )
+                                  + outline_half_thickness );
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        newRecord( PCB_PAD_T, pad->GetParent()->GetTimeStamp() );
+        add( pad->GetPackedPadName() );
+        addRect( pad->GetBoundingBox() );
+        addPoint( pad->GetPosition() );
+        addPoint( pad->ShapePos() );
+        addSize( pad->GetSize() );
+        addSize( pad->GetDrillSize() );
+        addSize( pad->GetDelta() );
+        add( KiROUND( pad->GetOrientation() ) );
+        add( pad->GetShape() );
+        add( pad->GetDrillShape() );
+        add( pad->GetAttribute() );
+        add( pad->IsOnLayer( GetLayer() ) );
+        add( pad->GetNetCode() );
+        add( pad->GetClearance() );
+        add( GetPadConnection( pad ) );
+        add( GetThermalReliefGap( pad ) );
+        add( GetThermalReliefCopperBridge( pad ) );
+    }
+
+    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+    {
+        for( BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+        {
+            if( item->Type() != PCB_MODULE_EDGE_T )
+                continue;
+
+            if( !item->IsOnLayer( GetLayer() ) && !item->IsOnLayer( Edge_Cuts ) )
+                continue;
+
+            EDGE_MODULE* edge = static_cast<EDGE_MODULE*>( item );
+
+            if( !edge->GetBoundingBox().Intersects( zone_boundingbox ) )
+                continue;
+
+            newRecord( PCB_MODULE_EDGE_T, module->GetTimeStamp() );
+            addRect( edge->GetBoundingBox() );
+            addPoint( edge->GetStart() );
+            addPoint( edge->GetEnd() );
+            add( edge->GetShape() );
+            add( KiROUND( edge->GetAngle() ) );
+            add( edge->GetWidth() );
+            addPolyPoints( edge );
+        }
+    }
+
+    // Tracks of all nets: same net tracks are used to remove islands and thermal stubs
+    for( TRACK* track : tracks )
+    {
+        if( !track->IsOnLayer( GetLayer() ) )
+            continue;
+
+        EDA_RECT item_boundingbox = track->GetBoundingBox();
+        item_boundingbox.Inflate( track->GetClearance() + outline_half_thickness );
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        newRecord( track->Type(), track->GetTimeStamp() );
+        addRect( track->GetBoundingBox() );
+        addPoint( track->GetStart() );
+        addPoint( track->GetEnd() );
+        add( track->GetWidth() );
+        add( track->GetNetCode() );
+        add( track->GetClearance() );
+    }
+
+    for( BOARD_ITEM* item = aPcb->m_Drawings; item; item = item->Next() )
+    {
+        if( item->GetLayer() != GetLayer() && item->GetLayer() != Edge_Cuts )
+            continue;
+
+        if( !item->GetBoundingBox().Intersects( zone_boundingbox ) )
+            continue;
+
+        newRecord( item->Type(), item->GetTimeStamp() );
+        addRect( item->GetBoundingBox() );
+
+        if( item->Type() == PCB_LINE_T )
+        {
+            DRAWSEGMENT* segment = static_cast<DRAWSEGMENT*>( item );
+            addPoint( segment->GetStart() );
+            addPoint( segment->GetEnd() );
+            add( segment->GetShape() );
+            add( KiROUND( segment->GetAngle() ) );
+            add( segment->GetWidth() );
+            addPolyPoints( segment );
+        }
+    }
+
+    // Zones and keepouts knocked out of this zone
+    for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* zone = aPcb->GetArea( ii );
+
+        if( zone == this || zone->GetLayer() != GetLayer() )
+            continue;
+
+        if( !zone->GetBoundingBox().Intersects( zone_boundingbox ) )
+            continue;
+
+        newRecord( PCB_ZONE_AREA_T, zone->GetTimeStamp() );
+        add( zone->GetPriority() );
+        add( zone->GetIsKeepout() );
+        add( zone->GetDoNotAllowCopperPour() );
+        add( zone->GetNetCode() );
+        add( zone->GetClearance() );
+        add( zone->GetMinThickness() );
+        addOutline( zone->Outline() );
+    }
+
+    std::sort( items.begin(), items.end() );
+
+    for( const std::vector<int64_t>& item : items )
+    {
+        aSignature.push_back( item.size() );
+        aSignature.insert( aSignature.end(), item.begin(), item.end() );
+    }
+}
+
+
 /** Helper function fillPolygonWithHorizontalSegments
  * fills a polygon with horizontal segments.
  * It can be used for any angle, if the zone outline to fill is rotated by this angle
@@ -185,9 +475,9 @@ bool ZONE_CONTAINER::FillZoneAreasWithSegments()
     m_FillSegmList.clear();
 
     // Creates the horizontal segments
-    for ( int index = 0; index < m_FilledPolysList.OutlineCount(); index++ )
+    for ( int index = 0; index < m_FilledPolysList->OutlineCount(); index++ )
     {
-        const SHAPE_LINE_CHAIN& outline0 = m_FilledPolysList.COutline( index );
+        const SHAPE_LINE_CHAIN& outline0 = m_FilledPolysList->COutline( index );
         success = fillPolygonWithHorizontalSegments( outline0, m_FillSegmList, grid_size );
 
         if( !success )
@@ -44,6 +44,10 @@
 #include <zones.h>
 
 #include <view/view.h>
+#include <zone_fill_scheduler.h>
+#include <drc_item_index.h>
+
+#include <atomic>
 
 #ifdef PCBNEW_WITH_TRACKITEMS
 #include "trackitems/viastitching.h"
@@ -158,31 +162,70 @@ int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
     // Remove segment zones
     GetBoard()->m_Zone.DeleteAll();
 
-    int ii;
+    std::vector<ZONE_CONTAINER*> zones;
 
-    for( ii = 0; ii < areaCount; ii++ )
+    for( int ii = 0; ii < areaCount; ii++ )
     {
         ZONE_CONTAINER* zoneContainer = GetBoard()->GetArea( ii );
-        if( zoneContainer->GetIsKeepout() )
-            continue;
 
-        msg.Printf( FORMAT_STRING, ii + 1, areaCount, GetChars( zoneContainer->GetNetname() ) );
+        if( !zoneContainer->GetIsKeepout() )
+            zones.push_back( zoneContainer );
+    }
+
+    // Zones are filled on worker threads, the view and ratsnest are updated afterwards
+    // from this thread.  A fill task only modifies its own zone.
+    // Zones with nothing changed around them since their last fill are not rebuilt.
+    // A zone which cannot be filled stops the fill of the zones not yet started, unless
+    // aVerbose is set.
+    // The items near each zone are found in an index of the board pads and tracks, which
+    // is only read by the fill tasks.
+    DRC_ITEM_INDEX      itemIndex( GetBoard() );
+    ZONE_FILL_SCHEDULER scheduler( zones );
+    std::atomic<int>    fillError( 0 );
+    std::atomic<bool>   refilled( false );
+
+    auto fillZone = [&]( ZONE_CONTAINER* aZone )
+    {
+        if( fillError && !aVerbose )
+            return;
 
-        if( progressDialog )
+        if( aZone->RefillIfChanged( GetBoard(), &itemIndex ) )
         {
-            if( !progressDialog->Update( ii+1, msg ) )
-                break;  // Aborted by user
+            refilled = true;
+
+            if( !aZone->IsFilled() )
+                fillError = 1;
         }
+    };
+
+    auto progress = [&]( int aFinished ) -> bool
+    {
+        msg.Printf( _( "Filled %d zones out of %d..." ), aFinished, (int) zones.size() );
+        return progressDialog->Update( aFinished, msg );    // false if aborted by user
+    };
 
-        errorLevel = Fill_Zone( zoneContainer );
+    if( progressDialog )
+        scheduler.Run( fillZone, true, progress );
+    else
+        scheduler.Run( fillZone, true );
 
-        if( errorLevel && !aVerbose )
-            break;
+    scheduler.ReportTimings( wxT( "Fill" ) );
+
+    for( ZONE_CONTAINER* zone : zones )
+    {
+        GetGalCanvas()->GetView()->Update( zone, KIGFX::ALL );
+        GetBoard()->GetRatsnest()->Update( zone );
     }
 
+    errorLevel = fillError;
+
+    // The board is modified only if a zone was actually refilled
+    if( refilled )
+        OnModify();
+
     if( progressDialog )
     {
-        progressDialog->Update( ii+2, _( "Updating ratsnest..." ) );
+        progressDialog->Update( areaCount+1, _( "Updating ratsnest..." ) );
 #ifdef __WXMAC__
         // Work around a dialog z-order issue on OS X
         aActiveWindow->Raise();
@@ -487,7 +487,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList_NG( BOARD* aPcb )
         dumper->Write( &areas_fractured, "areas_fractured" );
 #endif
 
-    m_FilledPolysList = areas_fractured;
+    setFilledPolys( areas_fractured );
 
     // Remove insulated islands:
     if( GetNetCode() > 0 )
@@ -524,7 +524,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList_NG( BOARD* aPcb )
             dumper->Write ( &th_fractured, "th_fractured" );
 #endif
 
-        m_FilledPolysList = th_fractured;
+        setFilledPolys( th_fractured );
 
         if( GetNetCode() > 0 )
             TestForCopperIslandAndRemoveInsulatedIslands( aPcb );
@@ -40,7 +40,7 @@
 
 void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
 {
-    if( m_FilledPolysList.IsEmpty() )
+    if( m_FilledPolysList->IsEmpty() )
         return;
 
     // Build a list of points connected to the net:
@@ -77,7 +77,7 @@ void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
 
     // test if a point is inside
 
-    for( int outline = 0; outline < m_FilledPolysList.OutlineCount(); outline++ )
+    for( int outline = 0; outline < m_FilledPolysList->OutlineCount(); outline++ )
     {
         bool connected = false;
 
@@ -86,7 +86,7 @@ void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
             // test if this area is connected to a board item:
             wxPoint pos = listPointsCandidates[ic];
 
-            if( m_FilledPolysList.Contains( VECTOR2I( pos.x, pos.y ), outline ) )
+            if( m_FilledPolysList->Contains( VECTOR2I( pos.x, pos.y ), outline ) )
             {
                 connected = true;
                 break;
@@ -95,7 +95,7 @@ void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
 
         if( !connected )                 // this polygon is connected: analyse next polygon
         {
-            m_FilledPolysList.DeletePolygon( outline );
+            filledPolys().DeletePolygon( outline );
             outline--;
         }
     }
@@ -0,0 +1,172 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include <fctsys.h>
+#include <plot_common.h>
+
+
+/// Gives access to the number formatters of the plotters
+struct PLOT_NUMBER_FORMATTER : public PLOTTER
+{
+    using PLOTTER::NUMBER_MAX_LEN;
+    using PLOTTER::formatInt;
+    using PLOTTER::formatDouble;
+};
+
+
+static std::string formatInt( int aValue )
+{
+    char buffer[PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN];
+
+    return std::string( buffer, PLOT_NUMBER_FORMATTER::formatInt( buffer, aValue ) );
+}
+
+
+static std::string formatDouble( double aValue )
+{
+    char buffer[PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN];
+
+    return std::string( buffer, PLOT_NUMBER_FORMATTER::formatDouble( buffer, aValue ) );
+}
+
+
+// The plot files are written in the C locale, like the formatters
+static std::string printfInt( int aValue )
+{
+    char buffer[PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN];
+
+    snprintf( buffer, sizeof( buffer ), "%d", aValue );
+    return buffer;
+}
+
+
+static std::string printfDouble( double aValue )
+{
+    char buffer[PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN];
+
+    snprintf( buffer, sizeof( buffer ), "%g", aValue );
+    return buffer;
+}
+
+
+BOOST_AUTO_TEST_SUITE( PlotNumberFormat )
+
+/**
+ * Checks formatInt() on the limits of int.
+ */
+BOOST_AUTO_TEST_CASE( Int )
+{
+    const int values[] = { 0, 1, -1, 9, 10, -10, 12345, -98765, INT_MAX, INT_MIN, INT_MIN + 1 };
+
+    for( int value : values )
+        BOOST_CHECK_EQUAL( formatInt( value ), printfInt( value ) );
+}
+
+/**
+ * Checks formatDouble() on the limits of the fixed notation of %g, where the exponent
+ * notation begins.
+ */
+BOOST_AUTO_TEST_CASE( NotationLimits )
+{
+    const double values[] = { 1e-4, std::nextafter( 1e-4, 0.0 ), 9.99995e-5, 9.99994e-5,
+                              1e6, std::nextafter( 1e6, 0.0 ), 999999.4, 999999.5,
+                              -1e-4, -1e6, 1e-5, 1e7, 1e300, 5e-324 };
+
+    for( double value : values )
+        BOOST_CHECK_EQUAL( formatDouble( value ), printfDouble( value ) );
+}
+
+/**
+ * Checks formatDouble() when the rounding to 6 digits gives one more digit.
+ */
+BOOST_AUTO_TEST_CASE( RoundingCarry )
+{
+    const double values[] = { 9.999995, 9.9999949, 99999.95, 0.9999995, 0.00099999951,
+                              -9.999995, 999.9995, 99.99995, 1.0000005, 3.0000005 };
+
+    for( double value : values )
+        BOOST_CHECK_EQUAL( formatDouble( value ), printfDouble( value ) );
+}
+
+/**
+ * Checks formatDouble() on exact ties, rounded half to even by printf, and on decimal
+ * ties which are not exact in binary.
+ */
+BOOST_AUTO_TEST_CASE( Ties )
+{
+    const double values[] = { 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, 123456.5, 123457.5,
+                              999998.5, 1000.0625, 12345.65, 2.25e-3, 0.0001234565 };
+
+    for( double value : values )
+        BOOST_CHECK_EQUAL( formatDouble( value ), printfDouble( value ) );
+}
+
+/**
+ * Checks formatDouble() on the zeros, infinities and NaN.
+ */
+BOOST_AUTO_TEST_CASE( SpecialValues )
+{
+    const double values[] = { 0.0, -0.0, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(),
+                              std::numeric_limits<double>::quiet_NaN() };
+
+    for( double value : values )
+        BOOST_CHECK_EQUAL( formatDouble( value ), printfDouble( value ) );
+}
+
+/**
+ * Checks formatDouble() on many plot like coordinates and on random binary fractions.
+ */
+BOOST_AUTO_TEST_CASE( Coordinates )
+{
+    unsigned int seed = 1;
+    int          mismatches = 0;
+
+    for( int ii = 0; ii < 1000000; ++ii )
+    {
+        seed = seed * 1103515245u + 12345u;
+
+        double value = (int) seed * 0.0072;
+
+        if( ii & 1 )
+            value = std::ldexp( (double) ( seed >> 8 ), -(int) ( seed % 40 ) );
+
+        if( formatDouble( value ) != printfDouble( value ) )
+        {
+            if( mismatches++ < 10 )
+                BOOST_ERROR( "formatDouble( " << value << " ) gives " << formatDouble( value ) );
+        }
+    }
+
+    BOOST_CHECK_EQUAL( mismatches, 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file connections.cpp
+ * @brief Checks that the subnets computed by CONNECTIONS::TestBoardConnections() are kept
+ * while the board does not change, and computed again, with the same clusters, after a
+ * track is removed, added back, or changes its net.
+ *
+ *      qa_connections board.kicad_pcb
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+#include <common.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connect.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/**
+ * Returns the cluster of each pad of aBoard, then of each track of aTracks, as the index
+ * of the first item of the same net and subnet.  Two computations numbering the subnets
+ * in another order give the same clusters.  The items of subnet 0 are not connected, and
+ * each of them is its own cluster.
+ */
+static std::vector<int> subnetClusters( BOARD* aBoard, const std::vector<TRACK*>& aTracks )
+{
+    std::vector<BOARD_CONNECTED_ITEM*> items;
+
+    for( unsigned ii = 0; ii < aBoard->GetPadCount(); ii++ )
+        items.push_back( aBoard->GetPad( ii ) );
+
+    items.insert( items.end(), aTracks.begin(), aTracks.end() );
+
+    std::map<std::pair<int, int>, int> firstItems;
+    std::vector<int>                   clusters;
+
+    for( int ii = 0; ii < (int) items.size(); ii++ )
+    {
+        int subnet = items[ii]->GetSubNet();
+
+        if( subnet == 0 )
+        {
+            clusters.push_back( ii );
+            continue;
+        }
+
+        auto key = std::make_pair( items[ii]->GetNetCode(), subnet );
+        clusters.push_back( firstItems.insert( std::make_pair( key, ii ) ).first->second );
+    }
+
+    return clusters;
+}
+
+
+static int failures = 0;
+
+static void check( bool aSuccess, const char* aWhat )
+{
+    printf( "%s: %s\n", aWhat, aSuccess ? "OK" : "FAILED" );
+
+    if( !aSuccess )
+        failures++;
+}
+
+
+static bool isConnectionOk( BOARD* aBoard )
+{
+    return ( aBoard->m_Status_Pcb & CONNEXION_OK ) != 0;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s board.kicad_pcb\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM             program( argc, argv );
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    board->BuildListOfNets();
+
+    std::vector<TRACK*> tracks;
+    std::vector<TRACK*> segments;
+
+    for( TRACK* track = board->m_Track; track; track = track->Next() )
+    {
+        tracks.push_back( track );
+
+        if( track->Type() == PCB_TRACE_T && track->GetNetCode() > 0 )
+            segments.push_back( track );
+    }
+
+    if( segments.empty() )
+    {
+        printf( "board: %s has no track segment in a net\n", argv[1] );
+        return 1;
+    }
+
+    TRACK* edited = segments[segments.size() / 2];
+
+    board->m_Status_Pcb &= ~CONNEXION_OK;
+
+    PROF_COUNTER timer;
+    CONNECTIONS::TestBoardConnections( board.get() );
+    double time = timer.msecs();
+
+    printf( "board: %s, %u pads, %u tracks, connections in %.1f ms\n", argv[1],
+            board->GetPadCount(), (unsigned) tracks.size(), time );
+
+    check( isConnectionOk( board.get() ), "connections computed" );
+
+    std::vector<int> expected = subnetClusters( board.get(), tracks );
+
+    // A subnet changed by hand shows whether the subnets are computed again
+    int subnet = edited->GetSubNet();
+    edited->SetSubNet( subnet + 1000000 );
+
+    timer.Start();
+    CONNECTIONS::TestBoardConnections( board.get() );
+    time = timer.msecs();
+
+    check( edited->GetSubNet() == subnet + 1000000, "unchanged board: connections kept" );
+    printf( "    kept in %.3f ms\n", time );
+    edited->SetSubNet( subnet );
+
+    board->Remove( edited );
+    check( !isConnectionOk( board.get() ), "track removed: connections invalidated" );
+
+    CONNECTIONS::TestBoardConnections( board.get() );
+    check( isConnectionOk( board.get() ), "track removed: connections computed" );
+
+    board->Add( edited, ADD_INSERT );
+    check( !isConnectionOk( board.get() ), "track added: connections invalidated" );
+
+    CONNECTIONS::TestBoardConnections( board.get() );
+    check( subnetClusters( board.get(), tracks ) == expected,
+           "track added back: same subnets as before" );
+
+    // The tracks have to stay sorted by net, so the net is changed back before the test
+    int netCode = edited->GetNetCode();
+    edited->SetNetCode( 0 );
+    check( !isConnectionOk( board.get() ), "net changed: connections invalidated" );
+
+    edited->SetNetCode( netCode );
+    CONNECTIONS::TestBoardConnections( board.get() );
+    check( subnetClusters( board.get(), tracks ) == expected,
+           "net changed back: same subnets as before" );
+
+    printf( "%s\n", failures ? "FAILED" : "OK" );
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drc_tracks.cpp
+ * @brief Runs the track clearance test of the DRC on a board, without display, in one
+ * thread and then in several threads, and checks that both find the same markers in
+ * the same order.
+ *
+ *      qa_drc_tracks board.kicad_pcb [thread count] [run count]
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+#include <common.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <drc_stuff.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/**
+ * Runs the track clearance test with aThreadCount threads.
+ * @return the reports of the markers, in the order they would be added to the board
+ */
+static std::vector<wxString> testTracks( BOARD* aBoard, size_t aThreadCount, double& aTime )
+{
+    DRC                      drc( aBoard );
+    PROF_COUNTER             timer;
+    std::vector<MARKER_PCB*> markers = drc.TestTrackClearances( aThreadCount );
+    std::vector<wxString>    reports;
+
+    aTime = timer.msecs();
+
+    for( MARKER_PCB* marker : markers )
+    {
+        reports.push_back( marker->GetReporter().ShowReport() );
+        delete marker;
+    }
+
+    return reports;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s board.kicad_pcb [thread count] [run count]\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM             program( argc, argv );
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    size_t threadCount = std::max( 2u, std::thread::hardware_concurrency() );
+    int    runCount = 5;
+
+    if( argc > 2 )
+        threadCount = std::max( 2, atoi( argv[2] ) );
+
+    if( argc > 3 )
+        runCount = std::max( 1, atoi( argv[3] ) );
+
+    double                serialTime;
+    std::vector<wxString> expected = testTracks( board.get(), 1, serialTime );
+    int                   failures = 0;
+
+    printf( "board: %s, %u markers in %.1f ms with 1 thread\n", argv[1],
+            (unsigned) expected.size(), serialTime );
+
+    // The threads share the segments in a different way on each run
+    for( int run = 0; run < runCount; run++ )
+    {
+        double                time;
+        std::vector<wxString> found = testTracks( board.get(), threadCount, time );
+
+        printf( "run %d: %u markers in %.1f ms with %u threads\n", run,
+                (unsigned) found.size(), time, (unsigned) threadCount );
+
+        if( found == expected )
+            continue;
+
+        failures++;
+
+        for( size_t ii = 0; ii < std::max( found.size(), expected.size() ); ii++ )
+        {
+            if( ii < found.size() && ii < expected.size() && found[ii] == expected[ii] )
+                continue;
+
+            printf( "first different marker: %u\nexpected:\n%sfound:\n%s", (unsigned) ii,
+                    ii < expected.size() ? TO_UTF8( expected[ii] ) : "none\n",
+                    ii < found.size() ? TO_UTF8( found[ii] ) : "none\n" );
+            break;
+        }
+    }
+
+    printf( "%s\n", failures ? "FAILED" : "OK" );
+
+    return failures ? 1 : 0;
+}
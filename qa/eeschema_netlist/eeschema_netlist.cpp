@@ -0,0 +1,353 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file eeschema_netlist.cpp
+ * @brief Builds the netlist of a schematic, without display, and compares its nets with
+ * a reference netlist.
+ *
+ * The nets are compared by name and by their set of pins, so the net codes, the order
+ * of the nets and the order of the pins in a net do not matter.  The reference netlists
+ * are written by this program with --write, from a build of the connection code without
+ * the index of the items, and show that the index finds the same nets.
+ *
+ *      qa_eeschema_netlist schematic.sch reference.net
+ *      qa_eeschema_netlist --write schematic.sch reference.net
+ */
+
+#include <fctsys.h>
+#include <kiway.h>
+#include <richio.h>
+#include <common.h>
+#include <wildcards_and_files_ext.h>
+#include <netlist_lexer.h>
+
+#include <wx/filename.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <general.h>
+#include <sch_io_mgr.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <class_sch_screen.h>
+#include <class_library.h>
+#include <class_netlist_object.h>
+#include <netlist_exporters/netlist_exporter_kicad.h>
+
+#include <qa_program.h>
+
+using namespace NL_T;
+
+
+/// The pins of each net, as "ref pin" strings, by net name
+typedef std::map<std::string, std::set<std::string>> NETS;
+
+
+/**
+ * Class NETS_PARSER
+ * reads the nets section of a netlist in the KiCad s-expression format, with the lexer
+ * of KICAD_NETLIST_PARSER.  The other sections are skipped.
+ */
+class NETS_PARSER : public NETLIST_LEXER
+{
+public:
+    NETS_PARSER( LINE_READER* aReader ) :
+        NETLIST_LEXER( aReader )
+    {}
+
+    NETS_PARSER( const std::string& aText, const wxString& aSource ) :
+        NETLIST_LEXER( aText, aSource )
+    {}
+
+    /**
+     * Function Parse
+     * @return the nets of the netlist
+     * @throw IO_ERROR if the netlist cannot be read
+     */
+    NETS Parse();
+
+private:
+    /// Skips the current section, up to its closing parenthesis
+    void skipCurrent();
+
+    /// Reads a section like (net (code 1) (name /PC-A0) (node (ref U3) (pin 3)) ...)
+    void parseNet( NETS& aNets );
+};
+
+
+void NETS_PARSER::skipCurrent()
+{
+    int level = 0;
+    T   token;
+
+    while( ( token = NextTok() ) != T_EOF )
+    {
+        if( token == T_LEFT )
+            level--;
+
+        if( token == T_RIGHT && ++level > 0 )
+            return;
+    }
+}
+
+
+NETS NETS_PARSER::Parse()
+{
+    NETS nets;
+    T    token;
+
+    while( ( token = NextTok() ) != T_EOF )
+    {
+        if( token == T_LEFT )
+            token = NextTok();
+
+        switch( token )
+        {
+        case T_export:      // the sections are in export
+        case T_RIGHT:       // the end of export
+            break;
+
+        case T_nets:
+            while( ( token = NextTok() ) != T_RIGHT )
+            {
+                if( token == T_LEFT )
+                    token = NextTok();
+
+                if( token == T_net )
+                    parseNet( nets );
+                else
+                    skipCurrent();
+            }
+
+            break;
+
+        default:
+            skipCurrent();
+            break;
+        }
+    }
+
+    return nets;
+}
+
+
+void NETS_PARSER::parseNet( NETS& aNets )
+{
+    std::string           name;
+    std::set<std::string> pins;
+    T                     token;
+
+    while( ( token = NextTok() ) != T_RIGHT )
+    {
+        if( token == T_LEFT )
+            token = NextTok();
+
+        switch( token )
+        {
+        case T_name:
+            NeedSYMBOLorNUMBER();
+            name = CurText();
+            NeedRIGHT();
+            break;
+
+        case T_node:
+        {
+            std::string reference;
+            std::string pin;
+
+            while( ( token = NextTok() ) != T_RIGHT )
+            {
+                if( token == T_LEFT )
+                    token = NextTok();
+
+                switch( token )
+                {
+                case T_ref:
+                    NeedSYMBOLorNUMBER();
+                    reference = CurText();
+                    NeedRIGHT();
+                    break;
+
+                case T_pin:
+                    NeedSYMBOLorNUMBER();
+                    pin = CurText();
+                    NeedRIGHT();
+                    break;
+
+                default:
+                    skipCurrent();
+                    break;
+                }
+            }
+
+            pins.insert( reference + " " + pin );
+            break;
+        }
+
+        default:
+            skipCurrent();
+            break;
+        }
+    }
+
+    aNets[name].insert( pins.begin(), pins.end() );
+}
+
+
+/**
+ * Loads a schematic and its libraries, like SCH_EDIT_FRAME::OpenProjectFiles(), and
+ * formats the nets section of its netlist to aFormatter, like
+ * SCH_EDIT_FRAME::CreateNetlist().
+ */
+static void buildNetlist( KIWAY& aKiway, const wxFileName& aSchematic,
+                          OUTPUTFORMATTER* aFormatter )
+{
+    wxFileName pro = aSchematic;
+    pro.SetExt( ProjectFileExtension );
+
+    aKiway.Prj().SetProjectFullName( pro.GetFullPath() );
+
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+    g_RootSheet = pi->Load( aSchematic.GetFullPath(), &aKiway );
+
+    PART_LIBS*  libs = aKiway.Prj().SchLibs();
+    SCH_SCREENS schematic;
+
+    schematic.UpdateSymbolLinks();
+
+    SCH_SHEET_LIST sheets( g_RootSheet );
+    sheets.AnnotatePowerSymbols( libs );
+    schematic.SchematicCleanUp();
+
+    std::unique_ptr<NETLIST_OBJECT_LIST> netAtoms( new NETLIST_OBJECT_LIST() );
+    netAtoms->BuildNetListInfo( sheets );
+
+    // The exporter owns the list
+    NETLIST_EXPORTER_KICAD exporter( netAtoms.release(), libs );
+
+    exporter.Format( aFormatter, GNL_NETS );
+}
+
+
+/**
+ * Compares the nets of a netlist with the expected ones, and prints their differences.
+ * @return the number of differences
+ */
+static int compareNets( const NETS& aNets, const NETS& aExpected )
+{
+    int errors = 0;
+
+    for( const auto& net : aExpected )
+    {
+        auto found = aNets.find( net.first );
+
+        if( found == aNets.end() )
+        {
+            printf( "missing net '%s'\n", net.first.c_str() );
+            errors++;
+        }
+        else if( found->second != net.second )
+        {
+            printf( "net '%s' has different pins:", net.first.c_str() );
+
+            for( const std::string& pin : found->second )
+                printf( " %s", pin.c_str() );
+
+            printf( "\n" );
+            errors++;
+        }
+    }
+
+    for( const auto& net : aNets )
+    {
+        if( !aExpected.count( net.first ) )
+        {
+            printf( "unexpected net '%s'\n", net.first.c_str() );
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    bool write = argc > 1 && strcmp( argv[1], "--write" ) == 0;
+    int  arg = write ? 2 : 1;
+
+    if( argc < arg + 2 )
+    {
+        printf( "usage: %s [--write] schematic.sch reference.net\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM program( argc, argv );
+    KIWAY      kiway( program.GetProgram(), KFCTL_STANDALONE );
+    wxFileName schematic( FROM_UTF8( argv[arg] ) );
+    wxString   reference = FROM_UTF8( argv[arg + 1] );
+    int        errors = 0;
+
+    schematic.MakeAbsolute();
+
+    try
+    {
+        if( write )
+        {
+            FILE_OUTPUTFORMATTER formatter( reference );
+
+            buildNetlist( kiway, schematic, &formatter );
+            printf( "%s: written to %s\n", argv[arg], argv[arg + 1] );
+        }
+        else
+        {
+            STRING_FORMATTER formatter;
+            buildNetlist( kiway, schematic, &formatter );
+
+            FILE_LINE_READER reader( reference );
+            NETS_PARSER      referenceParser( &reader );
+            NETS_PARSER      netlistParser( formatter.GetString(), schematic.GetFullPath() );
+            NETS             nets = netlistParser.Parse();
+
+            errors = compareNets( nets, referenceParser.Parse() );
+            printf( "%s: %u nets, %d differences\n", argv[arg], (unsigned) nets.size(),
+                    errors );
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "%s\n", TO_UTF8( ioe.What() ) );
+        errors = 1;
+    }
+
+    delete g_RootSheet;
+    g_RootSheet = NULL;
+
+    return errors ? 1 : 0;
+}
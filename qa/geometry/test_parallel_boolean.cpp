@@ -0,0 +1,246 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_line_chain.h>
+
+/**
+ * Fixture for the parallel boolean operations tests: the sets are big enough to be split
+ * in several buckets.
+ *      1. holes: a grid of octagons, overlapping in groups of three along the rows.
+ *      2. plane: two big rectangles, each one covering a part of the grid.
+ *      3. strips: thin rectangles crossing the grid columns.
+ */
+struct ParallelBooleanFixture
+{
+    SHAPE_POLY_SET holes;
+    SHAPE_POLY_SET plane;
+    SHAPE_POLY_SET strips;
+
+    static SHAPE_LINE_CHAIN octagon( int aX, int aY, int aRadius )
+    {
+        SHAPE_LINE_CHAIN path;
+
+        for( int ii = 0; ii < 8; ++ii )
+        {
+            double angle = ii * M_PI / 4.0;
+            path.Append( aX + int( aRadius * cos( angle ) ), aY + int( aRadius * sin( angle ) ) );
+        }
+
+        path.SetClosed( true );
+
+        return path;
+    }
+
+    static SHAPE_LINE_CHAIN rectangle( int aX0, int aY0, int aX1, int aY1 )
+    {
+        SHAPE_LINE_CHAIN path;
+
+        path.Append( aX0, aY0 );
+        path.Append( aX1, aY0 );
+        path.Append( aX1, aY1 );
+        path.Append( aX0, aY1 );
+        path.SetClosed( true );
+
+        return path;
+    }
+
+    ParallelBooleanFixture()
+    {
+        const int pitch = 1000;
+
+        for( int row = 0; row < 40; ++row )
+        {
+            for( int col = 0; col < 40; ++col )
+            {
+                // Octagons of the same group of three overlap
+                int x = col * pitch - ( col % 3 ) * pitch / 3;
+                holes.AddOutline( octagon( x, row * pitch, 400 ) );
+            }
+        }
+
+        plane.AddOutline( rectangle( -2000, -2000, 15000, 41000 ) );
+        plane.AddOutline( rectangle( 20000, 5000, 41000, 30000 ) );
+
+        for( int col = 0; col < 40; col += 4 )
+            strips.AddOutline( rectangle( col * pitch - 100, -1000, col * pitch + 100, 20000 ) );
+    }
+};
+
+/**
+ * Checks that two polygon sets cover exactly the same area, with the same polygon and
+ * hole counts.
+ */
+static bool sameArea( const SHAPE_POLY_SET& aFirst, const SHAPE_POLY_SET& aSecond )
+{
+    SHAPE_POLY_SET firstOnly = aFirst;
+    firstOnly.BooleanSubtract( aSecond, SHAPE_POLY_SET::PM_FAST );
+
+    SHAPE_POLY_SET secondOnly = aSecond;
+    secondOnly.BooleanSubtract( aFirst, SHAPE_POLY_SET::PM_FAST );
+
+    int firstHoles = 0;
+    int secondHoles = 0;
+
+    for( int ii = 0; ii < aFirst.OutlineCount(); ++ii )
+        firstHoles += aFirst.HoleCount( ii );
+
+    for( int ii = 0; ii < aSecond.OutlineCount(); ++ii )
+        secondHoles += aSecond.HoleCount( ii );
+
+    return firstOnly.IsEmpty() && secondOnly.IsEmpty()
+           && aFirst.OutlineCount() == aSecond.OutlineCount()
+           && firstHoles == secondHoles;
+}
+
+BOOST_FIXTURE_TEST_SUITE( ParallelBoolean, ParallelBooleanFixture )
+
+/**
+ * Checks that the parallel union merges the overlapping holes like the serial one.
+ */
+BOOST_AUTO_TEST_CASE( Simplify )
+{
+    SHAPE_POLY_SET serial = holes;
+    SHAPE_POLY_SET parallel = holes;
+
+    serial.Simplify( SHAPE_POLY_SET::PM_FAST );
+    parallel.Simplify( SHAPE_POLY_SET::PM_FAST, true );
+
+    // Each group of three octagons is merged in a single polygon
+    BOOST_CHECK_EQUAL( serial.OutlineCount(), 40 * 14 );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks the union of two sets, and of a set with itself.
+ */
+BOOST_AUTO_TEST_CASE( Add )
+{
+    SHAPE_POLY_SET serial = holes;
+    SHAPE_POLY_SET parallel = holes;
+
+    serial.BooleanAdd( strips, SHAPE_POLY_SET::PM_FAST );
+    parallel.BooleanAdd( strips, SHAPE_POLY_SET::PM_FAST, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+
+    serial.BooleanAdd( holes, plane, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    parallel.BooleanAdd( holes, plane, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+
+    parallel.BooleanAdd( parallel, SHAPE_POLY_SET::PM_FAST, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks the subtraction of many holes from a few big polygons, like in zone filling.
+ */
+BOOST_AUTO_TEST_CASE( Subtract )
+{
+    SHAPE_POLY_SET serial = plane;
+    SHAPE_POLY_SET parallel = plane;
+
+    serial.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    parallel.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+
+    serial.BooleanSubtract( holes, strips, SHAPE_POLY_SET::PM_FAST );
+    parallel.BooleanSubtract( holes, strips, SHAPE_POLY_SET::PM_FAST, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks the intersection, where some polygons of a set have no counterpart in the other one.
+ */
+BOOST_AUTO_TEST_CASE( Intersection )
+{
+    SHAPE_POLY_SET serial = holes;
+    SHAPE_POLY_SET parallel = holes;
+
+    serial.BooleanIntersection( strips, SHAPE_POLY_SET::PM_FAST );
+    parallel.BooleanIntersection( strips, SHAPE_POLY_SET::PM_FAST, true );
+    BOOST_CHECK( !serial.IsEmpty() );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+
+    serial.BooleanIntersection( plane, holes, SHAPE_POLY_SET::PM_FAST );
+    parallel.BooleanIntersection( plane, holes, SHAPE_POLY_SET::PM_FAST, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks that polygons which are apart before an inflation, but touch after it, are merged.
+ */
+BOOST_AUTO_TEST_CASE( Inflate )
+{
+    SHAPE_POLY_SET serial = holes;
+    SHAPE_POLY_SET parallel = holes;
+
+    serial.Inflate( 150, 16 );
+    parallel.Inflate( 150, 16, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+
+    serial.Inflate( -300, 16 );
+    parallel.Inflate( -300, 16, true );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks that the fractured polygons have no holes, and cover the same area.
+ */
+BOOST_AUTO_TEST_CASE( Fracture )
+{
+    SHAPE_POLY_SET serial = plane;
+    SHAPE_POLY_SET parallel = plane;
+
+    serial.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    parallel.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE, true );
+
+    serial.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    parallel.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE, true );
+
+    BOOST_CHECK( !parallel.HasHoles() );
+    BOOST_CHECK( sameArea( serial, parallel ) );
+}
+
+/**
+ * Checks that small sets give the serial result, polygon by polygon.
+ */
+BOOST_AUTO_TEST_CASE( SmallSet )
+{
+    SHAPE_POLY_SET serial = strips;
+    SHAPE_POLY_SET parallel = strips;
+
+    serial.BooleanAdd( plane, SHAPE_POLY_SET::PM_FAST );
+    parallel.BooleanAdd( plane, SHAPE_POLY_SET::PM_FAST, true );
+
+    BOOST_REQUIRE_EQUAL( serial.OutlineCount(), parallel.OutlineCount() );
+
+    for( int ii = 0; ii < serial.OutlineCount(); ++ii )
+    {
+        BOOST_CHECK_EQUAL( serial.COutline( ii ).PointCount(),
+                           parallel.COutline( ii ).PointCount() );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
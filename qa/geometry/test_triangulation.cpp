@@ -0,0 +1,272 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_line_chain.h>
+#include <profile.h>
+
+/**
+ * Fixture for the triangulation tests:
+ *      1. comb: a concave polygon, with long teeth.
+ *      2. fill: a large zone fill, a plane with a grid of round holes, fractured.
+ */
+struct TriangulationFixture
+{
+    SHAPE_POLY_SET comb;
+    SHAPE_POLY_SET fill;
+
+    TriangulationFixture()
+    {
+        SHAPE_LINE_CHAIN path;
+
+        for( int ii = 0; ii < 50; ++ii )
+        {
+            path.Append( ii * 1000, 0 );
+            path.Append( ii * 1000 + 500, 20000 );
+        }
+
+        path.Append( 50000, 0 );
+        path.Append( 50000, -1000 );
+        path.Append( 0, -1000 );
+        path.SetClosed( true );
+        comb.AddOutline( path );
+
+        SHAPE_LINE_CHAIN plane;
+
+        plane.Append( -1000, -1000 );
+        plane.Append( 100000, -1000 );
+        plane.Append( 100000, 100000 );
+        plane.Append( -1000, 100000 );
+        plane.SetClosed( true );
+        fill.AddOutline( plane );
+
+        SHAPE_POLY_SET holes;
+
+        for( int row = 0; row < 50; ++row )
+        {
+            for( int col = 0; col < 50; ++col )
+            {
+                SHAPE_LINE_CHAIN hole;
+
+                for( int ii = 0; ii < 16; ++ii )
+                {
+                    double angle = ii * M_PI / 8.0;
+                    hole.Append( col * 2000 + int( 600 * cos( angle ) ),
+                                 row * 2000 + int( 600 * sin( angle ) ) );
+                }
+
+                hole.SetClosed( true );
+                holes.AddOutline( hole );
+            }
+        }
+
+        fill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+        fill.Fracture( SHAPE_POLY_SET::PM_FAST );
+    }
+};
+
+
+// Twice the signed area of a contour
+static double contourArea( const SHAPE_LINE_CHAIN& aPath )
+{
+    double area = 0.0;
+
+    for( int ii = 0, jj = aPath.PointCount() - 1; ii < aPath.PointCount(); jj = ii++ )
+    {
+        const VECTOR2I& a = aPath.CPoint( jj );
+        const VECTOR2I& b = aPath.CPoint( ii );
+        area += double( a.x ) * b.y - double( b.x ) * a.y;
+    }
+
+    return area;
+}
+
+
+// Twice the area of the polygons, holes excluded
+static double polySetArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        area += std::abs( contourArea( aSet.COutline( ii ) ) );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            area -= std::abs( contourArea( aSet.CHole( ii, jj ) ) );
+    }
+
+    return area;
+}
+
+
+/**
+ * Checks that the triangles have the same orientation, and cover the area of the set: as
+ * they cannot overlap without covering more area, they tile the polygons.
+ */
+static bool coversSet( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+    int    positive = 0;
+    int    negative = 0;
+
+    for( unsigned int ii = 0; ii < aSet.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri = aSet.TriangulatedPolygon( ii );
+
+        for( int jj = 0; jj < tri->GetTriangleCount(); ++jj )
+        {
+            VECTOR2I a, b, c;
+            tri->GetTriangle( jj, a, b, c );
+
+            double triArea = double( b.x - a.x ) * ( c.y - a.y )
+                             - double( b.y - a.y ) * ( c.x - a.x );
+
+            if( triArea > 0 )
+                positive++;
+            else if( triArea < 0 )
+                negative++;
+
+            area += std::abs( triArea );
+        }
+    }
+
+    double expected = polySetArea( aSet );
+
+    return ( positive == 0 || negative == 0 ) && std::abs( area - expected ) <= 1e-9 * expected;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( Triangulation, TriangulationFixture )
+
+/**
+ * Checks the triangles of a concave polygon, in both orientations.
+ */
+BOOST_AUTO_TEST_CASE( Concave )
+{
+    comb.CacheTriangulation();
+
+    BOOST_CHECK( comb.IsTriangulationUpToDate() );
+    BOOST_REQUIRE_EQUAL( comb.TriangulatedPolyCount(), 1 );
+    BOOST_CHECK_EQUAL( comb.TriangulatedPolygon( 0 )->GetTriangleCount(),
+                       comb.COutline( 0 ).PointCount() - 2 );
+    BOOST_CHECK( coversSet( comb ) );
+
+    SHAPE_POLY_SET reversed;
+    reversed.AddOutline( comb.COutline( 0 ).Reverse() );
+    reversed.CacheTriangulation();
+
+    BOOST_CHECK( reversed.IsTriangulationUpToDate() );
+    BOOST_CHECK( coversSet( reversed ) );
+}
+
+/**
+ * Checks the triangles of a large fractured zone fill, whose slits are overlapping edges,
+ * and reports the triangulation time.
+ */
+BOOST_AUTO_TEST_CASE( ZoneFill )
+{
+    BOOST_REQUIRE( !fill.HasHoles() );
+
+    PROF_COUNTER timer;
+    fill.CacheTriangulation();
+    double time = timer.msecs();
+
+    BOOST_TEST_MESSAGE( "triangulation of " << fill.TotalVertices() << " vertices: "
+                        << time << " ms" );
+
+    BOOST_CHECK( fill.IsTriangulationUpToDate() );
+    BOOST_CHECK( coversSet( fill ) );
+}
+
+/**
+ * Checks that the polygons with holes are fractured before the triangulation.
+ */
+BOOST_AUTO_TEST_CASE( Holes )
+{
+    SHAPE_POLY_SET plate = comb;
+    SHAPE_LINE_CHAIN hole;
+
+    hole.Append( 10000, -500 );
+    hole.Append( 10000, -200 );
+    hole.Append( 40000, -200 );
+    hole.Append( 40000, -500 );
+    hole.SetClosed( true );
+    plate.AddHole( hole );
+
+    plate.CacheTriangulation();
+
+    BOOST_CHECK( plate.IsTriangulationUpToDate() );
+    BOOST_CHECK( coversSet( plate ) );
+}
+
+/**
+ * Checks that the triangles are invalidated by a change of the polygons, kept by a move,
+ * and shared by the copies.
+ */
+BOOST_AUTO_TEST_CASE( Cache )
+{
+    comb.CacheTriangulation();
+
+    SHAPE_POLY_SET copy = comb;
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolygon( 0 ), comb.TriangulatedPolygon( 0 ) );
+
+    // A const access keeps the triangles, a new call does not build them again
+    const SHAPE_POLY_SET& constCopy = copy;
+    int vertexCount = 0;
+
+    for( auto it = constCopy.CIterateWithHoles(); it; it++ )
+        vertexCount++;
+
+    copy.CacheTriangulation();
+    BOOST_CHECK_EQUAL( vertexCount, comb.TotalVertices() );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolygon( 0 ), comb.TriangulatedPolygon( 0 ) );
+
+    copy.Vertex( 3, 0, -1 ).y += 100;
+    BOOST_CHECK( !copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( comb.IsTriangulationUpToDate() );
+
+    copy.CacheTriangulation();
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( coversSet( copy ) );
+
+    VECTOR2I a, b, c;
+    comb.TriangulatedPolygon( 0 )->GetTriangle( 0, a, b, c );
+
+    copy = comb;
+    copy.Move( VECTOR2I( 1000, -2000 ) );
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( coversSet( copy ) );
+
+    VECTOR2I movedA, movedB, movedC;
+    copy.TriangulatedPolygon( 0 )->GetTriangle( 0, movedA, movedB, movedC );
+    BOOST_CHECK( movedA == a + VECTOR2I( 1000, -2000 ) );
+
+    // The original triangles are not moved
+    comb.TriangulatedPolygon( 0 )->GetTriangle( 0, movedA, movedB, movedC );
+    BOOST_CHECK( movedA == a );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file net_scan_perf.cpp
+ * @brief Looks for the vias and the pads at the ends of all the tracks of a board, with
+ * the net scans of the track items, without and with their per net spatial index
+ * (TRACKITEMS::NET_SCAN_INDEX), and reports the times.
+ *
+ * Both runs must find the same items.
+ *
+ *      qa_net_scan_perf board.kicad_pcb [run count]
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+#include <common.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <trackitems/trackitems.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/**
+ * Looks for the via and the pad at both ends of each track, like the teardrop and sharp
+ * angle operations do.
+ * @return the items found, in the track order
+ */
+static std::vector<const BOARD_ITEM*> scanTrackEnds( BOARD* aBoard, int aRunCount, double& aTime )
+{
+    std::vector<const BOARD_ITEM*> found;
+    TRACKITEMS*                    trackItems = aBoard->TrackItems();
+    PROF_COUNTER                   timer;
+
+    for( int run = 0; run < aRunCount; run++ )
+    {
+        found.clear();
+
+        for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+        {
+            if( track->Type() != PCB_TRACE_T )
+                continue;
+
+            found.push_back( trackItems->StartPosVia( track ) );
+            found.push_back( trackItems->EndPosVia( track ) );
+            found.push_back( trackItems->StartPosPad( track ) );
+            found.push_back( trackItems->EndPosPad( track ) );
+        }
+    }
+
+    aTime = timer.msecs();
+
+    return found;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s board.kicad_pcb [run count]\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM             program( argc, argv );
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    int runCount = argc > 2 ? std::max( 1, atoi( argv[2] ) ) : 3;
+    int trackCount = 0;
+
+    for( TRACK* track = board->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() == PCB_TRACE_T )
+            trackCount++;
+    }
+
+    printf( "board: %s, %d tracks, %d nets\n", argv[1], trackCount,
+            (int) board->GetNetCount() );
+
+    double linearTime;
+    std::vector<const BOARD_ITEM*> expected = scanTrackEnds( board.get(), runCount, linearTime );
+
+    // The index is built at the first query of each net, and dropped by Disable()
+    double indexedTime;
+    board->TrackItems()->NetScanIndex()->Enable();
+    std::vector<const BOARD_ITEM*> found = scanTrackEnds( board.get(), runCount, indexedTime );
+    board->TrackItems()->NetScanIndex()->Disable();
+
+    int itemCount = std::count_if( expected.begin(), expected.end(),
+                                   []( const BOARD_ITEM* aItem ) { return aItem != NULL; } );
+
+    printf( "%d runs, %d vias and pads found per run\n", runCount, itemCount );
+    printf( "    net walk:      %10.1f ms\n", linearTime );
+    printf( "    spatial index: %10.1f ms\n", indexedTime );
+
+    if( found != expected )
+    {
+        printf( "the indexed scans found other items\n" );
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,468 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_perf.cpp
+ * @brief Plots the enabled layers of a board in several formats, without display, and
+ * reports the plot times and the file sizes.
+ *
+ * The number formatting of the plotters is compared with printf, and the output of the
+ * plot coordinates with the old path (fprintf to a file with the default buffer).  The
+ * PDF files are plotted with several compression levels, and the layers are plotted one
+ * after the other, then as a batch by PLOT_CONTROLLER::PlotLayers().
+ *
+ *      qa_plot_perf board.kicad_pcb [output directory]
+ *
+ * With --compare, the layers are plotted one after the other by PLOT_CONTROLLER::PlotLayer()
+ * and as a batch in Gerber, PostScript and SVG, and the files are compared, without their
+ * date stamps.  The exit code is not 0 if they differ.
+ *
+ *      qa_plot_perf --compare board.kicad_pcb [output directory]
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+#include <common.h>
+
+#include <wx/filename.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <class_board.h>
+#include <plot_common.h>
+#include <pcbplot.h>
+#include <plotcontroller.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/// Gives access to the number formatters of the plotters
+struct PLOT_NUMBER_FORMATTER : public PLOTTER
+{
+    using PLOTTER::NUMBER_MAX_LEN;
+    using PLOTTER::formatInt;
+    using PLOTTER::formatDouble;
+    using PLOTTER::setFileBuffer;
+    using PLOTTER::writeCoords;
+};
+
+
+/**
+ * Formats as many numbers as the coordinates of a large plot, with printf and with the
+ * plotter formatters.
+ */
+static void benchmarkFormatting()
+{
+    const int           count = 4000000;
+    std::vector<int>    ints( count );
+    std::vector<double> doubles( count );
+    unsigned int        seed = 1;
+
+    for( int ii = 0; ii < count; ii++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        ints[ii] = int( seed % 200000000 ) - 100000000;
+        doubles[ii] = ints[ii] * 0.0072;
+    }
+
+    char   buffer[PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN];
+    size_t length = 0;
+
+    LOCALE_IO toggle;
+
+    PROF_COUNTER timer;
+
+    for( int value : ints )
+        length += snprintf( buffer, sizeof( buffer ), "%d", value );
+
+    double printfInt = timer.msecs();
+    timer.Start();
+
+    for( int value : ints )
+        length += PLOT_NUMBER_FORMATTER::formatInt( buffer, value ) - buffer;
+
+    double formatInt = timer.msecs();
+    timer.Start();
+
+    for( double value : doubles )
+        length += snprintf( buffer, sizeof( buffer ), "%g", value );
+
+    double printfDouble = timer.msecs();
+    timer.Start();
+
+    for( double value : doubles )
+        length += PLOT_NUMBER_FORMATTER::formatDouble( buffer, value ) - buffer;
+
+    double formatDouble = timer.msecs();
+
+    printf( "formatting %d numbers (%u chars):\n", count, (unsigned) length );
+    printf( "    int:    printf %8.1f ms, formatInt    %8.1f ms\n", printfInt, formatInt );
+    printf( "    double: printf %8.1f ms, formatDouble %8.1f ms\n", printfDouble, formatDouble );
+}
+
+
+// Reads a whole file, to compare the outputs
+static std::string readFile( const wxString& aFileName )
+{
+    std::string content;
+    FILE*       file = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !file )
+        return content;
+
+    char   buffer[4096];
+    size_t count;
+
+    while( ( count = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+        content.append( buffer, count );
+
+    fclose( file );
+    return content;
+}
+
+
+/**
+ * Writes the coordinates of a large plot to files, like the Gerber D codes and the
+ * PostScript and PDF path points, first by the old output path: fprintf to a file with
+ * the default stdio buffer, then by the new one: the plotter formatters, to a file with
+ * the plotter buffer.  Reports the times and checks that the files are the same.
+ */
+static void benchmarkOutput( const wxFileName& aOutputDir )
+{
+    const int        count = 2000000;
+    std::vector<int> ints( count );
+    unsigned int     seed = 7;
+
+    for( int ii = 0; ii < count; ii++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        ints[ii] = int( seed % 200000000 ) - 100000000;
+    }
+
+    wxString oldName = wxFileName( aOutputDir.GetPath(), wxT( "output_old.txt" ) ).GetFullPath();
+    wxString newName = wxFileName( aOutputDir.GetPath(), wxT( "output_new.txt" ) ).GetFullPath();
+
+    LOCALE_IO toggle;
+
+    FILE*        file = wxFopen( oldName, wxT( "wb" ) );
+    PROF_COUNTER timer;
+
+    if( !file )
+        return;
+
+    for( int ii = 0; ii + 1 < count; ii += 2 )
+    {
+        fprintf( file, "X%dY%dD%02d*\n", ints[ii], ints[ii + 1], 1 );
+        fprintf( file, "%g %g l\n", ints[ii] * 0.0072, ints[ii + 1] * 0.0072 );
+    }
+
+    fclose( file );
+    double oldTime = timer.msecs();
+
+    std::unique_ptr<char[]> fileBuffer;
+
+    timer.Start();
+    file = wxFopen( newName, wxT( "wb" ) );
+
+    if( !file )
+        return;
+
+    PLOT_NUMBER_FORMATTER::setFileBuffer( file, fileBuffer );
+
+    for( int ii = 0; ii + 1 < count; ii += 2 )
+    {
+        // Like GERBER_PLOTTER::emitDcode()
+        char  line[3 * PLOT_NUMBER_FORMATTER::NUMBER_MAX_LEN + 8];
+        char* end = line;
+
+        *end++ = 'X';
+        end = PLOT_NUMBER_FORMATTER::formatInt( end, ints[ii] );
+        *end++ = 'Y';
+        end = PLOT_NUMBER_FORMATTER::formatInt( end, ints[ii + 1] );
+        memcpy( end, "D01*\n", 5 );
+        fwrite( line, 1, end + 5 - line, file );
+
+        PLOT_NUMBER_FORMATTER::writeCoords( file, ints[ii] * 0.0072, ints[ii + 1] * 0.0072,
+                                            " l\n" );
+    }
+
+    fclose( file );
+    double newTime = timer.msecs();
+
+    bool same = readFile( oldName ) == readFile( newName );
+
+    printf( "writing %d coordinates: old path %8.1f ms, new path %8.1f ms%s\n",
+            count, oldTime, newTime, same ? "" : " (THE FILES DIFFER)" );
+
+    wxRemoveFile( oldName );
+    wxRemoveFile( newName );
+}
+
+
+/**
+ * Plots the layers one after the other, each one in its own file, like a script calling
+ * PLOT_CONTROLLER::PlotLayer() for each layer.
+ * @param aCompression is the compression level of the PDF files
+ * @param aSize is set to the total size of the files
+ * @return the plot time in ms
+ */
+static double plotSerial( BOARD* aBoard, const PCB_PLOT_PARAMS& aOptions, const LSEQ& aLayers,
+                          int aCompression, long long& aSize )
+{
+    PCB_PLOT_PARAMS options = aOptions;
+    wxFileName      outputDir = wxFileName::DirName( options.GetOutputDirectory() );
+    PROF_COUNTER    timer;
+
+    options.SetPDFCompressionLevel( aCompression );
+    aSize = 0;
+
+    for( PCB_LAYER_ID layer : aLayers )
+    {
+        wxFileName fn( aBoard->GetFileName() );
+        BuildPlotFileName( &fn, outputDir.GetPath(), aBoard->GetLayerName( layer ),
+                           GetDefaultPlotExtension( options.GetFormat() ) );
+
+        LOCALE_IO toggle;
+        PLOTTER*  plotter = StartPlotBoard( aBoard, &options, layer, fn.GetFullPath(),
+                                            wxEmptyString );
+
+        if( !plotter )
+            continue;
+
+        PlotOneBoardLayer( aBoard, plotter, layer, options );
+        plotter->EndPlot();
+        delete plotter;
+
+        aSize += wxFileName::GetSize( fn.GetFullPath() ).GetValue();
+    }
+
+    return timer.msecs();
+}
+
+
+// Reads the lines of a plot file, without the ones giving the plot date
+static std::string readPlotWithoutDates( const wxString& aFileName )
+{
+    std::string content = readFile( aFileName );
+    std::string masked;
+    size_t      start = 0;
+
+    while( start < content.size() )
+    {
+        size_t end = content.find( '\n', start );
+        end = end == std::string::npos ? content.size() : end + 1;
+
+        std::string line = content.substr( start, end - start );
+
+        // Gerber "G04 Created by ... date", SVG "created as ... date", and the Gerber X2
+        // and PostScript creation dates
+        if( line.find( " date " ) == std::string::npos
+                && line.find( "CreationDate" ) == std::string::npos )
+            masked += line;
+
+        start = end;
+    }
+
+    return masked;
+}
+
+
+/**
+ * Plots the layers one after the other and as a batch, in several formats, and compares
+ * the files.
+ * @return true if the files are the same, date stamps excepted
+ */
+static bool comparePlots( BOARD* aBoard, const wxFileName& aOutputDir, const LSEQ& aLayers )
+{
+    const PlotFormat formats[] = { PLOT_FORMAT_GERBER, PLOT_FORMAT_POST, PLOT_FORMAT_SVG };
+    bool             same = true;
+
+    for( PlotFormat format : formats )
+    {
+        wxFileName serialDir( aOutputDir );
+        wxFileName batchDir( aOutputDir );
+
+        serialDir.AppendDir( wxT( "serial" ) );
+        batchDir.AppendDir( wxT( "batch" ) );
+
+        PLOT_CONTROLLER serial( aBoard );
+        PLOT_CONTROLLER batch( aBoard );
+
+        for( PLOT_CONTROLLER* controller : { &serial, &batch } )
+        {
+            controller->GetPlotOptions().SetOutputDirectory( controller == &serial ?
+                                                              serialDir.GetPath() :
+                                                              batchDir.GetPath() );
+            controller->GetPlotOptions().SetPlotFrameRef( false );
+        }
+
+        std::vector<wxString> serialFiles;
+
+        for( PCB_LAYER_ID layer : aLayers )
+        {
+            serial.SetLayer( layer );
+
+            if( serial.OpenPlotfile( aBoard->GetLayerName( layer ), format, wxEmptyString ) )
+            {
+                serialFiles.push_back( serial.GetPlotFileName() );
+                serial.PlotLayer();
+            }
+            else
+            {
+                serialFiles.push_back( wxEmptyString );
+            }
+
+            serial.ClosePlot();
+            batch.AddLayerPlot( layer, aBoard->GetLayerName( layer ), wxEmptyString );
+        }
+
+        batch.PlotLayers( format );
+
+        int differences = 0;
+
+        for( int ii = 0; ii < batch.GetLayerPlotCount(); ii++ )
+        {
+            const PLOT_LAYER_JOB& job = batch.GetLayerPlot( ii );
+
+            if( serialFiles[ii].IsEmpty() || !job.m_success
+                    || readPlotWithoutDates( serialFiles[ii] )
+                            != readPlotWithoutDates( job.m_fileName ) )
+            {
+                printf( "    %s differs\n", TO_UTF8( job.m_fileName ) );
+                differences++;
+            }
+        }
+
+        printf( "%s: %d layers, %d different files\n",
+                TO_UTF8( GetDefaultPlotExtension( format ) ), batch.GetLayerPlotCount(),
+                differences );
+
+        same = same && !differences;
+    }
+
+    return same;
+}
+
+
+int main( int argc, char** argv )
+{
+    bool compare = argc > 1 && !strcmp( argv[1], "--compare" );
+
+    if( compare )
+    {
+        argc--;
+        argv++;
+    }
+
+    if( argc < 2 )
+    {
+        printf( "usage: %s [--compare] board.kicad_pcb [output directory]\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM             program( argc, argv );
+    PROF_COUNTER           loadTimer;
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    printf( "board: %s, loaded in %.1f ms\n", argv[1], loadTimer.msecs() );
+
+    wxFileName outputDir = wxFileName::DirName( FROM_UTF8( argc > 2 ? argv[2] : "plot_perf" ) );
+    outputDir.MakeAbsolute();
+
+    if( !outputDir.DirExists() && !outputDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+    {
+        printf( "cannot create the output directory '%s'\n", TO_UTF8( outputDir.GetPath() ) );
+        return 1;
+    }
+
+    LSEQ layers = board->GetEnabledLayers().Seq();
+
+    if( compare )
+        return comparePlots( board.get(), outputDir, layers ) ? 0 : 1;
+
+    benchmarkFormatting();
+    benchmarkOutput( outputDir );
+
+    PCB_PLOT_PARAMS options;
+    options.SetOutputDirectory( outputDir.GetPath() );
+    options.SetPlotFrameRef( false );   // the page layout is not loaded
+
+    struct FORMAT_RUN
+    {
+        PlotFormat  format;
+        int         compression;
+        const char* name;
+    };
+
+    const FORMAT_RUN runs[] =
+    {
+        { PLOT_FORMAT_GERBER, 0, "gerber" },
+        { PLOT_FORMAT_POST,   0, "postscript" },
+        { PLOT_FORMAT_SVG,    0, "svg" },
+        { PLOT_FORMAT_PDF,    9, "pdf level 9" },
+        { PLOT_FORMAT_PDF,    6, "pdf level 6" },
+        { PLOT_FORMAT_PDF,    1, "pdf level 1" },
+    };
+
+    printf( "serial plot of %u layers:\n", (unsigned) layers.size() );
+
+    for( const FORMAT_RUN& run : runs )
+    {
+        long long size;
+
+        options.SetFormat( run.format );
+        double time = plotSerial( board.get(), options, layers, run.compression, size );
+
+        printf( "    %-12s %10.1f ms %12lld bytes\n", run.name, time, size );
+    }
+
+    // The same layers, plotted at the same time
+    PLOT_CONTROLLER controller( board.get() );
+    controller.GetPlotOptions() = options;
+
+    for( PCB_LAYER_ID layer : layers )
+        controller.AddLayerPlot( layer, board->GetLayerName( layer ), wxEmptyString );
+
+    PROF_COUNTER timer;
+    bool         success = controller.PlotLayers( PLOT_FORMAT_GERBER );
+    double       time = timer.msecs();
+
+    printf( "batch gerber plot: %.1f ms%s\n", time, success ? "" : " (some files failed)" );
+
+    for( int ii = 0; ii < controller.GetLayerPlotCount(); ii++ )
+    {
+        const PLOT_LAYER_JOB& job = controller.GetLayerPlot( ii );
+
+        printf( "    %-12s %10.1f ms\n", TO_UTF8( job.m_suffix ), job.m_time );
+    }
+
+    return 0;
+}
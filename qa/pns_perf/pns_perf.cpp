@@ -0,0 +1,308 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_perf.cpp
+ * @brief Replays a recorded router session on a board, without display, and reports the
+ * latency of each router operation.
+ *
+ * A session is recorded by pcbnew when the KICAD_PNS_SESSION_LOG environment variable
+ * names the log file.  Save the board before routing: the replay starts from the saved
+ * board, and the routed tracks are not written back to it.
+ *
+ *      qa_pns_perf board.kicad_pcb session.log [repeat count]
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <class_board.h>
+
+#include <router/pns_kicad_iface.h>
+#include <router/pns_router.h>
+#include <router/pns_logger.h>
+#include <router/pns_node.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/// @return the peak resident memory of the process in kB, or 0 if it is not known.
+static long peakMemory()
+{
+#ifndef _WIN32
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+        return usage.ru_maxrss;     // kB on Linux
+#endif
+
+    return 0;
+}
+
+
+/**
+ * Finds in the router world the item of a recorded event, from its kind, net and layers.
+ */
+static PNS::ITEM* findEventItem( PNS::ROUTER& aRouter, const PNS::LOGGER::EVENT_ENTRY& aEvent )
+{
+    if( !aEvent.m_itemKind )
+        return nullptr;
+
+    const PNS::ITEM_SET items = aRouter.QueryHoverItems( aEvent.m_p );
+
+    for( int ii = 0; ii < items.Size(); ii++ )
+    {
+        PNS::ITEM* item = items[ii];
+
+        if( item->Kind() == aEvent.m_itemKind && item->Net() == aEvent.m_itemNet
+            && item->Layers().Start() == aEvent.m_itemLayerStart
+            && item->Layers().End() == aEvent.m_itemLayerEnd )
+            return item;
+    }
+
+    return nullptr;
+}
+
+
+static void applySizes( PNS::ROUTER& aRouter, const std::vector<int>& aParams )
+{
+    if( aParams.size() < 11 )
+        return;
+
+    PNS::SIZES_SETTINGS sizes = aRouter.Sizes();
+
+    sizes.SetTrackWidth( aParams[0] );
+    sizes.SetViaDiameter( aParams[1] );
+    sizes.SetViaDrill( aParams[2] );
+    sizes.SetViaType( (VIATYPE_T) aParams[3] );
+    sizes.SetDiffPairWidth( aParams[4] );
+    sizes.SetDiffPairGap( aParams[5] );
+    sizes.SetDiffPairViaGap( aParams[6] );
+    sizes.SetDiffPairViaGapSameAsTraceGap( aParams[7] );
+    sizes.ClearLayerPairs();
+
+    if( aParams[8] )
+        sizes.AddLayerPair( aParams[9], aParams[10] );
+
+    aRouter.UpdateSizes( sizes );
+}
+
+
+/**
+ * Applies a recorded event to the router.
+ * @return false if the event item was not found in the router world.
+ */
+static bool replayEvent( PNS::ROUTER& aRouter, const PNS::LOGGER::EVENT_ENTRY& aEvent )
+{
+    PNS::ITEM* item = findEventItem( aRouter, aEvent );
+    int param = aEvent.m_params.empty() ? 0 : aEvent.m_params[0];
+
+    switch( aEvent.m_type )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE:
+        aRouter.StartRouting( aEvent.m_p, item, param );
+        break;
+
+    case PNS::LOGGER::EVT_START_DRAG:
+        aRouter.StartDragging( aEvent.m_p, item );
+        break;
+
+    case PNS::LOGGER::EVT_MOVE:
+        aRouter.Move( aEvent.m_p, item );
+        break;
+
+    case PNS::LOGGER::EVT_FIX:
+        aRouter.FixRoute( aEvent.m_p, item );
+        break;
+
+    case PNS::LOGGER::EVT_STOP:
+        aRouter.StopRouting();
+        break;
+
+    case PNS::LOGGER::EVT_SWITCH_LAYER:
+        aRouter.SwitchLayer( param );
+        break;
+
+    case PNS::LOGGER::EVT_TOGGLE_VIA:
+        aRouter.ToggleViaPlacement();
+        break;
+
+    case PNS::LOGGER::EVT_FLIP_POSTURE:
+        aRouter.FlipPosture();
+        break;
+
+    case PNS::LOGGER::EVT_SET_MODE:
+        aRouter.SetMode( (PNS::ROUTER_MODE) param );
+        break;
+
+    case PNS::LOGGER::EVT_SETTINGS:
+        if( aEvent.m_params.size() >= 2 )
+        {
+            aRouter.Settings().SetMode( (PNS::PNS_MODE) aEvent.m_params[0] );
+            aRouter.Settings().SetOptimizerEffort(
+                    (PNS::PNS_OPTIMIZATION_EFFORT) aEvent.m_params[1] );
+        }
+        break;
+
+    case PNS::LOGGER::EVT_SIZES:
+        applySizes( aRouter, aEvent.m_params );
+        break;
+
+    default:
+        break;
+    }
+
+    return item || !aEvent.m_itemKind;
+}
+
+
+static double percentile( const std::vector<double>& aSorted, double aFraction )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    size_t index = std::min( aSorted.size() - 1, size_t( aFraction * aSorted.size() ) );
+
+    return aSorted[index];
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 3 )
+    {
+        printf( "usage: %s board.kicad_pcb session.log [repeat count]\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM program( argc, argv );
+
+    std::vector<PNS::LOGGER::EVENT_ENTRY> events;
+
+    if( !PNS::LOGGER::LoadEvents( argv[2], events ) )
+    {
+        printf( "cannot read the session log '%s'\n", argv[2] );
+        return 1;
+    }
+
+    int                    repeat = argc > 3 ? std::max( 1, atoi( argv[3] ) ) : 1;
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    board->SynchronizeNetsAndNetClasses();
+
+    PNS_KICAD_IFACE iface;
+    PNS::ROUTER     router;
+
+    iface.SetBoard( board.get() );
+    iface.SetView( NULL );
+    router.SetInterface( &iface );
+
+    std::vector<double> latencies[PNS::LOGGER::EVT_LAST];
+    double              syncTime = 0.0;
+    int                 missingItems = 0;
+
+    unsigned long long  branches = PNS::NODE::BranchCount();
+    unsigned long long  copiedJoints = PNS::NODE::BranchCopiedJoints();
+
+    for( int pass = 0; pass < repeat; pass++ )
+    {
+        // The world is synchronized again, as the replay modified it
+        PROF_COUNTER syncTimer;
+        router.ClearWorld();
+        router.SyncWorld();
+        syncTime += syncTimer.msecs();
+
+        for( const PNS::LOGGER::EVENT_ENTRY& evt : events )
+        {
+            PROF_COUNTER timer;
+
+            if( !replayEvent( router, evt ) )
+                missingItems++;
+
+            latencies[evt.m_type].push_back( timer.msecs() );
+        }
+
+        router.StopRouting();
+    }
+
+    branches = PNS::NODE::BranchCount() - branches;
+    copiedJoints = PNS::NODE::BranchCopiedJoints() - copiedJoints;
+
+    printf( "board: %s, session: %s, %u events, %d passes\n", argv[1], argv[2],
+            (unsigned) events.size(), repeat );
+    printf( "world sync: %.2f ms per pass\n", syncTime / repeat );
+    printf( "%-10s %8s %10s %10s %10s %10s %12s\n",
+            "event", "count", "p50 ms", "p90 ms", "p99 ms", "max ms", "total ms" );
+
+    double total = 0.0;
+    size_t count = 0;
+
+    for( int type = 0; type < PNS::LOGGER::EVT_LAST; type++ )
+    {
+        std::vector<double>& times = latencies[type];
+
+        if( times.empty() )
+            continue;
+
+        std::sort( times.begin(), times.end() );
+
+        double sum = 0.0;
+
+        for( double t : times )
+            sum += t;
+
+        printf( "%-10s %8u %10.3f %10.3f %10.3f %10.3f %12.1f\n",
+                PNS::LOGGER::EventName( (PNS::LOGGER::EVENT_TYPE) type ), (unsigned) times.size(),
+                percentile( times, 0.5 ), percentile( times, 0.9 ), percentile( times, 0.99 ),
+                times.back(), sum );
+
+        total += sum;
+        count += times.size();
+    }
+
+    printf( "total: %.1f ms for %u events\n", total, (unsigned) count );
+    printf( "node branches: %llu (%.1f per event), copied joints: %llu\n", branches,
+            count ? double( branches ) / count : 0.0, copiedJoints );
+    printf( "peak memory: %ld kB\n", peakMemory() );
+
+    if( missingItems )
+        printf( "warning: %d event items not found, the board differs from the session\n",
+                missingItems );
+
+    router.ClearWorld();
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_loader.cpp
+ */
+
+#include <fctsys.h>
+#include <common.h>
+
+#include <cstdio>
+
+#include <class_board.h>
+#include <io_mgr.h>
+
+#include <board_loader.h>
+
+
+std::unique_ptr<BOARD> LoadBoard( const char* aFileName )
+{
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        board.reset( IO_MGR::Load( IO_MGR::KICAD, FROM_UTF8( aFileName ) ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "cannot load the board '%s': %s\n", aFileName, TO_UTF8( ioe.What() ) );
+    }
+
+    return board;
+}
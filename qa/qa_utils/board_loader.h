@@ -0,0 +1,45 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_loader.h
+ * @brief Loads the boards of the pcbnew qa programs.
+ */
+
+#ifndef BOARD_LOADER_H
+#define BOARD_LOADER_H
+
+#include <memory>
+
+class BOARD;
+
+
+/**
+ * Function LoadBoard
+ * loads a board file in the KiCad format, and prints the error when it cannot be loaded.
+ * @param aFileName is the board file, as given on the command line
+ * @return the board, or an empty pointer on error.
+ */
+std::unique_ptr<BOARD> LoadBoard( const char* aFileName );
+
+#endif  // BOARD_LOADER_H
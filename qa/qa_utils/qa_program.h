@@ -0,0 +1,65 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file qa_program.h
+ * @brief The program object of the qa programs linked with the code of a kiface.
+ */
+
+#ifndef QA_PROGRAM_H
+#define QA_PROGRAM_H
+
+#include <pgm_base.h>
+
+#include <wx/init.h>
+
+
+/**
+ * Class QA_PROGRAM
+ * initializes wxWidgets and gives a minimal program object to the kiface code linked in a
+ * qa program, like a kiface loader does.  It must live as long as the kiface code is used,
+ * usually for the whole main().
+ */
+class QA_PROGRAM
+{
+public:
+    QA_PROGRAM( int aArgc, char** aArgv );
+
+    /// @return the program object, to create a KIWAY
+    PGM_BASE* GetProgram() { return &m_program; }
+
+private:
+    /// The minimal program object needed by the kiface code
+    class PGM_QA : public PGM_BASE
+    {
+    public:
+        bool OnPgmInit() override { return true; }
+        void OnPgmExit() override {}
+        void MacOpenFile( const wxString& aFileName ) override {}
+    };
+
+    wxInitializer   m_initializer;      ///< before m_program, which uses wxWidgets
+    PGM_QA          m_program;
+};
+
+#endif  // QA_PROGRAM_H
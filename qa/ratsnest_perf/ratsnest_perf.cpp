@@ -0,0 +1,181 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file ratsnest_perf.cpp
+ * @brief Computes the ratsnest of a board several times, with RN_DATA::ProcessBoard(), and
+ * reports the times and the memory used by the nodes and edges of the nets.
+ *
+ * The runs are made twice: with the nodes and edges taken from the pools of the nets, and
+ * with each of them allocated on the heap, as before the pools (see
+ * RN_POOL::SetHeapAllocation()).  The heap memory does not count the overhead of the
+ * allocator, about 16 bytes per object.
+ *
+ * Each run creates its nodes and edges again, at other addresses, so all the runs must give
+ * the same ratsnest lines.  Big boards are made by qa/scale_board.py: its --own-nets option
+ * gives many small nets, without it the nets get many items.
+ *
+ *      qa_ratsnest_perf board.kicad_pcb [run count]
+ */
+
+#include <fctsys.h>
+#include <profile.h>
+#include <common.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <class_board.h>
+#include <ratsnest_data.h>
+
+#include <qa_program.h>
+#include <board_loader.h>
+
+
+/**
+ * Returns the end coordinates of the ratsnest lines of all the nets, in the net order and
+ * the order of the lines in each net.
+ */
+static std::vector<int> ratsnestLines( RN_DATA* aRatsnest )
+{
+    std::vector<int> lines;
+
+    for( int net = 1; net < aRatsnest->GetNetCount(); net++ )
+    {
+        const std::vector<RN_EDGE_MST_PTR>* edges = aRatsnest->GetNet( net ).GetUnconnected();
+
+        if( !edges )
+            continue;
+
+        for( const RN_EDGE_MST_PTR& edge : *edges )
+        {
+            lines.push_back( edge->GetSourceNode()->GetX() );
+            lines.push_back( edge->GetSourceNode()->GetY() );
+            lines.push_back( edge->GetTargetNode()->GetX() );
+            lines.push_back( edge->GetTargetNode()->GetY() );
+        }
+    }
+
+    return lines;
+}
+
+
+/**
+ * Results of the runs with one allocation.
+ */
+struct RUN_RESULT
+{
+    double           best;
+    double           mean;
+    size_t           memory;
+    std::vector<int> lines;
+    bool             same;
+};
+
+
+/**
+ * Runs RN_DATA::ProcessBoard() aRunCount times, with the nodes and edges allocated on the
+ * heap if aHeap is true, or taken from the pools.
+ */
+static RUN_RESULT runProcessBoard( RN_DATA* aRatsnest, int aRunCount, bool aHeap )
+{
+    RUN_RESULT result;
+    double     total = 0.0;
+
+    result.best = 0.0;
+    result.same = true;
+
+    RN_POOL::SetHeapAllocation( aHeap );
+
+    for( int run = 0; run < aRunCount; run++ )
+    {
+        PROF_COUNTER timer;
+        aRatsnest->ProcessBoard();
+        double time = timer.msecs();
+
+        total += time;
+        result.best = run ? std::min( result.best, time ) : time;
+
+        std::vector<int> lines = ratsnestLines( aRatsnest );
+
+        if( run == 0 )
+            result.lines = lines;
+        else if( lines != result.lines )
+            result.same = false;
+    }
+
+    result.mean = total / aRunCount;
+    result.memory = 0;
+
+    for( int net = 1; net < aRatsnest->GetNetCount(); net++ )
+        result.memory += aRatsnest->GetNet( net ).GetMemoryUsage();
+
+    RN_POOL::SetHeapAllocation( false );
+
+    return result;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        printf( "usage: %s board.kicad_pcb [run count]\n", argv[0] );
+        return 1;
+    }
+
+    QA_PROGRAM             program( argc, argv );
+    std::unique_ptr<BOARD> board = LoadBoard( argv[1] );
+
+    if( !board )
+        return 1;
+
+    int      runCount = argc > 2 ? std::max( 1, atoi( argv[2] ) ) : 5;
+    RN_DATA* ratsnest = board->GetRatsnest();
+
+    printf( "board: %s, %d nets, %d pads\n", argv[1], (int) board->GetNetCount(),
+            (int) board->GetPadCount() );
+
+    RUN_RESULT heap = runProcessBoard( ratsnest, runCount, true );
+    RUN_RESULT pool = runProcessBoard( ratsnest, runCount, false );
+
+    printf( "%d runs, %d ratsnest lines\n", runCount, (int) ( pool.lines.size() / 4 ) );
+    printf( "    heap: %10.1f ms (best), %10.1f ms (mean), nodes and edges: %8u kB\n",
+            heap.best, heap.mean, (unsigned) ( heap.memory / 1024 ) );
+    printf( "    pool: %10.1f ms (best), %10.1f ms (mean), nodes and edges: %8u kB\n",
+            pool.best, pool.mean, (unsigned) ( pool.memory / 1024 ) );
+
+    if( pool.best > 0.0 )
+        printf( "    speedup: %.2fx\n", heap.best / pool.best );
+
+    if( !heap.same || !pool.same || heap.lines != pool.lines )
+    {
+        printf( "the runs gave other ratsnest lines\n" );
+        return 1;
+    }
+
+    return 0;
+}
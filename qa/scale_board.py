@@ -0,0 +1,185 @@
+#!/usr/bin/env python
+#
+# This program source code file is part of KiCad, a free EDA CAD application.
+#
+# Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, you may find one here:
+# http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+# or you may search the http://www.gnu.org website for the version 2 license,
+# or you may write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+"""
+Makes a big board for benchmarks, by tiling copies of the modules, tracks, vias and zones
+of a .kicad_pcb file.  The copies keep their nets, so the nets get many more items.  With
+--own-nets, each copy gets its own nets instead, so the board gets many more small nets.
+
+    python scale_board.py data/complex_hierarchy.kicad_pcb big.kicad_pcb 10 10
+    python scale_board.py --own-nets data/complex_hierarchy.kicad_pcb many.kicad_pcb 10 10
+
+qa_ratsnest_perf reports the ratsnest time and memory of the result.
+"""
+
+import re
+import sys
+
+TILED_SECTIONS = ( 'module', 'segment', 'via', 'zone' )
+COORDINATE = re.compile( r'\((at|start|end|xy) (-?[0-9.]+) (-?[0-9.]+)' )
+
+# Net names are quoted or not, (net code name) in net sections and pads, (net code) elsewhere
+NET = re.compile( r'\(net ([0-9]+)( ("(\\.|[^"\\])*"|[^\s()]+))?\)' )
+NET_NAME = re.compile( r'\(net_name ("(\\.|[^"\\])*"|[^\s()]+)\)' )
+
+
+def split_sections( lines ):
+    """ Returns the header lines, the top level sections, and the closing lines. """
+    header, sections = [], []
+    depth, current = 0, None
+
+    for line in lines:
+        if current is None and depth == 1 and line.startswith( '  (' ):
+            current = []
+
+        if current is None:
+            if not sections:
+                header.append( line )
+        else:
+            current.append( line )
+
+        # Quoted strings can hold parentheses
+        unquoted = re.sub( r'"(\\.|[^"\\])*"', '', line )
+        depth += unquoted.count( '(' ) - unquoted.count( ')' )
+
+        if current is not None and depth == 1:
+            sections.append( current )
+            current = None
+
+    return header, sections, [ ')\n' ]
+
+
+def section_type( section ):
+    return section[0].strip()[1:].split( ' ', 1 )[0].rstrip( ')' )
+
+
+def shift( section, dx, dy ):
+    """ Moves a section: module positions (pads are relative), track ends, via and zone points. """
+    kind = section_type( section )
+    shifted = []
+    moved_module = False
+
+    for line in section:
+        def move( match ):
+            return '(%s %.4f %.4f' % ( match.group( 1 ), float( match.group( 2 ) ) + dx,
+                                        float( match.group( 3 ) ) + dy )
+
+        if kind == 'module':
+            # Only the module (at ...) is absolute
+            if not moved_module and line.startswith( '    (at ' ):
+                line = COORDINATE.sub( move, line, count=1 )
+                moved_module = True
+        else:
+            line = COORDINATE.sub( move, line )
+
+        shifted.append( line )
+
+    return shifted
+
+
+def rename_net( name, copy ):
+    """ Returns the name of a net in a copy, the first copy keeps the original names. """
+    if copy == 0 or name in ( '', '""' ):
+        return name
+
+    if name.startswith( '"' ):
+        return '%s_%d"' % ( name[:-1], copy )
+
+    return '%s_%d' % ( name, copy )
+
+
+def renumber( section, copy, net_count ):
+    """ Gives the nets of a copy their own codes and names.  Net 0 stays unconnected. """
+    def net( match ):
+        code = int( match.group( 1 ) )
+
+        if code == 0:
+            return match.group( 0 )
+
+        code += copy * net_count
+
+        if match.group( 3 ) is None:
+            return '(net %d)' % code
+
+        return '(net %d %s)' % ( code, rename_net( match.group( 3 ), copy ) )
+
+    def net_name( match ):
+        return '(net_name %s)' % rename_net( match.group( 1 ), copy )
+
+    return [ NET_NAME.sub( net_name, NET.sub( net, line ) ) for line in section ]
+
+
+def main():
+    args = [ arg for arg in sys.argv[1:] if arg != '--own-nets' ]
+    own_nets = len( args ) < len( sys.argv ) - 1
+
+    if len( args ) < 4:
+        print( 'usage: %s [--own-nets] input.kicad_pcb output.kicad_pcb columns rows [pitch_mm]'
+               % sys.argv[0] )
+        return 1
+
+    with open( args[0] ) as f:
+        header, sections, footer = split_sections( f.readlines() )
+
+    columns, rows = int( args[2] ), int( args[3] )
+    pitch = float( args[4] ) if len( args ) > 4 else 200.0
+    nets = [ section for section in sections if section_type( section ) == 'net' ]
+    net_count = 1 + max( [ int( NET.match( net[0].strip() ).group( 1 ) ) for net in nets ] + [ 0 ] )
+
+    with open( args[1], 'w' ) as out:
+        out.writelines( header )
+
+        for section in sections:
+            kind = section_type( section )
+
+            if kind in TILED_SECTIONS:
+                continue
+
+            out.writelines( section )
+
+            # The nets of the copies are declared after the original ones
+            if own_nets and section is nets[-1]:
+                for copy in range( 1, columns * rows ):
+                    for net in nets[1:]:
+                        out.writelines( renumber( net, copy, net_count ) )
+
+        for column in range( columns ):
+            for row in range( rows ):
+                copy = column * rows + row
+
+                for section in sections:
+                    if section_type( section ) in TILED_SECTIONS:
+                        section = shift( section, column * pitch, row * pitch )
+
+                        if own_nets:
+                            section = renumber( section, copy, net_count )
+
+                        out.writelines( section )
+
+        out.writelines( footer )
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit( main() )